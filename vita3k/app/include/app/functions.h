@@ -37,6 +37,10 @@ namespace app {
 struct LaunchRuntimeMetrics {
     bool tracking_started = false;
     std::chrono::steady_clock::time_point last_fps_time{};
+    // texture cache counters at the last update
+    uint64_t texture_hits = 0;
+    uint64_t texture_misses = 0;
+    uint64_t texture_evictions = 0;
 };
 
 struct FirmwareState {
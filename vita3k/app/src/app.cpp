@@ -28,6 +28,7 @@
 #include <renderer/functions.h>
 #include <renderer/shaders.h>
 #include <renderer/state.h>
+#include <renderer/texture_cache.h>
 #include <util/fs.h>
 #include <util/log.h>
 #include <util/net_utils.h>
@@ -71,6 +72,9 @@ void reset_perf_metrics(EmuEnvState &emuenv) {
     renderer.perf_overlay.fps_values.fill(0.0f);
     renderer.perf_overlay.fps_values_count = 0;
     renderer.perf_overlay.current_fps_offset = 0;
+    renderer.perf_overlay.texture_hits = 0;
+    renderer.perf_overlay.texture_misses = 0;
+    renderer.perf_overlay.texture_evictions = 0;
 }
 
 void sync_perf_overlay_config(EmuEnvState &emuenv) {
@@ -339,6 +343,19 @@ bool update_runtime_metrics(EmuEnvState &emuenv, LaunchRuntimeMetrics &metrics)
     renderer.perf_overlay.fps_values_count = perf_frames_size;
     renderer.perf_overlay.current_fps_offset = emuenv.current_fps_offset;
 
+    const renderer::TextureCacheStats &texture_stats = renderer.get_texture_cache()->stats;
+    const uint64_t texture_hits = texture_stats.hits.load(std::memory_order_relaxed);
+    const uint64_t texture_misses = texture_stats.misses.load(std::memory_order_relaxed);
+    const uint64_t texture_evictions = texture_stats.evictions.load(std::memory_order_relaxed);
+    renderer.perf_overlay.texture_hits = static_cast<uint32_t>(texture_hits - metrics.texture_hits);
+    renderer.perf_overlay.texture_misses = static_cast<uint32_t>(texture_misses - metrics.texture_misses);
+    renderer.perf_overlay.texture_evictions = static_cast<uint32_t>(texture_evictions - metrics.texture_evictions);
+    renderer.perf_overlay.texture_memory_used = texture_stats.memory_used.load(std::memory_order_relaxed);
+    renderer.perf_overlay.texture_memory_budget = texture_stats.memory_budget.load(std::memory_order_relaxed);
+    metrics.texture_hits = texture_hits;
+    metrics.texture_misses = texture_misses;
+    metrics.texture_evictions = texture_evictions;
+
     return true;
 }
 
@@ -36,6 +36,7 @@
 #include <kernel/state.h>
 #include <lang/state.h>
 #include <mem/functions.h>
+#include <mem/util.h>
 #include <modules/module_parent.h>
 #include <motion/state.h>
 #include <net/state.h>
@@ -562,7 +563,7 @@ bool late_init(EmuEnvState &state) {
     state.renderer->late_init(state.cfg, state.app_path, state.mem);
 
     const bool need_page_table = state.renderer->mapping_method == MappingMethod::PageTable || state.renderer->mapping_method == MappingMethod::NativeBuffer;
-    if (!init(state.mem, need_page_table)) {
+    if (!init(state.mem, need_page_table, state.cfg.huge_pages)) {
         LOG_ERROR("Failed to initialize memory for emulator state!");
         return false;
     }
@@ -592,6 +593,7 @@ void apply_renderer_config(EmuEnvState &emuenv) {
     r.stretch_hd_pixel_perfect(cc.fullscreen_hd_res_pixel_perfect);
     r.set_async_compilation(cc.async_pipeline_compilation);
     r.get_texture_cache()->set_replacement_state(cc.import_textures, cc.export_textures, cc.export_as_png);
+    r.get_texture_cache()->set_memory_budget(MiB(cc.texture_cache_budget));
 #ifdef __ANDROID__
     if (r.support_custom_drivers())
         r.set_turbo_mode(emuenv.cfg.turbo_mode);
@@ -685,6 +687,7 @@ void apply_runtime_settings(EmuEnvState &emuenv) {
     r.stretch_hd_pixel_perfect(cc.fullscreen_hd_res_pixel_perfect);
     r.set_async_compilation(cc.async_pipeline_compilation);
     r.get_texture_cache()->set_replacement_state(cc.import_textures, cc.export_textures, cc.export_as_png);
+    r.get_texture_cache()->set_memory_budget(MiB(cc.texture_cache_budget));
 #ifdef __ANDROID__
     if (r.support_custom_drivers())
         r.set_turbo_mode(emuenv.cfg.turbo_mode);
@@ -152,9 +152,13 @@ using PhysicalKeyCode = input::PhysicalKeyCode;
     code(bool, "v-sync", true, v_sync)                                                                  \
     code(int, "anisotropic-filtering", 1, anisotropic_filtering)                                        \
     code(bool, "texture-cache", true, texture_cache)                                                    \
+    code(int, "texture-cache-budget", 1024, texture_cache_budget)                                       \
     code(bool, "async-pipeline-compilation", true, async_pipeline_compilation)                          \
     code(bool, "show-compile-shaders", true, show_compile_shaders)                                      \
     code(bool, "hashless-texture-cache", false, hashless_texture_cache)                                 \
+    code(bool, "async-texture-upload", true, async_texture_upload)                                      \
+    code(bool, "texture-disk-cache", false, texture_disk_cache)                                         \
+    code(int, "texture-disk-cache-size", 1024, texture_disk_cache_size)                                 \
     code(bool, "import-textures", false, import_textures)                                               \
     code(bool, "export-textures", false, export_textures)                                               \
     code(bool, "export-as-png", true, export_as_png)                                                    \
@@ -175,6 +179,11 @@ using PhysicalKeyCode = input::PhysicalKeyCode;
     code(float, "background-alpha", .300f, background_alpha)                                            \
     code(int, "log-level", 0 /*SPDLOG_LEVEL_TRACE*/, log_level)                                         \
     code(bool, "cpu-opt", true, cpu_opt)                                                                \
+    code(bool, "jit-warm-up", true, jit_warm_up)                                                        \
+    code(bool, "huge-pages", false, huge_pages)                                                         \
+    code(bool, "thread-pinning", false, thread_pinning)                                                 \
+    code(std::string, "thread-pinning-cores", "", thread_pinning_cores)                                 \
+    code(bool, "thread-priorities", false, thread_priorities)                                           \
     code(std::string, "pref-path", std::string{}, vita_fs_path)                                         \
     code(bool, "discord-rich-presence", true, discord_rich_presence)                                    \
     code(bool, "wait-for-debugger", false, wait_for_debugger)                                           \
@@ -60,6 +60,7 @@ struct Config {
      */
     struct CurrentConfig {
         bool cpu_opt = true;
+        bool jit_warm_up = true;
         int modules_mode = ModulesMode::AUTOMATIC;
         std::vector<std::string> lle_modules = {};
         std::string audio_backend = "SDL";
@@ -86,6 +87,7 @@ struct Config {
         bool shader_cache = true;
         bool spirv_shader = false;
         bool texture_cache = true;
+        int texture_cache_budget = 1024;
         bool stretch_the_display_area = false;
         bool fullscreen_hd_res_pixel_perfect = false;
         int file_loading_delay = 0;
@@ -32,6 +32,7 @@ namespace {
 
 void copy_global_to_current(Config::CurrentConfig &current, const Config &cfg) {
     current.cpu_opt = cfg.cpu_opt;
+    current.jit_warm_up = cfg.jit_warm_up;
     current.modules_mode = cfg.modules_mode;
     current.lle_modules = cfg.lle_modules;
     current.backend_renderer = cfg.backend_renderer;
@@ -54,6 +55,7 @@ void copy_global_to_current(Config::CurrentConfig &current, const Config &cfg) {
     current.shader_cache = cfg.shader_cache;
     current.spirv_shader = cfg.spirv_shader;
     current.texture_cache = cfg.texture_cache;
+    current.texture_cache_budget = cfg.texture_cache_budget;
     current.audio_backend = cfg.audio_backend;
     current.audio_volume = cfg.audio_volume;
     current.ngs_enable = cfg.ngs_enable;
@@ -77,6 +79,7 @@ void copy_global_to_current(Config::CurrentConfig &current, const Config &cfg) {
 
 void copy_current_to_global(Config &cfg, const Config::CurrentConfig &current) {
     cfg.cpu_opt = current.cpu_opt;
+    cfg.jit_warm_up = current.jit_warm_up;
     cfg.modules_mode = current.modules_mode;
     cfg.lle_modules = current.lle_modules;
     cfg.backend_renderer = current.backend_renderer;
@@ -99,6 +102,7 @@ void copy_current_to_global(Config &cfg, const Config::CurrentConfig &current) {
     cfg.shader_cache = current.shader_cache;
     cfg.spirv_shader = current.spirv_shader;
     cfg.texture_cache = current.texture_cache;
+    cfg.texture_cache_budget = current.texture_cache_budget;
     cfg.audio_backend = current.audio_backend;
     cfg.audio_volume = current.audio_volume;
     cfg.ngs_enable = current.ngs_enable;
@@ -176,8 +180,11 @@ bool load_custom_config(Config::CurrentConfig &out, const fs::path &config_path,
             out.lle_modules.emplace_back(m.text().as_string());
     }
 
-    if (!config_child.child("cpu").empty())
-        out.cpu_opt = config_child.child("cpu").attribute("cpu-opt").as_bool();
+    if (!config_child.child("cpu").empty()) {
+        const auto cpu = config_child.child("cpu");
+        out.cpu_opt = cpu.attribute("cpu-opt").as_bool();
+        out.jit_warm_up = cpu.attribute("jit-warm-up").as_bool(true);
+    }
 
     if (!config_child.child("gpu").empty()) {
         const auto gpu = config_child.child("gpu");
@@ -201,6 +208,7 @@ bool load_custom_config(Config::CurrentConfig &out, const fs::path &config_path,
         out.shader_cache = gpu.attribute("shader-cache").as_bool(true);
         out.spirv_shader = gpu.attribute("spirv-shader").as_bool();
         out.texture_cache = gpu.attribute("texture-cache").as_bool(true);
+        out.texture_cache_budget = gpu.attribute("texture-cache-budget").as_int(1024);
     }
 
     if (!config_child.child("audio").empty()) {
@@ -267,6 +275,7 @@ bool save_custom_config(const Config::CurrentConfig &cc, const fs::path &config_
 
     auto cpu_child = config_child.append_child("cpu");
     cpu_child.append_attribute("cpu-opt") = cc.cpu_opt;
+    cpu_child.append_attribute("jit-warm-up") = cc.jit_warm_up;
 
     auto gpu_child = config_child.append_child("gpu");
     gpu_child.append_attribute("backend-renderer") = cc.backend_renderer.c_str();
@@ -289,6 +298,7 @@ bool save_custom_config(const Config::CurrentConfig &cc, const fs::path &config_
     gpu_child.append_attribute("shader-cache") = cc.shader_cache;
     gpu_child.append_attribute("spirv-shader") = cc.spirv_shader;
     gpu_child.append_attribute("texture-cache") = cc.texture_cache;
+    gpu_child.append_attribute("texture-cache-budget") = cc.texture_cache_budget;
 
     auto audio_child = config_child.append_child("audio");
     audio_child.append_attribute("audio-backend") = cc.audio_backend.c_str();
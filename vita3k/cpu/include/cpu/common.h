@@ -27,6 +27,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 struct CPUState;
 struct CPUContext;
@@ -35,6 +36,18 @@ struct CPUInterface;
 typedef std::unique_ptr<CPUState, std::function<void(CPUState *)>> CPUStatePtr;
 typedef std::unique_ptr<CPUInterface> CPUInterfacePtr;
 
+// Guest state a translated JIT block depends on
+struct JitBlockInfo {
+    Address pc;
+    bool thumb;
+    uint32_t fpscr;
+};
+
+typedef std::function<void(const JitBlockInfo &)> JitBlockTranslatedFunc;
+typedef std::vector<JitBlockInfo> JitBlockInfos;
+// Returns true if the svc was fully handled and the JIT can keep running without stopping
+typedef std::function<bool(CPUState &, uint32_t svc)> SVCFastPathFunc;
+
 inline constexpr std::size_t MAX_CORE_COUNT = 150;
 
 struct CPUContext {
@@ -27,6 +27,8 @@
 struct MemState;
 
 CPUStatePtr init_cpu(bool cpu_opt, SceUID thread_id, std::size_t processor_id, MemState &mem);
+// Bring back a cpu previously used by another thread to its initial state, without dropping its translated code
+void reset_cpu(CPUState &state, SceUID thread_id);
 int run(CPUState &state);
 int step(CPUState &state);
 void stop(CPUState &state);
@@ -49,6 +51,9 @@ CPUContext save_context(CPUState &state);
 void load_context(CPUState &state, const CPUContext &ctx);
 std::size_t get_processor_id(CPUState &state);
 void invalidate_jit_cache(CPUState &state, Address start, size_t length);
+// Translate the given blocks ahead of time without executing any guest code.
+// Must not be called while the cpu is running.
+void warm_up_jit(CPUState &state, const JitBlockInfos &blocks);
 
 uint32_t read_fpscr(CPUState &state);
 void write_fpscr(CPUState &state, uint32_t value);
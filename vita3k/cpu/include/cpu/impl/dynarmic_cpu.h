@@ -52,6 +52,7 @@ public:
     ~DynarmicCPU() override;
     int run() override;
     void stop() override;
+    void reset() override;
 
     uint32_t get_reg(uint8_t idx) override;
     void set_reg(uint8_t idx, uint32_t val) override;
@@ -93,6 +94,7 @@ public:
     void clear_exclusive() override;
     std::size_t processor_id() const override;
     void invalidate_jit_cache(Address start, size_t length) override;
+    void warm_up(const JitBlockInfos &blocks) override;
 
     static Dynarmic::ExclusiveMonitor shared_monitor;
 };
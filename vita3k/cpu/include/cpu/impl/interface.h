@@ -27,6 +27,8 @@ struct CPUInterface {
 
     virtual int run() = 0;
     virtual void stop() = 0;
+    // Clear the registers and any pending halt, keeping the translated code
+    virtual void reset() = 0;
 
     virtual uint32_t get_reg(uint8_t idx) = 0;
     virtual void set_reg(uint8_t idx, uint32_t val) = 0;
@@ -55,6 +57,7 @@ struct CPUInterface {
     virtual CPUContext save_context() = 0;
     virtual void load_context(const CPUContext &ctx) = 0;
     virtual void invalidate_jit_cache(Address start, size_t length) = 0;
+    virtual void warm_up(const JitBlockInfos &blocks) = 0;
 
     virtual bool is_thumb_mode() = 0;
     virtual int step() = 0;
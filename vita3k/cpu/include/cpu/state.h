@@ -32,6 +32,10 @@ struct CPUState {
     DisasmState disasm;
 
     CPUInterfacePtr cpu;
+    // Called by the JIT each time it translates a new block, used to record the JIT profile
+    JitBlockTranslatedFunc block_translated;
+    // Called by the JIT on svc, from inside the JIT, before stopping it
+    SVCFastPathFunc svc_fast_path;
     bool svc_called;
     uint32_t svc;
 
@@ -52,6 +52,18 @@ CPUStatePtr init_cpu(bool cpu_opt, SceUID thread_id, std::size_t processor_id, M
     return state;
 }
 
+void reset_cpu(CPUState &state, SceUID thread_id) {
+    state.thread_id = thread_id;
+    state.block_translated = nullptr;
+    state.svc_fast_path = nullptr;
+    state.svc_called = false;
+    state.svc = 0;
+    state.abort_pending = false;
+    state.abort_fault_addr = 0;
+    state.abort_is_write = false;
+    state.cpu->reset();
+}
+
 int run(CPUState &state) {
     return state.cpu->run();
 }
@@ -168,6 +180,10 @@ void invalidate_jit_cache(CPUState &state, Address start, size_t length) {
     state.cpu->invalidate_jit_cache(start, length);
 }
 
+void warm_up_jit(CPUState &state, const JitBlockInfos &blocks) {
+    state.cpu->warm_up(blocks);
+}
+
 std::string disassemble(CPUState &state, uint64_t at, bool thumb, uint16_t *insn_size) {
     MemState &mem = *state.mem;
     const uint8_t *const code = Ptr<const uint8_t>(static_cast<Address>(at)).get(mem);
@@ -154,6 +154,12 @@ public:
     }
 
     void PreCodeTranslationHook(bool is_thumb, Dynarmic::A32::VAddr pc, Dynarmic::A32::IREmitter &ir) override {
+        // This hook is called for every instruction, only report the first one of each block
+        if (parent->block_translated) {
+            const Dynarmic::A32::LocationDescriptor location{ ir.block.Location() };
+            if (location.PC() == pc)
+                parent->block_translated({ pc, is_thumb, location.FPSCR().Value() });
+        }
         if (cpu->log_code) {
             ir.CallHostFunction(&TraceInstruction, ir.Imm64((uint64_t)this), ir.Imm64(pc), ir.Imm64(is_thumb));
         }
@@ -318,6 +324,10 @@ public:
     }
 
     void CallSVC(uint32_t svc) override {
+        // the guest registers are kept in the jit state, so they can be used and updated from here
+        if (parent->svc_fast_path && parent->svc_fast_path(*parent, svc))
+            return;
+
         parent->svc_called = true;
         parent->svc = svc;
         cpu->jit->HaltExecution(Dynarmic::HaltReason::UserDefined8);
@@ -375,6 +385,16 @@ int DynarmicCPU::run() {
     return halted;
 }
 
+void DynarmicCPU::reset() {
+    // a stop request received after the last run would otherwise halt the next thread right away
+    jit->ClearHalt(Dynarmic::HaltReason::UserDefined1 | Dynarmic::HaltReason::UserDefined7 | Dynarmic::HaltReason::UserDefined8);
+    halted = false;
+    break_ = false;
+    load_context(CPUContext{});
+    cp15->set_tpidruro(0);
+    clear_exclusive();
+}
+
 int DynarmicCPU::step() {
     parent->svc_called = false;
     jit->Step();
@@ -520,6 +540,21 @@ void DynarmicCPU::invalidate_jit_cache(Address start, size_t length) {
     jit->InvalidateCacheRange(start, length);
 }
 
+void DynarmicCPU::warm_up(const JitBlockInfos &blocks) {
+    // Run() fetches (and translates if needed) the block at the current location before
+    // checking for a pending halt, so halting beforehand compiles the block without executing it
+    const CPUContext ctx = save_context();
+    constexpr uint32_t CPSR_THUMB_AND_IT_MASK = 0x0600FC20;
+    for (const auto &block : blocks) {
+        jit->SetCpsr((ctx.cpsr & ~CPSR_THUMB_AND_IT_MASK) | (block.thumb ? 0x20 : 0));
+        jit->SetFpscr(block.fpscr);
+        jit->Regs()[15] = block.pc;
+        jit->HaltExecution(Dynarmic::HaltReason::UserDefined7);
+        jit->Run();
+    }
+    load_context(ctx);
+}
+
 void DynarmicCPU::clear_exclusive() {
     shared_monitor.ClearProcessor(core_id);
 }
@@ -0,0 +1,65 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Sample loops shared by the NGS and SAS voices, on interleaved stereo float frames.
+ * The implementation is chosen at runtime depending on the host CPU (SSE2, AVX2 or NEON)
+ * and gives the same results, bit for bit, as the scalar one.
+ */
+namespace dsp {
+
+enum class Implementation {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+// implementation used by the functions below
+Implementation get_implementation();
+// only for testing, the next calls use the given implementation if it is supported by the host
+bool set_implementation(Implementation implementation);
+
+// dest[L] = clamp(dest[L] + src[L] * matrix[0][0] + src[R] * matrix[1][0], -1, 1)
+// dest[R] = clamp(dest[R] + src[L] * matrix[0][1] + src[R] * matrix[1][1], -1, 1)
+void mix_stereo(float *dest, const float *src, const float matrix[2][2], int32_t frame_count);
+
+// dest[L] += src * volume[0], dest[R] += src * volume[1], without clamping so several sources can be summed first
+void mix_mono(float *dest, const float *src, const float volume[2], int32_t frame_count);
+
+// clamps the samples scaled by 32768 to the int16 range and truncates them
+void float_to_s16(int16_t *dest, const float *src, int32_t sample_count);
+
+// dest[i] = linear interpolation of the mono samples of src at position + i * step (32.32 fixed point),
+// src must hold the sample after the last position
+void interpolate(float *dest, const float *src, uint64_t position, uint64_t step, uint32_t sample_count);
+
+// number of input frames used for each output frame by resample_stereo
+constexpr uint32_t resampler_taps = 16;
+
+// Writes frame_count interleaved stereo frames, filtering the planar input channels at position, position + step, ...
+// (32.32 fixed point, the output frame is between the two middle taps).
+// filter holds (1 << phase_bits) + 1 rows of resampler_taps coefficients for evenly spaced positions
+// between two input frames, the coefficients used are interpolated between the two closest rows.
+void resample_stereo(float *dest, const float *left, const float *right, const float *filter, uint32_t phase_bits,
+    uint64_t position, uint64_t step, uint32_t frame_count);
+
+} // namespace dsp
@@ -0,0 +1,482 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <dsp/dsp.h>
+
+#include <util/log.h>
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DSP_X86
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((__target__("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+#include <immintrin.h>
+#include <util/instrset_detect.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define DSP_NEON
+#include <arm_neon.h>
+#endif
+
+namespace dsp {
+
+static void mix_stereo_scalar(float *dest, const float *src, const float matrix[2][2], int32_t frame_count) {
+    for (int32_t k = 0; k < frame_count; k++) {
+        // the vector implementations don't fuse the products with the additions either,
+        // dsp.cpp is built without floating point contraction so the results match exactly
+        const float left_from_left = src[k * 2] * matrix[0][0];
+        const float left_from_right = src[k * 2 + 1] * matrix[1][0];
+        const float right_from_left = src[k * 2] * matrix[0][1];
+        const float right_from_right = src[k * 2 + 1] * matrix[1][1];
+        dest[k * 2] = std::clamp(dest[k * 2] + left_from_left + left_from_right, -1.0f, 1.0f);
+        dest[k * 2 + 1] = std::clamp(dest[k * 2 + 1] + right_from_left + right_from_right, -1.0f, 1.0f);
+    }
+}
+
+static void mix_mono_scalar(float *dest, const float *src, const float volume[2], int32_t frame_count) {
+    for (int32_t k = 0; k < frame_count; k++) {
+        const float left = src[k] * volume[0];
+        const float right = src[k] * volume[1];
+        dest[k * 2] += left;
+        dest[k * 2 + 1] += right;
+    }
+}
+
+static void float_to_s16_scalar(int16_t *dest, const float *src, int32_t sample_count) {
+    for (int32_t i = 0; i < sample_count; i++) {
+        dest[i] = static_cast<int16_t>(std::clamp(src[i] * 32768.0f, -32768.0f, 32767.0f));
+    }
+}
+
+// only 24 bits of the fraction, converted from a signed integer which is much faster than from an unsigned one on x86
+static inline float get_fraction(uint64_t position) {
+    return static_cast<float>(static_cast<int32_t>(static_cast<uint32_t>(position) >> 8)) * (1.0f / (1 << 24));
+}
+
+static void interpolate_scalar(float *dest, const float *src, uint64_t position, uint64_t step, uint32_t sample_count) {
+    for (uint32_t i = 0; i < sample_count; i++, position += step) {
+        const float *samples = src + (position >> 32);
+        const float difference = samples[1] - samples[0];
+        const float interpolation = difference * get_fraction(position);
+        dest[i] = samples[0] + interpolation;
+    }
+}
+
+// position of the frame in the row of the filter before it, and its weight in the interpolation with the next row
+struct FilterPosition {
+    const float *row;
+    float weight;
+};
+
+static inline FilterPosition get_filter_position(const float *filter, uint32_t phase_bits, uint64_t position) {
+    const uint32_t fraction = static_cast<uint32_t>(position);
+    const uint32_t weight_bits = 32 - phase_bits;
+    return {
+        filter + (fraction >> weight_bits) * resampler_taps,
+        static_cast<float>(fraction & ((1U << weight_bits) - 1)) * (1.0f / (1U << weight_bits))
+    };
+}
+
+static void resample_stereo_scalar(float *dest, const float *left, const float *right, const float *filter, uint32_t phase_bits,
+    uint64_t position, uint64_t step, uint32_t frame_count) {
+    for (uint32_t i = 0; i < frame_count; i++, position += step) {
+        const FilterPosition filter_position = get_filter_position(filter, phase_bits, position);
+        const float *row = filter_position.row;
+        const float *next_row = row + resampler_taps;
+        const float *left_frames = left + (position >> 32);
+        const float *right_frames = right + (position >> 32);
+
+        // 4 sums added together in the same order as the vector implementations do
+        float left_sums[4] = {};
+        float right_sums[4] = {};
+        for (uint32_t tap = 0; tap < resampler_taps; tap += 4) {
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                const float difference = next_row[tap + lane] - row[tap + lane];
+                const float interpolation = difference * filter_position.weight;
+                const float coefficient = row[tap + lane] + interpolation;
+                const float left_product = left_frames[tap + lane] * coefficient;
+                const float right_product = right_frames[tap + lane] * coefficient;
+                left_sums[lane] += left_product;
+                right_sums[lane] += right_product;
+            }
+        }
+
+        dest[i * 2] = (left_sums[0] + left_sums[2]) + (left_sums[1] + left_sums[3]);
+        dest[i * 2 + 1] = (right_sums[0] + right_sums[2]) + (right_sums[1] + right_sums[3]);
+    }
+}
+
+#ifdef DSP_X86
+// max and min return their second operand when one is NaN, written this way they behave like std::clamp
+static inline __m128 clamp_sse2(__m128 value, __m128 low, __m128 high) {
+    return _mm_min_ps(high, _mm_max_ps(low, value));
+}
+
+static void mix_stereo_sse2(float *dest, const float *src, const float matrix[2][2], int32_t frame_count) {
+    const __m128 from_left = _mm_setr_ps(matrix[0][0], matrix[0][1], matrix[0][0], matrix[0][1]);
+    const __m128 from_right = _mm_setr_ps(matrix[1][0], matrix[1][1], matrix[1][0], matrix[1][1]);
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(1.0f);
+
+    int32_t k = 0;
+    for (; k + 2 <= frame_count; k += 2) {
+        const __m128 samples = _mm_loadu_ps(src + k * 2);
+        const __m128 left = _mm_shuffle_ps(samples, samples, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 right = _mm_shuffle_ps(samples, samples, _MM_SHUFFLE(3, 3, 1, 1));
+
+        __m128 mixed = _mm_add_ps(_mm_loadu_ps(dest + k * 2), _mm_mul_ps(left, from_left));
+        mixed = _mm_add_ps(mixed, _mm_mul_ps(right, from_right));
+        _mm_storeu_ps(dest + k * 2, clamp_sse2(mixed, low, high));
+    }
+
+    mix_stereo_scalar(dest + k * 2, src + k * 2, matrix, frame_count - k);
+}
+
+static void mix_mono_sse2(float *dest, const float *src, const float volume[2], int32_t frame_count) {
+    const __m128 volumes = _mm_setr_ps(volume[0], volume[1], volume[0], volume[1]);
+
+    int32_t k = 0;
+    for (; k + 4 <= frame_count; k += 4) {
+        const __m128 samples = _mm_loadu_ps(src + k);
+        // [s0, s0, s1, s1] and [s2, s2, s3, s3]
+        const __m128 first = _mm_unpacklo_ps(samples, samples);
+        const __m128 second = _mm_unpackhi_ps(samples, samples);
+        _mm_storeu_ps(dest + k * 2, _mm_add_ps(_mm_loadu_ps(dest + k * 2), _mm_mul_ps(first, volumes)));
+        _mm_storeu_ps(dest + k * 2 + 4, _mm_add_ps(_mm_loadu_ps(dest + k * 2 + 4), _mm_mul_ps(second, volumes)));
+    }
+
+    mix_mono_scalar(dest + k * 2, src + k, volume, frame_count - k);
+}
+
+static void float_to_s16_sse2(int16_t *dest, const float *src, int32_t sample_count) {
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 low = _mm_set1_ps(-32768.0f);
+    const __m128 high = _mm_set1_ps(32767.0f);
+
+    int32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        const __m128 first = clamp_sse2(_mm_mul_ps(_mm_loadu_ps(src + i), scale), low, high);
+        const __m128 second = clamp_sse2(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), low, high);
+        // the values are already in range, the saturation of the pack does nothing
+        const __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(first), _mm_cvttps_epi32(second));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), packed);
+    }
+
+    float_to_s16_scalar(dest + i, src + i, sample_count - i);
+}
+
+static void interpolate_sse2(float *dest, const float *src, uint64_t position, uint64_t step, uint32_t sample_count) {
+    // the fractions are the low 32 bits of the positions, they can be computed with 32-bit additions
+    const __m128i fraction_step = _mm_set1_epi32(static_cast<int32_t>(step * 4));
+    __m128i fractions = _mm_add_epi32(_mm_set1_epi32(static_cast<int32_t>(position)),
+        _mm_setr_epi32(0, static_cast<int32_t>(step), static_cast<int32_t>(step * 2), static_cast<int32_t>(step * 3)));
+    const __m128 fraction_scale = _mm_set1_ps(1.0f / (1 << 24));
+
+    uint32_t i = 0;
+    for (; i + 4 <= sample_count; i += 4, position += step * 4) {
+        const float *samples0 = src + (position >> 32);
+        const float *samples1 = src + ((position + step) >> 32);
+        const float *samples2 = src + ((position + step * 2) >> 32);
+        const float *samples3 = src + ((position + step * 3) >> 32);
+        const __m128 first = _mm_setr_ps(samples0[0], samples1[0], samples2[0], samples3[0]);
+        const __m128 second = _mm_setr_ps(samples0[1], samples1[1], samples2[1], samples3[1]);
+
+        const __m128 fraction = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(fractions, 8)), fraction_scale);
+        _mm_storeu_ps(dest + i, _mm_add_ps(first, _mm_mul_ps(_mm_sub_ps(second, first), fraction)));
+        fractions = _mm_add_epi32(fractions, fraction_step);
+    }
+
+    interpolate_scalar(dest + i, src, position, step, sample_count - i);
+}
+
+static void resample_stereo_sse2(float *dest, const float *left, const float *right, const float *filter, uint32_t phase_bits,
+    uint64_t position, uint64_t step, uint32_t frame_count) {
+    for (uint32_t i = 0; i < frame_count; i++, position += step) {
+        const FilterPosition filter_position = get_filter_position(filter, phase_bits, position);
+        const __m128 weight = _mm_set1_ps(filter_position.weight);
+        const float *left_frames = left + (position >> 32);
+        const float *right_frames = right + (position >> 32);
+
+        __m128 left_sums = _mm_setzero_ps();
+        __m128 right_sums = _mm_setzero_ps();
+        for (uint32_t tap = 0; tap < resampler_taps; tap += 4) {
+            const __m128 row = _mm_loadu_ps(filter_position.row + tap);
+            const __m128 next_row = _mm_loadu_ps(filter_position.row + resampler_taps + tap);
+            const __m128 coefficients = _mm_add_ps(row, _mm_mul_ps(_mm_sub_ps(next_row, row), weight));
+            left_sums = _mm_add_ps(left_sums, _mm_mul_ps(_mm_loadu_ps(left_frames + tap), coefficients));
+            right_sums = _mm_add_ps(right_sums, _mm_mul_ps(_mm_loadu_ps(right_frames + tap), coefficients));
+        }
+
+        // [L0 + L2, R0 + R2, L1 + L3, R1 + R3] then the two halves added together
+        const __m128 sums = _mm_add_ps(_mm_unpacklo_ps(left_sums, right_sums), _mm_unpackhi_ps(left_sums, right_sums));
+        _mm_storel_pi(reinterpret_cast<__m64 *>(dest + i * 2), _mm_add_ps(sums, _mm_movehl_ps(sums, sums)));
+    }
+}
+
+static inline TARGET_AVX2 __m256 clamp_avx2(__m256 value, __m256 low, __m256 high) {
+    return _mm256_min_ps(high, _mm256_max_ps(low, value));
+}
+
+static TARGET_AVX2 void mix_stereo_avx2(float *dest, const float *src, const float matrix[2][2], int32_t frame_count) {
+    const __m256 from_left = _mm256_setr_ps(matrix[0][0], matrix[0][1], matrix[0][0], matrix[0][1],
+        matrix[0][0], matrix[0][1], matrix[0][0], matrix[0][1]);
+    const __m256 from_right = _mm256_setr_ps(matrix[1][0], matrix[1][1], matrix[1][0], matrix[1][1],
+        matrix[1][0], matrix[1][1], matrix[1][0], matrix[1][1]);
+    const __m256 low = _mm256_set1_ps(-1.0f);
+    const __m256 high = _mm256_set1_ps(1.0f);
+
+    int32_t k = 0;
+    for (; k + 4 <= frame_count; k += 4) {
+        const __m256 samples = _mm256_loadu_ps(src + k * 2);
+        const __m256 left = _mm256_moveldup_ps(samples);
+        const __m256 right = _mm256_movehdup_ps(samples);
+
+        __m256 mixed = _mm256_add_ps(_mm256_loadu_ps(dest + k * 2), _mm256_mul_ps(left, from_left));
+        mixed = _mm256_add_ps(mixed, _mm256_mul_ps(right, from_right));
+        _mm256_storeu_ps(dest + k * 2, clamp_avx2(mixed, low, high));
+    }
+
+    mix_stereo_sse2(dest + k * 2, src + k * 2, matrix, frame_count - k);
+}
+
+static TARGET_AVX2 void mix_mono_avx2(float *dest, const float *src, const float volume[2], int32_t frame_count) {
+    const __m256 volumes = _mm256_setr_ps(volume[0], volume[1], volume[0], volume[1], volume[0], volume[1], volume[0], volume[1]);
+
+    int32_t k = 0;
+    for (; k + 8 <= frame_count; k += 8) {
+        // the unpacks work on each 128-bit lane, [s0, s1, s4, s5] in the low lane gives [s0, s0, s1, s1] first
+        const __m256 samples = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_loadu_ps(src + k)), _MM_SHUFFLE(3, 1, 2, 0)));
+        const __m256 first = _mm256_unpacklo_ps(samples, samples);
+        const __m256 second = _mm256_unpackhi_ps(samples, samples);
+        _mm256_storeu_ps(dest + k * 2, _mm256_add_ps(_mm256_loadu_ps(dest + k * 2), _mm256_mul_ps(first, volumes)));
+        _mm256_storeu_ps(dest + k * 2 + 8, _mm256_add_ps(_mm256_loadu_ps(dest + k * 2 + 8), _mm256_mul_ps(second, volumes)));
+    }
+
+    mix_mono_sse2(dest + k * 2, src + k, volume, frame_count - k);
+}
+
+static TARGET_AVX2 void float_to_s16_avx2(int16_t *dest, const float *src, int32_t sample_count) {
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    const __m256 low = _mm256_set1_ps(-32768.0f);
+    const __m256 high = _mm256_set1_ps(32767.0f);
+
+    int32_t i = 0;
+    for (; i + 16 <= sample_count; i += 16) {
+        const __m256 first = clamp_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), low, high);
+        const __m256 second = clamp_avx2(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), low, high);
+        // the pack works on each 128-bit lane, put the 64-bit halves back in order afterwards
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(first), _mm256_cvttps_epi32(second));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    float_to_s16_sse2(dest + i, src + i, sample_count - i);
+}
+#endif
+
+#ifdef DSP_NEON
+static void mix_stereo_neon(float *dest, const float *src, const float matrix[2][2], int32_t frame_count) {
+    const float32x4_t low = vdupq_n_f32(-1.0f);
+    const float32x4_t high = vdupq_n_f32(1.0f);
+
+    int32_t k = 0;
+    for (; k + 4 <= frame_count; k += 4) {
+        // split the left and right channels
+        const float32x4x2_t samples = vld2q_f32(src + k * 2);
+        float32x4x2_t mixed = vld2q_f32(dest + k * 2);
+
+        mixed.val[0] = vaddq_f32(vaddq_f32(mixed.val[0], vmulq_n_f32(samples.val[0], matrix[0][0])), vmulq_n_f32(samples.val[1], matrix[1][0]));
+        mixed.val[1] = vaddq_f32(vaddq_f32(mixed.val[1], vmulq_n_f32(samples.val[0], matrix[0][1])), vmulq_n_f32(samples.val[1], matrix[1][1]));
+        mixed.val[0] = vminq_f32(vmaxq_f32(mixed.val[0], low), high);
+        mixed.val[1] = vminq_f32(vmaxq_f32(mixed.val[1], low), high);
+        vst2q_f32(dest + k * 2, mixed);
+    }
+
+    mix_stereo_scalar(dest + k * 2, src + k * 2, matrix, frame_count - k);
+}
+
+static void mix_mono_neon(float *dest, const float *src, const float volume[2], int32_t frame_count) {
+    int32_t k = 0;
+    for (; k + 4 <= frame_count; k += 4) {
+        const float32x4_t samples = vld1q_f32(src + k);
+        float32x4x2_t mixed = vld2q_f32(dest + k * 2);
+        mixed.val[0] = vaddq_f32(mixed.val[0], vmulq_n_f32(samples, volume[0]));
+        mixed.val[1] = vaddq_f32(mixed.val[1], vmulq_n_f32(samples, volume[1]));
+        vst2q_f32(dest + k * 2, mixed);
+    }
+
+    mix_mono_scalar(dest + k * 2, src + k, volume, frame_count - k);
+}
+
+static void float_to_s16_neon(int16_t *dest, const float *src, int32_t sample_count) {
+    const float32x4_t low = vdupq_n_f32(-32768.0f);
+    const float32x4_t high = vdupq_n_f32(32767.0f);
+
+    int32_t i = 0;
+    for (; i + 8 <= sample_count; i += 8) {
+        const float32x4_t first = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 32768.0f), low), high);
+        const float32x4_t second = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f), low), high);
+        // the conversion truncates like the cast, the values are already in range for the narrowing
+        vst1q_s16(dest + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(first)), vqmovn_s32(vcvtq_s32_f32(second))));
+    }
+
+    float_to_s16_scalar(dest + i, src + i, sample_count - i);
+}
+
+static void interpolate_neon(float *dest, const float *src, uint64_t position, uint64_t step, uint32_t sample_count) {
+    // the fractions are the low 32 bits of the positions, they can be computed with 32-bit additions
+    const uint32x4_t fraction_step = vdupq_n_u32(static_cast<uint32_t>(step * 4));
+    const uint32_t first_fractions[4] = { static_cast<uint32_t>(position), static_cast<uint32_t>(position + step),
+        static_cast<uint32_t>(position + step * 2), static_cast<uint32_t>(position + step * 3) };
+    uint32x4_t fractions = vld1q_u32(first_fractions);
+
+    uint32_t i = 0;
+    for (; i + 4 <= sample_count; i += 4, position += step * 4) {
+        float first_samples[4];
+        float second_samples[4];
+        for (uint32_t lane = 0; lane < 4; lane++) {
+            const float *samples = src + ((position + step * lane) >> 32);
+            first_samples[lane] = samples[0];
+            second_samples[lane] = samples[1];
+        }
+        const float32x4_t first = vld1q_f32(first_samples);
+        const float32x4_t second = vld1q_f32(second_samples);
+
+        const float32x4_t fraction = vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(vshrq_n_u32(fractions, 8))), 1.0f / (1 << 24));
+        vst1q_f32(dest + i, vaddq_f32(first, vmulq_f32(vsubq_f32(second, first), fraction)));
+        fractions = vaddq_u32(fractions, fraction_step);
+    }
+
+    interpolate_scalar(dest + i, src, position, step, sample_count - i);
+}
+
+static void resample_stereo_neon(float *dest, const float *left, const float *right, const float *filter, uint32_t phase_bits,
+    uint64_t position, uint64_t step, uint32_t frame_count) {
+    for (uint32_t i = 0; i < frame_count; i++, position += step) {
+        const FilterPosition filter_position = get_filter_position(filter, phase_bits, position);
+        const float *left_frames = left + (position >> 32);
+        const float *right_frames = right + (position >> 32);
+
+        float32x4_t left_sums = vdupq_n_f32(0.0f);
+        float32x4_t right_sums = vdupq_n_f32(0.0f);
+        for (uint32_t tap = 0; tap < resampler_taps; tap += 4) {
+            const float32x4_t row = vld1q_f32(filter_position.row + tap);
+            const float32x4_t next_row = vld1q_f32(filter_position.row + resampler_taps + tap);
+            const float32x4_t coefficients = vaddq_f32(row, vmulq_n_f32(vsubq_f32(next_row, row), filter_position.weight));
+            left_sums = vaddq_f32(left_sums, vmulq_f32(vld1q_f32(left_frames + tap), coefficients));
+            right_sums = vaddq_f32(right_sums, vmulq_f32(vld1q_f32(right_frames + tap), coefficients));
+        }
+
+        // [L0 + L2, R0 + R2, L1 + L3, R1 + R3] then the two halves added together
+        const float32x4_t sums = vaddq_f32(vzip1q_f32(left_sums, right_sums), vzip2q_f32(left_sums, right_sums));
+        vst1_f32(dest + i * 2, vadd_f32(vget_low_f32(sums), vget_high_f32(sums)));
+    }
+}
+#endif
+
+struct Functions {
+    Implementation implementation;
+    const char *name;
+    void (*mix_stereo)(float *dest, const float *src, const float matrix[2][2], int32_t frame_count);
+    void (*mix_mono)(float *dest, const float *src, const float volume[2], int32_t frame_count);
+    void (*float_to_s16)(int16_t *dest, const float *src, int32_t sample_count);
+    void (*interpolate)(float *dest, const float *src, uint64_t position, uint64_t step, uint32_t sample_count);
+    void (*resample_stereo)(float *dest, const float *left, const float *right, const float *filter, uint32_t phase_bits,
+        uint64_t position, uint64_t step, uint32_t frame_count);
+};
+
+static constexpr Functions scalar_functions = { Implementation::Scalar, "scalar", mix_stereo_scalar, mix_mono_scalar, float_to_s16_scalar, interpolate_scalar, resample_stereo_scalar };
+#ifdef DSP_X86
+static constexpr Functions sse2_functions = { Implementation::SSE2, "SSE2", mix_stereo_sse2, mix_mono_sse2, float_to_s16_sse2, interpolate_sse2, resample_stereo_sse2 };
+// 16 taps are just 4 SSE vectors, and wider sums wouldn't add the products in the same order
+static constexpr Functions avx2_functions = { Implementation::AVX2, "AVX2", mix_stereo_avx2, mix_mono_avx2, float_to_s16_avx2, interpolate_sse2, resample_stereo_sse2 };
+#endif
+#ifdef DSP_NEON
+static constexpr Functions neon_functions = { Implementation::NEON, "NEON", mix_stereo_neon, mix_mono_neon, float_to_s16_neon, interpolate_neon, resample_stereo_neon };
+#endif
+
+// nullptr if the implementation can't be used on this host
+static const Functions *find_functions(Implementation implementation) {
+    switch (implementation) {
+    case Implementation::Scalar:
+        return &scalar_functions;
+#ifdef DSP_X86
+    case Implementation::SSE2:
+        return &sse2_functions;
+    case Implementation::AVX2:
+        return util::instrset::instrset_detect() >= util::instrset::instrset_AVX2 ? &avx2_functions : nullptr;
+#endif
+#ifdef DSP_NEON
+    case Implementation::NEON:
+        return &neon_functions;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+static std::atomic<const Functions *> &current_functions() {
+    static std::atomic<const Functions *> current = []() {
+        for (const Implementation implementation : { Implementation::AVX2, Implementation::SSE2, Implementation::NEON }) {
+            if (const Functions *functions = find_functions(implementation)) {
+                LOG_INFO("Using the {} implementation of the NGS DSP functions", functions->name);
+                return functions;
+            }
+        }
+        return &scalar_functions;
+    }();
+    return current;
+}
+
+Implementation get_implementation() {
+    return current_functions().load(std::memory_order_relaxed)->implementation;
+}
+
+bool set_implementation(Implementation implementation) {
+    const Functions *functions = find_functions(implementation);
+    if (!functions)
+        return false;
+
+    current_functions().store(functions, std::memory_order_relaxed);
+    return true;
+}
+
+void mix_stereo(float *dest, const float *src, const float matrix[2][2], int32_t frame_count) {
+    current_functions().load(std::memory_order_relaxed)->mix_stereo(dest, src, matrix, frame_count);
+}
+
+void mix_mono(float *dest, const float *src, const float volume[2], int32_t frame_count) {
+    current_functions().load(std::memory_order_relaxed)->mix_mono(dest, src, volume, frame_count);
+}
+
+void float_to_s16(int16_t *dest, const float *src, int32_t sample_count) {
+    current_functions().load(std::memory_order_relaxed)->float_to_s16(dest, src, sample_count);
+}
+
+void interpolate(float *dest, const float *src, uint64_t position, uint64_t step, uint32_t sample_count) {
+    current_functions().load(std::memory_order_relaxed)->interpolate(dest, src, position, step, sample_count);
+}
+
+void resample_stereo(float *dest, const float *left, const float *right, const float *filter, uint32_t phase_bits,
+    uint64_t position, uint64_t step, uint32_t frame_count) {
+    current_functions().load(std::memory_order_relaxed)->resample_stereo(dest, left, right, filter, phase_bits, position, step, frame_count);
+}
+
+} // namespace dsp
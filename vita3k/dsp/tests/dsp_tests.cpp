@@ -0,0 +1,258 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <dsp/dsp.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using dsp::Implementation;
+
+static constexpr Implementation vector_implementations[] = { Implementation::SSE2, Implementation::AVX2, Implementation::NEON };
+
+// includes values going above 1 once mixed, and more than one granule to test the tails of the vector loops
+static std::vector<float> random_samples(std::mt19937 &random, size_t count) {
+    std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+    std::vector<float> samples(count);
+    for (float &sample : samples)
+        sample = distribution(random);
+
+    return samples;
+}
+
+TEST(dsp, mix_stereo_matches_scalar) {
+    const Implementation default_implementation = dsp::get_implementation();
+    std::mt19937 random(42);
+
+    const float matrices[][2][2] = {
+        { { 1.0f, 0.0f }, { 0.0f, 1.0f } },
+        { { 0.7f, 0.3f }, { 0.25f, 0.9f } },
+        { { -0.5f, 1.3f }, { 2.0f, 0.0f } },
+    };
+
+    for (const Implementation implementation : vector_implementations) {
+        if (!dsp::set_implementation(implementation))
+            continue;
+
+        for (const auto &matrix : matrices) {
+            for (int32_t frame_count = 0; frame_count <= 1027; frame_count += (frame_count < 40) ? 1 : 329) {
+                const std::vector<float> src = random_samples(random, frame_count * 2);
+                std::vector<float> expected = random_samples(random, frame_count * 2);
+                std::vector<float> result = expected;
+
+                dsp::set_implementation(Implementation::Scalar);
+                dsp::mix_stereo(expected.data(), src.data(), matrix, frame_count);
+                dsp::set_implementation(implementation);
+                dsp::mix_stereo(result.data(), src.data(), matrix, frame_count);
+
+                ASSERT_EQ(memcmp(expected.data(), result.data(), expected.size() * sizeof(float)), 0)
+                    << "implementation " << static_cast<int>(implementation) << ", " << frame_count << " frames";
+            }
+        }
+    }
+
+    dsp::set_implementation(default_implementation);
+}
+
+TEST(dsp, mix_mono_matches_scalar) {
+    const Implementation default_implementation = dsp::get_implementation();
+    std::mt19937 random(42);
+
+    const float volumes[][2] = { { 1.0f, 1.0f }, { 0.3f, 0.8f }, { -0.5f, 1.7f } };
+
+    for (const Implementation implementation : vector_implementations) {
+        if (!dsp::set_implementation(implementation))
+            continue;
+
+        for (const auto &volume : volumes) {
+            for (int32_t frame_count = 0; frame_count <= 1027; frame_count += (frame_count < 40) ? 1 : 329) {
+                const std::vector<float> src = random_samples(random, frame_count);
+                std::vector<float> expected = random_samples(random, frame_count * 2);
+                std::vector<float> result = expected;
+
+                dsp::set_implementation(Implementation::Scalar);
+                dsp::mix_mono(expected.data(), src.data(), volume, frame_count);
+                dsp::set_implementation(implementation);
+                dsp::mix_mono(result.data(), src.data(), volume, frame_count);
+
+                ASSERT_EQ(memcmp(expected.data(), result.data(), expected.size() * sizeof(float)), 0)
+                    << "implementation " << static_cast<int>(implementation) << ", " << frame_count << " frames";
+            }
+        }
+    }
+
+    dsp::set_implementation(default_implementation);
+}
+
+TEST(dsp, float_to_s16_matches_scalar) {
+    const Implementation default_implementation = dsp::get_implementation();
+    std::mt19937 random(42);
+
+    for (const Implementation implementation : vector_implementations) {
+        if (!dsp::set_implementation(implementation))
+            continue;
+
+        for (int32_t sample_count = 0; sample_count <= 1027; sample_count += (sample_count < 40) ? 1 : 329) {
+            std::vector<float> src = random_samples(random, sample_count);
+            // the values right at the limits and truncated towards 0
+            if (sample_count >= 6) {
+                src[0] = 1.0f;
+                src[1] = -1.0f;
+                src[2] = 32767.0f / 32768.0f;
+                src[3] = -0.99999f;
+                src[4] = 0.5f / 32768.0f;
+                src[5] = -0.5f / 32768.0f;
+            }
+
+            std::vector<int16_t> expected(sample_count);
+            std::vector<int16_t> result(sample_count);
+
+            dsp::set_implementation(Implementation::Scalar);
+            dsp::float_to_s16(expected.data(), src.data(), sample_count);
+            dsp::set_implementation(implementation);
+            dsp::float_to_s16(result.data(), src.data(), sample_count);
+
+            ASSERT_EQ(expected, result) << "implementation " << static_cast<int>(implementation) << ", " << sample_count << " samples";
+        }
+    }
+
+    dsp::set_implementation(default_implementation);
+}
+
+TEST(dsp, interpolate_matches_scalar) {
+    const Implementation default_implementation = dsp::get_implementation();
+    std::mt19937 random(42);
+
+    // the same speed, twice as fast, the lowest speed and a random one
+    const uint64_t steps[] = { 0x100000000, 0x200000000, 0x100000, 0x1234567 };
+
+    for (const Implementation implementation : vector_implementations) {
+        if (!dsp::set_implementation(implementation))
+            continue;
+
+        for (const uint64_t step : steps) {
+            for (uint32_t sample_count = 0; sample_count <= 300; sample_count += (sample_count < 12) ? 1 : 97) {
+                const uint64_t position = 0xC0000000 + step / 3;
+                const std::vector<float> src = random_samples(random, ((position + step * sample_count) >> 32) + 2);
+
+                std::vector<float> expected(sample_count);
+                std::vector<float> result(sample_count);
+
+                dsp::set_implementation(Implementation::Scalar);
+                dsp::interpolate(expected.data(), src.data(), position, step, sample_count);
+                dsp::set_implementation(implementation);
+                dsp::interpolate(result.data(), src.data(), position, step, sample_count);
+
+                ASSERT_EQ(memcmp(expected.data(), result.data(), expected.size() * sizeof(float)), 0)
+                    << "implementation " << static_cast<int>(implementation) << ", step " << step << ", " << sample_count << " samples";
+            }
+        }
+    }
+
+    dsp::set_implementation(default_implementation);
+}
+
+TEST(dsp, resample_stereo_matches_scalar) {
+    const Implementation default_implementation = dsp::get_implementation();
+    std::mt19937 random(42);
+
+    constexpr uint32_t phase_bits = 4;
+    const std::vector<float> filter = random_samples(random, ((1 << phase_bits) + 1) * dsp::resampler_taps);
+    // the ratios between 44.1 kHz, 22.05 kHz and 48 kHz, plus one with a random fraction
+    const uint64_t steps[] = { 0xEB333333, 0x75999999, 0x1B4A3D70A, 0x100000000, 0x1234567 };
+
+    for (const Implementation implementation : vector_implementations) {
+        if (!dsp::set_implementation(implementation))
+            continue;
+
+        for (const uint64_t step : steps) {
+            const uint32_t frame_count = 300;
+            const uint64_t position = 0x8000000 + step / 3;
+            const size_t input_frames = ((position + step * frame_count) >> 32) + dsp::resampler_taps;
+            const std::vector<float> left = random_samples(random, input_frames);
+            const std::vector<float> right = random_samples(random, input_frames);
+
+            std::vector<float> expected(frame_count * 2);
+            std::vector<float> result(frame_count * 2);
+
+            dsp::set_implementation(Implementation::Scalar);
+            dsp::resample_stereo(expected.data(), left.data(), right.data(), filter.data(), phase_bits, position, step, frame_count);
+            dsp::set_implementation(implementation);
+            dsp::resample_stereo(result.data(), left.data(), right.data(), filter.data(), phase_bits, position, step, frame_count);
+
+            ASSERT_EQ(memcmp(expected.data(), result.data(), expected.size() * sizeof(float)), 0)
+                << "implementation " << static_cast<int>(implementation) << ", step " << step;
+        }
+    }
+
+    dsp::set_implementation(default_implementation);
+}
+
+// Run with --gtest_also_run_disabled_tests, prints the time per output sample (a stereo frame is two samples)
+// of each function with every implementation supported by the host
+TEST(dsp, DISABLED_sample_loops_benchmark) {
+    constexpr uint32_t FRAME_COUNT = 1024;
+    constexpr int ITERATIONS = 20000;
+    static const char *implementation_names[] = { "scalar", "SSE2", "AVX2", "NEON" };
+
+    const Implementation default_implementation = dsp::get_implementation();
+    std::mt19937 random(42);
+
+    constexpr uint32_t phase_bits = 4;
+    const std::vector<float> filter = random_samples(random, ((1 << phase_bits) + 1) * dsp::resampler_taps);
+    // 44.1 kHz to 48 kHz
+    const uint64_t step = 0xEB333333;
+    const std::vector<float> src = random_samples(random, FRAME_COUNT * 2 + dsp::resampler_taps);
+    std::vector<float> dest(FRAME_COUNT * 2);
+    std::vector<int16_t> dest_s16(FRAME_COUNT * 2);
+    const float matrix[2][2] = { { 0.8f, 0.1f }, { 0.2f, 0.7f } };
+    const float volume[2] = { 0.6f, 0.4f };
+
+    auto measure = [&](const char *name, Implementation implementation, uint32_t sample_count, auto &&func) {
+        const auto start_time = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            func();
+            // the mixing functions accumulate, keep the samples in range
+            if ((i & 63) == 0)
+                std::fill(dest.begin(), dest.end(), 0.0f);
+        }
+        const double duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << name << " (" << implementation_names[static_cast<int>(implementation)] << "): "
+                  << duration / (static_cast<double>(sample_count) * ITERATIONS) << " ns per sample" << std::endl;
+    };
+
+    for (const Implementation implementation : { Implementation::Scalar, Implementation::SSE2, Implementation::AVX2, Implementation::NEON }) {
+        if (!dsp::set_implementation(implementation))
+            continue;
+
+        measure("mix_stereo", implementation, FRAME_COUNT * 2, [&] { dsp::mix_stereo(dest.data(), src.data(), matrix, FRAME_COUNT); });
+        measure("mix_mono", implementation, FRAME_COUNT * 2, [&] { dsp::mix_mono(dest.data(), src.data(), volume, FRAME_COUNT); });
+        measure("float_to_s16", implementation, FRAME_COUNT * 2, [&] { dsp::float_to_s16(dest_s16.data(), src.data(), FRAME_COUNT * 2); });
+        measure("interpolate", implementation, FRAME_COUNT, [&] { dsp::interpolate(dest.data(), src.data(), 0, step, FRAME_COUNT); });
+        measure("resample_stereo", implementation, FRAME_COUNT * 2, [&] {
+            dsp::resample_stereo(dest.data(), src.data(), src.data() + FRAME_COUNT, filter.data(), phase_bits, 0, step, FRAME_COUNT);
+        });
+    }
+
+    dsp::set_implementation(default_implementation);
+}
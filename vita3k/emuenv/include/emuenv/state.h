@@ -43,6 +43,10 @@ namespace ngs {
 struct State;
 };
 
+namespace sas {
+struct State;
+};
+
 struct Config;
 struct CompatState;
 struct MemState;
@@ -104,6 +108,7 @@ private:
     std::unique_ptr<NetCtlState> _netctl;
     std::unique_ptr<ngs::State> _ngs;
     std::unique_ptr<NpState> _np;
+    std::unique_ptr<sas::State> _sas;
     std::unique_ptr<DisplayState> _display;
     std::unique_ptr<DialogState> _common_dialog;
     std::unique_ptr<Ime> _ime;
@@ -161,6 +166,7 @@ public:
     NetCtlState &netctl;
     ngs::State &ngs;
     NpState &np;
+    sas::State &sas;
     DisplayState &display;
     DialogState &common_dialog;
     Ime &ime;
@@ -41,6 +41,7 @@
 #include <regmgr/state.h>
 #include <renderer/functions.h>
 #include <renderer/state.h>
+#include <sas/state.h>
 #include <touch/state.h>
 
 #include <gdbstub/state.h>
@@ -81,6 +82,8 @@ EmuEnvState::EmuEnvState()
     , ngs(*_ngs)
     , _np(new NpState)
     , np(*_np)
+    , _sas(new sas::State)
+    , sas(*_sas)
     , _display(new DisplayState)
     , display(*_display)
     , _common_dialog(new DialogState)
@@ -48,6 +48,7 @@ public:
     bool init(renderer::Generator *generator, renderer::Deleter *deleter) {
         assert(generator != nullptr);
         assert(deleter != nullptr);
+        this->generator = generator;
         this->deleter = deleter;
         generator(static_cast<GLsizei>(names.size()), &names[0]);
 
@@ -64,6 +65,14 @@ public:
         return names.size();
     }
 
+    // replace the object at this index with a new one, freeing what the previous one was using
+    void reset(size_t i) {
+        assert(i < names.size());
+        assert(deleter != nullptr);
+        deleter(1, &names[i]);
+        generator(1, &names[i]);
+    }
+
     void cleanup() {
         if (deleter) {
             deleter(static_cast<GLsizei>(names.size()), &names[0]);
@@ -76,5 +85,6 @@ private:
     typedef std::array<GLuint, Size> Names;
 
     Names names;
+    renderer::Generator *generator = nullptr;
     renderer::Deleter *deleter = nullptr;
 };
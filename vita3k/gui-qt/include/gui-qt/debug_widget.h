@@ -28,6 +28,7 @@ class QLineEdit;
 class QComboBox;
 class QPlainTextEdit;
 class QSpinBox;
+class QPushButton;
 
 struct EmuEnvState;
 
@@ -49,6 +50,7 @@ public:
         EventFlags,
         Allocations,
         Disassembly,
+        ImportProfiler,
         TabCount
     };
 
@@ -68,6 +70,7 @@ private:
     void refresh_semaphores();
     void refresh_event_flags();
     void refresh_allocations();
+    void refresh_import_profiler();
 
     void on_disassembly_evaluate();
     void on_thread_double_clicked(QTreeWidgetItem *item, int column);
@@ -89,4 +92,7 @@ private:
     QLineEdit *m_disasm_address = nullptr;
     QSpinBox *m_disasm_count = nullptr;
     QComboBox *m_disasm_arch = nullptr;
+    QWidget *m_import_profiler_tab = nullptr;
+    QTreeWidget *m_import_profiler_tree = nullptr;
+    QPushButton *m_import_profiler_toggle = nullptr;
 };
@@ -19,6 +19,7 @@
 
 #include <cpu/functions.h>
 #include <emuenv/state.h>
+#include <io/state.h>
 #include <kernel/state.h>
 #include <kernel/thread/thread_state.h>
 #include <mem/functions.h>
@@ -34,6 +35,7 @@
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QPlainTextEdit>
+#include <QPushButton>
 #include <QSpinBox>
 #include <QTabWidget>
 #include <QTreeWidget>
@@ -153,6 +155,45 @@ void DebugWidget::setup_ui() {
 
     m_tabs->addTab(m_disasm_tab, tr("Disassembly"));
 
+    m_import_profiler_tab = new QWidget(m_tabs);
+    auto *import_profiler_layout = new QVBoxLayout(m_import_profiler_tab);
+    import_profiler_layout->setContentsMargins(4, 4, 4, 4);
+
+    auto *import_profiler_controls = new QHBoxLayout();
+    m_import_profiler_toggle = new QPushButton(m_import_profiler_tab);
+    auto *import_profiler_reset = new QPushButton(tr("Reset"), m_import_profiler_tab);
+    auto *import_profiler_dump = new QPushButton(tr("Dump to Log Folder"), m_import_profiler_tab);
+    import_profiler_controls->addWidget(m_import_profiler_toggle);
+    import_profiler_controls->addWidget(import_profiler_reset);
+    import_profiler_controls->addWidget(import_profiler_dump);
+    import_profiler_controls->addStretch();
+    import_profiler_layout->addLayout(import_profiler_controls);
+
+    m_import_profiler_tree = create_tree({ tr("NID"), tr("Name"), tr("Calls"), tr("Total (ms)"), tr("Average (us)"), tr("P99 (us)") });
+    m_import_profiler_tree->setColumnWidth(0, 100);
+    m_import_profiler_tree->setColumnWidth(1, 280);
+    import_profiler_layout->addWidget(m_import_profiler_tree);
+
+    auto update_import_profiler_toggle = [this] {
+        m_import_profiler_toggle->setText(emuenv.kernel.import_profiler.is_enabled() ? tr("Stop Profiling") : tr("Start Profiling"));
+    };
+    update_import_profiler_toggle();
+    connect(m_import_profiler_toggle, &QPushButton::clicked, this, [this, update_import_profiler_toggle] {
+        emuenv.kernel.import_profiler.set_enabled(!emuenv.kernel.import_profiler.is_enabled());
+        update_import_profiler_toggle();
+    });
+    connect(import_profiler_reset, &QPushButton::clicked, this, [this] {
+        emuenv.kernel.import_profiler.reset();
+        refresh_import_profiler();
+    });
+    connect(import_profiler_dump, &QPushButton::clicked, this, [this] {
+        const fs::path profile_path = emuenv.log_path / "import_profile" / (emuenv.io.title_id.empty() ? "import_profile" : emuenv.io.title_id);
+        emuenv.kernel.import_profiler.dump_csv(fs::path(profile_path).replace_extension(".csv"));
+        emuenv.kernel.import_profiler.dump_json(fs::path(profile_path).replace_extension(".json"));
+    });
+
+    m_tabs->addTab(m_import_profiler_tab, tr("Import Profiler"));
+
     connect(m_tabs, &QTabWidget::currentChanged, this, [this](int) {
         refresh_current_tab();
     });
@@ -207,6 +248,9 @@ void DebugWidget::refresh_current_tab() {
         break;
     case Tab::Disassembly:
         break;
+    case Tab::ImportProfiler:
+        refresh_import_profiler();
+        break;
     }
 }
 
@@ -355,6 +399,20 @@ void DebugWidget::refresh_allocations() {
     }
 }
 
+void DebugWidget::refresh_import_profiler() {
+    m_import_profiler_tree->clear();
+
+    for (const auto &entry : emuenv.kernel.import_profiler.get_imports()) {
+        auto *item = new QTreeWidgetItem(m_import_profiler_tree);
+        item->setText(0, QStringLiteral("0x%1").arg(entry.nid, 8, 16, QLatin1Char('0')).toUpper());
+        item->setText(1, QString::fromStdString(entry.name));
+        item->setData(2, Qt::DisplayRole, QVariant::fromValue<qulonglong>(entry.count));
+        item->setData(3, Qt::DisplayRole, entry.total_ns / 1e6);
+        item->setData(4, Qt::DisplayRole, entry.total_ns / 1e3 / entry.count);
+        item->setData(5, Qt::DisplayRole, entry.p99_ns / 1e3);
+    }
+}
+
 void DebugWidget::on_thread_double_clicked(QTreeWidgetItem *item, int /*column*/) {
     if (!item)
         return;
@@ -367,11 +425,24 @@ void DebugWidget::on_thread_double_clicked(QTreeWidgetItem *item, int /*column*/
         return;
     }
 
-    CPUState &cpu = *thread->cpu;
+    // the cpu is taken away from the thread once it exits, so everything shown is read at once
+    std::unique_lock<std::mutex> thread_lock(thread->mutex);
+    if (!thread->cpu) {
+        thread_lock.unlock();
+        QMessageBox::warning(this, tr("Thread Not Found"),
+            tr("Thread 0x%1 no longer exists.").arg(thread_id, 8, 16, QLatin1Char('0')));
+        return;
+    }
 
+    CPUState &cpu = *thread->cpu;
     const uint32_t pc = read_pc(cpu);
     const uint32_t sp = read_sp(cpu);
     const uint32_t lr = read_lr(cpu);
+    std::array<uint32_t, 13> registers;
+    for (int i = 0; i < 13; i++)
+        registers[i] = read_reg(cpu, i);
+    const std::string executing = disassemble(cpu, pc);
+    thread_lock.unlock();
 
     auto *dlg = new QDialog(this);
     dlg->setWindowTitle(tr("Thread: %1 (0x%2)")
@@ -394,7 +465,7 @@ void DebugWidget::on_thread_double_clicked(QTreeWidgetItem *item, int /*column*/
     form->addRow(tr("PC:"), new QLabel(make_hex(pc), dlg));
     form->addRow(tr("SP:"), new QLabel(make_hex(sp), dlg));
     form->addRow(tr("LR:"), new QLabel(make_hex(lr), dlg));
-    form->addRow(tr("Executing:"), new QLabel(QString::fromStdString(disassemble(cpu, pc)), dlg));
+    form->addRow(tr("Executing:"), new QLabel(QString::fromStdString(executing), dlg));
 
     layout->addLayout(form);
 
@@ -411,7 +482,7 @@ void DebugWidget::on_thread_double_clicked(QTreeWidgetItem *item, int /*column*/
     for (int i = 0; i < 13; i++) {
         auto *row = new QTreeWidgetItem(reg_tree);
         row->setText(0, QStringLiteral("r%1").arg(i));
-        row->setText(1, make_hex(read_reg(cpu, i)));
+        row->setText(1, make_hex(registers[i]));
     }
     {
         auto *row = new QTreeWidgetItem(reg_tree);
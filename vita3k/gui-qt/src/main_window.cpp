@@ -467,6 +467,7 @@ void MainWindow::initialize() {
     connect(m_ui->debug_event_flags_action, &QAction::triggered, this, [this] { open_debug_widget(DebugWidget::EventFlags); });
     connect(m_ui->debug_allocations_action, &QAction::triggered, this, [this] { open_debug_widget(DebugWidget::Allocations); });
     connect(m_ui->debug_disassembly_action, &QAction::triggered, this, [this] { open_debug_widget(DebugWidget::Disassembly); });
+    connect(m_ui->debug_import_profiler_action, &QAction::triggered, this, [this] { open_debug_widget(DebugWidget::ImportProfiler); });
 
     connect(m_ui->pause_action, &QAction::triggered,
         this, &MainWindow::on_toolbar_start);
@@ -56,6 +56,7 @@
 
 #include "patch/patch.h"
 
+#include <algorithm>
 #include <memory>
 #include <regex>
 
@@ -422,16 +423,21 @@ static void do_patches(MemState &mem, const Patches &patches, const SceKernelMod
 }
 
 static ExitCode load_app_impl(SceUID &main_module_id, EmuEnvState &emuenv, const AppLaunchRequest &launch_request) {
-    const auto call_import = [&emuenv](CPUState &cpu, uint32_t nid, SceUID thread_id) {
-        ::call_import(emuenv, cpu, nid, thread_id);
+    const auto call_import = [&emuenv](CPUState &cpu, uint32_t svc, uint32_t nid, SceUID thread_id) {
+        ::call_import(emuenv, cpu, svc, nid, thread_id);
+    };
+    const auto call_import_fast = [&emuenv](CPUState &cpu, uint32_t svc, SceUID thread_id) {
+        return ::call_import_fast(emuenv, cpu, svc, thread_id);
     };
     emuenv.kernel.process_exit_callback = [&emuenv](int res, std::optional<AppLaunchRequest> relaunch) {
         emuenv.post_app_launch_request(relaunch.value_or(AppLaunchRequest{ .reason = AppLaunchReason::ProcessExit }));
     };
-    if (!emuenv.kernel.init(emuenv.mem, call_import, emuenv.cfg.current_config.cpu_opt)) {
+    if (!emuenv.kernel.init(emuenv.mem, call_import, call_import_fast, emuenv.cfg.current_config.cpu_opt)) {
         LOG_WARN("Failed to init kernel!");
         return KernelInitFailed;
     }
+    emuenv.kernel.cpu_pool.set_max_size(std::max(emuenv.cfg.cpu_pool_size, 0));
+    emuenv.kernel.host_thread_policy.init(emuenv.cfg.thread_pinning, emuenv.cfg.thread_pinning_cores, emuenv.cfg.thread_priorities);
 
     if (emuenv.cfg.archive_log) {
         const fs::path log_directory{ emuenv.log_path / "logs" };
@@ -442,7 +448,10 @@ static ExitCode load_app_impl(SceUID &main_module_id, EmuEnvState &emuenv, const
         logging::set_level(static_cast<spdlog::level::level_enum>(emuenv.cfg.log_level));
     }
 
+    emuenv.kernel.jit_profile.init(emuenv.cache_path / "jit" / emuenv.io.title_id / "jit-profile.dat", emuenv.cfg.current_config.jit_warm_up);
+
     LOG_INFO("CPU Optimisation state: {}", emuenv.cfg.current_config.cpu_opt);
+    LOG_INFO("JIT warm-up state: {}", emuenv.cfg.current_config.jit_warm_up);
     LOG_INFO("ngs state: {}", emuenv.cfg.current_config.ngs_enable);
     LOG_INFO("Resolution multiplier: {}", emuenv.cfg.resolution_multiplier);
 
@@ -683,7 +692,7 @@ ExitCode run_app(EmuEnvState &emuenv, int32_t main_module_id, const AppLaunchReq
     }
     emuenv.main_thread_id = main_thread->id;
 
-    // Run `module_start` export (entry point) of loaded libraries
+    // Run `module_start` export (entry point) of loaded libraries, meanwhile the main thread warms up its JIT
     for (auto &[_, module] : emuenv.kernel.loaded_modules) {
         if (module->info.modid != main_module_id)
             start_module(emuenv, module->info);
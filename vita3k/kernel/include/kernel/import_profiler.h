@@ -0,0 +1,96 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+#include <util/types.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct KernelState;
+
+struct ImportCallStats {
+    // 4 buckets per power of two, which puts the percentiles within 25% of the real value
+    static constexpr size_t BUCKET_COUNT = 164;
+
+    std::atomic<uint64_t> count = 0;
+    std::atomic<uint64_t> total_ns = 0;
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> histogram{};
+
+    void add(uint64_t duration_ns);
+    void reset();
+    // Upper bound of the duration under which the given fraction of the calls completed
+    uint64_t percentile(double fraction) const;
+};
+
+struct ImportProfileEntry {
+    uint32_t nid;
+    SceUID thread_id;
+    std::string name;
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t p99_ns;
+};
+
+typedef std::vector<ImportProfileEntry> ImportProfileEntries;
+
+/**
+ * @brief Counts the HLE import calls and the host time they take, per NID and per guest thread
+ *
+ * Disabled by default. While disabled, the only cost on an import call is the check of the enabled flag.
+ */
+struct ImportProfiler {
+    ImportProfiler() = delete;
+    explicit ImportProfiler(KernelState &kernel);
+
+    bool is_enabled() const { return enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool enable);
+    void reset();
+
+    void record(uint32_t svc, uint32_t nid, SceUID thread_id, uint64_t duration_ns);
+
+    // Sorted by decreasing total time
+    ImportProfileEntries get_imports();
+    ImportProfileEntries get_threads();
+
+    bool dump_csv(const fs::path &path);
+    bool dump_json(const fs::path &path);
+
+private:
+    ImportCallStats &get_import_stats(uint32_t index);
+    ImportCallStats &get_thread_stats(SceUID thread_id);
+
+    std::atomic<bool> enabled = false;
+    // bumped by reset, invalidates the stats cached by each host thread
+    std::atomic<uint32_t> generation = 0;
+    KernelState &parent;
+
+    // indexed by import_index, 0 being used for the unknown NIDs, each entry is allocated on its first call
+    std::unique_ptr<std::atomic<ImportCallStats *>[]> imports;
+    std::vector<std::unique_ptr<ImportCallStats>> allocated_imports;
+
+    std::mutex mutex;
+    std::map<SceUID, std::unique_ptr<ImportCallStats>> threads;
+    std::map<SceUID, std::string> thread_names;
+};
@@ -0,0 +1,79 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cpu/common.h>
+#include <mem/util.h>
+#include <util/fs.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+
+struct CPUState;
+
+struct JitProfileBlock {
+    // offset of the block from the start of its code segment
+    uint32_t offset;
+    bool thumb;
+    uint32_t fpscr;
+
+    auto operator<=>(const JitProfileBlock &) const = default;
+};
+
+struct JitProfileSegment {
+    uint64_t hash;
+    uint32_t size;
+};
+
+typedef std::set<JitProfileBlock> JitProfileBlocks;
+
+/**
+ * @brief Persistent list of the guest blocks translated by the JIT
+ *
+ * Blocks are stored relative to the executable segment they belong to, segments being identified
+ * by the hash of their content so the profile stays valid when a relocatable module is loaded at another address.
+ * On the next boot, the recorded blocks of every loaded segment can be translated before the guest starts running.
+ */
+struct JitProfile {
+    // Load the profile saved at path, a profile that is not enabled records nothing
+    void init(const fs::path &path, bool enabled);
+    // Save the profile if anything new was recorded and clear it
+    void deinit();
+    bool is_enabled() const { return enabled; }
+
+    void add_code_segment(Address start, uint32_t size, uint64_t hash);
+    void remove_code_segment(Address start);
+
+    void record_block(const JitBlockInfo &block);
+    // Translate all the known blocks of the currently loaded segments using the given cpu,
+    // jit_mutex is held while translating so the code can't be invalidated at the same time
+    void warm_up(CPUState &cpu, std::mutex &jit_mutex);
+
+private:
+    bool load();
+    bool save();
+
+    std::mutex mutex;
+    bool enabled = false;
+    bool dirty = false;
+    fs::path path;
+
+    std::map<Address, JitProfileSegment, std::greater<>> code_segments;
+    std::map<uint64_t, JitProfileBlocks> blocks;
+};
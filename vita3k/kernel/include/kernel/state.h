@@ -20,8 +20,11 @@
 #include <cpu/common.h>
 #include <kernel/callback.h>
 #include <kernel/debugger.h>
+#include <kernel/import_profiler.h>
+#include <kernel/jit_profile.h>
 #include <kernel/object_store.h>
 #include <kernel/sync_primitives.h>
+#include <kernel/thread/host_thread_policy.h>
 #include <kernel/types.h>
 #include <mem/allocator.h>
 #include <mem/block.h>
@@ -62,7 +65,8 @@ typedef std::map<SceUID, CallbackPtr> CallbackPtrs;
 typedef unordered_map_fast<uint32_t, Address> ExportNids;
 
 typedef std::map<Address, uint32_t> NotFoundVars;
-typedef std::function<void(CPUState &cpu, uint32_t nid, SceUID thread_id)> CallImportFunc;
+typedef std::function<void(CPUState &cpu, uint32_t svc, uint32_t nid, SceUID thread_id)> CallImportFunc;
+typedef std::function<bool(CPUState &cpu, uint32_t svc, SceUID thread_id)> CallImportFastFunc;
 
 struct CodecEngineBlock {
     uint32_t size;
@@ -82,6 +86,23 @@ struct CorenumAllocator {
     void free_corenum(const int num);
 };
 
+// The code translated by a JIT can't be shared with threads running at the same time, so instead of
+// being destroyed, the cpu of exited threads is kept and given to the next created threads
+struct CPUPool {
+    std::vector<CPUStatePtr> cpus;
+    std::size_t max_size = 0;
+    std::mutex lock;
+
+    void set_max_size(const std::size_t max);
+
+    // Returns a reset cpu keeping its translated code and core number, or nullptr if the pool is empty
+    CPUStatePtr acquire();
+    // Returns false if the pool is full, in which case the cpu is left untouched
+    bool release(CPUStatePtr &cpu);
+    void invalidate_jit_cache(Address start, size_t length);
+    void clear();
+};
+
 struct VarBindingInfo {
     void *entries;
     uint32_t size;
@@ -137,7 +158,11 @@ struct KernelState {
 
     bool cpu_opt;
     CorenumAllocator corenum_allocator;
+    CPUPool cpu_pool;
+    HostThreadPolicy host_thread_policy;
     CallImportFunc call_import;
+    // Handles the imports that can be called without stopping the JIT, returns false for the others
+    CallImportFastFunc call_import_fast;
 
     // Shared NOP+WFI sentinel used by the Dynarmic as the halt return address
     Block halt_instruction;
@@ -153,6 +178,10 @@ struct KernelState {
     Ptr<void> libc_dso_handle_main = Ptr<void>(0);
 
     Debugger debugger;
+    JitProfile jit_profile;
+    // the JIT of a thread is warmed up on its own host thread while others can invalidate its code
+    std::mutex jit_mutex;
+    ImportProfiler import_profiler;
 
     // kubridge exception handlers (DABT=0, PABT=1, UNDEF=2)
     static constexpr int EXCEPTION_HANDLER_MAX = 3;
@@ -163,7 +192,7 @@ struct KernelState {
         return next_uid++;
     }
 
-    bool init(MemState &mem, const CallImportFunc &call_import, bool cpu_opt);
+    bool init(MemState &mem, const CallImportFunc &call_import, const CallImportFastFunc &call_import_fast, bool cpu_opt);
     void deinit(MemState &mem);
     void load_process_param(MemState &mem, Ptr<uint32_t> ptr);
     ThreadStatePtr create_thread(MemState &mem, const char *name, Ptr<const void> entry_point = Ptr<const void>(0));
@@ -128,6 +128,8 @@ struct Mutex : SyncPrimitive {
     ThreadStatePtr owner;
     WaitingThreadQueuePtr waiting_threads;
     Ptr<SceKernelLwMutexWork> workarea;
+    // set once removed from the kernel, a lightweight mutex can still be cached by the threads which used it
+    bool deleted = false;
 };
 
 typedef std::shared_ptr<Mutex> MutexPtr;
@@ -226,9 +228,13 @@ SceUID mutex_create(SceUID *uid_out, KernelState &kernel, MemState &mem, const c
 SceUID mutex_find(KernelState &kernel, const char *export_name, const char *pName);
 int mutex_lock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int lock_count, unsigned int *timeout, SyncWeight weight);
 int mutex_try_lock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int lock_count, SyncWeight weight);
-int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight);
+int mutex_unlock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight);
 int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight);
 MutexPtr mutex_get(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight);
+// Uncontended lock and unlock of a lightweight mutex, without any lookup under the kernel mutex.
+// They return false when the call has to go through mutex_lock or mutex_unlock (contention, waiting threads, errors).
+bool lw_mutex_lock_fast(KernelState &kernel, MemState &mem, SceUID thread_id, Ptr<SceKernelLwMutexWork> workarea, int lock_count);
+bool lw_mutex_unlock_fast(KernelState &kernel, MemState &mem, SceUID thread_id, Ptr<SceKernelLwMutexWork> workarea, int unlock_count);
 
 // RWLock
 SceUID rwlock_create(KernelState &kernel, MemState &mem, const char *export_name, const char *name, SceUID thread_id, SceUInt32 attr);
@@ -0,0 +1,48 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <array>
+#include <string>
+
+struct ThreadState;
+
+/**
+ * @brief Maps the affinity and priority of the guest threads to the host threads running them
+ *
+ * Each guest core is bound to a host core, a guest thread is then pinned to the host cores of all
+ * the guest cores in its affinity mask. Priorities are mapped to three host levels around the default game priority.
+ */
+struct HostThreadPolicy {
+    static constexpr size_t GUEST_CORE_COUNT = 4;
+
+    // host_cores is a comma-separated list of host cores, one per guest core, the list wraps around if it is shorter.
+    // If it is empty, the guest cores are spread over the host cores, leaving the first one to the host when possible.
+    void init(bool pin_threads, const std::string &host_cores, bool map_priorities);
+    bool is_enabled() const { return pin_threads || map_priorities; }
+
+    // Must be called from the host thread running the guest thread
+    void apply(const ThreadState &thread) const;
+
+private:
+    bool pin_threads = false;
+    bool map_priorities = false;
+    std::array<int, GUEST_CORE_COUNT> guest_core_to_host{};
+    // lowest nice value the host threads can set (Linux only), given by RLIMIT_NICE without CAP_SYS_NICE
+    int min_host_nice = 0;
+};
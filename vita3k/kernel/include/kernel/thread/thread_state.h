@@ -23,6 +23,7 @@
 #include <mem/block.h>
 #include <mem/ptr.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
@@ -70,11 +71,16 @@ struct ThreadState {
 
     int priority;
     SceInt32 affinity_mask;
+    // set when the priority or affinity changed, the host thread then updates its own scheduling before running again
+    std::atomic<bool> host_policy_changed = true;
     uint64_t start_tick;
     uint64_t last_vblank_waited;
     // set to true if thread is processing kernel callbacks
     bool is_processing_callbacks = false;
+    // set if the cpu was created for this thread, a cpu from the pool already holds the code it translated
+    bool needs_jit_warm_up = false;
 
+    // null once the thread has exited, other threads must check it with mutex held
     CPUStatePtr cpu;
     ThreadStatus status = ThreadStatus::dormant;
 
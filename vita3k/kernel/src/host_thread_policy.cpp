@@ -0,0 +1,147 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/thread/host_thread_policy.h>
+
+#include <kernel/thread/thread_state.h>
+#include <kernel/types.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// guest core i is bit (16 + i) of an affinity mask
+constexpr int GUEST_CORE_MASK_SHIFT = 16;
+
+enum class HostThreadPriority {
+    High,
+    Normal,
+    Low,
+};
+
+static HostThreadPriority get_host_priority(int priority) {
+    // lower values are higher priorities
+    if (priority < SCE_KERNEL_GAME_DEFAULT_PRIORITY_ACTUAL - 32)
+        return HostThreadPriority::High;
+    if (priority > SCE_KERNEL_GAME_DEFAULT_PRIORITY_ACTUAL)
+        return HostThreadPriority::Low;
+    return HostThreadPriority::Normal;
+}
+
+void HostThreadPolicy::init(bool pin_threads, const std::string &host_cores, bool map_priorities) {
+    this->pin_threads = pin_threads;
+    this->map_priorities = map_priorities;
+
+    const int host_core_count = std::max<int>(std::thread::hardware_concurrency(), 1);
+    std::vector<int> cores;
+    for (size_t pos = 0; pos < host_cores.size();) {
+        const size_t end = std::min(host_cores.find(',', pos), host_cores.size());
+        int core = 0;
+        const auto [ptr, ec] = std::from_chars(host_cores.data() + pos, host_cores.data() + end, core);
+        if (ec == std::errc() && core >= 0 && core < host_core_count)
+            cores.push_back(core);
+        else
+            LOG_WARN("Ignoring invalid host core {} for the thread pinning", host_cores.substr(pos, end - pos));
+        pos = end + 1;
+    }
+
+    if (cores.empty()) {
+        // keep the first host core for the host threads (audio, input, ...) when there are enough of them
+        const int first_core = host_core_count > static_cast<int>(GUEST_CORE_COUNT) ? 1 : 0;
+        for (size_t i = 0; i < GUEST_CORE_COUNT; i++)
+            cores.push_back((first_core + static_cast<int>(i)) % host_core_count);
+    }
+
+    for (size_t i = 0; i < GUEST_CORE_COUNT; i++)
+        guest_core_to_host[i] = cores[i % cores.size()];
+
+    if (pin_threads)
+        LOG_INFO("Pinning the guest cores to the host cores {}, {}, {}, {}", guest_core_to_host[0], guest_core_to_host[1], guest_core_to_host[2], guest_core_to_host[3]);
+
+#ifdef __linux__
+    // without CAP_SYS_NICE, a thread can't set a nice value lower than 20 - RLIMIT_NICE, even to undo a previous raise
+    min_host_nice = 0;
+    rlimit nice_limit{};
+    if (geteuid() == 0)
+        min_host_nice = -20;
+    else if (getrlimit(RLIMIT_NICE, &nice_limit) == 0)
+        min_host_nice = nice_limit.rlim_cur == RLIM_INFINITY ? -20 : 20 - static_cast<int>(std::min<rlim_t>(nice_limit.rlim_cur, 40));
+
+    if (map_priorities && min_host_nice > 0)
+        LOG_WARN("The nice value of the threads can't be lowered back (RLIMIT_NICE is {}), the guest priorities are not mapped", 20 - min_host_nice);
+#endif
+}
+
+void HostThreadPolicy::apply(const ThreadState &thread) const {
+    if (pin_threads) {
+        const int affinity_mask = thread.affinity_mask == SCE_KERNEL_THREAD_CPU_AFFINITY_MASK_DEFAULT ? SCE_KERNEL_CPU_MASK_USER_ALL : thread.affinity_mask;
+
+#ifdef _WIN32
+        DWORD_PTR host_mask = 0;
+        for (size_t i = 0; i < GUEST_CORE_COUNT; i++) {
+            // a host core outside of the current processor group can't be set in the mask
+            if ((affinity_mask & (1 << (GUEST_CORE_MASK_SHIFT + i))) && guest_core_to_host[i] < static_cast<int>(sizeof(DWORD_PTR) * 8))
+                host_mask |= DWORD_PTR(1) << guest_core_to_host[i];
+        }
+        if (host_mask && !SetThreadAffinityMask(GetCurrentThread(), host_mask))
+            LOG_WARN("Failed to set the affinity of thread {}", thread.name);
+#elif defined(__linux__)
+        cpu_set_t host_set;
+        CPU_ZERO(&host_set);
+        for (size_t i = 0; i < GUEST_CORE_COUNT; i++) {
+            if ((affinity_mask & (1 << (GUEST_CORE_MASK_SHIFT + i))) && guest_core_to_host[i] < CPU_SETSIZE)
+                CPU_SET(guest_core_to_host[i], &host_set);
+        }
+        if (CPU_COUNT(&host_set) > 0 && sched_setaffinity(0, sizeof(host_set), &host_set) != 0)
+            LOG_WARN("Failed to set the affinity of thread {}", thread.name);
+#endif
+    }
+
+    if (map_priorities) {
+        const HostThreadPriority host_priority = get_host_priority(thread.priority);
+
+#ifdef _WIN32
+        const int win_priority = host_priority == HostThreadPriority::High ? THREAD_PRIORITY_ABOVE_NORMAL : (host_priority == HostThreadPriority::Low ? THREAD_PRIORITY_BELOW_NORMAL : THREAD_PRIORITY_NORMAL);
+        if (!SetThreadPriority(GetCurrentThread(), win_priority))
+            LOG_WARN("Failed to set the priority of thread {}", thread.name);
+#elif defined(__linux__)
+        // on Linux the nice value is per thread, it is only raised if the thread can get back to the normal one later
+        int nice_value = host_priority == HostThreadPriority::High ? -4 : (host_priority == HostThreadPriority::Low ? 4 : 0);
+        if (min_host_nice > 0)
+            nice_value = 0;
+        nice_value = std::max(nice_value, std::min(min_host_nice, 0));
+
+        const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, tid, nice_value) != 0)
+            LOG_WARN("Failed to set the nice value of thread {} to {}: {}", thread.name, nice_value, strerror(errno));
+#endif
+    }
+}
@@ -0,0 +1,263 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/import_profiler.h>
+
+#include <kernel/state.h>
+#include <kernel/thread/thread_state.h>
+#include <nids/functions.h>
+#include <util/log.h>
+#include <util/string_utils.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+static size_t duration_to_bucket(uint64_t duration_ns) {
+    if (duration_ns < 4)
+        return duration_ns;
+
+    // the two bits following the most significant one select the bucket inside the power of two
+    const size_t msb = std::bit_width(duration_ns) - 1;
+    const size_t bucket = (msb - 1) * 4 + ((duration_ns >> (msb - 2)) & 3);
+    return std::min(bucket, ImportCallStats::BUCKET_COUNT - 1);
+}
+
+static uint64_t bucket_upper_bound(size_t bucket) {
+    if (bucket < 4)
+        return bucket;
+
+    const size_t msb = bucket / 4 + 1;
+    const uint64_t lower_bound = (4 + bucket % 4) << (msb - 2);
+    return lower_bound + (uint64_t(1) << (msb - 2)) - 1;
+}
+
+void ImportCallStats::add(uint64_t duration_ns) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+    histogram[duration_to_bucket(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ImportCallStats::reset() {
+    count = 0;
+    total_ns = 0;
+    for (auto &bucket : histogram)
+        bucket = 0;
+}
+
+uint64_t ImportCallStats::percentile(double fraction) const {
+    uint64_t nb_calls = 0;
+    for (const auto &bucket : histogram)
+        nb_calls += bucket.load(std::memory_order_relaxed);
+    if (nb_calls == 0)
+        return 0;
+
+    const uint64_t target = static_cast<uint64_t>(std::ceil(nb_calls * fraction));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += histogram[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return bucket_upper_bound(i);
+    }
+
+    return bucket_upper_bound(BUCKET_COUNT - 1);
+}
+
+ImportProfiler::ImportProfiler(KernelState &kernel)
+    : parent(kernel) {
+}
+
+void ImportProfiler::set_enabled(bool enable) {
+    const std::lock_guard<std::mutex> guard(mutex);
+    if (enable && !imports) {
+        const size_t size = import_count() + 1;
+        imports = std::make_unique<std::atomic<ImportCallStats *>[]>(size);
+        for (size_t i = 0; i < size; i++)
+            imports[i] = nullptr;
+    }
+
+    enabled = enable;
+}
+
+void ImportProfiler::reset() {
+    const std::lock_guard<std::mutex> guard(mutex);
+    for (auto &stats : allocated_imports)
+        stats->reset();
+    for (auto &[_, stats] : threads)
+        stats->reset();
+    thread_names.clear();
+    // the threads look their stats up again on their next call, which also reads their current name
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+ImportCallStats &ImportProfiler::get_import_stats(uint32_t index) {
+    ImportCallStats *stats = imports[index].load(std::memory_order_acquire);
+    if (stats)
+        return *stats;
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    stats = imports[index].load(std::memory_order_acquire);
+    if (!stats) {
+        stats = allocated_imports.emplace_back(std::make_unique<ImportCallStats>()).get();
+        imports[index].store(stats, std::memory_order_release);
+    }
+
+    return *stats;
+}
+
+ImportCallStats &ImportProfiler::get_thread_stats(SceUID thread_id) {
+    // a guest thread always runs on the same host thread, and the stats are never freed, so they can be cached until the next reset
+    thread_local const ImportProfiler *cached_profiler = nullptr;
+    thread_local uint32_t cached_generation = 0;
+    thread_local SceUID cached_thread_id = 0;
+    thread_local ImportCallStats *cached_stats = nullptr;
+    const uint32_t current_generation = generation.load(std::memory_order_relaxed);
+    if (cached_profiler == this && cached_generation == current_generation && cached_thread_id == thread_id)
+        return *cached_stats;
+
+    const ThreadStatePtr thread = parent.get_thread(thread_id);
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    auto &stats = threads[thread_id];
+    if (!stats)
+        stats = std::make_unique<ImportCallStats>();
+    if (thread)
+        thread_names[thread_id] = thread->name;
+
+    cached_profiler = this;
+    cached_generation = current_generation;
+    cached_thread_id = thread_id;
+    cached_stats = stats.get();
+    return *stats;
+}
+
+void ImportProfiler::record(uint32_t svc, uint32_t nid, SceUID thread_id, uint64_t duration_ns) {
+    if (!is_enabled())
+        return;
+
+    // the stubs dispatched by NID don't carry their index
+    const uint32_t index = svc != 0 ? svc : import_index(nid);
+    if (index == 0 || index > import_count())
+        return;
+
+    get_import_stats(index).add(duration_ns);
+    get_thread_stats(thread_id).add(duration_ns);
+}
+
+static bool compare_total_time(const ImportProfileEntry &a, const ImportProfileEntry &b) {
+    return a.total_ns > b.total_ns;
+}
+
+ImportProfileEntries ImportProfiler::get_imports() {
+    ImportProfileEntries entries;
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    if (!imports)
+        return entries;
+
+    for (uint32_t index = 1; index <= import_count(); index++) {
+        const ImportCallStats *stats = imports[index].load(std::memory_order_acquire);
+        if (!stats || stats->count == 0)
+            continue;
+
+        const uint32_t nid = import_nid(index);
+        entries.push_back({ nid, 0, import_name(nid), stats->count, stats->total_ns, stats->percentile(0.99) });
+    }
+    std::ranges::sort(entries, compare_total_time);
+
+    return entries;
+}
+
+ImportProfileEntries ImportProfiler::get_threads() {
+    ImportProfileEntries entries;
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    for (const auto &[thread_id, stats] : threads) {
+        if (stats->count == 0)
+            continue;
+
+        entries.push_back({ 0, thread_id, thread_names[thread_id], stats->count, stats->total_ns, stats->percentile(0.99) });
+    }
+    std::ranges::sort(entries, compare_total_time);
+
+    return entries;
+}
+
+bool ImportProfiler::dump_csv(const fs::path &path) {
+    fs::create_directories(path.parent_path());
+    fs::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to write import profile to {}", path);
+        return false;
+    }
+
+    file << "type,nid,thread_id,name,count,total_ns,average_ns,p99_ns\n";
+    auto write_entries = [&](const char *type, const ImportProfileEntries &entries) {
+        for (const auto &entry : entries) {
+            std::string name = entry.name;
+            string_utils::replace(name, "\"", "\"\"");
+            file << fmt::format("{},{},{},\"{}\",{},{},{},{}\n", type, log_hex(entry.nid), entry.thread_id, name,
+                entry.count, entry.total_ns, entry.total_ns / entry.count, entry.p99_ns);
+        }
+    };
+    write_entries("import", get_imports());
+    write_entries("thread", get_threads());
+
+    LOG_INFO("Import profile written to {}", path);
+    return true;
+}
+
+static std::string escape_json(const std::string &str) {
+    std::string escaped;
+    for (const char c : str) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            escaped += fmt::format("\\u{:04x}", c);
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+bool ImportProfiler::dump_json(const fs::path &path) {
+    fs::create_directories(path.parent_path());
+    fs::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("Failed to write import profile to {}", path);
+        return false;
+    }
+
+    auto write_entries = [&](const char *key, const ImportProfileEntries &entries) {
+        file << fmt::format("  \"{}\": [", key);
+        for (size_t i = 0; i < entries.size(); i++) {
+            const auto &entry = entries[i];
+            file << fmt::format("{}\n    {{ \"nid\": \"{}\", \"thread_id\": {}, \"name\": \"{}\", \"count\": {}, \"total_ns\": {}, \"p99_ns\": {} }}",
+                i == 0 ? "" : ",", log_hex(entry.nid), entry.thread_id, escape_json(entry.name), entry.count, entry.total_ns, entry.p99_ns);
+        }
+        file << "\n  ]";
+    };
+
+    file << "{\n";
+    write_entries("imports", get_imports());
+    file << ",\n";
+    write_entries("threads", get_threads());
+    file << "\n}\n";
+
+    LOG_INFO("Import profile written to {}", path);
+    return true;
+}
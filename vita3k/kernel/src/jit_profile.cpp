@@ -0,0 +1,187 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/jit_profile.h>
+
+#include <cpu/functions.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <chrono>
+
+// magic number put at the beginning of the jit profile file
+constexpr uint32_t jit_profile_magic = 0x4A495450;
+constexpr uint32_t jit_profile_version = 1;
+
+void JitProfile::init(const fs::path &path, bool enabled) {
+    const std::lock_guard<std::mutex> guard(mutex);
+    this->path = path;
+    this->enabled = enabled;
+    dirty = false;
+    blocks.clear();
+
+    if (enabled)
+        load();
+}
+
+void JitProfile::deinit() {
+    const std::lock_guard<std::mutex> guard(mutex);
+    if (enabled && dirty)
+        save();
+
+    enabled = false;
+    dirty = false;
+    code_segments.clear();
+    blocks.clear();
+}
+
+bool JitProfile::load() {
+    fs::ifstream profile_file(path, std::ios::in | std::ios::binary);
+    if (!profile_file.is_open())
+        return false;
+
+    auto read_integer = [&]<typename T>(T &val) {
+        profile_file.read(reinterpret_cast<char *>(&val), sizeof(T));
+    };
+
+    uint32_t magic_number = 0;
+    uint32_t version = 0;
+    read_integer(magic_number);
+    read_integer(version);
+    if (magic_number != jit_profile_magic || version != jit_profile_version) {
+        LOG_WARN("JIT profile {} is outdated or corrupted, ignoring it.", path);
+        return false;
+    }
+
+    uint64_t nb_segments = 0;
+    read_integer(nb_segments);
+    size_t nb_blocks_total = 0;
+    for (uint64_t i = 0; i < nb_segments && profile_file; i++) {
+        uint64_t hash = 0;
+        uint64_t nb_blocks = 0;
+        read_integer(hash);
+        read_integer(nb_blocks);
+
+        auto &segment_blocks = blocks[hash];
+        for (uint64_t j = 0; j < nb_blocks && profile_file; j++) {
+            // bit 0 of the offset is the thumb bit, like for a pc
+            uint32_t offset = 0;
+            uint32_t fpscr = 0;
+            read_integer(offset);
+            read_integer(fpscr);
+            segment_blocks.insert({ offset & ~1U, (offset & 1) != 0, fpscr });
+        }
+        nb_blocks_total += segment_blocks.size();
+    }
+
+    if (!profile_file) {
+        LOG_WARN("JIT profile {} is truncated, ignoring it.", path);
+        blocks.clear();
+        return false;
+    }
+
+    LOG_INFO("Loaded JIT profile with {} blocks from {} code segments", nb_blocks_total, blocks.size());
+    return true;
+}
+
+bool JitProfile::save() {
+    fs::create_directories(path.parent_path());
+    fs::ofstream profile_file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!profile_file.is_open()) {
+        LOG_ERROR("Failed to save JIT profile to {}", path);
+        return false;
+    }
+
+    auto write_integer = [&]<typename T>(T val) {
+        profile_file.write(reinterpret_cast<const char *>(&val), sizeof(T));
+    };
+
+    write_integer(jit_profile_magic);
+    write_integer(jit_profile_version);
+    write_integer(static_cast<uint64_t>(blocks.size()));
+    for (const auto &[hash, segment_blocks] : blocks) {
+        write_integer(hash);
+        write_integer(static_cast<uint64_t>(segment_blocks.size()));
+        for (const auto &block : segment_blocks) {
+            write_integer(block.offset | static_cast<uint32_t>(block.thumb));
+            write_integer(block.fpscr);
+        }
+    }
+
+    dirty = false;
+    LOG_INFO("JIT profile saved");
+    return true;
+}
+
+void JitProfile::add_code_segment(Address start, uint32_t size, uint64_t hash) {
+    const std::lock_guard<std::mutex> guard(mutex);
+    if (!enabled)
+        return;
+
+    code_segments[start] = { hash, size };
+}
+
+void JitProfile::remove_code_segment(Address start) {
+    const std::lock_guard<std::mutex> guard(mutex);
+    code_segments.erase(start);
+}
+
+void JitProfile::record_block(const JitBlockInfo &block) {
+    const std::lock_guard<std::mutex> guard(mutex);
+    // code_segments is sorted in decreasing order, find the last segment starting before the block
+    const auto it = code_segments.lower_bound(block.pc);
+    if (it == code_segments.end() || block.pc >= it->first + it->second.size)
+        return;
+
+    const JitProfileBlock profile_block{ block.pc - it->first, block.thumb, block.fpscr };
+    if (blocks[it->second.hash].insert(profile_block).second)
+        dirty = true;
+}
+
+void JitProfile::warm_up(CPUState &cpu, std::mutex &jit_mutex) {
+    JitBlockInfos to_translate;
+    {
+        const std::lock_guard<std::mutex> guard(mutex);
+        if (!enabled)
+            return;
+
+        for (const auto &[start, segment] : code_segments) {
+            const auto it = blocks.find(segment.hash);
+            if (it == blocks.end())
+                continue;
+
+            for (const auto &block : it->second) {
+                if (block.offset < segment.size)
+                    to_translate.push_back({ start + block.offset, block.thumb, block.fpscr });
+            }
+        }
+    }
+
+    if (to_translate.empty())
+        return;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    // invalidations wait for jit_mutex with the kernel mutex held, so it is only held for a few blocks at a time
+    constexpr size_t BATCH_SIZE = 256;
+    for (size_t i = 0; i < to_translate.size(); i += BATCH_SIZE) {
+        const JitBlockInfos batch(to_translate.begin() + i, to_translate.begin() + std::min(i + BATCH_SIZE, to_translate.size()));
+        const std::lock_guard<std::mutex> guard(jit_mutex);
+        warm_up_jit(cpu, batch);
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG_INFO("JIT warm-up translated {} blocks in {} ms", to_translate.size(), duration.count());
+}
@@ -50,6 +50,41 @@ void CorenumAllocator::set_max_core_count(const std::size_t max) {
     alloc.set_maximum(max);
 }
 
+void CPUPool::set_max_size(const std::size_t max) {
+    const std::lock_guard<std::mutex> guard(lock);
+    max_size = max;
+}
+
+CPUStatePtr CPUPool::acquire() {
+    const std::lock_guard<std::mutex> guard(lock);
+    if (cpus.empty())
+        return nullptr;
+
+    CPUStatePtr cpu = std::move(cpus.back());
+    cpus.pop_back();
+    return cpu;
+}
+
+bool CPUPool::release(CPUStatePtr &cpu) {
+    const std::lock_guard<std::mutex> guard(lock);
+    if (cpus.size() >= max_size)
+        return false;
+
+    cpus.push_back(std::move(cpu));
+    return true;
+}
+
+void CPUPool::invalidate_jit_cache(Address start, size_t length) {
+    const std::lock_guard<std::mutex> guard(lock);
+    for (const auto &cpu : cpus)
+        ::invalidate_jit_cache(*cpu, start, length);
+}
+
+void CPUPool::clear() {
+    const std::lock_guard<std::mutex> guard(lock);
+    cpus.clear();
+}
+
 // TODO implement cross platform debug thread name setter and eliminate SDL thread
 struct ThreadParams {
     KernelState *kernel = nullptr;
@@ -71,13 +106,29 @@ static int SDLCALL thread_function(void *data) {
     }
 #endif
 
+    if (thread->needs_jit_warm_up) {
+        // translate the blocks recorded during previous runs before running anything, the thread can't be started meanwhile
+        const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+        thread->needs_jit_warm_up = false;
+        params.kernel->jit_profile.warm_up(*thread->cpu, params.kernel->jit_mutex);
+    }
+
     thread->run_loop();
     const uint32_t r0 = read_reg(*thread->cpu, 0);
 
     {
         std::lock_guard<std::mutex> lock(params.kernel->mutex);
         params.kernel->threads.erase(thread->id);
-        params.kernel->corenum_allocator.free_corenum(get_processor_id(*thread->cpu));
+        // the thread state can outlive the thread, so its cpu is always taken away, pooled or not
+        CPUStatePtr cpu;
+        {
+            const std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            cpu = std::move(thread->cpu);
+        }
+        // keep the cpu and its core number for the next thread if possible
+        const int corenum = static_cast<int>(get_processor_id(*cpu));
+        if (!params.kernel->cpu_pool.release(cpu))
+            params.kernel->corenum_allocator.free_corenum(corenum);
         params.kernel->thread_deleted_cond.notify_all();
     }
 
@@ -85,14 +136,16 @@ static int SDLCALL thread_function(void *data) {
 }
 
 KernelState::KernelState()
-    : debugger(*this) {
+    : debugger(*this)
+    , import_profiler(*this) {
 }
 
-bool KernelState::init(MemState &mem, const CallImportFunc &call_import, bool cpu_opt) {
+bool KernelState::init(MemState &mem, const CallImportFunc &call_import, const CallImportFastFunc &call_import_fast, bool cpu_opt) {
     corenum_allocator.set_max_core_count(MAX_CORE_COUNT);
     start_tick = rtc_get_ticks(rtc_base_ticks());
     base_tick = { rtc_base_ticks() };
     this->call_import = call_import;
+    this->call_import_fast = call_import_fast;
     this->cpu_opt = cpu_opt;
 
     // Generate halt instruction (NOP + WFI)
@@ -133,9 +186,11 @@ void KernelState::set_memory_watch(bool enabled) {
 
 void KernelState::invalidate_jit_cache(Address start, size_t length) {
     std::lock_guard<std::mutex> lock(mutex);
+    const std::lock_guard<std::mutex> jit_lock(jit_mutex);
     for (const auto &[_, thread] : threads) {
         ::invalidate_jit_cache(*thread->cpu, start, length);
     }
+    cpu_pool.invalidate_jit_cache(start, length);
 }
 
 ThreadStatePtr KernelState::get_thread(SceUID thread_id) {
@@ -219,6 +274,9 @@ void KernelState::resume_threads() {
 void KernelState::deinit(MemState &mem) {
     process_exit();
     threads.clear();
+    cpu_pool.clear();
+
+    jit_profile.deinit();
 
     simple_events.clear();
     timers.clear();
@@ -269,6 +327,7 @@ void KernelState::deinit(MemState &mem) {
     libc_dso_handle_main = Ptr<void>(0);
 
     debugger.deinit();
+    import_profiler.reset();
 
     next_uid = 1;
 
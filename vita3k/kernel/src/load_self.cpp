@@ -34,6 +34,8 @@
 // clang-format on
 #include <miniz.h>
 #include <self.h>
+#define XXH_INLINE_ALL
+#include <xxhash.h>
 
 #include <cassert>
 #include <cstring>
@@ -140,7 +142,7 @@ static bool load_func_imports(const uint32_t *nids, const Ptr<uint32_t> *entries
 
         kernel.func_binding_infos.emplace(nid, entry.address());
         if (export_address == kernel.export_nids.end()) {
-            stub[0] = 0xef000000; // svc #0 - Call our interrupt hook.
+            stub[0] = encode_arm_inst(INSTRUCTION_SYSCALL, import_index(nid), 0); // svc #index - Call our interrupt hook.
             stub[1] = 0xe1a0f00e; // mov pc, lr - Return to the caller.
             stub[2] = nid; // Our interrupt hook will read this.
         } else {
@@ -300,7 +302,7 @@ static bool unload_func_exports(const uint32_t *nids, size_t count, KernelState
             Address entry = it->second;
             uint32_t *stub = Ptr<uint32_t>(entry).get(mem);
 
-            stub[0] = 0xef000000; // svc #0 - Call our interrupt hook.
+            stub[0] = encode_arm_inst(INSTRUCTION_SYSCALL, import_index(nid), 0); // svc #index - Call our interrupt hook.
             stub[1] = 0xe1a0f00e; // mov pc, lr - Return to the caller.
             stub[2] = nid; // Our interrupt hook will read this.
             kernel.invalidate_jit_cache(entry, 3 * sizeof(uint32_t));
@@ -578,8 +580,9 @@ SceUID load_self(KernelState &kernel, MemState &mem, const void *self, const std
 
     SegmentInfosForReloc segment_reloc_info;
 
-    auto free_all_segments = [](MemState &mem, SegmentInfosForReloc &segs_info) {
+    auto free_all_segments = [&kernel](MemState &mem, SegmentInfosForReloc &segs_info) {
         for (auto &[_, segment] : segs_info) {
+            kernel.jit_profile.remove_code_segment(segment.addr);
             free(mem, segment.addr);
         }
     };
@@ -633,6 +636,10 @@ SceUID load_self(KernelState &kernel, MemState &mem, const void *self, const std
                     memcpy(seg_ptr.get(mem), seg_bytes, seg_header.p_filesz);
                 }
 
+                // hash the code before relocation so it doesn't depend on the load address
+                if (kernel.jit_profile.is_enabled() && (seg_header.p_flags & PF_X))
+                    kernel.jit_profile.add_code_segment(segment_address, seg_header.p_memsz, XXH3_64bits(seg_ptr.get(mem), seg_header.p_filesz));
+
                 segment_reloc_info[seg_index] = { segment_address, seg_header.p_vaddr, seg_header.p_memsz };
             }
         } else if (seg_header.p_type == PT_SCE_RELA) {
@@ -809,6 +816,7 @@ int unload_self(KernelState &kernel, MemState &mem, KernelModule &module) {
             continue;
 
         kernel.invalidate_jit_cache(segment.vaddr.address(), segment.memsz);
+        kernel.jit_profile.remove_code_segment(segment.vaddr.address());
         free(mem, module.info.segments[i].vaddr.address());
     }
 
@@ -23,6 +23,9 @@
 #include <util/lock_and_find.h>
 #include <util/log.h>
 
+#include <array>
+#include <atomic>
+
 static constexpr bool LOG_SYNC_PRIMITIVES = false;
 
 // ***********
@@ -617,6 +620,14 @@ SceUID mutex_find(KernelState &kernel, const char *export_name, const char *pNam
     return RET_ERROR(SCE_KERNEL_ERROR_UID_CANNOT_FIND_BY_NAME);
 }
 
+// The lock count and the owner of a lightweight mutex are mirrored in its guest work area,
+// the lock count is checked there before trying to take the mutex without waiting
+inline static void update_lw_mutex_workarea(MemState &mem, const Mutex &mutex) {
+    SceKernelLwMutexWork *workarea = mutex.workarea.get(mem);
+    workarea->owner = mutex.owner ? mutex.owner->id : 0;
+    std::atomic_ref<uint32_t>(workarea->lockCount).store(mutex.lock_count, std::memory_order_release);
+}
+
 inline static int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, int lock_count, MutexPtr &mutex, SyncWeight weight, SceUInt *timeout, bool only_try) {
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid: {} thread_id: {} name: \"{}\" attr: {} lock_count: {} timeout: {} waiting_threads: {}",
@@ -637,7 +648,7 @@ inline static int mutex_lock_impl(KernelState &kernel, MemState &mem, const char
             if (is_recursive) {
                 mutex->lock_count += lock_count;
                 if (weight == SyncWeight::Light)
-                    mutex->workarea.get(mem)->lockCount += lock_count;
+                    update_lw_mutex_workarea(mem, *mutex);
 
                 return SCE_KERNEL_OK;
             }
@@ -670,12 +681,8 @@ inline static int mutex_lock_impl(KernelState &kernel, MemState &mem, const char
 
         int res = handle_timeout(kernel, thread, thread_lock, mutex_lock, mutex->waiting_threads, data_it, export_name, timeout);
 
-        if (weight == SyncWeight::Light) {
-            mutex->workarea.get(mem)->lockCount = mutex->lock_count;
-            if (mutex->owner == thread) {
-                mutex->workarea.get(mem)->owner = thread_id;
-            }
-        }
+        if (weight == SyncWeight::Light)
+            update_lw_mutex_workarea(mem, *mutex);
 
         return res;
     }
@@ -685,12 +692,8 @@ inline static int mutex_lock_impl(KernelState &kernel, MemState &mem, const char
     mutex->lock_count += lock_count;
     mutex->owner = thread;
 
-    if (weight == SyncWeight::Light) {
-        mutex->workarea.get(mem)->lockCount = mutex->lock_count;
-        if (mutex->owner == thread) {
-            mutex->workarea.get(mem)->owner = thread_id;
-        }
-    }
+    if (weight == SyncWeight::Light)
+        update_lw_mutex_workarea(mem, *mutex);
 
     return SCE_KERNEL_OK;
 }
@@ -715,7 +718,7 @@ int mutex_try_lock(KernelState &kernel, MemState &mem, const char *export_name,
     return mutex_lock_impl(kernel, mem, export_name, thread_id, lock_count, mutex, weight, nullptr, true);
 }
 
-inline static int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUID thread_id, int unlock_count, MutexPtr &mutex) {
+inline static int mutex_unlock_impl(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, int unlock_count, MutexPtr &mutex) {
     const ThreadStatePtr current_thread = kernel.get_thread(thread_id);
 
     const std::lock_guard<std::mutex> mutex_lock(mutex->mutex);
@@ -743,12 +746,15 @@ inline static int mutex_unlock_impl(KernelState &kernel, const char *export_name
                 mutex->owner = waiting_thread;
             }
         }
+
+        if (mutex->workarea)
+            update_lw_mutex_workarea(mem, *mutex);
     }
 
     return SCE_KERNEL_OK;
 }
 
-int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight) {
+int mutex_unlock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight) {
     assert(mutexid >= 0);
 
     MutexPtr mutex;
@@ -761,7 +767,7 @@ int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id,
             mutex->waiting_threads->size());
     }
 
-    return mutex_unlock_impl(kernel, export_name, thread_id, unlock_count, mutex);
+    return mutex_unlock_impl(kernel, mem, export_name, thread_id, unlock_count, mutex);
 }
 
 int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight) {
@@ -779,6 +785,10 @@ int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id,
     }
 
     if (mutex->waiting_threads->empty()) {
+        {
+            const std::lock_guard<std::mutex> mutex_lock(mutex->mutex);
+            mutex->deleted = true;
+        }
         const std::lock_guard<std::mutex> kernel_guard(kernel.mutex);
         mutexes->erase(mutexid);
     } else {
@@ -805,6 +815,109 @@ MutexPtr mutex_get(KernelState &kernel, const char *export_name, SceUID thread_i
     return mutex;
 }
 
+// A guest thread always runs on the same host thread, so its state and the lightweight mutexes it used
+// can be kept in a thread local cache instead of being looked up under the kernel mutex on each call
+struct LwMutexCache {
+    static constexpr size_t SIZE = 16;
+
+    const KernelState *kernel = nullptr;
+    SceUID thread_id = 0;
+    std::weak_ptr<ThreadState> thread;
+    std::array<std::weak_ptr<Mutex>, SIZE> mutexes;
+};
+
+static thread_local LwMutexCache lw_mutex_cache;
+
+static ThreadStatePtr get_cached_thread(KernelState &kernel, SceUID thread_id) {
+    LwMutexCache &cache = lw_mutex_cache;
+    if (cache.kernel != &kernel || cache.thread_id != thread_id) {
+        cache = {};
+        cache.kernel = &kernel;
+        cache.thread_id = thread_id;
+    }
+
+    ThreadStatePtr thread = cache.thread.lock();
+    if (!thread) {
+        thread = kernel.get_thread(thread_id);
+        cache.thread = thread;
+    }
+    return thread;
+}
+
+// Must be called after get_cached_thread
+static MutexPtr get_cached_lw_mutex(KernelState &kernel, SceUID mutexid) {
+    auto &entry = lw_mutex_cache.mutexes[mutexid % LwMutexCache::SIZE];
+    MutexPtr mutex = entry.lock();
+    if (!mutex || mutex->uid != mutexid) {
+        mutex = lock_and_find(mutexid, kernel.lwmutexes, kernel.mutex);
+        entry = mutex;
+    }
+    return mutex;
+}
+
+bool lw_mutex_lock_fast(KernelState &kernel, MemState &mem, SceUID thread_id, Ptr<SceKernelLwMutexWork> workarea, int lock_count) {
+    if (!workarea)
+        return false;
+
+    // the guest work area tells if the mutex is owned, in which case there is no need to look it up
+    SceKernelLwMutexWork *workarea_mem = workarea.get(mem);
+    const SceUID mutexid = workarea_mem->uid;
+    if (mutexid < 0 || std::atomic_ref<uint32_t>(workarea_mem->lockCount).load(std::memory_order_acquire) != 0)
+        return false;
+
+    const ThreadStatePtr thread = get_cached_thread(kernel, thread_id);
+    const MutexPtr mutex = get_cached_lw_mutex(kernel, mutexid);
+    if (!thread || !mutex)
+        return false;
+
+    // another thread holding the mutex lock means the mutex is contended
+    const std::unique_lock<std::mutex> mutex_lock(mutex->mutex, std::try_to_lock);
+    if (!mutex_lock.owns_lock() || mutex->deleted || mutex->lock_count > 0)
+        return false;
+
+    if (LOG_SYNC_PRIMITIVES) {
+        LOG_DEBUG("lw_mutex_lock_fast: uid: {} thread_id: {} name: \"{}\" lock_count: {}",
+            mutexid, thread_id, mutex->name, lock_count);
+    }
+
+    mutex->lock_count += lock_count;
+    mutex->owner = thread;
+    update_lw_mutex_workarea(mem, *mutex);
+
+    return true;
+}
+
+bool lw_mutex_unlock_fast(KernelState &kernel, MemState &mem, SceUID thread_id, Ptr<SceKernelLwMutexWork> workarea, int unlock_count) {
+    if (!workarea)
+        return false;
+
+    const SceUID mutexid = workarea.get(mem)->uid;
+    if (mutexid < 0)
+        return false;
+
+    const ThreadStatePtr thread = get_cached_thread(kernel, thread_id);
+    const MutexPtr mutex = get_cached_lw_mutex(kernel, mutexid);
+    if (!thread || !mutex)
+        return false;
+
+    // handing the mutex over to a waiting thread is left to mutex_unlock
+    const std::unique_lock<std::mutex> mutex_lock(mutex->mutex, std::try_to_lock);
+    if (!mutex_lock.owns_lock() || mutex->deleted || mutex->owner != thread || unlock_count > mutex->lock_count || !mutex->waiting_threads->empty())
+        return false;
+
+    if (LOG_SYNC_PRIMITIVES) {
+        LOG_DEBUG("lw_mutex_unlock_fast: uid: {} thread_id: {} name: \"{}\" unlock_count: {}",
+            mutexid, thread_id, mutex->name, unlock_count);
+    }
+
+    mutex->lock_count -= unlock_count;
+    if (mutex->lock_count == 0)
+        mutex->owner = nullptr;
+    update_lw_mutex_workarea(mem, *mutex);
+
+    return true;
+}
+
 // **************
 // * RWLock *
 // **************
@@ -1246,7 +1359,7 @@ int condvar_wait(KernelState &kernel, MemState &mem, const char *export_name, Sc
 
     std::unique_lock<std::mutex> condition_variable_lock(condvar->mutex);
 
-    if (auto error = mutex_unlock_impl(kernel, export_name, thread_id, 1, condvar->associated_mutex))
+    if (auto error = mutex_unlock_impl(kernel, mem, export_name, thread_id, 1, condvar->associated_mutex))
         return error;
 
     std::unique_lock<std::mutex> thread_lock(thread->mutex);
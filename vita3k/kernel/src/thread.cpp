@@ -54,12 +54,6 @@ int ThreadState::init(const char *name, Ptr<const void> entry_point, int init_pr
     this->name = name;
     this->entry_point = entry_point.address();
 
-    int core_num = kernel.corenum_allocator.new_corenum();
-    if (core_num < 0) {
-        LOG_ERROR("Out of core number to allocate, use 0");
-        core_num = 0;
-    }
-
     if (init_priority > SCE_KERNEL_LOWEST_PRIORITY_USER) {
         assert(SCE_KERNEL_HIGHEST_DEFAULT_PRIORITY <= init_priority && init_priority <= SCE_KERNEL_LOWEST_DEFAULT_PRIORITY);
         priority = init_priority - SCE_KERNEL_DEFAULT_PRIORITY + SCE_KERNEL_GAME_DEFAULT_PRIORITY_ACTUAL;
@@ -71,16 +65,35 @@ int ThreadState::init(const char *name, Ptr<const void> entry_point, int init_pr
     start_tick = rtc_get_ticks(kernel.base_tick.tick);
     last_vblank_waited = 0;
 
-    cpu = init_cpu(kernel.cpu_opt, id, static_cast<std::size_t>(core_num), mem);
-    if (!cpu) {
-        return SCE_KERNEL_ERROR_ERROR;
+    // reuse the cpu of an exited thread so the code it already translated doesn't have to be translated again
+    cpu = kernel.cpu_pool.acquire();
+    if (cpu) {
+        reset_cpu(*cpu, id);
+    } else {
+        int core_num = kernel.corenum_allocator.new_corenum();
+        if (core_num < 0) {
+            LOG_ERROR("Out of core number to allocate, use 0");
+            core_num = 0;
+        }
+
+        cpu = init_cpu(kernel.cpu_opt, id, static_cast<std::size_t>(core_num), mem);
+        if (!cpu) {
+            return SCE_KERNEL_ERROR_ERROR;
+        }
+        needs_jit_warm_up = true;
     }
-    if (kernel.debugger.watch_code) {
-        set_log_code(*cpu, true);
+    if (kernel.jit_profile.is_enabled()) {
+        cpu->block_translated = [&jit_profile = kernel.jit_profile](const JitBlockInfo &block) {
+            jit_profile.record_block(block);
+        };
     }
-    if (kernel.debugger.watch_memory) {
-        set_log_mem(*cpu, true);
+    if (kernel.call_import_fast) {
+        cpu->svc_fast_path = [&kernel = kernel, id = id](CPUState &cpu, uint32_t svc) {
+            return kernel.call_import_fast(cpu, svc, id);
+        };
     }
+    set_log_code(*cpu, kernel.debugger.watch_code);
+    set_log_mem(*cpu, kernel.debugger.watch_memory);
 
     std::string alloc_name = fmt::format("Stack for thread {} (#{})", name, id);
     stack = alloc_block(mem, stack_size, alloc_name.c_str());
@@ -268,13 +281,16 @@ void ThreadState::run_loop() {
 
             lock.unlock();
 
+            if (host_policy_changed.exchange(false) && kernel.host_thread_policy.is_enabled())
+                kernel.host_thread_policy.apply(*this);
+
             // Single step or run
             const int res = do_step ? step(*cpu) : run(*cpu);
 
             // handle svc call if this was what stopped the cpu
             if (cpu->svc_called) {
                 const uint32_t nid = *Ptr<uint32_t>(read_pc(*cpu) + 4).get(mem);
-                kernel.call_import(*cpu, nid, id);
+                kernel.call_import(*cpu, cpu->svc, nid, id);
                 clear_exclusive(*cpu);
             }
 
@@ -0,0 +1,214 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/state.h>
+#include <kernel/sync_primitives.h>
+#include <kernel/thread/thread_state.h>
+#include <mem/functions.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+class lw_mutex : public testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(init(mem, false));
+        workarea = Ptr<SceKernelLwMutexWork>(alloc(mem, sizeof(SceKernelLwMutexWork), "lw mutex workarea"));
+        ASSERT_TRUE(workarea);
+        owner = add_thread();
+    }
+
+    // the guest threads are never run, each test runs them on its own host threads
+    SceUID add_thread() {
+        const ThreadStatePtr thread = std::make_shared<ThreadState>(kernel.get_next_uid(), kernel, mem);
+        thread->status = ThreadStatus::run;
+        thread->priority = SCE_KERNEL_DEFAULT_PRIORITY;
+        kernel.threads.emplace(thread->id, thread);
+        return thread->id;
+    }
+
+    SceUID create(SceUInt attr = 0) {
+        SceUID uid = 0;
+        EXPECT_EQ(mutex_create(&uid, kernel, mem, "test", "lw mutex", owner, attr, 0, workarea, SyncWeight::Light), SCE_KERNEL_OK);
+        workarea.get(mem)->uid = uid;
+        return uid;
+    }
+
+    MutexPtr get_mutex(SceUID uid) {
+        return kernel.lwmutexes.at(uid);
+    }
+
+    // takes the fast path when it can, the regular one otherwise, as the modules do
+    void lock(SceUID thread_id, SceUID uid) {
+        if (!lw_mutex_lock_fast(kernel, mem, thread_id, workarea, 1))
+            ASSERT_EQ(mutex_lock(kernel, mem, "lock", thread_id, uid, 1, nullptr, SyncWeight::Light), SCE_KERNEL_OK);
+    }
+
+    void unlock(SceUID thread_id, SceUID uid) {
+        if (!lw_mutex_unlock_fast(kernel, mem, thread_id, workarea, 1))
+            ASSERT_EQ(mutex_unlock(kernel, mem, "unlock", thread_id, uid, 1, SyncWeight::Light), SCE_KERNEL_OK);
+    }
+
+    MemState mem;
+    KernelState kernel;
+    Ptr<SceKernelLwMutexWork> workarea;
+    SceUID owner = 0;
+};
+
+TEST_F(lw_mutex, fast_path_updates_mutex_and_workarea) {
+    const SceUID uid = create();
+
+    ASSERT_TRUE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+    EXPECT_EQ(get_mutex(uid)->lock_count, 1);
+    EXPECT_EQ(get_mutex(uid)->owner->id, owner);
+    EXPECT_EQ(workarea.get(mem)->lockCount, 1u);
+    EXPECT_EQ(workarea.get(mem)->owner, static_cast<uint32_t>(owner));
+
+    ASSERT_TRUE(lw_mutex_unlock_fast(kernel, mem, owner, workarea, 1));
+    EXPECT_EQ(get_mutex(uid)->lock_count, 0);
+    EXPECT_EQ(get_mutex(uid)->owner, nullptr);
+    EXPECT_EQ(workarea.get(mem)->lockCount, 0u);
+    EXPECT_EQ(workarea.get(mem)->owner, 0u);
+}
+
+TEST_F(lw_mutex, owned_mutex_is_left_to_regular_path) {
+    const SceUID uid = create(SCE_KERNEL_MUTEX_ATTR_RECURSIVE);
+    const SceUID other = add_thread();
+
+    ASSERT_TRUE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+    // recursive locks and other threads both see the lock count in the workarea
+    EXPECT_FALSE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+    EXPECT_FALSE(lw_mutex_lock_fast(kernel, mem, other, workarea, 1));
+    EXPECT_FALSE(lw_mutex_unlock_fast(kernel, mem, other, workarea, 1));
+    EXPECT_FALSE(lw_mutex_unlock_fast(kernel, mem, owner, workarea, 2));
+
+    ASSERT_EQ(mutex_lock(kernel, mem, "lock", owner, uid, 1, nullptr, SyncWeight::Light), SCE_KERNEL_OK);
+    EXPECT_EQ(workarea.get(mem)->lockCount, 2u);
+    ASSERT_TRUE(lw_mutex_unlock_fast(kernel, mem, owner, workarea, 2));
+    EXPECT_EQ(workarea.get(mem)->lockCount, 0u);
+}
+
+TEST_F(lw_mutex, invalid_or_deleted_mutex_is_left_to_regular_path) {
+    EXPECT_FALSE(lw_mutex_lock_fast(kernel, mem, owner, Ptr<SceKernelLwMutexWork>(), 1));
+    EXPECT_FALSE(lw_mutex_unlock_fast(kernel, mem, owner, Ptr<SceKernelLwMutexWork>(), 1));
+
+    const SceUID uid = create();
+    workarea.get(mem)->uid = uid + 1000;
+    EXPECT_FALSE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+
+    // the deleted mutex is still in the cache of this thread
+    workarea.get(mem)->uid = uid;
+    ASSERT_TRUE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+    ASSERT_TRUE(lw_mutex_unlock_fast(kernel, mem, owner, workarea, 1));
+    ASSERT_EQ(mutex_delete(kernel, "delete", owner, uid, SyncWeight::Light), SCE_KERNEL_OK);
+    EXPECT_FALSE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+}
+
+TEST_F(lw_mutex, waiting_thread_is_handed_over_by_regular_unlock) {
+    const SceUID uid = create();
+    const SceUID waiter = add_thread();
+
+    ASSERT_TRUE(lw_mutex_lock_fast(kernel, mem, owner, workarea, 1));
+    std::thread waiter_thread([&] { lock(waiter, uid); });
+
+    const MutexPtr mutex = get_mutex(uid);
+    while (true) {
+        const std::lock_guard<std::mutex> guard(mutex->mutex);
+        if (!mutex->waiting_threads->empty())
+            break;
+    }
+
+    EXPECT_FALSE(lw_mutex_unlock_fast(kernel, mem, owner, workarea, 1));
+    unlock(owner, uid);
+    waiter_thread.join();
+
+    EXPECT_EQ(mutex->owner->id, waiter);
+    EXPECT_EQ(workarea.get(mem)->owner, static_cast<uint32_t>(waiter));
+    EXPECT_EQ(workarea.get(mem)->lockCount, 1u);
+}
+
+TEST_F(lw_mutex, contended_locks_are_exclusive) {
+    constexpr int THREAD_COUNT = 4;
+    constexpr int LOCK_COUNT = 20000;
+
+    const SceUID uid = create();
+    std::vector<SceUID> thread_ids;
+    for (int i = 0; i < THREAD_COUNT; i++)
+        thread_ids.push_back(add_thread());
+
+    int counter = 0;
+    std::vector<std::thread> threads;
+    for (const SceUID thread_id : thread_ids) {
+        threads.emplace_back([&, thread_id] {
+            for (int i = 0; i < LOCK_COUNT; i++) {
+                lock(thread_id, uid);
+                counter++;
+                unlock(thread_id, uid);
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(counter, THREAD_COUNT * LOCK_COUNT);
+    EXPECT_EQ(get_mutex(uid)->lock_count, 0);
+    EXPECT_EQ(workarea.get(mem)->lockCount, 0u);
+}
+
+// Run with --gtest_also_run_disabled_tests, prints the time of a lock and unlock pair
+TEST_F(lw_mutex, DISABLED_lock_unlock_benchmark) {
+    constexpr int LOCK_COUNT = 1000000;
+
+    const SceUID uid = create();
+    auto measure = [&](const char *name, int thread_count, auto &&lock_unlock) {
+        std::vector<SceUID> thread_ids;
+        for (int i = 0; i < thread_count; i++)
+            thread_ids.push_back(add_thread());
+
+        const auto start_time = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (const SceUID thread_id : thread_ids) {
+            threads.emplace_back([&, thread_id] {
+                for (int i = 0; i < LOCK_COUNT / thread_count; i++)
+                    lock_unlock(thread_id);
+            });
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+        const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+
+        std::cout << name << ": " << duration.count() / LOCK_COUNT << " ns per lock and unlock" << std::endl;
+    };
+
+    auto regular = [&](SceUID thread_id) {
+        mutex_lock(kernel, mem, "lock", thread_id, uid, 1, nullptr, SyncWeight::Light);
+        mutex_unlock(kernel, mem, "unlock", thread_id, uid, 1, SyncWeight::Light);
+    };
+    auto fast = [&](SceUID thread_id) {
+        lock(thread_id, uid);
+        unlock(thread_id, uid);
+    };
+
+    measure("uncontended, regular path", 1, regular);
+    measure("uncontended, fast path", 1, fast);
+    measure("4 threads, regular path", 4, regular);
+    measure("4 threads, fast path", 4, fast);
+}
@@ -20,12 +20,28 @@
 #include <cstdint>
 #include <vector>
 
+// A set bit is a free slot, the first slot of a word being its most significant bit
 struct BitmapAllocator {
     std::vector<std::uint32_t> words;
     std::size_t max_offset;
 
 protected:
+    // Free runs of a group of 64 words, used to skip the groups where an allocation can't start.
+    // The values are exact after any change made through this allocator. Allocating by writing directly to words
+    // only makes them too large, which costs a scan of the group but never hides a free run.
+    struct FreeRunGroup {
+        std::uint16_t prefix;
+        std::uint16_t suffix;
+        std::uint16_t longest;
+    };
+    std::vector<FreeRunGroup> groups;
+
     int force_fill(const std::uint32_t offset, const std::uint32_t size, const bool or_mode = false);
+    void rebuild_groups();
+    void update_groups(const std::size_t first_word, const std::size_t end_word);
+    bool may_fit_in_group(std::size_t group, const std::size_t size) const;
+    std::size_t find_free_slot(const std::size_t offset, const std::size_t size) const;
+    std::size_t find_used_slot(const std::size_t offset, const std::size_t limit) const;
 
 public:
     BitmapAllocator() = default;
@@ -47,7 +47,7 @@ constexpr MemPerm most_restrictive_perm(MemPerm a, MemPerm b) {
     return MemPerm::ReadWrite;
 }
 
-bool init(MemState &state, const bool use_page_table);
+bool init(MemState &state, const bool use_page_table, const bool use_huge_pages = false);
 void deinit_mem(MemState &state);
 Address alloc(MemState &state, uint32_t size, const char *name, Address start_addr = user_main_memory_start);
 Address alloc_aligned(MemState &state, uint32_t size, const char *name, unsigned int alignment, Address start_addr = user_main_memory_start);
@@ -67,4 +67,6 @@ Address alloc_at(MemState &state, Address address, uint32_t size, const char *na
 Address try_alloc_at(MemState &state, Address address, uint32_t size, const char *name);
 void free(MemState &state, Address address);
 uint32_t mem_available(MemState &state);
+// Amount of guest memory currently backed by host huge pages, in bytes
+size_t mem_huge_page_usage(const MemState &state);
 const char *mem_name(Address address, MemState &state);
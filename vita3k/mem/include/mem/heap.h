@@ -0,0 +1,98 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/util.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct MemState;
+
+struct GuestHeapStats {
+    uint64_t slab_count;
+    uint64_t small_count;
+    uint64_t small_bytes;
+    uint64_t large_count;
+    uint64_t large_bytes;
+    // free blocks kept in the slabs, ready to be reused
+    uint64_t cached_blocks;
+};
+
+struct GuestHeapThreadCache {
+    // 4 size classes per power of two, from 16 to 2048 bytes
+    static constexpr size_t SIZE_CLASS_COUNT = 24;
+
+    std::array<std::vector<Address>, SIZE_CLASS_COUNT> blocks;
+    // only written by the owning thread, a block freed by another thread is counted by that thread
+    std::atomic<int64_t> allocated_count = 0;
+    std::atomic<int64_t> allocated_bytes = 0;
+    // set when the owning thread exits, its blocks are then given back to the heap
+    std::atomic<bool> orphaned = false;
+};
+
+typedef std::shared_ptr<GuestHeapThreadCache> GuestHeapThreadCachePtr;
+
+/**
+ * @brief Guest heap used by the HLE malloc family
+ *
+ * Small allocations are carved from 64 KiB slabs, each slab holding a single size class. Every host thread
+ * keeps a cache of free blocks per size class, so most allocations and frees don't take any lock.
+ * Larger allocations are directly allocated in the guest memory.
+ */
+struct GuestHeap {
+    static constexpr uint32_t SLAB_SIZE = KiB(64);
+    static constexpr uint32_t MAX_SMALL_SIZE = 2048;
+
+    // Must be called before the first allocation, and again to drop every allocation when the memory is reset
+    void init();
+
+    Address allocate(MemState &mem, uint32_t size);
+    Address allocate_aligned(MemState &mem, uint32_t size, uint32_t alignment);
+    void deallocate(MemState &mem, Address addr);
+    // Returns 0 for an address not allocated by this heap
+    uint32_t usable_size(Address addr);
+
+    GuestHeapStats get_stats();
+
+private:
+    GuestHeapThreadCache &get_thread_cache();
+    Address refill(MemState &mem, GuestHeapThreadCache &cache, size_t size_class);
+    void flush(GuestHeapThreadCache &cache, size_t size_class);
+    void collect_orphaned_caches();
+
+    // unique among all the heaps, identifies the thread caches belonging to this heap
+    uint64_t generation = 0;
+
+    // size class + 1 of the slab each 4 KiB page belongs to, 0 if the page is not part of a slab
+    std::unique_ptr<std::atomic<uint8_t>[]> page_classes;
+
+    std::mutex mutex;
+    std::array<std::vector<Address>, GuestHeapThreadCache::SIZE_CLASS_COUNT> free_blocks;
+    std::vector<GuestHeapThreadCachePtr> thread_caches;
+    std::map<Address, uint32_t> large_allocations;
+    uint64_t slab_count = 0;
+    uint64_t slab_blocks = 0;
+    // counters of the thread caches which were collected
+    int64_t retired_count = 0;
+    int64_t retired_bytes = 0;
+};
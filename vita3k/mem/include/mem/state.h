@@ -19,8 +19,10 @@
 
 #include <mem/allocator.h>
 #include <mem/functions.h>
+#include <mem/heap.h>
 #include <mem/util.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -37,6 +39,8 @@ typedef std::unique_ptr<uint8_t[], std::function<void(uint8_t *)>> Memory;
 typedef std::unique_ptr<AllocMemPage[]> AllocPageTable;
 typedef std::unique_ptr<PagePtr[]> PageTable;
 typedef std::map<int, std::string> PageNameMap;
+// one entry per host page, see host_page_perm
+typedef std::unique_ptr<std::atomic<uint8_t>[]> HostPagePermTable;
 
 struct ProtectBlockInfo {
     uint32_t size = 0;
@@ -67,10 +71,15 @@ struct MemState {
     std::mutex protect_mutex;
 
     uint32_t host_page_size = 0;
+    bool use_huge_pages = false;
     Memory memory;
     AllocPageTable alloc_table;
     BitmapAllocator allocator;
     ProtectSegmentTrees protect_tree;
+    GuestHeap heap;
+    // Last permission applied to each host page by protect_inner/unprotect_inner (stored as perm + 1), 0 if the page
+    // protection is not handled by them. Can be read without holding protect_mutex.
+    HostPagePermTable host_page_perm;
 
     PageNameMap page_name_map;
 
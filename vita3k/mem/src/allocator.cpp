@@ -17,9 +17,16 @@
 
 #include <mem/allocator.h>
 
+#include <algorithm>
+#include <bit>
+
+constexpr std::size_t NO_SLOT = static_cast<std::size_t>(-1);
+constexpr std::size_t GROUP_WORDS = 64;
+
 BitmapAllocator::BitmapAllocator(const std::size_t total_bits)
     : words((total_bits >> 5) + ((total_bits % 32 != 0) ? 1 : 0), 0xFFFFFFFF)
     , max_offset(total_bits) {
+    rebuild_groups();
 }
 
 void BitmapAllocator::set_maximum(const std::size_t total_bits) {
@@ -35,14 +42,122 @@ void BitmapAllocator::set_maximum(const std::size_t total_bits) {
     }
 
     max_offset = total_bits;
+    rebuild_groups();
 }
 
 void BitmapAllocator::reset() {
     words.clear();
+    groups.clear();
+}
+
+void BitmapAllocator::rebuild_groups() {
+    groups.assign((words.size() + GROUP_WORDS - 1) / GROUP_WORDS, {});
+    update_groups(0, words.size());
+}
+
+static std::uint32_t longest_run_in_word(std::uint32_t value) {
+    std::uint32_t length = 0;
+    while (value != 0) {
+        value &= value << 1;
+        length++;
+    }
+    return length;
+}
+
+void BitmapAllocator::update_groups(const std::size_t first_word, const std::size_t end_word) {
+    if (first_word >= end_word)
+        return;
+
+    for (std::size_t group = first_word / GROUP_WORDS; group <= (end_word - 1) / GROUP_WORDS; group++) {
+        const std::size_t group_end = std::min(words.size(), (group + 1) * GROUP_WORDS);
+        std::uint32_t prefix = 0;
+        std::uint32_t run = 0;
+        std::uint32_t longest = 0;
+        bool in_prefix = true;
+
+        for (std::size_t word = group * GROUP_WORDS; word < group_end; word++) {
+            const std::uint32_t value = words[word];
+            if (value == 0xFFFFFFFFU) {
+                run += 32;
+                continue;
+            }
+
+            run += std::countl_one(value);
+            if (in_prefix) {
+                prefix = run;
+                in_prefix = false;
+            }
+            longest = std::max({ longest, run, longest_run_in_word(value) });
+            run = std::countr_one(value);
+        }
+
+        if (in_prefix)
+            prefix = run;
+        longest = std::max(longest, run);
+        groups[group] = { static_cast<std::uint16_t>(prefix), static_cast<std::uint16_t>(run), static_cast<std::uint16_t>(longest) };
+    }
+}
+
+bool BitmapAllocator::may_fit_in_group(std::size_t group, const std::size_t size) const {
+    const FreeRunGroup &info = groups[group];
+    if (info.longest >= size)
+        return true;
+    if (info.suffix == 0)
+        return false;
+
+    // the run at the end of the group continues in the next ones
+    std::size_t length = info.suffix;
+    for (group++; group < groups.size() && length < size; group++) {
+        length += groups[group].prefix;
+        if (groups[group].prefix != GROUP_WORDS * 32)
+            break;
+    }
+
+    return length >= size;
+}
+
+// Returns the first free slot at or after offset where an allocation of the given size may start
+std::size_t BitmapAllocator::find_free_slot(const std::size_t offset, const std::size_t size) const {
+    for (std::size_t group = offset / (GROUP_WORDS * 32); group < groups.size(); group++) {
+        if (!may_fit_in_group(group, size))
+            continue;
+
+        const std::size_t start = std::max(offset, group * GROUP_WORDS * 32);
+        const std::size_t end_word = std::min(words.size(), (group + 1) * GROUP_WORDS);
+        std::size_t word = start >> 5;
+        std::uint32_t bits = words[word] & (0xFFFFFFFFU >> (start & 31));
+        while (true) {
+            if (bits != 0)
+                return (word << 5) + std::countl_zero(bits);
+            if (++word >= end_word)
+                break;
+            bits = words[word];
+        }
+    }
+
+    return NO_SLOT;
+}
+
+// Returns the first allocated slot at or after offset, or any value >= limit if there is none before it
+std::size_t BitmapAllocator::find_used_slot(const std::size_t offset, const std::size_t limit) const {
+    std::size_t word = offset >> 5;
+    const std::uint32_t first_bits = ~words[word] & (0xFFFFFFFFU >> (offset & 31));
+    if (first_bits != 0)
+        return (word << 5) + std::countl_zero(first_bits);
+
+    const std::size_t end_word = std::max(word + 1, std::min(words.size(), (limit + 31) >> 5));
+    const auto it = std::find_if(words.begin() + word + 1, words.begin() + end_word, [](const std::uint32_t value) {
+        return value != 0xFFFFFFFFU;
+    });
+    if (it == words.begin() + end_word)
+        return end_word << 5;
+
+    return ((it - words.begin()) << 5) + std::countl_one(*it);
 }
 
 int BitmapAllocator::force_fill(const std::uint32_t offset, const std::uint32_t size, const bool or_mode) {
-    std::uint32_t *word = &words[0] + (offset >> 5);
+    const std::size_t first_word = offset >> 5;
+    std::uint32_t *word = &words[0] + first_word;
     const std::uint32_t set_bit = offset & 31;
     std::uint32_t end_bit = set_bit + size;
 
@@ -58,6 +173,7 @@ int BitmapAllocator::force_fill(const std::uint32_t offset, const std::uint32_t
             *word = wval & (~mask);
         }
 
+        update_groups(first_word, first_word + 1);
         return std::min<int>(size, (words.size() << 5) - set_bit);
     }
 
@@ -86,6 +202,7 @@ int BitmapAllocator::force_fill(const std::uint32_t offset, const std::uint32_t
         }
     }
 
+    update_groups(first_word, word - words.data());
     return std::min<int>(size, (words.size() << 5) - set_bit);
 }
 
@@ -102,76 +219,39 @@ int BitmapAllocator::allocate_from(const std::uint32_t start_offset, std::uint32
         return -1;
     }
 
-    std::uint32_t *word = &words[0] + (start_offset >> 5);
-
-    // We have arrived at le word that still have free position (bit 1)
-    std::uint32_t *word_end = &words[words.size() - 1];
-
-    int bflmin = 0xFFFFFF;
-    int bofmin = -1;
-    std::uint32_t *wordmin = nullptr;
-
-    // Keep finding
-    while (word <= word_end) {
-        std::uint32_t wv = *word;
-
-        if (wv != 0) {
-            // Still have free stuff
-            int bflen = 0;
-            int boff = 0;
-            std::uint32_t *bword = nullptr;
-
-            int cursor = 31;
-
-            while (cursor >= 0) {
-                if (((wv >> cursor) & 1) == 1) {
-                    boff = cursor;
-                    bflen = 0;
-                    bword = word;
-
-                    while (cursor >= 0 && (((wv >> cursor) & 1) == 1)) {
-                        bflen++;
-                        cursor--;
-
-                        if (cursor < 0 && (word + 1 <= word_end)) {
-                            cursor = 31;
-                            word++;
-                            wv = *word;
-                        }
-                    }
-
-                    if (bflen >= size) {
-                        if (!best_fit) {
-                            // Force allocate and then return
-                            const int offset = static_cast<int>(31 - boff + ((bword - &words[0]) << 5));
-                            if ((static_cast<std::size_t>(offset) + size) <= max_offset) {
-                                size = force_fill(static_cast<const std::uint32_t>(offset), size, false);
-                                return offset;
-                            }
-                        } else {
-                            if (bflen < bflmin) {
-                                bflmin = bflen;
-                                bofmin = boff;
-                                wordmin = bword;
-                            }
-                        }
-                    }
-                }
-
-                cursor--;
+    std::size_t best_offset = NO_SLOT;
+    std::size_t best_length = NO_SLOT;
+
+    // Go from one free run to the next, skipping the groups of words which can't hold the allocation
+    std::size_t offset = find_free_slot(start_offset, size);
+    while (offset < max_offset) {
+        // for first fit, there is no need to know the length of the run past the requested size
+        const std::size_t limit = best_fit ? max_offset : offset + size;
+        const std::size_t run_end = std::min(find_used_slot(offset, limit), max_offset);
+        const std::size_t length = run_end - offset;
+
+        if (length >= size) {
+            if (!best_fit) {
+                size = force_fill(static_cast<std::uint32_t>(offset), size, false);
+                return static_cast<int>(offset);
+            }
+
+            if (length < best_length) {
+                best_offset = offset;
+                best_length = length;
+                if (length == size)
+                    break;
             }
         }
 
-        word++;
+        if (run_end >= max_offset)
+            break;
+        offset = find_free_slot(run_end, size);
     }
 
-    if (best_fit && bofmin != -1) {
-        // Force allocate and then return
-        const int offset = static_cast<int>(31 - bofmin + ((wordmin - &words[0]) << 5));
-        if ((static_cast<std::size_t>(offset) + size) <= max_offset) {
-            size = force_fill(static_cast<std::uint32_t>(offset), size, false);
-            return offset;
-        }
+    if (best_offset != NO_SLOT) {
+        size = force_fill(static_cast<std::uint32_t>(best_offset), size, false);
+        return static_cast<int>(best_offset);
     }
 
     return -1;
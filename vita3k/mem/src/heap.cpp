@@ -0,0 +1,268 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <mem/heap.h>
+
+#include <mem/functions.h>
+#include <mem/state.h>
+
+#include <algorithm>
+#include <bit>
+
+constexpr uint32_t HEAP_PAGE_SIZE = KiB(4);
+constexpr size_t HEAP_PAGE_COUNT = GiB(4) / HEAP_PAGE_SIZE;
+
+static constexpr std::array<uint32_t, GuestHeapThreadCache::SIZE_CLASS_COUNT> size_classes = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024,
+    1280, 1536, 1792, 2048
+};
+
+static std::atomic<uint64_t> next_generation = 1;
+
+// Keeps the cache of the current thread alive and marks it as orphaned once the thread exits
+struct GuestHeapThreadCacheHandle {
+    uint64_t generation = 0;
+    GuestHeapThreadCachePtr cache;
+
+    ~GuestHeapThreadCacheHandle() {
+        if (cache)
+            cache->orphaned.store(true, std::memory_order_release);
+    }
+};
+
+static thread_local GuestHeapThreadCacheHandle thread_cache_handle;
+
+static size_t get_size_class(uint32_t size) {
+    if (size <= 128)
+        return size == 0 ? 0 : (size - 1) / 16;
+
+    // above 128 bytes, the two bits following the most significant one select the class inside the power of two
+    const uint32_t last_byte = size - 1;
+    const uint32_t msb = std::bit_width(last_byte) - 1;
+    return 8 + (msb - 7) * 4 + ((last_byte >> (msb - 2)) & 3);
+}
+
+// a thread keeps around 8 KiB of free blocks per size class
+static size_t get_cache_capacity(size_t size_class) {
+    return std::clamp<size_t>(KiB(8) / size_classes[size_class], 4, 64);
+}
+
+// the counters of a cache are only written by their owner thread, so they don't need an atomic read-modify-write
+static void add_to_counter(std::atomic<int64_t> &counter, int64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void GuestHeap::init() {
+    const std::lock_guard<std::mutex> guard(mutex);
+    generation = next_generation++;
+
+    if (page_classes) {
+        for (size_t page = 0; page < HEAP_PAGE_COUNT; page++)
+            page_classes[page].store(0, std::memory_order_relaxed);
+    } else {
+        page_classes = std::make_unique<std::atomic<uint8_t>[]>(HEAP_PAGE_COUNT);
+    }
+
+    for (auto &blocks : free_blocks)
+        blocks.clear();
+    thread_caches.clear();
+    large_allocations.clear();
+    slab_count = 0;
+    slab_blocks = 0;
+    retired_count = 0;
+    retired_bytes = 0;
+}
+
+GuestHeapThreadCache &GuestHeap::get_thread_cache() {
+    GuestHeapThreadCacheHandle &handle = thread_cache_handle;
+    if (handle.generation == generation)
+        return *handle.cache;
+
+    // the previous cache of this thread belongs to another heap, or to a previous run of this one
+    if (handle.cache)
+        handle.cache->orphaned.store(true, std::memory_order_release);
+
+    handle.cache = std::make_shared<GuestHeapThreadCache>();
+    handle.generation = generation;
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    thread_caches.push_back(handle.cache);
+    return *handle.cache;
+}
+
+void GuestHeap::collect_orphaned_caches() {
+    std::erase_if(thread_caches, [&](const GuestHeapThreadCachePtr &cache) {
+        if (!cache->orphaned.load(std::memory_order_acquire))
+            return false;
+
+        for (size_t size_class = 0; size_class < GuestHeapThreadCache::SIZE_CLASS_COUNT; size_class++) {
+            const auto &blocks = cache->blocks[size_class];
+            free_blocks[size_class].insert(free_blocks[size_class].end(), blocks.begin(), blocks.end());
+        }
+        retired_count += cache->allocated_count.load(std::memory_order_relaxed);
+        retired_bytes += cache->allocated_bytes.load(std::memory_order_relaxed);
+        return true;
+    });
+}
+
+Address GuestHeap::refill(MemState &mem, GuestHeapThreadCache &cache, size_t size_class) {
+    const std::lock_guard<std::mutex> guard(mutex);
+    auto &central_blocks = free_blocks[size_class];
+    if (central_blocks.empty())
+        collect_orphaned_caches();
+
+    if (central_blocks.empty()) {
+        const Address slab = alloc(mem, SLAB_SIZE, "malloc slab");
+        if (!slab)
+            return 0;
+
+        for (uint32_t page = 0; page < SLAB_SIZE / HEAP_PAGE_SIZE; page++)
+            page_classes[slab / HEAP_PAGE_SIZE + page].store(static_cast<uint8_t>(size_class + 1), std::memory_order_relaxed);
+
+        // pushed in reverse so the blocks are handed out in increasing address order
+        const uint32_t block_size = size_classes[size_class];
+        const uint32_t nb_blocks = SLAB_SIZE / block_size;
+        for (uint32_t block = nb_blocks; block > 0; block--)
+            central_blocks.push_back(slab + (block - 1) * block_size);
+
+        slab_count++;
+        slab_blocks += nb_blocks;
+    }
+
+    const size_t count = std::min(central_blocks.size(), get_cache_capacity(size_class) / 2 + 1);
+    auto &blocks = cache.blocks[size_class];
+    blocks.insert(blocks.end(), central_blocks.end() - count, central_blocks.end());
+    central_blocks.resize(central_blocks.size() - count);
+
+    const Address addr = blocks.back();
+    blocks.pop_back();
+    return addr;
+}
+
+void GuestHeap::flush(GuestHeapThreadCache &cache, size_t size_class) {
+    // give back the half of the cache which was freed first
+    auto &blocks = cache.blocks[size_class];
+    const size_t count = blocks.size() / 2;
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    free_blocks[size_class].insert(free_blocks[size_class].end(), blocks.begin(), blocks.begin() + count);
+    blocks.erase(blocks.begin(), blocks.begin() + count);
+}
+
+Address GuestHeap::allocate(MemState &mem, uint32_t size) {
+    if (size > MAX_SMALL_SIZE) {
+        const Address addr = alloc(mem, size, "malloc");
+        if (addr) {
+            const std::lock_guard<std::mutex> guard(mutex);
+            large_allocations[addr] = size;
+        }
+        return addr;
+    }
+
+    GuestHeapThreadCache &cache = get_thread_cache();
+    const size_t size_class = get_size_class(size);
+    auto &blocks = cache.blocks[size_class];
+
+    Address addr = 0;
+    if (blocks.empty()) {
+        addr = refill(mem, cache, size_class);
+        if (!addr)
+            return 0;
+    } else {
+        addr = blocks.back();
+        blocks.pop_back();
+    }
+
+    add_to_counter(cache.allocated_count, 1);
+    add_to_counter(cache.allocated_bytes, size_classes[size_class]);
+    return addr;
+}
+
+Address GuestHeap::allocate_aligned(MemState &mem, uint32_t size, uint32_t alignment) {
+    // all the blocks of the slabs are 16 bytes aligned
+    if (alignment <= 16)
+        return allocate(mem, size);
+
+    const Address addr = alloc_aligned(mem, size, "memalign", alignment);
+    if (addr) {
+        const std::lock_guard<std::mutex> guard(mutex);
+        large_allocations[addr] = size;
+    }
+    return addr;
+}
+
+void GuestHeap::deallocate(MemState &mem, Address addr) {
+    if (!addr)
+        return;
+
+    const uint8_t page_class = page_classes[addr / HEAP_PAGE_SIZE].load(std::memory_order_relaxed);
+    if (page_class == 0) {
+        {
+            const std::lock_guard<std::mutex> guard(mutex);
+            large_allocations.erase(addr);
+        }
+        free(mem, addr);
+        return;
+    }
+
+    GuestHeapThreadCache &cache = get_thread_cache();
+    const size_t size_class = page_class - 1;
+    auto &blocks = cache.blocks[size_class];
+    blocks.push_back(addr);
+
+    add_to_counter(cache.allocated_count, -1);
+    add_to_counter(cache.allocated_bytes, -static_cast<int64_t>(size_classes[size_class]));
+
+    if (blocks.size() > get_cache_capacity(size_class))
+        flush(cache, size_class);
+}
+
+uint32_t GuestHeap::usable_size(Address addr) {
+    const uint8_t page_class = page_classes[addr / HEAP_PAGE_SIZE].load(std::memory_order_relaxed);
+    if (page_class != 0)
+        return size_classes[page_class - 1];
+
+    const std::lock_guard<std::mutex> guard(mutex);
+    const auto it = large_allocations.find(addr);
+    return it != large_allocations.end() ? it->second : 0;
+}
+
+GuestHeapStats GuestHeap::get_stats() {
+    const std::lock_guard<std::mutex> guard(mutex);
+    collect_orphaned_caches();
+
+    int64_t small_count = retired_count;
+    int64_t small_bytes = retired_bytes;
+    for (const auto &cache : thread_caches) {
+        small_count += cache->allocated_count.load(std::memory_order_relaxed);
+        small_bytes += cache->allocated_bytes.load(std::memory_order_relaxed);
+    }
+
+    GuestHeapStats stats{};
+    stats.slab_count = slab_count;
+    stats.small_count = static_cast<uint64_t>(small_count);
+    stats.small_bytes = static_cast<uint64_t>(small_bytes);
+    stats.large_count = large_allocations.size();
+    for (const auto &[_, size] : large_allocations)
+        stats.large_bytes += size;
+    stats.cached_blocks = slab_blocks - stats.small_count;
+
+    return stats;
+}
@@ -23,7 +23,10 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cinttypes>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <mutex>
 #include <utility>
 
@@ -49,6 +52,20 @@ constexpr bool PAGE_NAME_TRACKING = true;
 static AccessViolationHandler access_violation_handler;
 static void register_access_violation_handler(const AccessViolationHandler &handler);
 
+// value of host_page_perm for the pages whose protection is not handled by protect_inner/unprotect_inner
+constexpr uint8_t UNTRACKED_HOST_PAGE = 0;
+
+static uint8_t tracked_host_page(const MemPerm perm) {
+    return static_cast<uint8_t>(perm) + 1;
+}
+
+static void set_host_page_perm(MemState &state, Address addr, size_t size, const uint8_t value) {
+    const size_t first_page = addr / state.host_page_size;
+    const size_t end_page = (addr + size + state.host_page_size - 1) / state.host_page_size;
+    for (size_t page = first_page; page < end_page; page++)
+        state.host_page_perm[page].store(value, std::memory_order_release);
+}
+
 static Address alloc_inner(MemState &state, uint32_t start_page, uint32_t page_count, const char *name, const bool force);
 static void delete_memory(uint8_t *memory);
 
@@ -62,7 +79,7 @@ static std::string get_error_msg() {
 }
 #endif
 
-bool init(MemState &state, const bool use_page_table) {
+bool init(MemState &state, const bool use_page_table, const bool use_huge_pages) {
 #ifdef _WIN32
     SYSTEM_INFO system_info = {};
     GetSystemInfo(&system_info);
@@ -100,12 +117,28 @@ bool init(MemState &state, const bool use_page_table) {
     }
 #endif
 
+    if (use_huge_pages) {
+#ifdef MADV_HUGEPAGE
+        // let the kernel back the committed ranges with transparent huge pages, a huge page gets split
+        // back into regular pages as soon as part of it is protected or freed, so this doesn't change the protection granularity
+        if (madvise(state.memory.get(), TOTAL_MEM_SIZE, MADV_HUGEPAGE) == 0)
+            state.use_huge_pages = true;
+        else
+            LOG_WARN("Failed to enable huge pages for the guest memory: {}", get_error_msg());
+#else
+        LOG_WARN("Huge pages are not supported on this platform");
+#endif
+    }
+
     const size_t table_length = TOTAL_MEM_SIZE / STANDARD_PAGE_SIZE;
     state.alloc_table = AllocPageTable(new AllocMemPage[table_length]);
     memset(state.alloc_table.get(), 0, sizeof(AllocMemPage) * table_length);
 
     state.allocator.set_maximum(table_length);
 
+    state.host_page_perm = std::make_unique<std::atomic<uint8_t>[]>(TOTAL_MEM_SIZE / state.host_page_size);
+    state.heap.init();
+
     const auto handler = [&state](uint8_t *addr, bool write) noexcept {
         return handle_access_violation(state, addr, write);
     };
@@ -183,6 +216,7 @@ static Address alloc_inner(MemState &state, uint32_t start_page, uint32_t page_c
     const int ret = mprotect(commit_ptr, commit_size, PROT_READ | PROT_WRITE);
     LOG_CRITICAL_IF(ret == -1, "mprotect failed: {}", get_error_msg());
 #endif
+    set_host_page_perm(state, commit_start, commit_size, UNTRACKED_HOST_PAGE);
     std::memset(&state.memory[addr], 0, size);
 
     AllocMemPage &page = state.alloc_table[page_num];
@@ -247,6 +281,8 @@ void unprotect_inner(MemState &state, Address addr, uint32_t size) {
     const int ret = mprotect(aligned_start, aligned_size, PROT_READ | PROT_WRITE);
     LOG_CRITICAL_IF(ret == -1, "mprotect failed: {}", get_error_msg());
 #endif
+
+    set_host_page_perm(state, addr, size, tracked_host_page(MemPerm::ReadWrite));
 }
 
 void protect_inner(MemState &state, Address addr, uint32_t size, const MemPerm perm) {
@@ -266,6 +302,34 @@ void protect_inner(MemState &state, Address addr, uint32_t size, const MemPerm p
     const int ret = mprotect(aligned_start, aligned_size, (perm == MemPerm::None) ? PROT_NONE : ((perm == MemPerm::ReadOnly) ? PROT_READ : (PROT_READ | PROT_WRITE)));
     LOG_CRITICAL_IF(ret == -1, "mprotect failed: {}", get_error_msg());
 #endif
+
+    set_host_page_perm(state, addr, size, tracked_host_page(perm));
+}
+
+// Same as protect_inner, but skip the host pages which already have the given permission
+static void protect_changed_inner(MemState &state, Address addr, uint32_t size, const MemPerm perm) {
+    const uint8_t value = tracked_host_page(perm);
+    const size_t first_page = addr / state.host_page_size;
+    const size_t end_page = (static_cast<size_t>(addr) + size + state.host_page_size - 1) / state.host_page_size;
+
+    size_t run_start = first_page;
+    for (size_t page = first_page; page <= end_page; page++) {
+        if (page < end_page && state.host_page_perm[page].load(std::memory_order_relaxed) != value)
+            continue;
+
+        if (run_start < page)
+            protect_inner(state, static_cast<Address>(run_start * state.host_page_size), static_cast<uint32_t>((page - run_start) * state.host_page_size), perm);
+        run_start = page + 1;
+    }
+}
+
+static bool is_host_page_accessible(const MemState &state, Address addr, bool write) {
+    const uint8_t value = state.host_page_perm[addr / state.host_page_size].load(std::memory_order_acquire);
+    if (value == UNTRACKED_HOST_PAGE)
+        return false;
+
+    const MemPerm perm = static_cast<MemPerm>(value - 1);
+    return perm != MemPerm::None && (!write || perm != MemPerm::ReadOnly);
 }
 
 bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcept {
@@ -273,9 +337,10 @@ bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcep
     const uintptr_t fault_addr = reinterpret_cast<uintptr_t>(addr);
 
     Address vaddr = 0;
-    const std::unique_lock<std::mutex> lock(state.protect_mutex);
+    std::unique_lock<std::mutex> lock(state.protect_mutex, std::defer_lock);
     if (fault_addr < memory_addr || fault_addr >= memory_addr + TOTAL_MEM_SIZE) {
         if (state.use_page_table) {
+            lock.lock();
             // this may come from an external mapping
             uint64_t addr_val = std::bit_cast<uint64_t>(addr);
             auto it = state.external_mapping.lower_bound(addr_val);
@@ -294,6 +359,19 @@ bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcep
     if (!is_valid_addr(state, vaddr)) {
         return false;
     }
+
+    // when several threads access the same protected page, all of them fault but only the first one has to
+    // run the callbacks, the other ones only have to retry the access once the page has been unprotected
+    if (is_host_page_accessible(state, vaddr, write)) {
+        return true;
+    }
+    if (!lock.owns_lock()) {
+        lock.lock();
+        if (is_host_page_accessible(state, vaddr, write)) {
+            return true;
+        }
+    }
+
     if (LOG_PROTECT) {
         fmt::print("Access: {}\n", log_hex(vaddr));
     }
@@ -360,7 +438,8 @@ bool add_protect(MemState &state, Address addr, const uint32_t size, const MemPe
         state.protect_tree.erase(it--);
     }
 
-    protect_inner(state, addr, protect.size, protect.perm);
+    // the pages of the segments merged into this one may already be protected
+    protect_changed_inner(state, addr, protect.size, protect.perm);
 
     state.protect_tree.emplace(addr, std::move(protect));
     return true;
@@ -526,6 +605,7 @@ void free(MemState &state, Address address) {
             ret = madvise(memory, batch_size, MADV_DONTNEED);
             LOG_CRITICAL_IF(ret == -1, "madvise failed: {}", get_error_msg());
 #endif
+            set_host_page_perm(state, batch_start, batch_size, UNTRACKED_HOST_PAGE);
             batch_size = 0;
         }
         host_page = host_page_end;
@@ -542,6 +622,7 @@ void free(MemState &state, Address address) {
         ret = madvise(memory, batch_size, MADV_DONTNEED);
         LOG_CRITICAL_IF(ret == -1, "madvise failed: {}", get_error_msg());
 #endif
+        set_host_page_perm(state, batch_start, batch_size, UNTRACKED_HOST_PAGE);
     }
 }
 
@@ -549,6 +630,32 @@ uint32_t mem_available(MemState &state) {
     return state.allocator.free_slot_count(0, state.allocator.max_offset) * STANDARD_PAGE_SIZE;
 }
 
+size_t mem_huge_page_usage(const MemState &state) {
+    if (!state.use_huge_pages)
+        return 0;
+
+    size_t usage = 0;
+#ifdef __linux__
+    // the kernel only exposes this per mapping, sum it over the mappings inside the guest memory
+    std::ifstream smaps("/proc/self/smaps");
+    const uintptr_t memory_start = reinterpret_cast<uintptr_t>(state.memory.get());
+    const uintptr_t memory_end = memory_start + TOTAL_MEM_SIZE;
+    bool in_guest_memory = false;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        uintptr_t start = 0;
+        uintptr_t end = 0;
+        size_t size_kb = 0;
+        if (std::sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR, &start, &end) == 2)
+            in_guest_memory = start >= memory_start && end <= memory_end;
+        else if (in_guest_memory && std::sscanf(line.c_str(), "AnonHugePages: %zu kB", &size_kb) == 1)
+            usage += size_kb * KiB(1);
+    }
+#endif
+
+    return usage;
+}
+
 const char *mem_name(Address address, MemState &state) {
     if (PAGE_NAME_TRACKING) {
         return state.page_name_map.find(address / STANDARD_PAGE_SIZE)->second.c_str();
@@ -559,6 +666,9 @@ const char *mem_name(Address address, MemState &state) {
 void deinit_mem(MemState &state) {
     const std::lock_guard<std::mutex> gen_lock(state.generation_mutex);
 
+    if (state.use_huge_pages)
+        LOG_INFO("{} MiB of guest memory were backed by huge pages", mem_huge_page_usage(state) / MiB(1));
+
     {
         const std::lock_guard<std::mutex> prot_lock(state.protect_mutex);
         state.protect_tree.clear();
@@ -566,11 +676,13 @@ void deinit_mem(MemState &state) {
 
     state.memory.reset();
     state.alloc_table.reset();
+    state.host_page_perm.reset();
     state.allocator.reset();
     state.page_name_map.clear();
     state.page_table.reset();
     state.external_mapping.clear();
     state.use_page_table = false;
+    state.use_huge_pages = false;
     state.host_page_size = 0;
 }
 
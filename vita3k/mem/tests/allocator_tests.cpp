@@ -21,6 +21,11 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
 TEST(bitmap_allocator, one_bit_allocation) {
     BitmapAllocator allocator(KiB(5));
 
@@ -151,6 +156,62 @@ TEST(bitmap_allocator, battle_test) {
     }
 }
 
+// Allocation/free churn on an allocator the size of the guest memory in pages, half filled with small fragmented blocks.
+// Like the other benchmarks, it is disabled and only runs with --gtest_also_run_disabled_tests
+TEST(bitmap_allocator, DISABLED_churn_benchmark) {
+    constexpr int MEM_SIZE = GiB(4) / KiB(4);
+    constexpr int OPERATION_COUNT = 200000;
+    constexpr int MAX_MEM_CHUNK_SIZE = 64;
+
+    BitmapAllocator allocator(MEM_SIZE);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<uint32_t> size_dist(1, MAX_MEM_CHUNK_SIZE);
+
+    struct Page {
+        int n;
+        uint32_t size;
+    };
+    std::vector<Page> pages;
+
+    int tracked_size = MEM_SIZE;
+    while (tracked_size > MEM_SIZE / 2) {
+        uint32_t size = size_dist(rng);
+        const int offset = allocator.allocate_from(0, size, false);
+        ASSERT_GE(offset, 0);
+        pages.push_back({ offset, size });
+        tracked_size -= size;
+    }
+
+    // free every other block to fragment the bitmap
+    for (size_t i = 0; i < pages.size(); i += 2) {
+        allocator.free(pages[i].n, pages[i].size);
+        tracked_size += pages[i].size;
+        pages[i] = pages.back();
+        pages.pop_back();
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < OPERATION_COUNT; ++i) {
+        std::uniform_int_distribution<size_t> page_dist(0, pages.size() - 1);
+        const size_t index = page_dist(rng);
+        allocator.free(pages[index].n, pages[index].size);
+        tracked_size += pages[index].size;
+        pages[index] = pages.back();
+        pages.pop_back();
+
+        uint32_t size = size_dist(rng);
+        const int offset = allocator.allocate_from(0, size, i % 16 == 0);
+        ASSERT_GE(offset, 0);
+        pages.push_back({ offset, size });
+        tracked_size -= size;
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+
+    ASSERT_EQ(allocator.free_slot_count(0, MEM_SIZE), tracked_size);
+    std::cout << OPERATION_COUNT << " free/allocate pairs in " << duration.count() / 1000 << " ms ("
+              << duration.count() * 1000 / OPERATION_COUNT << " ns per pair)" << std::endl;
+}
+
 // These tests are from EKA2L1 (https://github.com/EKA2L1/EKA2L1/blob/4fbd057da2a0c4f66a5c0f9dfc406c5d90f7531f/src/tests/common/allocator.cpp)
 TEST(bitmap_allocator, no_best_fit_only_one_fit) {
     BitmapAllocator alloc(32);
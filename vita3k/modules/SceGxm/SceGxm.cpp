@@ -980,6 +980,8 @@ typedef std::set<CommandListRange>::iterator RangeIterator;
 
 struct SceGxmCommandList {
     renderer::CommandList *list;
+    // the blocks of the context arena holding the commands of this list
+    renderer::CommandArena::Blocks command_blocks;
 
     // the locations on the vita memory that correspond to this command list
     // this part is not copied in the command list given to the game by endCommandList
@@ -1014,6 +1016,7 @@ struct SceGxmContext {
     Ptr<uint8_t> alloc_space_start{};
     std::set<CommandListRange> command_list_ranges;
     SceGxmCommandList *curr_command_list = nullptr;
+    renderer::CommandArena command_arena;
 
     // tell if a call to set_texture must be made
     gxp::TextureInfo is_vert_texture_dirty;
@@ -1034,17 +1037,15 @@ struct SceGxmContext {
         assert(command_list->list);
 
         // command list has been overwritten, free the memory
-        // everything except the command_list except was allocated using malloc
+        // the commands are given back to the arena, along with the command list itself
         renderer::Command *cmd = command_list->list->first;
         while (cmd != command_list->list->last) {
             renderer::Command *next = cmd->next;
             renderer::destroy_command_payload(*cmd);
-            free(cmd);
             cmd = next;
         }
         renderer::destroy_command_payload(*cmd);
-        free(cmd);
-        free(command_list->list);
+        command_arena.release(command_list->command_blocks);
 
         // we also need to delete all ranges occupied by this list
         while (!command_list->memory_ranges.empty()) {
@@ -1138,30 +1139,40 @@ struct SceGxmContext {
         return true;
     }
 
-    std::uint8_t *linearly_allocate(KernelState &kern, const MemState &mem, const SceUID thread_id, const std::uint32_t size) {
+    // allocate 4 bytes in the vdm memory to make it look like the vdm buffer is getting used
+    // otherwise we would never know when to free our command lists
+    bool reserve_vdm_space(KernelState &kern, const MemState &mem, const SceUID thread_id) {
         if (state.type != SCE_GXM_CONTEXT_TYPE_DEFERRED) {
-            return nullptr;
+            return false;
         }
 
-        // allocate 4 bytes in the vdm memory to make it look like the vdm buffer is getting used
-        // otherwise we would never know when to free our command lists
         constexpr uint32_t allocated_on_vdm = 4;
 
         if (alloc_space.address() + allocated_on_vdm > alloc_space_end.address()) {
             if (!make_new_alloc_space(kern, mem, thread_id, true)) {
-                return nullptr;
+                return false;
             }
         }
 
         alloc_space = alloc_space + allocated_on_vdm;
+        return true;
+    }
+
+    std::uint8_t *linearly_allocate(KernelState &kern, const MemState &mem, const SceUID thread_id, const std::uint32_t size) {
+        if (!reserve_vdm_space(kern, mem, thread_id)) {
+            return nullptr;
+        }
 
         // the data returned is not part of the vita memory (our commands are too big and do not fit)
-        return static_cast<uint8_t *>(malloc(size));
+        // it is kept with the commands being recorded, and freed along them
+        return static_cast<uint8_t *>(command_arena.allocate_data(size));
     }
 
     template <typename T>
     T *linearly_allocate(KernelState &kern, const MemState &mem, const SceUID thread_id) {
-        return reinterpret_cast<T *>(linearly_allocate(kern, mem, thread_id, sizeof(T)));
+        static_assert(std::is_trivially_destructible_v<T>, "the arena blocks are reused without destroying their content");
+        uint8_t *data = linearly_allocate(kern, mem, thread_id, sizeof(T));
+        return data ? new (data) T : nullptr;
     }
 
     renderer::Command *allocate_new_command(KernelState &kern, const MemState &mem, SceUID current_thread_id) {
@@ -1178,9 +1189,12 @@ struct SceGxmContext {
                 new_command->flags |= renderer::Command::FLAG_FROM_HOST;
             }
         } else {
-            new_command = linearly_allocate<renderer::Command>(kern, mem, current_thread_id);
+            if (!reserve_vdm_space(kern, mem, current_thread_id)) {
+                return nullptr;
+            }
 
-            new (new_command) renderer::Command;
+            // the commands of a deferred context are freed with their command list
+            new_command = command_arena.allocate();
             new_command->flags |= renderer::Command::FLAG_NO_FREE;
         }
 
@@ -1214,16 +1228,17 @@ static void destroy_pending_immediate_commands(SceGxmContext *context) {
     renderer::reset_command_list(context->renderer->command_list);
 }
 
-static void destroy_pending_deferred_command_chain(renderer::CommandList &command_list) {
-    renderer::Command *cmd = command_list.first;
+static void destroy_pending_deferred_command_chain(SceGxmContext *context) {
+    renderer::Command *cmd = context->renderer->command_list.first;
     while (cmd) {
         renderer::Command *next = cmd->next;
         renderer::destroy_command_payload(*cmd);
-        free(cmd);
         cmd = next;
     }
 
-    renderer::reset_command_list(command_list);
+    auto blocks = context->command_arena.take_blocks();
+    context->command_arena.release(blocks);
+    renderer::reset_command_list(context->renderer->command_list);
 }
 
 static void destroy_pending_deferred_commands(SceGxmContext *context) {
@@ -1237,7 +1252,7 @@ static void destroy_pending_deferred_commands(SceGxmContext *context) {
         context->curr_command_list = nullptr;
     }
 
-    destroy_pending_deferred_command_chain(context->renderer->command_list);
+    destroy_pending_deferred_command_chain(context);
 
     while (!context->command_list_ranges.empty())
         context->free_command_list(context->command_list_ranges.begin()->command_list);
@@ -2283,6 +2298,13 @@ EXPORT(int, sceGxmDisplayQueueFinish) {
     return 0;
 }
 
+static void gxmSetTexture(EmuEnvState &emuenv, SceGxmContext *context, const uint32_t index, const SceGxmTexture &texture) {
+    renderer::set_texture(*emuenv.renderer, context->renderer.get(), index, texture);
+    // a deferred command list can be executed long after being recorded, only prefetch the textures drawn right away
+    if (context->state.type == SCE_GXM_CONTEXT_TYPE_IMMEDIATE)
+        renderer::prefetch_texture(*emuenv.renderer, texture, emuenv.mem);
+}
+
 static void gxmSetUniformBuffers(renderer::State &state, GxmState &gxm, SceGxmContext *context, const SceGxmProgram &program, std::span<UniformBuffer> buffers, const UniformBufferSizes &sizes, const MemState &mem) {
     for (size_t i = 0; i < buffers.size(); i++) {
         if (!buffers[i] || sizes.at(i) == 0) {
@@ -2360,11 +2382,11 @@ static int gxmDrawElementGeneral(EmuEnvState &emuenv, const char *export_name, c
     for (uint16_t texture_index = 0; texture_index < SCE_GXM_MAX_TEXTURE_UNITS; texture_index++) {
         if (vert_textures_sync[texture_index]) {
             const uint16_t index_position = SCE_GXM_MAX_TEXTURE_UNITS + texture_index;
-            renderer::set_texture(*emuenv.renderer, context->renderer.get(), index_position, textures[index_position]);
+            gxmSetTexture(emuenv, context, index_position, textures[index_position]);
         }
 
         if (frag_textures_sync[texture_index])
-            renderer::set_texture(*emuenv.renderer, context->renderer.get(), texture_index, textures[texture_index]);
+            gxmSetTexture(emuenv, context, texture_index, textures[texture_index]);
     }
 
     // Update vertex data. We should stores a copy of the data to pass it to GPU later, since another scene
@@ -2513,11 +2535,11 @@ EXPORT(int, sceGxmDrawPrecomputed, SceGxmContext *context, SceGxmPrecomputedDraw
     for (uint16_t texture_index = 0; texture_index < SCE_GXM_MAX_TEXTURE_UNITS; texture_index++) {
         if (vert_textures_sync[texture_index]) {
             const uint16_t index_position = SCE_GXM_MAX_TEXTURE_UNITS + texture_index;
-            renderer::set_texture(*emuenv.renderer, context->renderer.get(), index_position, vert_textures[texture_index]);
+            gxmSetTexture(emuenv, context, index_position, vert_textures[texture_index]);
         }
 
         if (frag_textures_sync[texture_index])
-            renderer::set_texture(*emuenv.renderer, context->renderer.get(), texture_index, frag_textures[texture_index]);
+            gxmSetTexture(emuenv, context, texture_index, frag_textures[texture_index]);
     }
 
     size_t max_data_length[SCE_GXM_MAX_VERTEX_STREAMS] = {};
@@ -2584,6 +2606,7 @@ EXPORT(int, sceGxmEndCommandList, SceGxmContext *deferredContext, SceGxmCommandL
 
     // also update our own command list
     deferredContext->curr_command_list->list = commandList->list;
+    deferredContext->curr_command_list->command_blocks = deferredContext->command_arena.take_blocks();
 
     *commandList->list = deferredContext->renderer->command_list;
 
@@ -2852,7 +2875,7 @@ EXPORT(int, sceGxmInitialize, const SceGxmInitializeParams *params) {
     // also, the last frame won't be in the queue so decrease the count by 1
     // the case where displayQueueMaxPendingCount is 1 handled in sceGxmDisplayQueueAddEntry
     const uint32_t max_queue_size = std::max(std::min(params->displayQueueMaxPendingCount, 3U) - 1, 1U);
-    emuenv.gxm.display_queue.maxPendingCount_ = max_queue_size;
+    emuenv.gxm.display_queue.set_capacity(max_queue_size);
 
     const ThreadStatePtr main_thread = emuenv.kernel.get_thread(thread_id);
     const ThreadStatePtr display_queue_thread = emuenv.kernel.create_thread(emuenv.mem, "SceGxmDisplayQueue", Ptr<void>(0), SCE_KERNEL_HIGHEST_PRIORITY_USER, SCE_KERNEL_THREAD_CPU_AFFINITY_MASK_DEFAULT, SCE_KERNEL_STACK_SIZE_USER_DEFAULT, nullptr);
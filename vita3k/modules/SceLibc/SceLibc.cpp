@@ -26,6 +26,8 @@
 #include <dlmalloc.h>
 #include <v3kprintf.h>
 
+#include <limits>
+
 TRACY_MODULE_NAME(SceLibc);
 
 EXPORT(int, _Assert) {
@@ -332,9 +334,17 @@ EXPORT(int, c32rtomb) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, calloc) {
-    TRACY_FUNC(calloc);
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, calloc, SceSize num, SceSize size) {
+    TRACY_FUNC(calloc, num, size);
+    const uint64_t total_size = static_cast<uint64_t>(num) * size;
+    if (total_size > std::numeric_limits<uint32_t>::max())
+        return Ptr<void>();
+
+    const Address address = emuenv.mem.heap.allocate(emuenv.mem, static_cast<uint32_t>(total_size));
+    if (address)
+        memset(Ptr<uint8_t>(address).get(emuenv.mem), 0, total_size);
+
+    return Ptr<void>(address);
 }
 
 EXPORT(int, clearerr) {
@@ -475,7 +485,7 @@ EXPORT(int, fread) {
 
 EXPORT(void, free, Address mem) {
     TRACY_FUNC(free, mem);
-    free(emuenv.mem, mem);
+    emuenv.mem.heap.deallocate(emuenv.mem, mem);
 }
 
 EXPORT(int, freopen) {
@@ -766,12 +776,14 @@ EXPORT(int, longjmp) {
 
 EXPORT(int, malloc, SceSize size) {
     TRACY_FUNC(malloc, size);
-    return alloc(emuenv.mem, size, __FUNCTION__);
+    return emuenv.mem.heap.allocate(emuenv.mem, size);
 }
 
-EXPORT(int, malloc_stats) {
+EXPORT(void, malloc_stats) {
     TRACY_FUNC(malloc_stats);
-    return UNIMPLEMENTED();
+    const GuestHeapStats stats = emuenv.mem.heap.get_stats();
+    LOG_INFO("malloc: {} slabs, {} small allocations ({} bytes), {} large allocations ({} bytes), {} free blocks in the slabs",
+        stats.slab_count, stats.small_count, stats.small_bytes, stats.large_count, stats.large_bytes, stats.cached_blocks);
 }
 
 EXPORT(int, malloc_stats_fast) {
@@ -779,9 +791,9 @@ EXPORT(int, malloc_stats_fast) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, malloc_usable_size) {
-    TRACY_FUNC(malloc_usable_size);
-    return UNIMPLEMENTED();
+EXPORT(SceSize, malloc_usable_size, Address mem) {
+    TRACY_FUNC(malloc_usable_size, mem);
+    return emuenv.mem.heap.usable_size(mem);
 }
 
 EXPORT(int, mblen) {
@@ -841,7 +853,7 @@ EXPORT(int, mbtowc) {
 
 EXPORT(Ptr<void>, memalign, uint32_t alignment, uint32_t size) {
     TRACY_FUNC(memalign, alignment, size);
-    Address address = alloc_aligned(emuenv.mem, size, "memalign", alignment);
+    Address address = emuenv.mem.heap.allocate_aligned(emuenv.mem, size, alignment);
 
     return Ptr<void>(address);
 }
@@ -1038,9 +1050,26 @@ EXPORT(int, rand_r) {
     return UNIMPLEMENTED();
 }
 
-EXPORT(int, realloc) {
-    TRACY_FUNC(realloc);
-    return UNIMPLEMENTED();
+EXPORT(Ptr<void>, realloc, Address mem, SceSize size) {
+    TRACY_FUNC(realloc, mem, size);
+    if (!mem)
+        return Ptr<void>(emuenv.mem.heap.allocate(emuenv.mem, size));
+
+    const uint32_t old_size = emuenv.mem.heap.usable_size(mem);
+    if (old_size == 0) {
+        LOG_ERROR("realloc called on unknown address {}", log_hex(mem));
+        return Ptr<void>();
+    }
+    if (size <= old_size)
+        return Ptr<void>(mem);
+
+    const Address address = emuenv.mem.heap.allocate(emuenv.mem, size);
+    if (!address)
+        return Ptr<void>();
+
+    memcpy(Ptr<uint8_t>(address).get(emuenv.mem), Ptr<uint8_t>(mem).get(emuenv.mem), old_size);
+    emuenv.mem.heap.deallocate(emuenv.mem, mem);
+    return Ptr<void>(address);
 }
 
 EXPORT(int, reallocalign) {
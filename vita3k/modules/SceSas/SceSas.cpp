@@ -17,134 +17,502 @@
 
 #include <module/module.h>
 
-EXPORT(int, sceSasCore) {
-    return UNIMPLEMENTED();
+#include <mem/functions.h>
+#include <sas/functions.h>
+#include <util/tracy.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+TRACY_MODULE_NAME(SceSas);
+
+enum SceSasErrorCode : uint32_t {
+    SCE_SAS_ERROR_INVALID_GRAIN = 0x80420001,
+    SCE_SAS_ERROR_INVALID_MAX_VOICES = 0x80420002,
+    SCE_SAS_ERROR_INVALID_OUTPUT_MODE = 0x80420003,
+    SCE_SAS_ERROR_INVALID_SAMPLE_RATE = 0x80420004,
+    SCE_SAS_ERROR_BAD_ADDRESS = 0x80420005,
+    SCE_SAS_ERROR_INVALID_VOICE_INDEX = 0x80420010,
+    SCE_SAS_ERROR_INVALID_NOISE_CLOCK = 0x80420011,
+    SCE_SAS_ERROR_INVALID_PITCH = 0x80420012,
+    SCE_SAS_ERROR_INVALID_ADSR_CURVE = 0x80420013,
+    SCE_SAS_ERROR_INVALID_ADPCM_SIZE = 0x80420014,
+    SCE_SAS_ERROR_INVALID_LOOP_POS = 0x80420015,
+    SCE_SAS_ERROR_VOICE_PAUSED = 0x80420016,
+    SCE_SAS_ERROR_INVALID_VOLUME = 0x80420018,
+    SCE_SAS_ERROR_INVALID_ADSR_RATE = 0x80420019,
+    SCE_SAS_ERROR_INVALID_PCM_SIZE = 0x8042001A,
+    SCE_SAS_ERROR_REV_INVALID_TYPE = 0x80420020,
+    SCE_SAS_ERROR_REV_INVALID_FEEDBACK = 0x80420021,
+    SCE_SAS_ERROR_REV_INVALID_DELAY_TIME = 0x80420022,
+    SCE_SAS_ERROR_REV_INVALID_VOLUME = 0x80420023,
+    SCE_SAS_ERROR_NOT_INIT = 0x80420100,
+    SCE_SAS_ERROR_ALREADY_INIT = 0x80420101,
+};
+
+enum SceSasAdsrFlag : uint32_t {
+    SCE_SAS_ATTACK_VALID = 1,
+    SCE_SAS_DECAY_VALID = 2,
+    SCE_SAS_SUSTAIN_VALID = 4,
+    SCE_SAS_RELEASE_VALID = 8,
+};
+
+// 0 if the voice can be used
+static uint32_t check_voice(const sas::State &state, SceInt32 voice) {
+    if (!state.initialized)
+        return SCE_SAS_ERROR_NOT_INIT;
+    if (voice < 0 || static_cast<uint32_t>(voice) >= state.voices.size())
+        return SCE_SAS_ERROR_INVALID_VOICE_INDEX;
+
+    return 0;
+}
+
+// the voices keep reading the samples after the call, the whole range must be mapped
+static bool is_guest_range_valid(const MemState &mem, Address address, uint64_t size) {
+    const uint64_t end = static_cast<uint64_t>(address) + size;
+    return end <= std::numeric_limits<Address>::max() && is_valid_addr_range(mem, address, static_cast<Address>(end));
+}
+
+static bool is_volume_valid(SceInt32 volume) {
+    return std::abs(volume) <= sas::MAX_VOLUME;
+}
+
+static float get_volume(SceInt32 volume) {
+    return static_cast<float>(volume) / sas::MAX_VOLUME;
+}
+
+static uint32_t check_config(const sas::Config &config) {
+    if (config.grain < sas::MIN_GRAIN || config.grain > sas::MAX_GRAIN)
+        return SCE_SAS_ERROR_INVALID_GRAIN;
+    if (config.voice_count == 0 || config.voice_count > sas::MAX_VOICES)
+        return SCE_SAS_ERROR_INVALID_MAX_VOICES;
+
+    return 0;
+}
+
+static int init_sas(EmuEnvState &emuenv, const char *export_name, const char *config_text, const SceUInt32 *grain, Ptr<void> buffer, SceSize buffer_size) {
+    sas::Config config;
+    if (!sas::parse_config(config_text, config))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_MAX_VOICES);
+    if (grain)
+        config.grain = *grain;
+    if (const uint32_t error = check_config(config))
+        return RET_ERROR(error);
+    if (!buffer || buffer_size < sas::get_needed_memory_size(config))
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_ALREADY_INIT);
+
+    sas::init(emuenv.sas, config, buffer, buffer_size);
+    return 0;
+}
+
+EXPORT(int, sceSasCore, SceInt16 *out) {
+    TRACY_FUNC(sceSasCore, out);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (!out)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+
+    sas::render(emuenv.sas, out);
+    return 0;
 }
 
-EXPORT(int, sceSasCoreWithMix) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasCoreWithMix, SceInt16 *in_out, SceInt32 left_volume, SceInt32 right_volume) {
+    TRACY_FUNC(sceSasCoreWithMix, in_out, left_volume, right_volume);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (!in_out)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+    if (!is_volume_valid(left_volume) || !is_volume_valid(right_volume))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_VOLUME);
+
+    const float volume[2] = { get_volume(left_volume), get_volume(right_volume) };
+    sas::render_with_mix(emuenv.sas, in_out, volume);
+    return 0;
 }
 
-EXPORT(int, sceSasExit) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasExit, Ptr<void> *out_buffer, SceSize *out_buffer_size) {
+    TRACY_FUNC(sceSasExit, out_buffer, out_buffer_size);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
 
-EXPORT(int, sceSasGetDryPeak) {
-    return UNIMPLEMENTED();
-}
+    if (out_buffer)
+        *out_buffer = emuenv.sas.buffer;
+    if (out_buffer_size)
+        *out_buffer_size = emuenv.sas.buffer_size;
 
-EXPORT(int, sceSasGetEndState) {
-    return UNIMPLEMENTED();
+    sas::exit(emuenv.sas);
+    return 0;
 }
 
-EXPORT(int, sceSasGetEnvelope) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetDryPeak, SceInt32 *peak) {
+    TRACY_FUNC(sceSasGetDryPeak, peak);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (!peak)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
 
-EXPORT(int, sceSasGetGrain) {
-    return UNIMPLEMENTED();
+    *peak = std::max(emuenv.sas.dry_peak[0], emuenv.sas.dry_peak[1]);
+    return 0;
 }
 
-EXPORT(int, sceSasGetNeededMemorySize) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetEndState, SceInt32 voice) {
+    TRACY_FUNC(sceSasGetEndState, voice);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
 
-EXPORT(int, sceSasGetOutputmode) {
-    return UNIMPLEMENTED();
+    return emuenv.sas.voices[voice].ended ? 1 : 0;
 }
 
-EXPORT(int, sceSasGetPauseState) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetEnvelope, SceInt32 voice) {
+    TRACY_FUNC(sceSasGetEnvelope, voice);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
 
-EXPORT(int, sceSasGetPreMasterPeak) {
-    return UNIMPLEMENTED();
+    return emuenv.sas.voices[voice].envelope.height;
 }
 
-EXPORT(int, sceSasGetWetPeak) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetGrain) {
+    TRACY_FUNC(sceSasGetGrain);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
 
-EXPORT(int, sceSasInit) {
-    return UNIMPLEMENTED();
+    return static_cast<int>(emuenv.sas.grain);
 }
 
-EXPORT(int, sceSasInitWithGrain) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetNeededMemorySize, const char *config_text, SceSize *out_size) {
+    TRACY_FUNC(sceSasGetNeededMemorySize, config_text, out_size);
+    if (!out_size)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
 
-EXPORT(int, sceSasSetADSR) {
-    return UNIMPLEMENTED();
-}
+    sas::Config config;
+    if (!sas::parse_config(config_text, config))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_MAX_VOICES);
+    if (const uint32_t error = check_config(config))
+        return RET_ERROR(error);
 
-EXPORT(int, sceSasSetADSRmode) {
-    return UNIMPLEMENTED();
+    *out_size = sas::get_needed_memory_size(config);
+    return 0;
 }
 
-EXPORT(int, sceSasSetDistortion) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetOutputmode) {
+    TRACY_FUNC(sceSasGetOutputmode);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
 
-EXPORT(int, sceSasSetEffect) {
-    return UNIMPLEMENTED();
+    return static_cast<int>(emuenv.sas.output_mode);
 }
 
-EXPORT(int, sceSasSetEffectParam) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetPauseState, SceInt32 voice) {
+    TRACY_FUNC(sceSasGetPauseState, voice);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
 
-EXPORT(int, sceSasSetEffectType) {
-    return UNIMPLEMENTED();
+    return emuenv.sas.voices[voice].paused ? 1 : 0;
 }
 
-EXPORT(int, sceSasSetEffectVolume) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetPreMasterPeak, SceInt32 *peak) {
+    TRACY_FUNC(sceSasGetPreMasterPeak, peak);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (!peak)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
 
-EXPORT(int, sceSasSetGrain) {
-    return UNIMPLEMENTED();
+    *peak = std::max(emuenv.sas.pre_master_peak[0], emuenv.sas.pre_master_peak[1]);
+    return 0;
 }
 
-EXPORT(int, sceSasSetKeyOff) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasGetWetPeak, SceInt32 *peak) {
+    TRACY_FUNC(sceSasGetWetPeak, peak);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (!peak)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
 
-EXPORT(int, sceSasSetKeyOn) {
-    return UNIMPLEMENTED();
+    *peak = std::max(emuenv.sas.wet_peak[0], emuenv.sas.wet_peak[1]);
+    return 0;
 }
 
-EXPORT(int, sceSasSetNoise) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasInit, const char *config_text, Ptr<void> buffer, SceSize buffer_size) {
+    TRACY_FUNC(sceSasInit, config_text, buffer, buffer_size);
+    return init_sas(emuenv, export_name, config_text, nullptr, buffer, buffer_size);
 }
 
-EXPORT(int, sceSasSetOutputmode) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasInitWithGrain, const char *config_text, SceUInt32 grain, Ptr<void> buffer, SceSize buffer_size) {
+    TRACY_FUNC(sceSasInitWithGrain, config_text, grain, buffer, buffer_size);
+    return init_sas(emuenv, export_name, config_text, &grain, buffer, buffer_size);
 }
 
-EXPORT(int, sceSasSetPause) {
-    return UNIMPLEMENTED();
-}
+EXPORT(int, sceSasSetADSR, SceInt32 voice, SceUInt32 flags, SceInt32 attack, SceInt32 decay, SceInt32 sustain, SceInt32 release) {
+    TRACY_FUNC(sceSasSetADSR, voice, flags, attack, decay, sustain, release);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (((flags & SCE_SAS_ATTACK_VALID) && attack < 0) || ((flags & SCE_SAS_DECAY_VALID) && decay < 0)
+        || ((flags & SCE_SAS_SUSTAIN_VALID) && sustain < 0) || ((flags & SCE_SAS_RELEASE_VALID) && release < 0))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_ADSR_RATE);
+
+    sas::Envelope &envelope = emuenv.sas.voices[voice].envelope;
+    if (flags & SCE_SAS_ATTACK_VALID)
+        envelope.attack_rate = attack;
+    if (flags & SCE_SAS_DECAY_VALID)
+        envelope.decay_rate = decay;
+    if (flags & SCE_SAS_SUSTAIN_VALID)
+        envelope.sustain_rate = sustain;
+    if (flags & SCE_SAS_RELEASE_VALID)
+        envelope.release_rate = release;
 
-EXPORT(int, sceSasSetPitch) {
-    return UNIMPLEMENTED();
-}
+    return 0;
+}
+
+EXPORT(int, sceSasSetADSRmode, SceInt32 voice, SceUInt32 flags, SceUInt32 attack, SceUInt32 decay, SceUInt32 sustain, SceUInt32 release) {
+    TRACY_FUNC(sceSasSetADSRmode, voice, flags, attack, decay, sustain, release);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (((flags & SCE_SAS_ATTACK_VALID) && attack >= sas::ENVELOPE_CURVE_COUNT) || ((flags & SCE_SAS_DECAY_VALID) && decay >= sas::ENVELOPE_CURVE_COUNT)
+        || ((flags & SCE_SAS_SUSTAIN_VALID) && sustain >= sas::ENVELOPE_CURVE_COUNT) || ((flags & SCE_SAS_RELEASE_VALID) && release >= sas::ENVELOPE_CURVE_COUNT))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_ADSR_CURVE);
+
+    sas::Envelope &envelope = emuenv.sas.voices[voice].envelope;
+    if (flags & SCE_SAS_ATTACK_VALID)
+        envelope.attack_curve = static_cast<sas::EnvelopeCurve>(attack);
+    if (flags & SCE_SAS_DECAY_VALID)
+        envelope.decay_curve = static_cast<sas::EnvelopeCurve>(decay);
+    if (flags & SCE_SAS_SUSTAIN_VALID)
+        envelope.sustain_curve = static_cast<sas::EnvelopeCurve>(sustain);
+    if (flags & SCE_SAS_RELEASE_VALID)
+        envelope.release_curve = static_cast<sas::EnvelopeCurve>(release);
 
-EXPORT(int, sceSasSetSL) {
-    return UNIMPLEMENTED();
+    return 0;
 }
 
-EXPORT(int, sceSasSetSimpleADSR) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasSetDistortion, SceInt32 voice, SceUInt32 distortion) {
+    TRACY_FUNC(sceSasSetDistortion, voice, distortion);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+
+    return STUBBED("distortion is not applied");
 }
 
-EXPORT(int, sceSasSetVoice) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasSetEffect, SceInt32 dry, SceInt32 wet) {
+    TRACY_FUNC(sceSasSetEffect, dry, wet);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+
+    emuenv.sas.effect.dry_enabled = dry != 0;
+    emuenv.sas.effect.wet_enabled = wet != 0;
+    return 0;
 }
 
-EXPORT(int, sceSasSetVoicePCM) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasSetEffectParam, SceUInt32 delay, SceUInt32 feedback) {
+    TRACY_FUNC(sceSasSetEffectParam, delay, feedback);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (delay > sas::EFFECT_PARAM_MAX)
+        return RET_ERROR(SCE_SAS_ERROR_REV_INVALID_DELAY_TIME);
+    if (feedback > sas::EFFECT_PARAM_MAX)
+        return RET_ERROR(SCE_SAS_ERROR_REV_INVALID_FEEDBACK);
+
+    sas::set_effect_param(emuenv.sas.effect, delay, feedback);
+    return 0;
 }
 
-EXPORT(int, sceSasSetVolume) {
-    return UNIMPLEMENTED();
+EXPORT(int, sceSasSetEffectType, SceInt32 type) {
+    TRACY_FUNC(sceSasSetEffectType, type);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (type < static_cast<SceInt32>(sas::EffectType::Off) || type > sas::EFFECT_TYPE_MAX)
+        return RET_ERROR(SCE_SAS_ERROR_REV_INVALID_TYPE);
+
+    sas::set_effect_type(emuenv.sas.effect, static_cast<sas::EffectType>(type));
+    return 0;
+}
+
+EXPORT(int, sceSasSetEffectVolume, SceInt32 left_volume, SceInt32 right_volume) {
+    TRACY_FUNC(sceSasSetEffectVolume, left_volume, right_volume);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (!is_volume_valid(left_volume) || !is_volume_valid(right_volume))
+        return RET_ERROR(SCE_SAS_ERROR_REV_INVALID_VOLUME);
+
+    emuenv.sas.effect.volume[0] = get_volume(left_volume);
+    emuenv.sas.effect.volume[1] = get_volume(right_volume);
+    return 0;
+}
+
+EXPORT(int, sceSasSetGrain, SceUInt32 grain) {
+    TRACY_FUNC(sceSasSetGrain, grain);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (grain < sas::MIN_GRAIN || grain > sas::MAX_GRAIN)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_GRAIN);
+
+    sas::set_grain(emuenv.sas, grain);
+    return 0;
+}
+
+EXPORT(int, sceSasSetKeyOff, SceInt32 voice) {
+    TRACY_FUNC(sceSasSetKeyOff, voice);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (emuenv.sas.voices[voice].paused)
+        return RET_ERROR(SCE_SAS_ERROR_VOICE_PAUSED);
+
+    sas::key_off(emuenv.sas.voices[voice]);
+    return 0;
+}
+
+EXPORT(int, sceSasSetKeyOn, SceInt32 voice) {
+    TRACY_FUNC(sceSasSetKeyOn, voice);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (emuenv.sas.voices[voice].paused)
+        return RET_ERROR(SCE_SAS_ERROR_VOICE_PAUSED);
+
+    sas::key_on(emuenv.sas.voices[voice]);
+    return 0;
+}
+
+EXPORT(int, sceSasSetNoise, SceInt32 voice, SceUInt32 clock) {
+    TRACY_FUNC(sceSasSetNoise, voice, clock);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (clock > sas::NOISE_CLOCK_MAX)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_NOISE_CLOCK);
+
+    sas::set_noise(emuenv.sas.voices[voice], clock);
+    return 0;
+}
+
+EXPORT(int, sceSasSetOutputmode, SceUInt32 mode) {
+    TRACY_FUNC(sceSasSetOutputmode, mode);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (!emuenv.sas.initialized)
+        return RET_ERROR(SCE_SAS_ERROR_NOT_INIT);
+    if (mode > static_cast<SceUInt32>(sas::OutputMode::Multichannel))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_OUTPUT_MODE);
+
+    emuenv.sas.output_mode = static_cast<sas::OutputMode>(mode);
+    return 0;
+}
+
+EXPORT(int, sceSasSetPause, SceInt32 voice, SceUInt32 pause) {
+    TRACY_FUNC(sceSasSetPause, voice, pause);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+
+    emuenv.sas.voices[voice].paused = pause != 0;
+    return 0;
+}
+
+EXPORT(int, sceSasSetPitch, SceInt32 voice, SceInt32 pitch) {
+    TRACY_FUNC(sceSasSetPitch, voice, pitch);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (pitch < sas::PITCH_MIN || pitch > sas::PITCH_MAX)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_PITCH);
+
+    emuenv.sas.voices[voice].pitch = pitch;
+    return 0;
+}
+
+EXPORT(int, sceSasSetSL, SceInt32 voice, SceUInt32 level) {
+    TRACY_FUNC(sceSasSetSL, voice, level);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (level > sas::ENVELOPE_HEIGHT_MAX)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_ADSR_RATE);
+
+    emuenv.sas.voices[voice].envelope.sustain_level = static_cast<int32_t>(level);
+    return 0;
+}
+
+EXPORT(int, sceSasSetSimpleADSR, SceInt32 voice, SceUInt32 adsr1, SceUInt32 adsr2) {
+    TRACY_FUNC(sceSasSetSimpleADSR, voice, adsr1, adsr2);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+
+    sas::set_simple_adsr(emuenv.sas.voices[voice].envelope, adsr1, adsr2);
+    return 0;
+}
+
+EXPORT(int, sceSasSetVoice, SceInt32 voice, Ptr<const uint8_t> vag, SceSize size, SceUInt32 loop) {
+    TRACY_FUNC(sceSasSetVoice, voice, vag, size, loop);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (!vag)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+    if (size == 0 || size % sas::VAG_BLOCK_SIZE != 0)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_ADPCM_SIZE);
+    if (loop > 1)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_LOOP_POS);
+    if (!is_guest_range_valid(emuenv.mem, vag.address(), size))
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+
+    sas::set_vag(emuenv.sas.voices[voice], vag.get(emuenv.mem), size, loop != 0);
+    return 0;
+}
+
+EXPORT(int, sceSasSetVoicePCM, SceInt32 voice, Ptr<const int16_t> pcm, SceSize sample_count, SceInt32 loop_position) {
+    TRACY_FUNC(sceSasSetVoicePCM, voice, pcm, sample_count, loop_position);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (!pcm)
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+    if (sample_count == 0)
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_PCM_SIZE);
+    if (loop_position >= static_cast<SceInt32>(sample_count))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_LOOP_POS);
+    if (!is_guest_range_valid(emuenv.mem, pcm.address(), static_cast<uint64_t>(sample_count) * sizeof(int16_t)))
+        return RET_ERROR(SCE_SAS_ERROR_BAD_ADDRESS);
+
+    sas::set_pcm(emuenv.sas.voices[voice], pcm.get(emuenv.mem), sample_count, loop_position);
+    return 0;
+}
+
+EXPORT(int, sceSasSetVolume, SceInt32 voice, SceInt32 left_volume, SceInt32 right_volume, SceInt32 wet_left_volume, SceInt32 wet_right_volume) {
+    TRACY_FUNC(sceSasSetVolume, voice, left_volume, right_volume, wet_left_volume, wet_right_volume);
+    const std::lock_guard<std::mutex> lock(emuenv.sas.mutex);
+    if (const uint32_t error = check_voice(emuenv.sas, voice))
+        return RET_ERROR(error);
+    if (!is_volume_valid(left_volume) || !is_volume_valid(right_volume) || !is_volume_valid(wet_left_volume) || !is_volume_valid(wet_right_volume))
+        return RET_ERROR(SCE_SAS_ERROR_INVALID_VOLUME);
+
+    sas::Voice &sas_voice = emuenv.sas.voices[voice];
+    sas_voice.dry_volume[0] = get_volume(left_volume);
+    sas_voice.dry_volume[1] = get_volume(right_volume);
+    sas_voice.wet_volume[0] = get_volume(wet_left_volume);
+    sas_voice.wet_volume[1] = get_volume(wet_right_volume);
+    return 0;
 }
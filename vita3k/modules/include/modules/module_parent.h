@@ -27,7 +27,10 @@ struct KernelState;
 
 void init_libraries(EmuEnvState &emuenv);
 void init_exported_vars(EmuEnvState &emuenv);
-void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t nid, SceUID thread_id);
+void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t svc, uint32_t nid, SceUID thread_id);
+// Called from inside the JIT, handles the hot imports which never block nor run guest code.
+// Returns false if the import must go through call_import.
+bool call_import_fast(EmuEnvState &emuenv, CPUState &cpu, uint32_t svc, SceUID thread_id);
 
 // Returns true if the NID has an HLE (C++) implementation in nids.inc.
 // Used to determine if an LLE export should be overridden with HLE dispatch.
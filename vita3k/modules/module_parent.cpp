@@ -28,15 +28,18 @@
 #include <io/vfs.h>
 #include <kernel/load_self.h>
 #include <kernel/state.h>
+#include <kernel/sync_primitives.h>
 #include <module/load_module.h>
 #include <nids/functions.h>
 #include <packages/license.h>
 #include <packages/sce_types.h>
+#include <util/arm.h>
 #include <util/find.h>
 #include <util/lock_and_find.h>
 #include <util/log.h>
 #include <util/string_utils.h>
 
+#include <chrono>
 #include <unordered_set>
 
 static constexpr bool LOG_UNK_NIDS_ALWAYS = false;
@@ -67,6 +70,38 @@ static const ImportFn *resolve_import(uint32_t nid) {
     }
 }
 
+// Indexed by the svc immediate of the import stubs (see import_index), 0 is used by the stubs dispatched by NID
+static const ImportFn *const import_table[] = {
+    nullptr,
+#define VAR_NID(name, nid)
+#define NID(name, nid) &import_##name,
+#include <nids/nids.inc>
+#undef NID
+#undef VAR_NID
+};
+
+// NID of each entry of import_table
+static constexpr uint32_t import_table_nids[] = {
+    0,
+#define VAR_NID(name, nid)
+#define NID(name, nid) nid,
+#include <nids/nids.inc>
+#undef NID
+#undef VAR_NID
+};
+
+// any code can use a svc, the immediate is only trusted when it comes from one of our stubs, which store the NID it was built from
+static bool is_indexed_stub(uint32_t svc, uint32_t nid) {
+    return svc != 0 && svc < std::size(import_table_nids) && import_table_nids[svc] == nid;
+}
+
+static const ImportFn *resolve_import(uint32_t svc, uint32_t nid) {
+    if (is_indexed_stub(svc, nid))
+        return import_table[svc];
+
+    return resolve_import(nid);
+}
+
 bool has_hle_implementation(uint32_t nid) {
     return resolve_import(nid) != nullptr;
 }
@@ -105,7 +140,7 @@ Ptr<void> create_vtable(const std::vector<uint32_t> &nids, MemState &mem) {
     for (uint32_t nid : nids) {
         *function_pointer = function_location;
         // encode svc call
-        function_svc[0] = 0xef000000; // svc #0 - Call our interrupt hook.
+        function_svc[0] = encode_arm_inst(INSTRUCTION_SYSCALL, import_index(nid), 0); // svc #index - Call our interrupt hook.
         function_svc[1] = 0xe1a0f00e; // mov pc, lr - Return to the caller.
         function_svc[2] = nid; // Our interrupt hook will read this.
 
@@ -149,7 +184,10 @@ static void log_import_call(char emulation_level, uint32_t nid, SceUID thread_id
     }
 }
 
-void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t nid, SceUID thread_id) {
+void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t svc, uint32_t nid, SceUID thread_id) {
+    if (!is_indexed_stub(svc, nid))
+        svc = 0;
+
     // HLE - call our C++ function
     if (emuenv.kernel.debugger.watch_import_calls) {
         const std::unordered_set<uint32_t> hle_nid_blacklist = {
@@ -160,9 +198,16 @@ void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t nid, SceUID thread
         auto lr = read_lr(cpu);
         log_import_call('H', nid, thread_id, hle_nid_blacklist, lr);
     }
-    const ImportFn *fn = resolve_import(nid);
+    const ImportFn *fn = resolve_import(svc, nid);
     if (fn) {
-        (*fn)(emuenv, cpu, thread_id);
+        if (emuenv.kernel.import_profiler.is_enabled()) {
+            const auto start = std::chrono::steady_clock::now();
+            (*fn)(emuenv, cpu, thread_id);
+            const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            emuenv.kernel.import_profiler.record(svc, nid, thread_id, duration.count());
+        } else {
+            (*fn)(emuenv, cpu, thread_id);
+        }
     } else {
         const ThreadStatePtr thread = emuenv.kernel.get_thread(thread_id);
         // make the function return 0
@@ -176,6 +221,55 @@ void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t nid, SceUID thread
     }
 }
 
+static bool lock_lw_mutex_fast(EmuEnvState &emuenv, CPUState &cpu, SceUID thread_id) {
+    // only take the mutex when it is free, waiting for it has to be done outside of the JIT
+    const Ptr<SceKernelLwMutexWork> workarea(read_reg(cpu, 0));
+    const int lock_count = static_cast<int>(read_reg(cpu, 1));
+    if (!lw_mutex_lock_fast(emuenv.kernel, emuenv.mem, thread_id, workarea, lock_count))
+        return false;
+
+    write_reg(cpu, 0, SCE_KERNEL_OK);
+    return true;
+}
+
+static bool call_import_fast_impl(EmuEnvState &emuenv, CPUState &cpu, uint32_t svc, SceUID thread_id) {
+    static const uint32_t svc_get_tls_addr = import_index(0xB295EB61); // sceKernelGetTLSAddr
+    static const uint32_t svc_get_thread_id = import_index(0x0FB972F9); // sceKernelGetThreadId
+    static const uint32_t svc_lock_lw_mutex = import_index(0x46E7BE7B); // sceKernelLockLwMutex
+    static const uint32_t svc_unlock_lw_mutex = import_index(0x91FA6614); // sceKernelUnlockLwMutex
+
+    // stubs dispatched by NID and traced calls always go through call_import
+    if (svc == 0 || emuenv.kernel.debugger.watch_import_calls)
+        return false;
+
+    // the pc is on the instruction after the svc, followed by the NID of the stub
+    const uint32_t nid = *Ptr<uint32_t>(read_pc(cpu) + 4).get(emuenv.mem);
+    if (!is_indexed_stub(svc, nid))
+        return false;
+
+    if (svc == svc_get_tls_addr || svc == svc_get_thread_id || svc == svc_unlock_lw_mutex) {
+        (*import_table[svc])(emuenv, cpu, thread_id);
+        return true;
+    }
+    if (svc == svc_lock_lw_mutex)
+        return lock_lw_mutex_fast(emuenv, cpu, thread_id);
+
+    return false;
+}
+
+bool call_import_fast(EmuEnvState &emuenv, CPUState &cpu, uint32_t svc, SceUID thread_id) {
+    if (!emuenv.kernel.import_profiler.is_enabled())
+        return call_import_fast_impl(emuenv, cpu, svc, thread_id);
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!call_import_fast_impl(emuenv, cpu, svc, thread_id))
+        return false;
+
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    emuenv.kernel.import_profiler.record(svc, 0, thread_id, duration.count());
+    return true;
+}
+
 struct SceKernelBootimageModules {
     Ptr<const char> path;
     Ptr<const void> data;
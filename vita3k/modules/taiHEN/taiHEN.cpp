@@ -160,9 +160,9 @@ static Address decode_lle_stub_target(const uint32_t *stub) {
     return (static_cast<Address>(hi) << 16) | lo;
 }
 
-// Check if a stub is an SVC (HLE) stub: svc #0; mov pc, lr; NID
+// Check if a stub is an SVC (HLE) stub: svc #index; mov pc, lr; NID
 static bool is_svc_stub(const uint32_t *stub) {
-    return stub[0] == 0xef000000 && stub[1] == 0xe1a0f00e;
+    return (stub[0] & 0xff000000) == 0xef000000 && stub[1] == 0xe1a0f00e;
 }
 
 // Find the import stub address for a given NID within a specific module
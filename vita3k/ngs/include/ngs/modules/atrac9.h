@@ -69,7 +69,6 @@ namespace ngs {
 
 struct Atrac9LogicalState : public ModuleLogicalState {
     PCMFrameQueue decoded_pcm;
-    // preserve enough recent resampler input to rebuild the swresample state later
     StereoRateResamplerLogicalState rate_resampler;
     std::vector<uint8_t> superframe_staging;
     // INTERNAL
@@ -82,16 +81,12 @@ struct Atrac9LogicalState : public ModuleLogicalState {
 
 struct Atrac9RuntimeState : public ModuleRuntimeState {
     std::unique_ptr<Atrac9DecoderState> decoder;
-    StereoRateResamplerRuntimeState rate_resampler;
     std::vector<uint8_t> decoded_superframe_samples;
     std::vector<uint8_t> temporary_bytes;
 };
 
 class Atrac9Module : public Module {
 private:
-    static SwrContext *swr_mono_to_stereo;
-    static SwrContext *swr_stereo;
-
     // return false if data could not be decoded (error or no more data available)
     bool decode_more_data(KernelState &kern, const MemState &mem, const SceUID thread_id, ModuleData &data, const SceNgsAT9Params *params, SceNgsAT9States *state, Atrac9LogicalState *logical, Atrac9RuntimeState *runtime, std::unique_lock<std::recursive_mutex> &scheduler_lock, std::unique_lock<std::mutex> &voice_lock);
 
@@ -102,9 +97,7 @@ public:
     std::unique_ptr<ModuleLogicalState> create_logical_state() const override;
     std::unique_ptr<ModuleRuntimeState> create_runtime_state() const override;
     void on_state_change(const MemState &mem, ModuleData &v, const VoiceState previous) override;
-    void on_param_change(const MemState &mem, ModuleData &data) override;
     void cleanup_voice_state(ModuleData &data) override;
-    static void free_swr_contexts();
 
     static constexpr uint32_t get_max_parameter_size() {
         return sizeof(SceNgsAT9Params);
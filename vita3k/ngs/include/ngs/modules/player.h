@@ -76,7 +76,6 @@ namespace ngs {
 
 struct PlayerLogicalState : public ModuleLogicalState {
     PCMFrameQueue decoded_pcm;
-    // preserve enough recent resampler input to rebuild the swresample state later
     StereoRateResamplerLogicalState rate_resampler;
     std::vector<uint8_t> adpcm_buffer;
     // INTERNAL
@@ -87,7 +86,6 @@ struct PlayerLogicalState : public ModuleLogicalState {
 
 struct PlayerRuntimeState : public ModuleRuntimeState {
     std::unique_ptr<PCMDecoderState> decoder;
-    StereoRateResamplerRuntimeState rate_resampler;
     std::vector<uint8_t> decoded_chunk;
 };
 
@@ -19,36 +19,41 @@
 
 #include <ngs/system.h>
 
-struct SwrContext;
+#include <cstdint>
+#include <vector>
 
 namespace ngs {
 
+/**
+ * State of a windowed sinc resampler of interleaved stereo float frames.
+ *
+ * The ratio between the rates can change at every call without any reset, only the input frames
+ * still needed by the filter and the position of the next output frame are kept between calls.
+ */
 struct StereoRateResamplerLogicalState {
-    PCMFrameQueue input_history;
-    bool needs_reset = false;
+    // input frames not entirely consumed yet, one channel after the other
+    std::vector<float> pending_left;
+    std::vector<float> pending_right;
+    // position of the next output frame in the pending frames, 32.32 fixed point
+    uint64_t position = 0;
+    // false until the silence preceding the first input frame has been added to the pending frames
+    bool primed = false;
 
     void clear() {
-        input_history.clear();
-        needs_reset = false;
+        pending_left.clear();
+        pending_right.clear();
+        position = 0;
+        primed = false;
     }
 
     void reset() {
-        input_history.clear();
-        needs_reset = true;
+        clear();
     }
 };
 
-struct StereoRateResamplerRuntimeState {
-    SwrContext *context = nullptr;
-    int source_rate = 0;
-    int dest_rate = 0;
-    std::vector<uint8_t> scratch_buffer;
-};
-
-void destroy_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime);
-bool ensure_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime, StereoRateResamplerLogicalState &logical,
-    int source_rate, int dest_rate);
-uint32_t process_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime, StereoRateResamplerLogicalState &logical,
+// Appends to output the input frames resampled from source_rate to dest_rate and returns the number of frames appended.
+// The last frames given are only output once enough frames follow them.
+uint32_t process_stereo_rate_resampler(StereoRateResamplerLogicalState &logical, double source_rate, int dest_rate,
     const uint8_t *input, uint32_t input_frames, PCMFrameQueue &output);
 
 } // namespace ngs
@@ -22,6 +22,9 @@
 #include <mem/ptr.h>
 
 #include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <queue>
 #include <vector>
 
@@ -65,8 +68,30 @@ struct VoiceScheduler {
     bool is_updating = false;
 
 protected:
+    struct WorkerCallback {
+        const std::function<void()> *func;
+        bool done = false;
+    };
+
+    // guest callbacks the worker threads wait for the updating thread to run
+    std::mutex workers_mutex;
+    std::condition_variable workers_cond;
+    std::vector<WorkerCallback *> worker_callbacks;
+
     void deque_insert(const MemState &mem, Voice *voice);
 
+    // Groups the voices by dependency level, keeping the queue order inside each level.
+    // A voice only receives data from voices of the previous levels.
+    std::vector<std::vector<Voice *>> split_in_levels(const MemState &mem, const std::vector<Voice *> &voice_queue);
+
+    // Return the id of the module which finished the voice, if any
+    std::optional<uint32_t> process_voice(KernelState &kern, const MemState &mem, const SceUID thread_id, Voice *voice, std::unique_lock<std::recursive_mutex> &scheduler_lock);
+    void process_voices_in_parallel(KernelState &kern, const MemState &mem, const SceUID thread_id, const std::vector<Voice *> &voices, std::vector<std::optional<uint32_t>> &results, std::unique_lock<std::recursive_mutex> &scheduler_lock);
+    // Handles the end of the voice and delivers its products, must be called on the updating thread
+    void finish_voice(KernelState &kern, const MemState &mem, const SceUID thread_id, const std::vector<Voice *> &voice_queue, Voice *voice, std::optional<uint32_t> finished_module, std::unique_lock<std::recursive_mutex> &scheduler_lock);
+    // Runs the callbacks requested by the workers, workers_lock must hold workers_mutex
+    void run_worker_callbacks(std::unique_lock<std::mutex> &workers_lock, std::unique_lock<std::recursive_mutex> &scheduler_lock);
+
     bool resort_to_respect_dependencies(const MemState &mem, Voice *source);
 
     std::int32_t get_position(Voice *v);
@@ -82,6 +107,11 @@ public:
 
     void update(KernelState &kern, const MemState &mem, const SceUID thread_id);
 
+    // true on the host threads processing voices for update, these can't run guest code
+    static bool is_worker_thread();
+    // Runs func on the thread calling update and returns once it is done, must be called from a worker thread
+    void run_on_update_thread(const std::function<void()> &func);
+
     Ptr<Patch> patch(const MemState &mem, SceNgsPatchSetupInfo *info);
 };
 } // namespace ngs
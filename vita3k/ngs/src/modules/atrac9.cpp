@@ -18,19 +18,13 @@
 #include <ngs/modules/atrac9.h>
 #include <util/log.h>
 
-extern "C" {
-#include <libswresample/swresample.h>
-}
-
 #include <cassert>
 #include <cmath>
 #include <cstring>
+#include <numbers>
 
 namespace ngs {
 
-SwrContext *Atrac9Module::swr_mono_to_stereo = nullptr;
-SwrContext *Atrac9Module::swr_stereo = nullptr;
-
 std::unique_ptr<ModuleLogicalState> Atrac9Module::create_logical_state() const {
     return std::make_unique<Atrac9LogicalState>();
 }
@@ -61,16 +55,6 @@ void Atrac9Module::on_state_change(const MemState &mem, ModuleData &data, const
     }
 }
 
-void Atrac9Module::on_param_change(const MemState &mem, ModuleData &data) {
-    Atrac9LogicalState *logical = data.get_logical_state<Atrac9LogicalState>();
-    const SceNgsAT9Params *old_params = reinterpret_cast<SceNgsAT9Params *>(data.last_info.data());
-    const SceNgsAT9Params *new_params = static_cast<SceNgsAT9Params *>(data.info.data.get(mem));
-
-    if (old_params->playback_frequency != new_params->playback_frequency || old_params->playback_scalar != new_params->playback_scalar) {
-        logical->rate_resampler.reset();
-    }
-}
-
 bool Atrac9Module::decode_more_data(KernelState &kern, const MemState &mem, const SceUID thread_id, ModuleData &data, const SceNgsAT9Params *params, SceNgsAT9States *state, Atrac9LogicalState *logical, Atrac9RuntimeState *runtime, std::unique_lock<std::recursive_mutex> &scheduler_lock, std::unique_lock<std::mutex> &voice_lock) {
     const SceNgsAT9BufferParams &bufparam = params->buffer_params[state->current_buffer];
 
@@ -209,41 +193,20 @@ bool Atrac9Module::decode_more_data(KernelState &kern, const MemState &mem, cons
         DecoderSize decoder_size;
         runtime->decoder->receive(runtime->temporary_bytes.data(), &decoder_size);
 
-        SwrContext *swr;
+        const int16_t *decoded_samples = reinterpret_cast<const int16_t *>(runtime->temporary_bytes.data());
+        float *converted_samples = reinterpret_cast<float *>(runtime->decoded_superframe_samples.data() + decoded_superframe_pos);
         if (channel_count == 1) {
-            if (!swr_mono_to_stereo) {
-                AVChannelLayout layout_mono = AV_CHANNEL_LAYOUT_MONO;
-                AVChannelLayout layout_stereo = AV_CHANNEL_LAYOUT_STEREO;
-
-                int ret = swr_alloc_set_opts2(&swr_mono_to_stereo,
-                    &layout_stereo, AV_SAMPLE_FMT_FLT, 480000,
-                    &layout_mono, AV_SAMPLE_FMT_S16, 480000,
-                    0, nullptr);
-                assert(ret == 0);
-                ret = swr_init(swr_mono_to_stereo);
-                assert(ret == 0);
+            // mono is played at -3 dB on both channels
+            constexpr float mono_scale = std::numbers::sqrt2_v<float> / 2.0f / 32768.0f;
+            for (uint32_t i = 0; i < decoder_size.samples; i++) {
+                converted_samples[i * 2] = decoded_samples[i] * mono_scale;
+                converted_samples[i * 2 + 1] = decoded_samples[i] * mono_scale;
             }
-
-            swr = swr_mono_to_stereo;
         } else {
-            if (!swr_stereo) {
-                AVChannelLayout layout_stereo = AV_CHANNEL_LAYOUT_STEREO;
-                int ret = swr_alloc_set_opts2(&swr_stereo,
-                    &layout_stereo, AV_SAMPLE_FMT_FLT, 480000,
-                    &layout_stereo, AV_SAMPLE_FMT_S16, 480000,
-                    0, nullptr);
-                assert(ret == 0);
-                ret = swr_init(swr_stereo);
-                assert(ret == 0);
-            }
-
-            swr = swr_stereo;
+            for (uint32_t i = 0; i < decoder_size.samples * 2; i++)
+                converted_samples[i] = decoded_samples[i] * (1.0f / 32768.0f);
         }
 
-        const uint8_t *swr_data_in = runtime->temporary_bytes.data();
-        uint8_t *swr_data_out = runtime->decoded_superframe_samples.data() + decoded_superframe_pos;
-        swr_convert(swr, &swr_data_out, decoder_size.samples, &swr_data_in, decoder_size.samples);
-
         decoded_superframe_pos += decoder_size.samples * sizeof(float) * 2;
         input += runtime->decoder->get_es_size();
         state->current_byte_position_in_buffer += runtime->decoder->get_es_size();
@@ -251,16 +214,13 @@ bool Atrac9Module::decode_more_data(KernelState &kern, const MemState &mem, cons
 
     const int32_t sample_rate = data.parent->rack->system->sample_rate;
     if (params->playback_scalar != 1 || static_cast<int>(std::round(params->playback_frequency)) != sample_rate) {
-        LOG_INFO_ONCE("The currently running game requests playback rate scaling when decoding audio. Audio might crackle.");
         double src_sample_rate = params->playback_frequency;
         if (params->playback_scalar != 1.0f) {
             src_sample_rate *= params->playback_scalar;
         }
 
-        ensure_stereo_rate_resampler(runtime->rate_resampler, logical->rate_resampler,
-            static_cast<int>(src_sample_rate), sample_rate);
         // sssume skipped samples happen before playback-rate scaling
-        decoded_size = process_stereo_rate_resampler(runtime->rate_resampler, logical->rate_resampler,
+        decoded_size = process_stereo_rate_resampler(logical->rate_resampler, src_sample_rate, sample_rate,
             runtime->decoded_superframe_samples.data() + decoded_start_offset * sizeof(float) * 2, decoded_size,
             logical->decoded_pcm);
 
@@ -336,21 +296,7 @@ bool Atrac9Module::process(KernelState &kern, const MemState &mem, const SceUID
     return is_finished;
 }
 
-void Atrac9Module::free_swr_contexts() {
-    if (swr_mono_to_stereo) {
-        swr_free(&swr_mono_to_stereo);
-        swr_mono_to_stereo = nullptr;
-    }
-    if (swr_stereo) {
-        swr_free(&swr_stereo);
-        swr_stereo = nullptr;
-    }
-}
-
 void Atrac9Module::cleanup_voice_state(ModuleData &data) {
-    if (auto *runtime = static_cast<Atrac9RuntimeState *>(data.runtime_state.get())) {
-        destroy_stereo_rate_resampler(runtime->rate_resampler);
-    }
     data.runtime_state.reset();
 }
 
@@ -82,12 +82,11 @@ void PlayerModule::on_param_change(const MemState &mem, ModuleData &data) {
         }
     }
 
-    // if playback scaling changed, reset the rate resampler
+    // if playback scaling changed, restart the HE-ADPCM prediction
+    // the rate resampler follows the new rate by itself
     if (old_params->playback_frequency != new_params->playback_frequency || old_params->playback_scalar != new_params->playback_scalar) {
         ADPCMHistory hist_empty{};
         std::fill_n(logical->adpcm_history, SCE_NGS_PLAYER_MAX_PCM_CHANNELS, hist_empty);
-
-        logical->rate_resampler.reset();
     }
 }
 
@@ -275,9 +274,7 @@ bool PlayerModule::process(KernelState &kern, const MemState &mem, const SceUID
                 src_sample_rate *= params->playback_scalar;
             }
 
-            ensure_stereo_rate_resampler(runtime->rate_resampler, logical->rate_resampler,
-                static_cast<int>(src_sample_rate), sample_rate);
-            process_stereo_rate_resampler(runtime->rate_resampler, logical->rate_resampler,
+            process_stereo_rate_resampler(logical->rate_resampler, src_sample_rate, sample_rate,
                 runtime->decoded_chunk.data(), samples_count.samples, logical->decoded_pcm);
 
         } else {
@@ -308,9 +305,6 @@ bool PlayerModule::process(KernelState &kern, const MemState &mem, const SceUID
 }
 
 void PlayerModule::cleanup_voice_state(ModuleData &data) {
-    if (auto *runtime = static_cast<PlayerRuntimeState *>(data.runtime_state.get())) {
-        destroy_stereo_rate_resampler(runtime->rate_resampler);
-    }
     data.runtime_state.reset();
 }
 
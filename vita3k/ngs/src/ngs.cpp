@@ -18,6 +18,7 @@
 #include <cpu/functions.h>
 #include <kernel/state.h>
 
+#include <dsp/dsp.h>
 #include <ngs/modules/atrac9.h>
 #include <ngs/state.h>
 #include <ngs/system.h>
@@ -97,12 +98,7 @@ int32_t VoiceInputManager::receive(const MemState &mem, ngs::Patch *patch, const
 
     // Try mixing, also with the use of this volume matrix
     // Dest is our voice to receive this data.
-    for (int32_t k = 0; k < dest->rack->system->granularity; k++) {
-        dest_buffer[k * 2] = std::clamp(dest_buffer[k * 2] + data_to_mix_in[k * 2] * volume_matrix[0][0]
-                + data_to_mix_in[k * 2 + 1] * volume_matrix[1][0],
-            -1.0f, 1.0f);
-        dest_buffer[k * 2 + 1] = std::clamp(dest_buffer[k * 2 + 1] + data_to_mix_in[k * 2] * volume_matrix[0][1] + data_to_mix_in[k * 2 + 1] * volume_matrix[1][1], -1.0f, 1.0f);
-    }
+    dsp::mix_stereo(dest_buffer, data_to_mix_in, volume_matrix, dest->rack->system->granularity);
 
     return 0;
 }
@@ -322,6 +318,15 @@ void Voice::invoke_callback(KernelState &kernel, const MemState &mem, const SceU
         return;
     }
 
+    VoiceScheduler &scheduler = rack->system->voice_scheduler;
+    if (scheduler.is_worker_thread()) {
+        // guest code must run on the guest thread, have it run the callback while this voice waits
+        scheduler.run_on_update_thread([&]() {
+            invoke_callback(kernel, mem, thread_id, callback, user_data, module_id, reason1, reason2, reason_ptr);
+        });
+        return;
+    }
+
     const ThreadStatePtr thread = kernel.get_thread(thread_id);
     const Address callback_info_addr = stack_alloc(*thread->cpu, sizeof(SceNgsCallbackInfo));
 
@@ -362,8 +367,6 @@ void deinit(State &ngs, MemState &mem) {
         release_system(ngs, mem, ngs.systems.back());
     }
 
-    Atrac9Module::free_swr_contexts();
-
     ngs.definitions = Ptr<VoiceDefinition>(0);
 }
 
@@ -15,181 +15,120 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <dsp/dsp.h>
 #include <ngs/rate_resampler.h>
-#include <util/log.h>
-
-extern "C" {
-#include <libavutil/channel_layout.h>
-#include <libavutil/samplefmt.h>
-#include <libswresample/swresample.h>
-}
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdint>
+#include <mutex>
+#include <numbers>
 
 namespace ngs {
 namespace {
-constexpr uint32_t stereo_channels = 2;
-constexpr uint32_t history_safety_margin_frames = 128;
-constexpr uint32_t history_compact_threshold_frames = 1024;
-
-bool create_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime, const int source_rate,
-    const int dest_rate) {
-    AVChannelLayout stereo = AV_CHANNEL_LAYOUT_STEREO;
-    const int alloc_result = swr_alloc_set_opts2(&runtime.context,
-        &stereo, AV_SAMPLE_FMT_FLT, dest_rate,
-        &stereo, AV_SAMPLE_FMT_FLT, source_rate,
-        0, nullptr);
-    if (alloc_result < 0) {
-        LOG_ERROR("Failed to allocate stereo rate SwrContext for {} -> {} Hz (error {}).",
-            source_rate, dest_rate, alloc_result);
-        runtime.context = nullptr;
-        return false;
-    }
-
-    const int init_result = swr_init(runtime.context);
-    if (init_result < 0) {
-        LOG_ERROR("Failed to initialize stereo rate SwrContext for {} -> {} Hz (error {}).",
-            source_rate, dest_rate, init_result);
-        swr_free(&runtime.context);
-        return false;
-    }
-
-    runtime.source_rate = source_rate;
-    runtime.dest_rate = dest_rate;
-    return true;
-}
-
-void compact_history_if_needed(StereoRateResamplerLogicalState &logical) {
-    if (logical.input_history.read_offset_frames == 0) {
-        return;
-    }
-
-    const uint32_t total_frames = logical.input_history.total_frames();
-    if (logical.input_history.read_offset_frames >= history_compact_threshold_frames
-        || logical.input_history.read_offset_frames >= (total_frames / 2)) {
-        logical.input_history.compact();
-    }
+constexpr uint32_t filter_taps = dsp::resampler_taps;
+// the filter is stored for this many positions between two input frames, the coefficients are interpolated in between
+constexpr uint32_t filter_phase_bits = 8;
+constexpr uint32_t filter_phases = 1 << filter_phase_bits;
+// when the source rate is the highest, the cutoff is lowered below the destination Nyquist frequency
+// to avoid aliasing, using the closest of these filters
+constexpr uint32_t filter_cutoff_steps = 16;
+// part of the band kept, the rest is for the transition band of the filter
+constexpr double filter_bandwidth = 0.9;
+
+// (filter_phases + 1) rows of filter_taps coefficients, the last row is only used for the interpolation
+using FilterTable = std::vector<float>;
+
+const FilterTable &get_filter_table(const uint32_t cutoff_step) {
+    static std::array<std::once_flag, filter_cutoff_steps> flags;
+    static std::array<FilterTable, filter_cutoff_steps> tables;
+
+    std::call_once(flags[cutoff_step], [cutoff_step]() {
+        const double cutoff = filter_bandwidth * (cutoff_step + 1) / filter_cutoff_steps;
+        constexpr double half_width = filter_taps / 2;
+
+        FilterTable &table = tables[cutoff_step];
+        table.resize((filter_phases + 1) * filter_taps);
+        for (uint32_t phase = 0; phase <= filter_phases; phase++) {
+            std::array<double, filter_taps> row;
+            double sum = 0.0;
+            for (uint32_t tap = 0; tap < filter_taps; tap++) {
+                // distance between the input frame of this tap and the output frame, which is between the two middle taps
+                const double t = tap - (half_width - 1) - static_cast<double>(phase) / filter_phases;
+                const double x = std::numbers::pi * cutoff * t;
+                const double sinc = (x == 0.0) ? 1.0 : std::sin(x) / x;
+                // Blackman window
+                const double w = std::numbers::pi * t / half_width;
+                const double window = (std::abs(t) >= half_width) ? 0.0 : 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+
+                row[tap] = sinc * window;
+                sum += row[tap];
+            }
+
+            // unity gain at every position, so a constant signal stays constant
+            for (uint32_t tap = 0; tap < filter_taps; tap++)
+                table[phase * filter_taps + tap] = static_cast<float>(row[tap] / sum);
+        }
+    });
+
+    return tables[cutoff_step];
 }
 
-void trim_history(StereoRateResamplerRuntimeState &runtime, StereoRateResamplerLogicalState &logical) {
-    if (!runtime.context) {
-        logical.input_history.clear();
-        return;
-    }
-
-    const int64_t delay = swr_get_delay(runtime.context, runtime.source_rate);
-    const uint32_t keep_frames = static_cast<uint32_t>(std::max<int64_t>(delay, 0)) + history_safety_margin_frames;
-    const uint32_t available_frames = logical.input_history.available_frames();
+uint32_t get_cutoff_step(const double ratio) {
+    if (ratio <= 1.0)
+        return filter_cutoff_steps - 1;
 
-    if (available_frames > keep_frames) {
-        logical.input_history.consume_frames(available_frames - keep_frames);
-        compact_history_if_needed(logical);
-    }
-}
-
-bool replay_history(StereoRateResamplerRuntimeState &runtime, StereoRateResamplerLogicalState &logical) {
-    logical.input_history.compact();
-
-    const uint32_t history_frames = logical.input_history.available_frames();
-    if (history_frames == 0) {
-        return true;
-    }
-
-    const int out_samples = swr_get_out_samples(runtime.context, static_cast<int>(history_frames));
-    if (out_samples < 0) {
-        LOG_ERROR("Failed to query stereo rate resampler replay output size for {} history frames (error {}).",
-            history_frames, out_samples);
-        return false;
-    }
-
-    runtime.scratch_buffer.resize(static_cast<size_t>(out_samples) * sizeof(float) * stereo_channels);
-
-    uint8_t *discard_output = runtime.scratch_buffer.empty() ? nullptr : runtime.scratch_buffer.data();
-    const uint8_t *history_input = logical.input_history.read_bytes();
-    const int result = swr_convert(runtime.context, &discard_output, out_samples, &history_input,
-        static_cast<int>(history_frames));
-    if (result < 0) {
-        LOG_ERROR("Failed to replay {} history frames into stereo rate resampler (error {}).",
-            history_frames, result);
-        return false;
-    }
-    return true;
+    return std::max(static_cast<uint32_t>(filter_cutoff_steps / ratio), 1U) - 1;
 }
 } // namespace
 
-void destroy_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime) {
-    if (runtime.context) {
-        swr_free(&runtime.context);
-    }
-
-    runtime.source_rate = 0;
-    runtime.dest_rate = 0;
-    runtime.scratch_buffer.clear();
-}
-
-bool ensure_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime, StereoRateResamplerLogicalState &logical,
-    const int source_rate, const int dest_rate) {
-    if (source_rate <= 0 || dest_rate <= 0) {
-        LOG_ERROR("Invalid stereo rate resampler configuration {} -> {} Hz.", source_rate, dest_rate);
-        return false;
-    }
-
-    const bool needs_recreate = logical.needs_reset || !runtime.context || runtime.source_rate != source_rate
-        || runtime.dest_rate != dest_rate;
-
-    if (!needs_recreate) {
-        return true;
-    }
-
-    destroy_stereo_rate_resampler(runtime);
-    if (!create_stereo_rate_resampler(runtime, source_rate, dest_rate)) {
-        return false;
-    }
-
-    if (!replay_history(runtime, logical)) {
-        destroy_stereo_rate_resampler(runtime);
-        return false;
-    }
-
-    logical.needs_reset = false;
-    return true;
-}
-
-uint32_t process_stereo_rate_resampler(StereoRateResamplerRuntimeState &runtime, StereoRateResamplerLogicalState &logical,
+uint32_t process_stereo_rate_resampler(StereoRateResamplerLogicalState &logical, const double source_rate, const int dest_rate,
     const uint8_t *input, const uint32_t input_frames, PCMFrameQueue &output) {
-    if (!input || input_frames == 0 || !runtime.context) {
+    if (!input || input_frames == 0 || !(source_rate > 0.0) || dest_rate <= 0) {
         return 0;
     }
 
-    const int out_samples = swr_get_out_samples(runtime.context, static_cast<int>(input_frames));
-    if (out_samples < 0) {
-        LOG_ERROR("Failed to query stereo rate resampler output size for {} input frames (error {}).",
-            input_frames, out_samples);
-        return 0;
+    std::vector<float> &left = logical.pending_left;
+    std::vector<float> &right = logical.pending_right;
+
+    // the first output frame is centered on the first input frame
+    if (!logical.primed) {
+        left.assign(filter_taps / 2 - 1, 0.0f);
+        right.assign(filter_taps / 2 - 1, 0.0f);
+        logical.primed = true;
     }
 
-    const size_t old_samples = output.samples.size();
-    output.samples.resize(old_samples + static_cast<size_t>(out_samples) * stereo_channels);
+    const float *samples = reinterpret_cast<const float *>(input);
+    const size_t previous_frames = left.size();
+    left.resize(previous_frames + input_frames);
+    right.resize(previous_frames + input_frames);
+    for (uint32_t i = 0; i < input_frames; i++) {
+        left[previous_frames + i] = samples[i * 2];
+        right[previous_frames + i] = samples[i * 2 + 1];
+    }
 
-    uint8_t *output_bytes = reinterpret_cast<uint8_t *>(output.samples.data() + old_samples);
-    const uint8_t *input_bytes = input;
-    const int produced_samples = swr_convert(runtime.context, &output_bytes, out_samples, &input_bytes,
-        static_cast<int>(input_frames));
+    const double ratio = source_rate / dest_rate;
+    const uint64_t step = std::max<uint64_t>(static_cast<uint64_t>(std::llround(std::ldexp(ratio, 32))), 1);
+    const FilterTable &table = get_filter_table(get_cutoff_step(ratio));
 
-    if (produced_samples < 0) {
-        LOG_ERROR("Stereo rate resampler failed while converting {} input frames (error {}).",
-            input_frames, produced_samples);
-        output.samples.resize(old_samples);
-        return 0;
-    }
+    // an output frame needs all the frames of its filter to be there
+    const size_t frame_count = left.size();
+    const uint64_t end = (frame_count >= filter_taps) ? static_cast<uint64_t>(frame_count - filter_taps + 1) << 32 : 0;
+    uint64_t position = logical.position;
+    const uint32_t output_frames = (position < end) ? static_cast<uint32_t>((end - position + step - 1) / step) : 0;
 
-    output.samples.resize(old_samples + static_cast<size_t>(produced_samples) * stereo_channels);
+    float *dest = reinterpret_cast<float *>(output.append_uninitialized_bytes(output_frames));
+    dsp::resample_stereo(dest, left.data(), right.data(), table.data(), filter_phase_bits, position, step, output_frames);
+    position += step * output_frames;
 
-    logical.input_history.append_bytes(input, input_frames);
-    trim_history(runtime, logical);
+    // drop the frames no output frame needs anymore
+    const size_t consumed_frames = std::min<size_t>(position >> 32, frame_count);
+    left.erase(left.begin(), left.begin() + consumed_frames);
+    right.erase(right.begin(), right.begin() + consumed_frames);
+    logical.position = position - (static_cast<uint64_t>(consumed_frames) << 32);
 
-    return static_cast<uint32_t>(produced_samples);
+    return output_frames;
 }
 
 } // namespace ngs
@@ -19,9 +19,12 @@
 #include <ngs/system.h>
 
 #include <kernel/state.h>
+#include <threads/worker_pool.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <memory>
 #include <util/vector_utils.h>
 
 namespace ngs {
@@ -120,6 +123,184 @@ bool VoiceScheduler::off(const MemState &mem, Voice *voice) {
     return true;
 }
 
+// levels with fewer voices are not worth waking up the workers
+static constexpr size_t MIN_PARALLEL_VOICES = 4;
+
+static thread_local bool is_voice_worker = false;
+
+bool VoiceScheduler::is_worker_thread() {
+    return is_voice_worker;
+}
+
+void VoiceScheduler::run_on_update_thread(const std::function<void()> &func) {
+    WorkerCallback callback{ &func };
+
+    std::unique_lock<std::mutex> lock(workers_mutex);
+    worker_callbacks.push_back(&callback);
+    workers_cond.notify_all();
+    workers_cond.wait(lock, [&]() { return callback.done; });
+}
+
+void VoiceScheduler::run_worker_callbacks(std::unique_lock<std::mutex> &workers_lock, std::unique_lock<std::recursive_mutex> &scheduler_lock) {
+    while (!worker_callbacks.empty()) {
+        WorkerCallback *callback = worker_callbacks.front();
+        worker_callbacks.erase(worker_callbacks.begin());
+
+        // same as the modules do when they run a callback themselves
+        workers_lock.unlock();
+        scheduler_lock.unlock();
+        (*callback->func)();
+        scheduler_lock.lock();
+        workers_lock.lock();
+
+        callback->done = true;
+        workers_cond.notify_all();
+    }
+}
+
+std::vector<std::vector<Voice *>> VoiceScheduler::split_in_levels(const MemState &mem, const std::vector<Voice *> &voice_queue) {
+    std::vector<uint32_t> voice_levels(voice_queue.size(), 0);
+    uint32_t level_count = 0;
+
+    for (size_t i = 0; i < voice_queue.size(); i++) {
+        const auto for_each_dest = [&](const auto &func) {
+            for (const auto &patches : voice_queue[i]->patches) {
+                for (const auto &patch : patches) {
+                    if (!patch || !patch.get(mem)->is_active())
+                        continue;
+
+                    const size_t dest_pos = vector_utils::find_index(voice_queue, patch.get(mem)->dest.get(mem));
+                    if (dest_pos != static_cast<size_t>(-1))
+                        func(dest_pos);
+                }
+            }
+        };
+
+        // a voice delivering to one processed before it in the queue must not be processed before that one either,
+        // otherwise the data would be mixed in, whereas it is lost when processing the queue in order
+        for_each_dest([&](size_t dest_pos) {
+            if (dest_pos < i)
+                voice_levels[i] = std::max(voice_levels[i], voice_levels[dest_pos]);
+        });
+        for_each_dest([&](size_t dest_pos) {
+            if (dest_pos > i)
+                voice_levels[dest_pos] = std::max(voice_levels[dest_pos], voice_levels[i] + 1);
+        });
+
+        level_count = std::max(level_count, voice_levels[i] + 1);
+    }
+
+    std::vector<std::vector<Voice *>> levels(level_count);
+    for (size_t i = 0; i < voice_queue.size(); i++)
+        levels[voice_levels[i]].push_back(voice_queue[i]);
+
+    return levels;
+}
+
+std::optional<uint32_t> VoiceScheduler::process_voice(KernelState &kern, const MemState &mem, const SceUID thread_id, Voice *voice, std::unique_lock<std::recursive_mutex> &scheduler_lock) {
+    // Modify the state, in peace....
+    std::unique_lock<std::mutex> voice_lock(*voice->voice_mutex);
+    memset(voice->products, 0, sizeof(voice->products));
+
+    std::optional<uint32_t> finished_module;
+
+    for (size_t i = 0; i < voice->rack->modules.size(); i++) {
+        if (voice->rack->modules[i]) {
+            if (voice->rack->modules[i]->process(kern, mem, thread_id, voice->datas[i], scheduler_lock, voice_lock)) {
+                finished_module = voice->rack->modules[i]->module_id();
+            }
+        }
+    }
+
+    return finished_module;
+}
+
+void VoiceScheduler::process_voices_in_parallel(KernelState &kern, const MemState &mem, const SceUID thread_id, const std::vector<Voice *> &voices, std::vector<std::optional<uint32_t>> &results, std::unique_lock<std::recursive_mutex> &scheduler_lock) {
+    // shared with the tasks, a task starting once everything is done only looks at next
+    struct SharedWork {
+        std::vector<Voice *> voices;
+        std::vector<std::optional<uint32_t>> results;
+        std::atomic<size_t> next = 0;
+        // protected by workers_mutex
+        size_t done = 0;
+    };
+
+    const auto work = std::make_shared<SharedWork>();
+    work->voices = voices;
+    work->results.resize(voices.size());
+
+    WorkerPool &pool = WorkerPool::get();
+    const size_t worker_count = std::min(voices.size() - 1, pool.thread_count());
+    for (size_t i = 0; i < worker_count; i++) {
+        pool.submit([this, &kern, &mem, thread_id, work]() {
+            // the scheduler mutex stays held by the updating thread, which releases it around the callbacks it runs for us,
+            // this one only exists for the modules to unlock
+            std::recursive_mutex worker_mutex;
+            std::unique_lock<std::recursive_mutex> worker_lock(worker_mutex);
+
+            is_voice_worker = true;
+            for (size_t index = work->next++; index < work->voices.size(); index = work->next++) {
+                work->results[index] = process_voice(kern, mem, thread_id, work->voices[index], worker_lock);
+
+                // notify with the mutex locked, the scheduler may be gone as soon as it is released
+                const std::lock_guard<std::mutex> guard(workers_mutex);
+                work->done++;
+                workers_cond.notify_all();
+            }
+            is_voice_worker = false;
+        });
+    }
+
+    std::unique_lock<std::mutex> workers_lock(workers_mutex, std::defer_lock);
+    for (size_t index = work->next++; index < work->voices.size(); index = work->next++) {
+        work->results[index] = process_voice(kern, mem, thread_id, work->voices[index], scheduler_lock);
+
+        workers_lock.lock();
+        work->done++;
+        run_worker_callbacks(workers_lock, scheduler_lock);
+        workers_lock.unlock();
+    }
+
+    // wait for the voices still handled by the workers, a worker waiting for a callback hasn't finished its voice
+    workers_lock.lock();
+    while (true) {
+        run_worker_callbacks(workers_lock, scheduler_lock);
+        if (work->done == work->voices.size())
+            break;
+
+        workers_cond.wait(workers_lock, [&]() { return work->done == work->voices.size() || !worker_callbacks.empty(); });
+    }
+    workers_lock.unlock();
+
+    results = std::move(work->results);
+}
+
+void VoiceScheduler::finish_voice(KernelState &kern, const MemState &mem, const SceUID thread_id, const std::vector<Voice *> &voice_queue, Voice *voice, std::optional<uint32_t> finished_module, std::unique_lock<std::recursive_mutex> &scheduler_lock) {
+    std::unique_lock<std::mutex> voice_lock(*voice->voice_mutex);
+
+    if (finished_module) {
+        voice->is_keyed_off = true;
+        voice->transition(mem, VOICE_STATE_FINALIZING);
+        if (voice->finished_callback) {
+            voice_lock.unlock();
+            scheduler_lock.unlock();
+            voice->invoke_callback(kern, mem, thread_id, voice->finished_callback, voice->finished_callback_user_data, *finished_module);
+            scheduler_lock.lock();
+            voice_lock.lock();
+        }
+        voice->is_keyed_off = false;
+
+        stop(mem, voice);
+    }
+
+    for (size_t i = 0; i < voice->rack->vdef->output_count; i++) {
+        if (voice->products[i].data)
+            deliver_data(mem, voice_queue, voice, static_cast<uint8_t>(i), voice->products[i]);
+    }
+
+    voice->frame_count++;
+}
+
 void VoiceScheduler::update(KernelState &kern, const MemState &mem, const SceUID thread_id) {
     std::unique_lock<std::recursive_mutex> scheduler_lock(mutex);
     is_updating = true;
@@ -132,43 +313,19 @@ void VoiceScheduler::update(KernelState &kern, const MemState &mem, const SceUID
         voice->inputs.reset_inputs();
     }
 
-    for (ngs::Voice *voice : queue_copy) {
-        // Modify the state, in peace....
-        std::unique_lock<std::mutex> voice_lock(*voice->voice_mutex);
-        memset(voice->products, 0, sizeof(voice->products));
-
-        bool finished = false;
-        uint32_t finished_module = 0;
-
-        for (size_t i = 0; i < voice->rack->modules.size(); i++) {
-            if (voice->rack->modules[i]) {
-                if (voice->rack->modules[i]->process(kern, mem, thread_id, voice->datas[i], scheduler_lock, voice_lock)) {
-                    finished = true;
-                    finished_module = voice->rack->modules[i]->module_id();
-                }
-            }
-        }
-        if (finished) {
-            voice->is_keyed_off = true;
-            voice->transition(mem, VOICE_STATE_FINALIZING);
-            if (voice->finished_callback) {
-                voice_lock.unlock();
-                scheduler_lock.unlock();
-                voice->invoke_callback(kern, mem, thread_id, voice->finished_callback, voice->finished_callback_user_data, finished_module);
-                scheduler_lock.lock();
-                voice_lock.lock();
-            }
-            voice->is_keyed_off = false;
-
-            stop(mem, voice);
-        }
-
-        for (size_t i = 0; i < voice->rack->vdef->output_count; i++) {
-            if (voice->products[i].data)
-                deliver_data(mem, queue_copy, voice, static_cast<uint8_t>(i), voice->products[i]);
+    // the voices of a level don't depend on each other and can be processed at the same time,
+    // their products are then delivered on this thread in the queue order so they are always mixed the same way
+    for (const std::vector<Voice *> &level : split_in_levels(mem, queue_copy)) {
+        std::vector<std::optional<uint32_t>> results(level.size());
+        if (level.size() >= MIN_PARALLEL_VOICES && WorkerPool::get().thread_count() > 0) {
+            process_voices_in_parallel(kern, mem, thread_id, level, results, scheduler_lock);
+        } else {
+            for (size_t i = 0; i < level.size(); i++)
+                results[i] = process_voice(kern, mem, thread_id, level[i], scheduler_lock);
         }
 
-        voice->frame_count++;
+        for (size_t i = 0; i < level.size(); i++)
+            finish_voice(kern, mem, thread_id, queue_copy, level[i], results[i], scheduler_lock);
     }
 
     while (!operations_pending.empty()) {
@@ -0,0 +1,224 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <ngs/modules/player.h>
+#include <ngs/state.h>
+#include <ngs/system.h>
+
+#include <kernel/state.h>
+#include <mem/functions.h>
+#include <mem/state.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numbers>
+#include <vector>
+
+static constexpr int32_t GRANULARITY = 512;
+static constexpr int32_t SAMPLE_RATE = 48000;
+
+// a system with a rack of player voices, optionally each patched into its own reverb voice, all patched into a master voice
+class PlayerRack {
+public:
+    PlayerRack(MemState &mem, ngs::State &ngs, uint32_t voice_count, bool with_reverb)
+        : mem(mem) {
+        SceNgsSystemInitParams init_params{};
+        init_params.max_racks = 3;
+        init_params.max_voices = static_cast<int32_t>(voice_count * 2 + 1);
+        init_params.granularity = GRANULARITY;
+        init_params.sample_rate = SAMPLE_RATE;
+        const uint32_t system_size = ngs::System::get_required_memspace_size(&init_params);
+        const Ptr<void> memspace(alloc(mem, system_size, "ngs system"));
+        EXPECT_TRUE(ngs::init_system(ngs, mem, &init_params, memspace, system_size));
+        system = memspace.cast<ngs::System>().get(mem);
+
+        players = init_rack(ngs, ngs::BussType::BUSS_SIMPLE, voice_count);
+        if (with_reverb)
+            reverbs = init_rack(ngs, ngs::BussType::BUSS_REVERB, voice_count);
+        master = init_rack(ngs, ngs::BussType::BUSS_MASTER, 1);
+    }
+
+    // the player voice plays the samples in a loop
+    void set_player(uint32_t index, Address samples, uint32_t sample_count, float frequency) {
+        const SceNgsPlayerParams params{
+            .descriptor = { SCE_NGS_PLAYER_PARAMS_STRUCT_ID, sizeof(SceNgsPlayerParams) },
+            .buffer_params = { { Ptr<void>(samples), static_cast<SceInt32>(sample_count * sizeof(int16_t)), -1, -1 } },
+            .playback_frequency = frequency,
+            .playback_scalar = 1.0f,
+            .channels = 1,
+            .type = ParameterAudioTypePCM,
+        };
+        ngs::Voice *voice = players->voices[index].get(mem);
+        memcpy(voice->datas[0].info.data.get(mem), &params, sizeof(params));
+
+        if (reverbs) {
+            patch(players->voices[index], reverbs->voices[index]);
+            patch(reverbs->voices[index], master->voices[0]);
+        } else {
+            patch(players->voices[index], master->voices[0]);
+        }
+    }
+
+    void play(uint32_t index) {
+        system->voice_scheduler.play(mem, players->voices[index].get(mem));
+        if (reverbs)
+            system->voice_scheduler.play(mem, reverbs->voices[index].get(mem));
+    }
+
+    // returns the samples written by the master voice
+    std::vector<int16_t> update(KernelState &kern) {
+        ngs::Voice *master_voice = master->voices[0].get(mem);
+        if (master_voice->state == ngs::VOICE_STATE_AVAILABLE)
+            system->voice_scheduler.play(mem, master_voice);
+
+        system->voice_scheduler.update(kern, mem, 0);
+
+        const std::vector<uint8_t> &output = master_voice->datas[1].guest_state_data;
+        std::vector<int16_t> samples(output.size() / sizeof(int16_t));
+        memcpy(samples.data(), output.data(), output.size());
+        return samples;
+    }
+
+private:
+    ngs::Rack *init_rack(ngs::State &ngs, ngs::BussType type, uint32_t voice_count) {
+        SceNgsRackDescription description{};
+        description.definition = ngs::get_voice_definition(ngs, mem, type);
+        description.voice_count = static_cast<int32_t>(voice_count);
+        description.channels_per_voice = 2;
+        description.max_patches_per_input = static_cast<int32_t>(voice_count);
+        description.patches_per_output = 1;
+
+        SceNgsBufferInfo info{};
+        info.size = ngs::Rack::get_required_memspace_size(mem, &description);
+        info.data = Ptr<void>(alloc(mem, info.size, "ngs rack"));
+        EXPECT_TRUE(ngs::init_rack(ngs, mem, system, &info, &description));
+        return info.data.cast<ngs::Rack>().get(mem);
+    }
+
+    void patch(Ptr<ngs::Voice> source, Ptr<ngs::Voice> dest) {
+        SceNgsPatchSetupInfo info{ source, 0, -1, dest, 0 };
+        const Ptr<ngs::Patch> patch = system->voice_scheduler.patch(mem, &info);
+        ASSERT_TRUE(patch);
+
+        ngs::Patch *patch_data = patch.get(mem);
+        patch_data->volume_matrix[0][0] = 1.0f;
+        patch_data->volume_matrix[1][1] = 1.0f;
+    }
+
+    MemState &mem;
+    ngs::System *system = nullptr;
+    ngs::Rack *players = nullptr;
+    ngs::Rack *reverbs = nullptr;
+    ngs::Rack *master = nullptr;
+};
+
+class ngs_scheduler : public testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(init(mem, false));
+        ASSERT_TRUE(ngs::init(ngs, mem));
+    }
+
+    void TearDown() override {
+        ngs::deinit(ngs, mem);
+    }
+
+    // one second of a sine wave, each voice plays a different one
+    Address make_sine(uint32_t voice, uint32_t sample_count) {
+        const Address address = alloc(mem, sample_count * sizeof(int16_t), "ngs samples");
+        int16_t *samples = Ptr<int16_t>(address).get(mem);
+        const float frequency = 110.0f + voice * 37.0f;
+        for (uint32_t i = 0; i < sample_count; i++)
+            samples[i] = static_cast<int16_t>(std::sin(2.0f * std::numbers::pi_v<float> * frequency * i / SAMPLE_RATE) * 1000.0f);
+
+        return address;
+    }
+
+    MemState mem;
+    ngs::State ngs;
+    KernelState kern;
+};
+
+// the voices of the rack are processed by the worker pool, the master must get the sum of what each voice plays alone
+TEST_F(ngs_scheduler, parallel_voices_match_voices_played_alone) {
+    constexpr uint32_t VOICE_COUNT = 16;
+    constexpr uint32_t SAMPLE_COUNT = 48000;
+    constexpr uint32_t UPDATE_COUNT = 20;
+
+    std::vector<Address> sines;
+    for (uint32_t i = 0; i < VOICE_COUNT; i++)
+        sines.push_back(make_sine(i, SAMPLE_COUNT));
+
+    // half of the voices go through the rate resampler
+    auto get_frequency = [](uint32_t voice) { return voice % 2 ? 44100.0f : 48000.0f; };
+
+    std::vector<int32_t> expected(static_cast<size_t>(GRANULARITY) * 2 * UPDATE_COUNT, 0);
+    for (uint32_t voice = 0; voice < VOICE_COUNT; voice++) {
+        PlayerRack rack(mem, ngs, 1, false);
+        rack.set_player(0, sines[voice], SAMPLE_COUNT, get_frequency(voice));
+        rack.play(0);
+        for (uint32_t update = 0; update < UPDATE_COUNT; update++) {
+            const std::vector<int16_t> output = rack.update(kern);
+            for (size_t i = 0; i < output.size(); i++)
+                expected[update * output.size() + i] += output[i];
+        }
+    }
+
+    ASSERT_GT(*std::max_element(expected.begin(), expected.end()), 1000) << "the voices played nothing";
+
+    PlayerRack rack(mem, ngs, VOICE_COUNT, true);
+    for (uint32_t voice = 0; voice < VOICE_COUNT; voice++) {
+        rack.set_player(voice, sines[voice], SAMPLE_COUNT, get_frequency(voice));
+        rack.play(voice);
+    }
+    for (uint32_t update = 0; update < UPDATE_COUNT; update++) {
+        const std::vector<int16_t> output = rack.update(kern);
+        for (size_t i = 0; i < output.size(); i++) {
+            // each voice played alone was rounded once
+            ASSERT_NEAR(output[i], expected[update * output.size() + i], VOICE_COUNT) << "update " << update << ", sample " << i;
+        }
+    }
+}
+
+// Time per update of N player+reverb voices patched into a master voice
+TEST_F(ngs_scheduler, DISABLED_rack_update_benchmark) {
+    constexpr uint32_t SAMPLE_COUNT = 48000;
+    constexpr uint32_t UPDATE_COUNT = 200;
+
+    for (const uint32_t voice_count : { 16, 64, 128 }) {
+        PlayerRack rack(mem, ngs, voice_count, true);
+        for (uint32_t voice = 0; voice < voice_count; voice++) {
+            rack.set_player(voice, make_sine(voice, SAMPLE_COUNT), SAMPLE_COUNT, 44100.0f);
+            rack.play(voice);
+        }
+
+        // the first update allocates the buffers of the voices
+        rack.update(kern);
+
+        const auto start_time = std::chrono::steady_clock::now();
+        for (uint32_t update = 0; update < UPDATE_COUNT; update++)
+            rack.update(kern);
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+
+        std::cout << voice_count << " player+reverb voices: " << duration.count() / UPDATE_COUNT << " us per update" << std::endl;
+    }
+}
@@ -20,3 +20,9 @@
 #include <cstdint>
 
 const char *import_name(uint32_t nid);
+// Position of a function NID in nids.inc starting from 1, or 0 if the NID is unknown
+uint32_t import_index(uint32_t nid);
+// Number of function NIDs in nids.inc, the highest index returned by import_index
+uint32_t import_count();
+// Function NID at the given index, or 0 if the index is out of range
+uint32_t import_nid(uint32_t index);
@@ -15,7 +15,13 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <nids/functions.h>
+
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #define VAR_NID(name, nid) extern const char name_##name[] = #name;
 #define NID(name, nid) extern const char name_##name[] = #name;
@@ -38,3 +44,40 @@ const char *import_name(uint32_t nid) {
         return "UNRECOGNISED";
     }
 }
+
+static constexpr uint32_t import_nids[] = {
+#define VAR_NID(name, nid)
+#define NID(name, nid) nid,
+#include <nids/nids.inc>
+#undef NID
+#undef VAR_NID
+};
+
+uint32_t import_index(uint32_t nid) {
+    // only called when binding imports, no need for anything faster than a binary search
+    static const auto sorted_nids = []() {
+        std::vector<std::pair<uint32_t, uint32_t>> sorted;
+        sorted.reserve(std::size(import_nids));
+        for (uint32_t i = 0; i < std::size(import_nids); i++)
+            sorted.emplace_back(import_nids[i], i + 1);
+        std::ranges::sort(sorted);
+        return sorted;
+    }();
+
+    const auto it = std::ranges::lower_bound(sorted_nids, nid, {}, &std::pair<uint32_t, uint32_t>::first);
+    if (it == sorted_nids.end() || it->first != nid)
+        return 0;
+
+    return it->second;
+}
+
+uint32_t import_count() {
+    return static_cast<uint32_t>(std::size(import_nids));
+}
+
+uint32_t import_nid(uint32_t index) {
+    if (index == 0 || index > std::size(import_nids))
+        return 0;
+
+    return import_nids[index - 1];
+}
@@ -40,8 +40,8 @@ enum class screen_quadrant : uint8_t {
 enum class perf_detail_level : uint8_t {
     minimum = 0, // FPS only
     low, // FPS + ms/frame
-    medium, // FPS + ms/frame + min/max/avg
-    maximum // FPS + ms/frame + min/max/avg + graph
+    medium, // FPS + ms/frame + min/max/avg + texture cache
+    maximum // FPS + ms/frame + min/max/avg + texture cache + graph
 };
 
 struct perf_overlay : public overlay {
@@ -54,6 +54,9 @@ struct perf_overlay : public overlay {
         uint32_t max_fps, uint32_t ms_per_frame,
         const float *fps_values, uint32_t fps_values_count,
         uint32_t fps_offset);
+    // must be called before set_fps_data, memory sizes are in bytes
+    void set_texture_cache_data(uint32_t hits, uint32_t misses, uint32_t evictions,
+        uint64_t memory_used, uint64_t memory_budget);
 
     compiled_resource get_compiled() override;
 
@@ -75,6 +78,12 @@ private:
     uint32_t m_min_fps = 0;
     uint32_t m_max_fps = 0;
     uint32_t m_ms_per_frame = 0;
+    uint32_t m_texture_hits = 0;
+    uint32_t m_texture_misses = 0;
+    uint32_t m_texture_evictions = 0;
+    uint64_t m_texture_memory_used = 0;
+    uint64_t m_texture_memory_budget = 0;
+    bool m_texture_changed = false;
 
     bool m_force_repaint = true;
 
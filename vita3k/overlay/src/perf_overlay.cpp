@@ -65,7 +65,8 @@ void perf_overlay::set_fps_data(uint32_t fps, uint32_t avg_fps, uint32_t min_fps
     uint32_t fps_offset) {
     const bool changed = (m_fps != fps || m_avg_fps != avg_fps
         || m_min_fps != min_fps || m_max_fps != max_fps
-        || m_ms_per_frame != ms_per_frame);
+        || m_ms_per_frame != ms_per_frame || m_texture_changed);
+    m_texture_changed = false;
 
     m_fps = fps;
     m_avg_fps = avg_fps;
@@ -84,6 +85,23 @@ void perf_overlay::set_fps_data(uint32_t fps, uint32_t avg_fps, uint32_t min_fps
     }
 }
 
+void perf_overlay::set_texture_cache_data(uint32_t hits, uint32_t misses, uint32_t evictions,
+    uint64_t memory_used, uint64_t memory_budget) {
+    // only shown with the min/max/avg stats
+    if (m_detail < perf_detail_level::medium)
+        return;
+
+    m_texture_changed |= (m_texture_hits != hits || m_texture_misses != misses
+        || m_texture_evictions != evictions || m_texture_memory_used != memory_used
+        || m_texture_memory_budget != memory_budget);
+
+    m_texture_hits = hits;
+    m_texture_misses = misses;
+    m_texture_evictions = evictions;
+    m_texture_memory_used = memory_used;
+    m_texture_memory_budget = memory_budget;
+}
+
 void perf_overlay::update_text() {
     std::string text;
 
@@ -103,6 +121,17 @@ void perf_overlay::update_text() {
         break;
     }
 
+    if (m_detail >= perf_detail_level::medium) {
+        constexpr uint64_t mib = 1024 * 1024;
+        const uint32_t lookups = m_texture_hits + m_texture_misses;
+        const uint32_t hit_rate = lookups > 0 ? static_cast<uint32_t>((static_cast<uint64_t>(m_texture_hits) * 100) / lookups) : 100;
+        if (m_texture_memory_budget > 0)
+            text += fmt::format("\nTextures: {}/{} MiB", m_texture_memory_used / mib, m_texture_memory_budget / mib);
+        else
+            text += fmt::format("\nTextures: {} MiB", m_texture_memory_used / mib);
+        text += fmt::format("  Hit: {}%  Evict: {}", hit_rate, m_texture_evictions);
+    }
+
     m_body.set_text(text);
     m_body.auto_resize();
     m_body.refresh();
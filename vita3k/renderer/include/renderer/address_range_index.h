@@ -0,0 +1,140 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/util.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace renderer {
+
+/**
+ * @brief Index of the guest memory ranges [begin, end) used by surfaces, at most one range per start address
+ *
+ * The ranges are stored contiguously, sorted by their start address, along with the highest end address
+ * of all the ranges up to each of them. Finding the ranges containing an address is a binary search followed
+ * by a walk back which stops as soon as no earlier range can reach the address, so overlapping ranges are
+ * found as well. Insertions and removals are linear, which is fine for the few dozens of surfaces cached.
+ */
+template <typename T>
+class AddressRangeIndex {
+public:
+    struct Entry {
+        Address begin;
+        Address end;
+        T value;
+    };
+
+    // replaces the range starting at begin if there is already one
+    void insert(Address begin, Address end, T value) {
+        auto it = std::lower_bound(entries.begin(), entries.end(), begin, [](const Entry &entry, Address address) {
+            return entry.begin < address;
+        });
+        if (it != entries.end() && it->begin == begin)
+            *it = Entry{ begin, end, value };
+        else
+            entries.insert(it, Entry{ begin, end, value });
+        update_max_ends();
+    }
+
+    // returns false if no range starts at begin
+    bool erase(Address begin) {
+        const size_t index = find_index(begin);
+        if (index == entries.size())
+            return false;
+
+        entries.erase(entries.begin() + index);
+        update_max_ends();
+        return true;
+    }
+
+    void clear() {
+        entries.clear();
+        begins.clear();
+        max_ends.clear();
+    }
+
+    // range starting exactly at begin, nullptr if there is none
+    const Entry *find(Address begin) const {
+        const size_t index = find_index(begin);
+        return index == entries.size() ? nullptr : &entries[index];
+    }
+
+    // range containing address with the highest start address, nullptr if there is none
+    const Entry *find_containing(Address address) const {
+        // number of ranges starting at or before address
+        size_t index = count_starting_before(address);
+
+        while (index > 0 && max_ends[index - 1] > address) {
+            index--;
+            if (entries[index].end > address)
+                return &entries[index];
+        }
+
+        return nullptr;
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+private:
+    // branchless binary search, the addresses looked up are hard to predict
+    size_t count_starting_before(Address address) const {
+        if (begins.empty())
+            return 0;
+
+        const Address *base = begins.data();
+        size_t count = begins.size();
+        while (count > 1) {
+            const size_t half = count / 2;
+            base = (base[half] <= address) ? base + half : base;
+            count -= half;
+        }
+        return (base - begins.data()) + (*base <= address);
+    }
+
+    size_t find_index(Address begin) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), begin, [](const Entry &entry, Address address) {
+            return entry.begin < address;
+        });
+        if (it == entries.end() || it->begin != begin)
+            return entries.size();
+        return it - entries.begin();
+    }
+
+    void update_max_ends() {
+        begins.resize(entries.size());
+        max_ends.resize(entries.size());
+        Address max_end = 0;
+        for (size_t i = 0; i < entries.size(); i++) {
+            begins[i] = entries[i].begin;
+            max_end = std::max(max_end, entries[i].end);
+            max_ends[i] = max_end;
+        }
+    }
+
+    std::vector<Entry> entries;
+    // start address of each entry, kept apart so the search only touches a few cache lines
+    std::vector<Address> begins;
+    // max_ends[i] is the highest end address of entries[0..i]
+    std::vector<Address> max_ends;
+};
+
+} // namespace renderer
@@ -17,9 +17,11 @@
 
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace renderer {
@@ -112,6 +114,36 @@ struct Command {
 
 using CommandPool = std::vector<Command>;
 
+/**
+ * @brief Allocates the commands recorded by a deferred context by blocks instead of one at a time
+ *
+ * The blocks used while recording a command list are handed over to it, and given back to the arena
+ * once the command list is freed. An arena is only used by the thread recording its context.
+ * The data recorded along the commands (such as the command list itself) is taken from the same blocks.
+ */
+struct CommandArena {
+    static constexpr size_t BLOCK_COMMAND_COUNT = 64;
+    // blocks kept around for the next command lists, the others are freed
+    static constexpr size_t MAX_FREE_BLOCKS = 64;
+
+    struct Block {
+        std::array<Command, BLOCK_COMMAND_COUNT> commands;
+        size_t used = 0;
+    };
+    typedef std::vector<std::unique_ptr<Block>> Blocks;
+
+    Command *allocate();
+    // Takes enough consecutive command slots for size bytes (at most a block), aligned like a command
+    void *allocate_data(size_t size);
+    // Returns the blocks used since the last call, the next command is allocated from a new block
+    Blocks take_blocks();
+    void release(Blocks &blocks);
+
+private:
+    Blocks recording_blocks;
+    Blocks free_blocks;
+};
+
 // It's to split a command list easier when ExecuteCommandList is used.
 struct CommandList {
     Command *first{ nullptr };
@@ -173,7 +205,7 @@ bool do_command_push_data(CommandHelper &helper, Head arg1, Args... args2) {
 }
 
 template <typename... Args>
-Command *make_command(CommandAllocFunc alloc_func, CommandFreeFunc free_func, const CommandOpcode opcode, int *status, Args... arguments) {
+Command *make_command(const CommandAllocFunc &alloc_func, const CommandFreeFunc &free_func, const CommandOpcode opcode, int *status, Args... arguments) {
     Command *new_command = alloc_func();
 
     new_command->opcode = opcode;
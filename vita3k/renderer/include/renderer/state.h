@@ -22,6 +22,7 @@
 #include <renderer/frame_host.h>
 #include <renderer/types.h>
 #include <threads/queue.h>
+#include <threads/ring_queue.h>
 
 #include <array>
 #include <atomic>
@@ -29,6 +30,7 @@
 #include <condition_variable>
 #include <functional>
 #include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -66,6 +68,13 @@ struct PerformanceOverlayState {
     std::array<float, 20> fps_values = {};
     uint32_t fps_values_count = 0;
     uint32_t current_fps_offset = 0;
+
+    // texture cache activity during the last second
+    uint32_t texture_hits = 0;
+    uint32_t texture_misses = 0;
+    uint32_t texture_evictions = 0;
+    uint64_t texture_memory_used = 0;
+    uint64_t texture_memory_budget = 0;
 };
 
 class TextureCache;
@@ -100,7 +109,7 @@ struct State {
     Context *context;
 
     GXPPtrMap gxp_ptr_map;
-    Queue<CommandList> command_buffer_queue;
+    RingQueue<CommandList> command_buffer_queue;
     std::condition_variable command_finish_one;
     std::mutex command_finish_one_mutex;
 
@@ -214,6 +223,13 @@ struct State {
     virtual std::string_view get_gpu_name() = 0;
 
     virtual void precompile_shader(const ShadersHash &hash) = 0;
+    // backends able to precompile shaders from any thread split the batch between the workers
+    virtual void precompile_shaders(std::span<const ShadersHash> hashes) {
+        for (const ShadersHash &hash : hashes)
+            precompile_shader(hash);
+    }
+    // compile the pipelines used during the previous sessions, called once all the shaders have been precompiled
+    virtual void precompile_pipelines() {}
     virtual void preclose_action() = 0;
 
     virtual ~State() = default;
@@ -18,13 +18,18 @@
 #pragma once
 
 #include <gxm/types.h>
+#include <mem/util.h>
 #include <util/containers.h>
 #include <util/fs.h>
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string_view>
+#include <vector>
 
 namespace ddspp {
 struct Descriptor;
@@ -43,7 +48,9 @@ struct YUVConversionCache {
 };
 
 enum class Backend : uint32_t;
-static constexpr size_t TextureCacheSize = 1024;
+class TextureDiskCache;
+// maximum number of cached textures, the memory they use is limited by the budget of the cache
+static constexpr size_t TextureCacheSize = 4096;
 
 typedef std::array<uint32_t, 4> TextureGxmDataRepr;
 struct TextureCacheInfo {
@@ -51,6 +58,10 @@ struct TextureCacheInfo {
     SceGxmTexture texture;
     int index = 0;
     uint32_t texture_size = 0;
+    // estimated size of the texture once uploaded to the host GPU
+    uint32_t memory_size = 0;
+    // value of the use counter of the cache the last time this texture was bound
+    uint64_t last_use = 0;
     bool use_hash = false;
     // no need for it to be atomic
     bool dirty = false;
@@ -69,6 +80,81 @@ struct SamplerCacheInfo {
     int index = 0;
 };
 
+// one mip of one face of a texture, converted to a format the host can upload
+struct TextureUploadLevel {
+    SceGxmTextureBaseFormat format;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t mip_index = 0;
+    int face = 0;
+    uint32_t pixels_per_stride = 0;
+    // points either to data or to the guest memory if the level needed no conversion
+    const void *pixels = nullptr;
+    std::vector<uint8_t> data;
+};
+
+// what the host GPU supports, decides which conversions are done before the upload
+struct TextureDecodeSettings {
+    bool is_vulkan = false;
+    bool support_dxt = false;
+    bool support_pvrt = false;
+    bool support_x8d24 = false;
+    bool support_e5rgb9 = false;
+    bool support_a2rgb10 = false;
+};
+
+// hash and converted content of a texture, computed by a worker thread ahead of the draw using it
+struct TexturePrefetch {
+    enum State : int {
+        Queued,
+        Running,
+        Done
+    };
+
+    std::atomic<int> state = Queued;
+    SceGxmTexture texture;
+    TextureGxmDataRepr repr;
+    // guest memory read by the prefetch (an upper bound for the texture data), the prefetch is dropped when it is written to
+    Address data_start = 0;
+    Address data_end = 0;
+    Address palette_start = 0;
+    Address palette_end = 0;
+    const MemState *mem = nullptr;
+    TextureDecodeSettings settings;
+    std::shared_ptr<TextureDiskCache> disk_cache;
+    // the hash kind used by the texture cache when the prefetch was requested
+    bool hash_nostride = false;
+    // convert the texture if its content is not the one last uploaded
+    bool decode = false;
+    uint64_t hash = 0;
+    // empty if the texture was not converted ahead
+    std::vector<TextureUploadLevel> levels;
+};
+
+// shared with the worker threads, which can outlive the texture cache
+struct TexturePrefetchState {
+    std::mutex mutex;
+    std::condition_variable done_cond;
+    // at most one pending prefetch per texture
+    unordered_map_fast<TextureGxmDataRepr, std::shared_ptr<TexturePrefetch>> pending;
+    // hash of the content last uploaded for each cached texture, a texture is only converted ahead if it changed
+    unordered_map_fast<TextureGxmDataRepr, uint64_t> uploaded_hashes;
+    // textures whose prefetch was never used (render targets sampled as textures, ...), they are not prefetched anymore
+    unordered_set_fast<TextureGxmDataRepr> unused;
+};
+
+// updated by the renderer thread, read by the performance overlay
+struct TextureCacheStats {
+    // texture bound with its content already uploaded
+    std::atomic<uint64_t> hits = 0;
+    // texture which had to be uploaded, because it was not cached or its content changed
+    std::atomic<uint64_t> misses = 0;
+    // texture removed from the cache to make room for another one
+    std::atomic<uint64_t> evictions = 0;
+    std::atomic<uint64_t> memory_used = 0;
+    std::atomic<uint64_t> memory_budget = 0;
+};
+
 struct AvailableTexture {
     bool is_dds;
     std::shared_ptr<fs::path> folder_path;
@@ -102,6 +188,27 @@ protected:
     bool save_as_png = true;
     bool export_textures = false;
 
+    std::shared_ptr<TexturePrefetchState> prefetch_state = std::make_shared<TexturePrefetchState>();
+    // converted content of the textures slow to decode, kept between sessions
+    std::shared_ptr<TextureDiskCache> disk_cache;
+
+    TextureGxmDataRepr get_texture_repr(const SceGxmTexture &gxm_texture) const;
+    TextureDecodeSettings get_decode_settings() const;
+    // returns the prefetch of this texture (waiting for it or running it if needed), nullptr if there is none
+    std::shared_ptr<TexturePrefetch> take_prefetch(const TextureGxmDataRepr &texture_repr);
+    void upload_levels(const std::vector<TextureUploadLevel> &levels);
+
+    // incremented each time a texture is bound
+    uint64_t use_counter = 0;
+    // remove the texture from the cache and release its host memory
+    void evict_texture(TextureCacheInfo &info, bool release);
+    // evict the least recently used textures until the memory used fits in the budget
+    void enforce_memory_budget();
+    // estimated size of the texture currently configured, used for the memory budget
+    virtual uint32_t get_memory_size(const SceGxmTexture &texture) const;
+    // release the host memory used by the texture at this index, it will be configured again before being used
+    virtual void release_texture(size_t index) {}
+
 public:
     Backend backend;
     bool use_protect = false;
@@ -113,6 +220,7 @@ public:
     // used to quickly get the info from a hash of a gxm_texture
     unordered_map_fast<TextureGxmDataRepr, TextureCacheInfo *> texture_lookup;
     lru::Queue<TextureCacheInfo> texture_queue;
+    TextureCacheStats stats;
 
     // when use_sampler_cache is set to true, used to quickly get a cached sampler
     unordered_map_fast<uint32_t, SamplerCacheInfo *> sampler_lookup;
@@ -142,8 +250,15 @@ public:
     bool support_e5rgb9 = false;
     bool support_a2rgb10 = false;
 
+    // hash and convert the textures on the worker threads as soon as the guest uses them in a draw
+    bool async_upload = false;
+
     bool init(const bool hashless_texture_cache, const fs::path &texture_folder, const std::string_view game_id, const size_t sampler_cache_size = 0);
     void set_replacement_state(bool import_textures, bool export_textures, bool export_as_png);
+    // budget is in bytes, 0 means only the number of textures is limited
+    void set_memory_budget(uint64_t budget);
+    // max_size is in bytes, 0 disables the disk cache
+    void init_disk_cache(const fs::path &folder, uint64_t max_size);
 
     virtual void select(size_t index, const SceGxmTexture &texture) = 0;
     virtual void configure_texture(const SceGxmTexture &texture) = 0;
@@ -154,6 +269,11 @@ public:
 
     void upload_texture(const SceGxmTexture &gxm_texture, MemState &mem);
     void cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemState &mem);
+    // can be called from any thread, starts hashing and converting the texture in the background
+    void prefetch_texture(const SceGxmTexture &gxm_texture, const MemState &mem);
+    // can be called from any thread once the host wrote to [start, end) of the guest memory (transfers, surface syncs),
+    // the pending prefetches which may have read this memory before the write are dropped
+    void invalidate_prefetches(Address start, Address end);
 
     // is called by cache_and_bind_texture if use_sampler_cache is set to true
     int cache_and_bind_sampler(const SceGxmTexture &gxm_texture, bool is_depth = false);
@@ -0,0 +1,73 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <renderer/texture_cache.h>
+
+#include <util/containers.h>
+#include <util/fs.h>
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace renderer {
+
+/**
+ * @brief Cache on disk of the converted content of the textures which are slow to decode (PVRT, BCn when not supported by the GPU)
+ *
+ * Each texture is stored deflate compressed in its own file, named after a hash of its content and layout.
+ * Once the total size gets above the limit, the least recently used files are removed.
+ * All the functions can be called from any thread.
+ */
+class TextureDiskCache {
+public:
+    void init(const fs::path &folder, uint64_t max_size);
+    bool is_enabled() const {
+        return max_size > 0;
+    }
+
+    // returns false if the texture is not in the cache, levels is left untouched in this case
+    bool load(uint64_t key, std::vector<TextureUploadLevel> &levels);
+    // does nothing if one of the levels was not converted
+    void store(uint64_t key, const std::vector<TextureUploadLevel> &levels);
+
+    uint64_t get_total_size();
+
+private:
+    struct Entry {
+        uint64_t size;
+        std::list<uint64_t>::iterator lru_it;
+    };
+
+    fs::path get_entry_path(uint64_t key) const;
+    // must be called with the mutex locked
+    void evict();
+
+    fs::path folder;
+    uint64_t max_size = 0;
+
+    std::mutex mutex;
+    uint64_t total_size = 0;
+    unordered_map_fast<uint64_t, Entry> entries;
+    // most recently used first
+    std::list<uint64_t> lru;
+};
+
+} // namespace renderer
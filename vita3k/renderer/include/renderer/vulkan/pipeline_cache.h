@@ -19,11 +19,13 @@
 
 #include <blockingconcurrentqueue.h>
 #include <util/containers.h>
+#include <util/fs.h>
 #include <vkutil/vkutil.h>
 
 #include <array>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 #include <thread>
 #include <vector>
@@ -51,6 +53,53 @@ struct CompileRequest;
 
 using PipelineCompileQueue = moodycamel::BlockingConcurrentQueue<CompileRequest *>;
 
+// arguments given to PipelineCache::retrieve_render_pass
+struct RenderPassParams {
+    vk::Format format;
+    bool force_load;
+    bool force_store;
+    bool is_color_transient;
+    bool no_color;
+
+    bool operator==(const RenderPassParams &) const = default;
+};
+
+// Everything needed to compile a pipeline again without its gxm programs
+// These are saved along the pipeline cache so the pipelines used by a game can be compiled while it boots
+struct PipelineDescription {
+    // fixed-size part, written field by field to the disk
+    struct Parameters {
+        Sha256Hash vertex_hash;
+        Sha256Hash fragment_hash;
+        vk::PipelineColorBlendAttachmentState blending;
+        vk::StencilOpState front_stencil;
+        vk::StencilOpState back_stencil;
+        vk::PrimitiveTopology topology;
+        vk::PolygonMode polygon_mode;
+        vk::CullModeFlags cull_mode;
+        vk::CompareOp depth_func;
+        vk::PipelineColorBlendStateCreateFlags color_blend_flags;
+        uint32_t vertex_texture_count;
+        uint32_t fragment_texture_count;
+        bool depth_write;
+        bool fragment_disabled;
+        // is the gamma correction specialization constant used by the fragment shader, and its value
+        bool use_srgb_specialization;
+        bool is_srgb;
+        RenderPassParams render_pass;
+
+        bool operator==(const Parameters &) const = default;
+    } params;
+
+    std::vector<vk::VertexInputBindingDescription> bindings;
+    std::vector<vk::VertexInputAttributeDescription> attributes;
+};
+
+// the descriptions are kept from one session to the next in a file next to the pipeline cache
+// reading stops at the first corrupted description, the ones before it are kept
+void read_pipeline_descriptions(const fs::path &path, unordered_map_fast<uint64_t, PipelineDescription> &descriptions);
+void save_pipeline_descriptions(const fs::path &path, const std::vector<std::pair<uint64_t, PipelineDescription>> &descriptions);
+
 class PipelineCache {
     friend struct VKState;
 
@@ -91,6 +140,23 @@ private:
     unordered_map_stable<Sha256Hash, vk::ShaderModule> shaders;
     unordered_map_stable<uint64_t, vk::Pipeline> pipelines;
 
+    // arguments used to create each render pass, so pipeline descriptions can refer to them
+    std::mutex render_pass_mutex;
+    unordered_map_fast<VkRenderPass, RenderPassParams> render_pass_params;
+
+    // descriptions of all the pipelines compiled for this game, including the ones from previous sessions
+    std::mutex descriptions_mutex;
+    unordered_map_fast<uint64_t, PipelineDescription> pipeline_descriptions;
+
+    struct PrecompiledPipeline {
+        vk::Pipeline pipeline;
+        Sha256Hash vertex_hash;
+        Sha256Hash fragment_hash;
+    };
+    // pipelines compiled while booting which were not used yet
+    // the key of a pipeline contains the address of its programs, so the shader hashes must be checked before using them
+    unordered_map_fast<uint64_t, PrecompiledPipeline> precompiled_pipelines;
+
     vk::PipelineShaderStageCreateInfo retrieve_shader(const SceGxmProgram *program, const Sha256Hash &hash, bool is_vertex, bool maskupdate, MemState &mem, const shader::Hints &hints, bool is_srgb = false);
     vk::PipelineVertexInputStateCreateInfo get_vertex_input_state(const SceGxmVertexProgram &vertex_program, MemState &mem);
 
@@ -102,7 +168,8 @@ private:
     // each pipeline compiler thread uses this function as its entrypoint
     void compiler_thread(MemState &mem);
 
-    vk::Pipeline compile_pipeline(SceGxmPrimitiveType type, vk::RenderPass render_pass, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem);
+    vk::Pipeline create_pipeline(const PipelineDescription &description, vk::RenderPass render_pass, vk::ShaderModule vertex_shader, vk::ShaderModule fragment_shader);
+    vk::Pipeline compile_pipeline(uint64_t key, SceGxmPrimitiveType type, vk::RenderPass render_pass, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem);
 
 public:
     // if not 0, next time the pipeline cache should be saved (in seconds since epoch)
@@ -133,6 +200,9 @@ public:
     vk::Pipeline retrieve_pipeline(VKContext &context, SceGxmPrimitiveType &type, bool consider_for_async, MemState &mem);
 
     vk::ShaderModule precompile_shader(const Sha256Hash &hash, bool search_first = true);
+    // compile the pipelines from the descriptions saved during the previous sessions
+    // must be called after the shaders have been precompiled
+    void precompile_pipelines();
 
     void set_async_compilation(bool enable);
 };
@@ -159,6 +159,8 @@ struct VKState : public renderer::State {
     uint32_t get_gpu_version() override;
 
     void precompile_shader(const ShadersHash &hash) override;
+    void precompile_shaders(std::span<const ShadersHash> hashes) override;
+    void precompile_pipelines() override;
     void preclose_action() override;
 
     inline FrameObject &frame() {
@@ -19,10 +19,14 @@
 
 #include <gxm/types.h>
 #include <mem/ptr.h>
+#include <renderer/address_range_index.h>
 #include <renderer/gxm_types.h>
 #include <util/containers.h>
 #include <vkutil/objects.h>
 
+#include <array>
+#include <condition_variable>
+#include <mutex>
 #include <optional>
 
 struct SwsContext;
@@ -74,6 +78,32 @@ struct CastedTexture {
     SceGxmColorBaseFormat format;
 };
 
+// copy of a color surface in host memory, converted on a worker thread then written back to the guest memory
+struct SurfaceReadback {
+    vkutil::Buffer buffer;
+    // set when the copy is recorded, cleared once the converted surface has been written back
+    bool in_use = false;
+    // set while a worker converts it
+    bool converting = false;
+
+    // layout of the surface when the copy was recorded, the surface may have been destroyed
+    // or reused by the time the copy is converted
+    Ptr<void> data;
+    uint16_t width;
+    uint16_t height;
+    uint32_t pixel_stride;
+    SceGxmColorBaseFormat format;
+    vk::Format texture_format;
+    // swizzle to undo, eR if there is none
+    vk::ComponentSwizzle swizzle;
+
+    // pointer to decoder used for 3-component rgb surfaces
+    SwsContext *sws_context = nullptr;
+
+    SurfaceReadback() = default;
+    ~SurfaceReadback();
+};
+
 struct ColorSurfaceCacheInfo : public SurfaceCacheInfo {
     uint16_t width;
     uint16_t height;
@@ -95,25 +125,17 @@ struct ColorSurfaceCacheInfo : public SurfaceCacheInfo {
     // only used when upscaling is enabled, to downscale the image first
     std::unique_ptr<vkutil::Image> blit_image;
 
-    // only used for 3-component rgb textures which can't be copied directly
-    std::unique_ptr<vkutil::Buffer> copy_buffer;
-
     // pointer shared with the memory trap indicating if this surface sync is needed
     std::shared_ptr<bool> need_surface_sync;
 
-    // pointer to decoder used for surface sync (if necessary)
-    SwsContext *sws_context = nullptr;
-
-    // do we need some CPU convert/unswizzling part for surface sync
-    bool need_post_surface_sync = false;
+    // set if the last surface sync needs some CPU convert/unswizzling part
+    // null if the surface was copied directly to the guest memory
+    SurfaceReadback *readback = nullptr;
 
     // only for double buffer, do we need to sync the two views?
     bool need_buffer_sync = false;
 
     std::shared_ptr<bool> dirty = std::make_shared<bool>(false);
-
-    ColorSurfaceCacheInfo() = default;
-    ~ColorSurfaceCacheInfo();
 };
 
 struct DepthSurfaceView {
@@ -163,16 +185,17 @@ private:
     // only have 20 color surfaces and 20 depth surfaces allocated at most at a given time
     static constexpr uint32_t max_surfaces_allowed = 20;
 
-    std::map<Address, ColorSurfaceCacheInfo *> color_address_lookup;
+    AddressRangeIndex<ColorSurfaceCacheInfo *> color_address_lookup;
 
-    std::map<Address, DepthStencilSurfaceCacheInfo *> depth_address_lookup;
-    std::map<Address, DepthStencilSurfaceCacheInfo *> stencil_address_lookup;
+    AddressRangeIndex<DepthStencilSurfaceCacheInfo *> depth_address_lookup;
+    AddressRangeIndex<DepthStencilSurfaceCacheInfo *> stencil_address_lookup;
 
     // structure allowing to set the lru surface with a good complexity
     lru::Queue<ColorSurfaceCacheInfo> color_surface_queue;
     lru::Queue<DepthStencilSurfaceCacheInfo> ds_surface_queue;
 
-    std::map<std::pair<vk::ImageView, vk::ImageView>, Framebuffer> framebuffer_array;
+    // key is the color and depth-stencil views, using the C handles so the pair can be hashed
+    unordered_map_fast<std::pair<VkImageView, VkImageView>, Framebuffer> framebuffer_array;
 
     // used with check_for_surface
     // contains the addresses of the surfaces that are the target
@@ -183,6 +206,23 @@ private:
     VKRenderTarget *target = nullptr;
     ColorSurfaceCacheInfo *last_written_surface = nullptr;
 
+    // the readbacks are used in turn, so a surface can be copied by the GPU
+    // while the copies of the previous frames are still being converted
+    static constexpr uint32_t readback_ring_size = 4;
+    std::array<SurfaceReadback, readback_ring_size> readback_ring;
+    uint32_t readback_ring_index = 0;
+
+    // protects in_use and converting of the readbacks and readbacks_pending
+    std::mutex readback_mutex;
+    std::condition_variable readback_cond;
+    // number of readbacks being converted on the worker threads
+    uint32_t readbacks_pending = 0;
+
+    // wait for the next readback of the ring to be available
+    SurfaceReadback &acquire_readback();
+    // give back a readback acquired for a sync which does not need it
+    void release_readback(SurfaceReadback &readback);
+
     // destroy all framebuffers using view as their color or depth-stencil
     void destroy_framebuffers(vk::ImageView view);
 
@@ -218,11 +258,17 @@ public:
     // so that subsequent calls to check_for_surface with the target destination also get delayed
     bool check_for_surface(MemState &mem, Address source_address, CallbackRequestFunction &callback, Address target_address);
 
-    // If non-null, the return value must be sent as a PostSurfaceSyncRequest
-    ColorSurfaceCacheInfo *perform_surface_sync();
+    // If the return value is non-null, it must be sent as a PostSurfaceSyncRequest
+    // acquired_readback is a readback already taken with acquire_readback, for callers which can't wait for one
+    ColorSurfaceCacheInfo *perform_surface_sync(SurfaceReadback *acquired_readback = nullptr);
+
+    // Called after the render has been done, the readback is converted and written back
+    // to the guest memory on a worker thread, the textures prefetched from this memory are dropped afterwards
+    void perform_post_surface_sync(const MemState &mem, SurfaceReadback *readback);
 
-    // Called after the render has been done
-    void perform_post_surface_sync(const MemState &mem, ColorSurfaceCacheInfo *surface);
+    // Wait for all the readbacks being converted to be written back to the guest memory
+    // Must be called before letting the guest know a render is done
+    void wait_for_readbacks();
 
     // destroy all framebuffers associated with render_target
     // (meaning their color or depth-stencil surface is not backed by memory)
@@ -72,6 +72,8 @@ struct VKTextureCache : public TextureCache {
     void configure_texture(const SceGxmTexture &texture) override;
     void upload_texture_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, uint32_t mip_index, const void *pixels, int face, uint32_t pixels_per_stride) override;
     void upload_done() override;
+    uint32_t get_memory_size(const SceGxmTexture &texture) const override;
+    void release_texture(size_t index) override;
 
     void configure_sampler(size_t index, const SceGxmTexture &texture, bool no_linear) override;
 
@@ -188,10 +190,14 @@ struct SyncSignalRequest {
     SceGxmSyncObject *sync;
     uint32_t timestamp;
 };
-struct ColorSurfaceCacheInfo;
+struct SurfaceReadback;
 
+// sent after each surface sync, the range [location, location+size] of the guest memory is written
+// once the GPU is done (and the readback converted if there is one)
 struct PostSurfaceSyncRequest {
-    ColorSurfaceCacheInfo *cache_info;
+    SurfaceReadback *readback;
+    Address location;
+    uint32_t size;
 };
 
 using CallbackRequestFunction = std::function<void()>;
@@ -30,8 +30,11 @@
 #include <overlay/shader_precompile_progress.h>
 #include <util/log.h>
 
+#include <algorithm>
 #include <memory>
+#include <span>
 #include <thread>
+#include <utility>
 
 #ifdef TRACY_ENABLE
 #include <tracy/Tracy.hpp>
@@ -48,6 +51,47 @@ void generic_command_free(Command *cmd) {
     delete cmd;
 }
 
+// Returns the first of count unused slots of the current block, starting a new block when there are not enough left
+static Command *take_command_slots(CommandArena::Blocks &recording_blocks, CommandArena::Blocks &free_blocks, size_t count) {
+    assert(count <= CommandArena::BLOCK_COMMAND_COUNT);
+    if (recording_blocks.empty() || recording_blocks.back()->used + count > CommandArena::BLOCK_COMMAND_COUNT) {
+        if (free_blocks.empty()) {
+            recording_blocks.push_back(std::make_unique<CommandArena::Block>());
+        } else {
+            recording_blocks.push_back(std::move(free_blocks.back()));
+            free_blocks.pop_back();
+        }
+    }
+
+    CommandArena::Block &block = *recording_blocks.back();
+    Command *slots = &block.commands[block.used];
+    block.used += count;
+    return slots;
+}
+
+Command *CommandArena::allocate() {
+    return new (take_command_slots(recording_blocks, free_blocks, 1)) Command;
+}
+
+void *CommandArena::allocate_data(size_t size) {
+    return take_command_slots(recording_blocks, free_blocks, (size + sizeof(Command) - 1) / sizeof(Command));
+}
+
+CommandArena::Blocks CommandArena::take_blocks() {
+    return std::exchange(recording_blocks, {});
+}
+
+void CommandArena::release(Blocks &blocks) {
+    for (auto &block : blocks) {
+        if (free_blocks.size() >= MAX_FREE_BLOCKS)
+            break;
+
+        block->used = 0;
+        free_blocks.push_back(std::move(block));
+    }
+    blocks.clear();
+}
+
 void complete_command(State &state, CommandHelper &helper, const int code) {
     auto lock = std::unique_lock(state.command_finish_one_mutex);
     helper.complete(code);
@@ -196,20 +240,27 @@ static void render_loop(renderer::State &state, DisplayState &display, GxmState
         const int total = static_cast<int>(state.precompile_queue.size());
         state.precompile_total = total;
 
-        for (int i = 0; i < total && !state.render_abort.load(std::memory_order_relaxed); ++i) {
+        // shaders are handled by batches, which the backend can split between multiple threads
+        constexpr int precompile_batch_size = 32;
+        for (int i = 0; i < total && !state.render_abort.load(std::memory_order_relaxed); i += precompile_batch_size) {
             if (!state.set_current())
                 break;
 
-            state.precompile_shader(state.precompile_queue[i]);
-            state.precompile_progress = i + 1;
+            const int count = std::min(precompile_batch_size, total - i);
+            state.precompile_shaders(std::span<const ShadersHash>(state.precompile_queue).subspan(i, count));
+            state.precompile_progress = i + count;
 
             if (progress_overlay) {
-                progress_overlay->set_progress(i + 1, total);
+                progress_overlay->set_progress(i + count, total);
                 state.render_frame(display, gxm, mem);
                 state.swap_window();
             }
         }
 
+        // the pipelines need the shaders, so compile them last
+        if (!state.render_abort.load(std::memory_order_relaxed))
+            state.precompile_pipelines();
+
         state.precompile_queue.clear();
 
         if (progress_overlay) {
@@ -279,7 +279,7 @@ bool init(FrameHost &frame, std::unique_ptr<State> &state, Backend backend, cons
     state->current_backend = backend;
 
     // Can change this
-    state->command_buffer_queue.maxPendingCount_ = 30;
+    state->command_buffer_queue.set_capacity(30);
 
     return true;
 }
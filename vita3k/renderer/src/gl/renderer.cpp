@@ -34,6 +34,7 @@
 
 #include <gxm/functions.h>
 #include <gxm/types.h>
+#include <mem/util.h>
 #include <util/log.h>
 
 #ifdef _WIN32
@@ -262,6 +263,9 @@ bool GLState::init() {
 
 void GLState::late_init(const Config &cfg, const std::string_view game_id, MemState &mem) {
     texture_cache.init(true, texture_folder(), game_id);
+    texture_cache.async_upload = cfg.async_texture_upload;
+    if (cfg.texture_disk_cache)
+        texture_cache.init_disk_cache(cache_path / "textures" / std::string(game_id), MiB(cfg.texture_disk_cache_size));
 }
 
 bool create(std::unique_ptr<Context> &context) {
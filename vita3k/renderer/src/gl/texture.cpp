@@ -241,6 +241,11 @@ void GLTextureCache::upload_texture_impl(SceGxmTextureBaseFormat base_format, ui
     }
 }
 
+void GLTextureCache::release_texture(size_t index) {
+    // a new texture name takes the place of the previous one and its storage
+    textures.reset(index);
+}
+
 void GLTextureCache::import_configure_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, bool is_srgb, uint16_t nb_components, uint16_t mipcount, bool swap_rb) {
     SceGxmTexture &gxm_texture = current_info->texture;
     GLint default_swizzle[] = { GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA };
@@ -28,6 +28,7 @@
 #include <overlay/shader_compile_notice.h>
 #include <renderer/gl/state.h>
 #include <renderer/gl/types.h>
+#include <renderer/texture_cache.h>
 #include <renderer/vulkan/functions.h>
 
 #include <gxm/functions.h>
@@ -79,6 +80,9 @@ void State::update_overlays() {
 
         perf->set_position(static_cast<overlay::screen_quadrant>(perf_overlay.position));
         perf->set_detail_level(static_cast<overlay::perf_detail_level>(perf_overlay.detail));
+        perf->set_texture_cache_data(perf_overlay.texture_hits, perf_overlay.texture_misses,
+            perf_overlay.texture_evictions, perf_overlay.texture_memory_used,
+            perf_overlay.texture_memory_budget);
         perf->set_fps_data(perf_overlay.fps, perf_overlay.avg_fps, perf_overlay.min_fps,
             perf_overlay.max_fps, perf_overlay.ms_per_frame,
             perf_overlay.fps_values.data(), perf_overlay.fps_values_count,
@@ -182,6 +186,10 @@ void set_texture(State &state, Context *ctx, const std::uint32_t tex_index, cons
     renderer::add_state_set_command(ctx, renderer::GXMState::Texture, tex_index, tex);
 }
 
+void prefetch_texture(State &state, const SceGxmTexture &tex, const MemState &mem) {
+    state.get_texture_cache()->prefetch_texture(tex, mem);
+}
+
 void set_viewport_real(State &state, Context *ctx, float xOffset, float yOffset, float zOffset, float xScale, float yScale, float zScale) {
     renderer::add_state_set_command(ctx, renderer::GXMState::Viewport, false, xOffset, yOffset,
         zOffset, xScale, yScale, zScale);
@@ -19,14 +19,20 @@
 
 #include <renderer/profile.h>
 #include <renderer/texture_cache.h>
+#include <renderer/texture_disk_cache.h>
 
 #include <gxm/functions.h>
 #include <mem/ptr.h>
 #include <util/align.h>
 #include <util/log.h>
 
+#include <threads/worker_pool.h>
+
 #include <algorithm>
 #include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <numeric>
 #if defined(__x86_64__) && !defined(__APPLE__)
 #include <xxh_x86dispatch.h>
@@ -242,7 +248,9 @@ uint64_t hash_texture_nostride(const SceGxmTexture &texture, const MemState &mem
     }
 
     // all the pixels are not in a contiguous memory range
-    static XXH3_state_t *hash_state = XXH3_createState();
+    // textures are hashed by the render thread and the worker threads, so each one has its own state
+    thread_local const std::unique_ptr<XXH3_state_t, decltype(&XXH3_freeState)> thread_hash_state(XXH3_createState(), XXH3_freeState);
+    XXH3_state_t *const hash_state = thread_hash_state.get();
     XXH3_64bits_reset(hash_state);
 
     if (texture.texture_type() == SCE_GXM_TEXTURE_LINEAR || texture.texture_type() == SCE_GXM_TEXTURE_LINEAR_STRIDED) {
@@ -283,44 +291,13 @@ uint16_t get_upload_mip(const uint16_t true_mip, const uint16_t width, const uin
     uint16_t max_mip_text = std::bit_width(std::min(width, height));
     return std::min(true_mip, max_mip_text);
 }
-} // namespace texture
-
-using namespace texture;
-
-bool TextureCache::init(const bool hashless_texture_cache, const fs::path &texture_folder, std::string_view game_id, const size_t sampler_cache_size) {
-    use_protect = hashless_texture_cache;
-
-    // initialize the texture queue
-    texture_queue.init(TextureCacheSize);
-    // set the proper index of each entry
-    for (size_t i = 0; i < TextureCacheSize; i++)
-        texture_queue.items[i].content.index = static_cast<int>(i);
-
-    // prevent stutter caused by the hashmap resizing
-    texture_lookup.reserve(TextureCacheSize);
-
-    use_sampler_cache = sampler_cache_size > 0;
-    if (use_sampler_cache) {
-        sampler_queue.init(sampler_cache_size);
-
-        for (size_t i = 0; i < sampler_cache_size; i++)
-            sampler_queue.items[i].content.index = static_cast<int>(i);
-
-        sampler_lookup.reserve(sampler_cache_size);
-    }
-
-    export_folder = texture_folder / "export" / std::string(game_id);
-    import_folder = texture_folder / "import" / std::string(game_id);
-
-    refresh_available_textures();
-
-    return true;
-}
-
-void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
+// Convert every mip and face of the texture to a format the host can upload, on_level is called once per level.
+// If keep_data is set, the converted pixels are moved to the level instead of being reused for the next level.
+// yuv_cache can only be null if the texture is not a YUV texture.
+static void decode_texture(const SceGxmTexture &gxm_texture, const MemState &mem, const TextureDecodeSettings &settings, YUVConversionCache *yuv_cache, bool keep_data, const std::function<void(TextureUploadLevel &)> &on_level) {
     R_PROFILE(__func__);
 
-    bool is_vulkan = (backend == renderer::Backend::Vulkan);
+    const bool is_vulkan = settings.is_vulkan;
 
     const SceGxmTextureFormat fmt = gxm::get_format(gxm_texture);
     const SceGxmTextureBaseFormat base_format = gxm::get_base_format(fmt);
@@ -457,7 +434,7 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
         case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT4BPP:
         case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII2BPP:
         case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII4BPP:
-            if (support_pvrt) {
+            if (settings.support_pvrt) {
                 LOG_INFO_ONCE("Your device support SCE_GXM_TEXTURE_BASE_FORMAT_PVRT");
                 break;
             }
@@ -482,7 +459,7 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
             break;
         case SCE_GXM_TEXTURE_BASE_FORMAT_SE5M9M9M9:
             // this format is supported on all GPUs with vulkan
-            if (is_vulkan && support_e5rgb9) {
+            if (is_vulkan && settings.support_e5rgb9) {
                 LOG_INFO_ONCE("Your device support SCE_GXM_TEXTURE_BASE_FORMAT_SE5M9M9M9");
                 break;
             }
@@ -492,7 +469,7 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
             break;
         case SCE_GXM_TEXTURE_BASE_FORMAT_U2F10F10F10:
             // don't change what openGL is doing (which is completely wrong)
-            if (!is_vulkan || support_a2rgb10) {
+            if (!is_vulkan || settings.support_a2rgb10) {
                 LOG_INFO_ONCE("Your device support SCE_GXM_TEXTURE_BASE_FORMAT_U2F10F10F10");
                 break;
             }
@@ -503,7 +480,7 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
             break;
         case SCE_GXM_TEXTURE_BASE_FORMAT_X8U24:
             texture_data_decompressed.resize(pixels_per_stride * memory_height * 4);
-            if (is_vulkan && support_x8d24) {
+            if (is_vulkan && settings.support_x8d24) {
                 LOG_INFO_ONCE("Your device support SCE_GXM_TEXTURE_BASE_FORMAT_X8U24");
                 break;
             } else if (is_vulkan) {
@@ -528,7 +505,7 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
         case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
         case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
             texture_data_decompressed.resize(pixels_per_stride * memory_height * 4);
-            yuv420_texture_to_rgb(yuv_conversion_cache, texture_data_decompressed.data(),
+            yuv420_texture_to_rgb(*yuv_cache, texture_data_decompressed.data(),
                 static_cast<const uint8_t *>(pixels), pixels_per_stride, memory_height, layout_width, layout_height,
                 base_format == SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3);
             pixels = texture_data_decompressed.data();
@@ -556,7 +533,7 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
             pixels = texture_pixels_lineared.data();
         }
 
-        if (!support_dxt && gxm::is_bcn_format(base_format)) {
+        if (!settings.support_dxt && gxm::is_bcn_format(base_format)) {
             // decompress the texture
             const int num_comp = gxm::get_num_components(base_format);
             texture_data_decompressed.resize(pixels_per_stride * memory_height * num_comp);
@@ -566,9 +543,23 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
             upload_format = get_matching_decompressed_format(base_format);
         }
 
-        upload_texture_impl(upload_format, width, height, mip_index, pixels, upload_type, pixels_per_stride);
-        if (export_textures)
-            export_texture_impl(upload_format, width, height, mip_index, pixels, upload_type, pixels_per_stride);
+        TextureUploadLevel level{
+            .format = upload_format,
+            .width = width,
+            .height = height,
+            .mip_index = mip_index,
+            .face = upload_type,
+            .pixels_per_stride = pixels_per_stride,
+            .pixels = pixels
+        };
+        if (keep_data) {
+            // moving the vector keeps its content at the same address
+            if (pixels == texture_pixels_lineared.data())
+                level.data = std::move(texture_pixels_lineared);
+            else if (pixels == texture_data_decompressed.data())
+                level.data = std::move(texture_data_decompressed);
+        }
+        on_level(level);
 
         const uint32_t nb_pixels = align(layout_width, align_width) * align(layout_height, align_height);
         const uint32_t mip_size = (nb_pixels >> block_shift) * block_size;
@@ -612,6 +603,282 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
     }
 }
 
+// the textures for which loading the converted content from the disk is faster than converting it again
+static bool is_slow_to_decode(SceGxmTextureBaseFormat base_format, const TextureDecodeSettings &settings) {
+    if (gxm::is_pvrt_format(base_format))
+        return !settings.support_pvrt;
+    if (gxm::is_bcn_format(base_format))
+        return !settings.support_dxt;
+    return gxm::is_yuv_format(base_format);
+}
+
+// the textures kept in the disk cache, the YUV textures are video frames which are never seen again
+static bool use_disk_cache_for(SceGxmTextureBaseFormat base_format, const TextureDecodeSettings &settings) {
+    return is_slow_to_decode(base_format, settings) && !gxm::is_yuv_format(base_format);
+}
+
+// size of the guest memory read by decode_texture: every mip of every face with the padding between them
+static uint32_t get_decoded_data_size(const SceGxmTexture &gxm_texture) {
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(gxm_texture));
+    const uint32_t width = gxm::get_width(gxm_texture);
+    const uint32_t height = gxm::get_height(gxm_texture);
+    const uint32_t bpp = gxm::bits_per_pixel(base_format);
+    const uint32_t bytes_per_pixel = (bpp + 7) >> 3;
+    const uint32_t mip_count = get_upload_mip(gxm_texture.true_mip_count(), width, height);
+
+    const auto texture_type = gxm_texture.texture_type();
+    const bool is_cube = texture_type == SCE_GXM_TEXTURE_CUBE || texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY;
+    uint32_t face_align_bytes = 4;
+    if (is_cube && gxm_texture.mip_count != 0xF) {
+        const bool twok_align_cond1 = width >= 32 && height >= 32 && (bpp <= 8 || gxm::is_block_compressed_format(base_format));
+        const bool twok_align_cond2 = width >= 16 && height >= 16 && (bpp == 16 || bpp == 32);
+        const bool twok_align_cond3 = width >= 8 && height >= 8 && bpp == 64;
+        if (twok_align_cond1 || twok_align_cond2 || twok_align_cond3)
+            face_align_bytes = 2048;
+    }
+
+    const bool no_mip_padding = gxm_texture.mip_count == 0xF && texture_type == SCE_GXM_TEXTURE_LINEAR;
+    const auto [block_width, block_height] = gxm::get_block_size(base_format);
+    const uint32_t block_size = (block_width * block_height * bpp) / 8;
+    const uint32_t block_shift = std::bit_width(block_width * block_height) - 1;
+    uint32_t align_width = block_width;
+    uint32_t align_height = block_height;
+    if (texture_type == SCE_GXM_TEXTURE_LINEAR) {
+        align_width = std::max(align_width, 8U);
+    } else if (texture_type == SCE_GXM_TEXTURE_TILED) {
+        align_width = std::max(align_width, 32U);
+        align_height = std::max(align_height, 32U);
+    }
+    const auto get_mip_size = [&](uint32_t layout_width, uint32_t layout_height) {
+        const uint32_t nb_pixels = align(layout_width, align_width) * align(layout_height, align_height);
+        return (nb_pixels >> block_shift) * block_size;
+    };
+
+    // offset of the current level, and end of the data read so far, a strided level can be read past its mip size
+    uint64_t offset = 0;
+    uint64_t end = 0;
+    for (uint32_t face = 0; face < (is_cube ? 6U : 1U); face++) {
+        uint32_t level_width = width;
+        uint32_t level_height = height;
+        uint32_t layout_width = no_mip_padding ? width : next_power_of_two(width);
+        uint32_t layout_height = no_mip_padding ? height : next_power_of_two(height);
+        for (uint32_t mip = 0; mip < mip_count; mip++) {
+            uint32_t pixels_per_stride = level_width;
+            uint32_t memory_height = level_height;
+            if (texture_type == SCE_GXM_TEXTURE_SWIZZLED_ARBITRARY || texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY) {
+                pixels_per_stride = next_power_of_two(level_width);
+                memory_height = next_power_of_two(level_height);
+            } else if (texture_type == SCE_GXM_TEXTURE_LINEAR_STRIDED) {
+                pixels_per_stride = gxm::get_stride_in_bytes(gxm_texture) / bytes_per_pixel;
+                if (base_format == SCE_GXM_TEXTURE_BASE_FORMAT_P4)
+                    pixels_per_stride *= 2;
+            }
+            pixels_per_stride = align(pixels_per_stride, align_width);
+            memory_height = align(memory_height, align_height);
+            end = std::max(end, offset + static_cast<uint64_t>(pixels_per_stride) * memory_height * bpp / 8);
+
+            offset += get_mip_size(layout_width, layout_height);
+            level_width /= 2;
+            level_height /= 2;
+            layout_width /= 2;
+            layout_height /= 2;
+        }
+        if (is_cube && gxm_texture.mip_count != 0xF) {
+            // the space of all possible mips is there
+            for (; layout_width > 0 && layout_height > 0; layout_width /= 2, layout_height /= 2)
+                offset += get_mip_size(layout_width, layout_height);
+        }
+        offset = align(offset, face_align_bytes);
+    }
+
+    return static_cast<uint32_t>(std::max(offset, end));
+}
+
+static uint64_t get_disk_cache_key(const SceGxmTexture &gxm_texture, const MemState &mem) {
+    // only keep what describes the content, the addresses are not the same from one session to the other
+    SceGxmTexture layout = gxm_texture;
+    layout.data_addr = 0;
+    layout.palette_addr = 0;
+    layout.vaddr_mode = 0;
+    layout.uaddr_mode = 0;
+    layout.mip_filter = 0;
+    layout.min_filter = 0;
+    layout.mag_filter = 0;
+    layout.lod_bias = 0;
+    layout.lod_min0 = 0;
+    layout.lod_min1 = 0;
+
+    // all the levels and faces are loaded from the disk, they must all be part of the key
+    const uint64_t content_hash = hash_texture_data(gxm_texture, get_decoded_data_size(gxm_texture), mem);
+    return XXH3_64bits_withSeed(&layout, sizeof(layout), content_hash);
+}
+
+// Convert the texture into levels, loading them from the disk cache if they were converted in a previous session.
+static void decode_texture_levels(const SceGxmTexture &gxm_texture, const MemState &mem, const TextureDecodeSettings &settings, YUVConversionCache *yuv_cache, const std::shared_ptr<TextureDiskCache> &disk_cache, std::vector<TextureUploadLevel> &levels) {
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(gxm_texture));
+    const bool use_disk_cache = disk_cache->is_enabled() && use_disk_cache_for(base_format, settings);
+    uint64_t key = 0;
+    if (use_disk_cache) {
+        key = get_disk_cache_key(gxm_texture, mem);
+        if (disk_cache->load(key, levels))
+            return;
+    }
+
+    decode_texture(gxm_texture, mem, settings, yuv_cache, true, [&](TextureUploadLevel &level) {
+        levels.push_back(std::move(level));
+    });
+
+    if (use_disk_cache)
+        // compressing and writing the file takes a while and the levels are needed right now
+        WorkerPool::get().submit([disk_cache, key, levels]() {
+            disk_cache->store(key, levels);
+        });
+}
+
+} // namespace texture
+
+using namespace texture;
+
+bool TextureCache::init(const bool hashless_texture_cache, const fs::path &texture_folder, std::string_view game_id, const size_t sampler_cache_size) {
+    use_protect = hashless_texture_cache;
+    // stays disabled until init_disk_cache is called
+    disk_cache = std::make_shared<TextureDiskCache>();
+
+    // initialize the texture queue
+    texture_queue.init(TextureCacheSize);
+    // set the proper index of each entry
+    for (size_t i = 0; i < TextureCacheSize; i++)
+        texture_queue.items[i].content.index = static_cast<int>(i);
+
+    // prevent stutter caused by the hashmap resizing
+    texture_lookup.reserve(TextureCacheSize);
+
+    use_sampler_cache = sampler_cache_size > 0;
+    if (use_sampler_cache) {
+        sampler_queue.init(sampler_cache_size);
+
+        for (size_t i = 0; i < sampler_cache_size; i++)
+            sampler_queue.items[i].content.index = static_cast<int>(i);
+
+        sampler_lookup.reserve(sampler_cache_size);
+    }
+
+    export_folder = texture_folder / "export" / std::string(game_id);
+    import_folder = texture_folder / "import" / std::string(game_id);
+
+    refresh_available_textures();
+
+    return true;
+}
+
+void TextureCache::init_disk_cache(const fs::path &folder, uint64_t max_size) {
+    disk_cache->init(folder, max_size);
+}
+
+void TextureCache::set_memory_budget(uint64_t budget) {
+    stats.memory_budget.store(budget, std::memory_order_relaxed);
+}
+
+uint32_t TextureCache::get_memory_size(const SceGxmTexture &gxm_texture) const {
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(gxm_texture));
+    uint32_t width = gxm::get_width(gxm_texture);
+    uint32_t height = gxm::get_height(gxm_texture);
+    uint32_t mip_count = get_upload_mip(gxm_texture.true_mip_count(), width, height);
+
+    uint32_t bpp;
+    if (current_info && current_info->is_imported) {
+        width = current_info->width;
+        height = current_info->height;
+        mip_count = current_info->mip_count;
+        bpp = 32;
+    } else if (gxm::is_paletted_format(base_format) || is_slow_to_decode(base_format, get_decode_settings())) {
+        // converted to rgba8 before the upload
+        bpp = 32;
+    } else {
+        bpp = gxm::bits_per_pixel(base_format);
+    }
+
+    uint64_t size = 0;
+    for (uint32_t mip = 0; mip < std::max(mip_count, 1U); mip++)
+        size += (static_cast<uint64_t>(std::max(width >> mip, 1U)) * std::max(height >> mip, 1U) * bpp) / 8;
+
+    if (gxm_texture.texture_type() == SCE_GXM_TEXTURE_CUBE || gxm_texture.texture_type() == SCE_GXM_TEXTURE_CUBE_ARBITRARY)
+        size *= 6;
+
+    return static_cast<uint32_t>(std::min<uint64_t>(size, UINT32_MAX));
+}
+
+void TextureCache::evict_texture(TextureCacheInfo &info, bool release) {
+    const TextureGxmDataRepr texture_repr = std::bit_cast<TextureGxmDataRepr>(info.texture);
+    texture_lookup.erase(texture_repr);
+    if (async_upload) {
+        const std::lock_guard<std::mutex> lock(prefetch_state->mutex);
+        prefetch_state->uploaded_hashes.erase(texture_repr);
+    }
+
+    if (release)
+        release_texture(info.index);
+
+    stats.memory_used.fetch_sub(info.memory_size, std::memory_order_relaxed);
+    stats.evictions.fetch_add(1, std::memory_order_relaxed);
+    // an empty texture, the write protection callback compares it with the texture it was set for
+    info.texture = std::bit_cast<SceGxmTexture>(TextureGxmDataRepr{});
+    info.texture_size = 0;
+    info.memory_size = 0;
+    info.is_imported = false;
+}
+
+void TextureCache::enforce_memory_budget() {
+    const uint64_t budget = stats.memory_budget.load(std::memory_order_relaxed);
+    if (budget == 0)
+        return;
+
+    // never evict the textures which may still be bound to the current draw
+    constexpr uint64_t min_eviction_age = SCE_GXM_MAX_TEXTURE_UNITS * 2;
+
+    TextureCacheInfo *info = texture_queue.get_lru();
+    const TextureCacheInfo *mru = texture_queue.get_mru();
+    while (stats.memory_used.load(std::memory_order_relaxed) > budget && info != mru) {
+        TextureCacheInfo *next = texture_queue.get_more_recent(info);
+        if (info->texture_size > 0) {
+            // the textures after this one have been used even more recently
+            if (use_counter - info->last_use < min_eviction_age)
+                break;
+
+            evict_texture(*info, true);
+            // reuse the empty slot first
+            texture_queue.set_as_lru(info);
+        }
+        info = next;
+    }
+}
+
+void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
+    const TextureDecodeSettings settings = get_decode_settings();
+    if (disk_cache->is_enabled() && use_disk_cache_for(gxm::get_base_format(gxm::get_format(gxm_texture)), settings)) {
+        std::vector<TextureUploadLevel> levels;
+        decode_texture_levels(gxm_texture, mem, settings, &yuv_conversion_cache, disk_cache, levels);
+        upload_levels(levels);
+        return;
+    }
+
+    decode_texture(gxm_texture, mem, settings, &yuv_conversion_cache, false, [&](TextureUploadLevel &level) {
+        upload_texture_impl(level.format, level.width, level.height, level.mip_index, level.pixels, level.face, level.pixels_per_stride);
+        if (export_textures)
+            export_texture_impl(level.format, level.width, level.height, level.mip_index, level.pixels, level.face, level.pixels_per_stride);
+    });
+}
+
+void TextureCache::upload_levels(const std::vector<TextureUploadLevel> &levels) {
+    R_PROFILE(__func__);
+
+    for (const TextureUploadLevel &level : levels) {
+        upload_texture_impl(level.format, level.width, level.height, level.mip_index, level.pixels, level.face, level.pixels_per_stride);
+        if (export_textures)
+            export_texture_impl(level.format, level.width, level.height, level.mip_index, level.pixels, level.face, level.pixels_per_stride);
+    }
+}
+
 // remove everything related to the sampler state
 static constexpr TextureGxmDataRepr default_texture_mask = {
     0x981E0000,
@@ -626,15 +893,46 @@ static constexpr TextureGxmDataRepr strided_texture_mask = {
     0xF3FFFFFF
 };
 
-void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
-    R_PROFILE(__func__);
+// pending prefetches which were never used are dropped past this count
+static constexpr size_t MAX_PENDING_PREFETCHES = 256;
 
-    size_t index = 0;
-    bool configure = false;
-    bool upload = false;
+// To prevent protecting too commonly accessed data that belongs to the page where the texture also resides
+// (for example, uniform buffer value and texture data got mixed, so page faults are triggered too many, it's not always good).
+// This works under the assumption that once this big enough texture decided to modify. It will have to modify either all of its data,
+// or replace with an entire new texture.
+static bool can_protect_texture(Address data_addr, uint32_t texture_size, const MemState &mem) {
+    if (texture_size < mem.host_page_size * 4)
+        return false;
 
-    // Try to find GXM texture in cache.
-    int cached_gxm_texture_index = -1;
+    const Address range_protect_begin = align(data_addr, mem.host_page_size);
+    const Address range_protect_end = align_down(data_addr + texture_size, mem.host_page_size);
+    return range_protect_end - range_protect_begin >= mem.host_page_size * 4;
+}
+
+static void run_prefetch(TexturePrefetch &prefetch, TexturePrefetchState &prefetch_state) {
+    const SceGxmTexture &texture = prefetch.texture;
+    const MemState &mem = *prefetch.mem;
+    if (prefetch.hash_nostride)
+        prefetch.hash = hash_texture_nostride(texture, mem);
+    else
+        prefetch.hash = hash_texture_data(texture, gxm::texture_size_first_mip(texture), mem) ^ 1;
+
+    if (prefetch.decode) {
+        bool is_uploaded;
+        {
+            const std::lock_guard<std::mutex> lock(prefetch_state.mutex);
+            const auto it = prefetch_state.uploaded_hashes.find(prefetch.repr);
+            is_uploaded = it != prefetch_state.uploaded_hashes.end() && it->second == prefetch.hash;
+        }
+
+        if (!is_uploaded)
+            decode_texture_levels(texture, mem, prefetch.settings, nullptr, prefetch.disk_cache, prefetch.levels);
+    }
+
+    prefetch.state.store(TexturePrefetch::Done, std::memory_order_release);
+}
+
+TextureGxmDataRepr TextureCache::get_texture_repr(const SceGxmTexture &gxm_texture) const {
     TextureGxmDataRepr texture_repr = std::bit_cast<TextureGxmDataRepr>(gxm_texture);
     if (use_sampler_cache) {
         // remove the sampler state from the representation
@@ -642,6 +940,162 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
         for (int i = 0; i < 4; i++)
             texture_repr[i] &= mask[i];
     }
+    return texture_repr;
+}
+
+TextureDecodeSettings TextureCache::get_decode_settings() const {
+    return TextureDecodeSettings{
+        .is_vulkan = backend == renderer::Backend::Vulkan,
+        .support_dxt = support_dxt,
+        .support_pvrt = support_pvrt,
+        .support_x8d24 = support_x8d24,
+        .support_e5rgb9 = support_e5rgb9,
+        .support_a2rgb10 = support_a2rgb10
+    };
+}
+
+void TextureCache::prefetch_texture(const SceGxmTexture &gxm_texture, const MemState &mem) {
+    if (!async_upload || gxm_texture.data_addr == 0)
+        return;
+
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(gxm_texture));
+    if (gxm::is_paletted_format(base_format) && gxm_texture.palette_addr == 0)
+        return;
+
+    // replaced textures are not converted, and the YUV conversion cache can only be used by the render thread
+    const bool decode = !import_textures && !gxm::is_yuv_format(base_format) && base_format != SCE_GXM_TEXTURE_BASE_FORMAT_YUV422;
+    // a protected texture is only uploaded again once it is written to, which the prefetch can't know about
+    if (use_protect && can_protect_texture(gxm_texture.data_addr << 2, gxm::texture_size_first_mip(gxm_texture), mem))
+        return;
+
+    auto prefetch = std::make_shared<TexturePrefetch>();
+    prefetch->texture = gxm_texture;
+    prefetch->repr = get_texture_repr(gxm_texture);
+    // the mips of a face are smaller than a third of the first one, a cube has 6 faces
+    const SceGxmTextureType texture_type = gxm_texture.texture_type();
+    const bool is_cube = texture_type == SCE_GXM_TEXTURE_CUBE || texture_type == SCE_GXM_TEXTURE_CUBE_ARBITRARY;
+    const uint64_t data_size = static_cast<uint64_t>(gxm::texture_size_first_mip(gxm_texture)) * 2 * (is_cube ? 6 : 1);
+    prefetch->data_start = gxm_texture.data_addr << 2;
+    prefetch->data_end = static_cast<Address>(std::min<uint64_t>(prefetch->data_start + data_size, std::numeric_limits<Address>::max()));
+    if (gxm::is_paletted_format(base_format)) {
+        prefetch->palette_start = gxm_texture.palette_addr << 6;
+        prefetch->palette_end = prefetch->palette_start + 256 * sizeof(uint32_t);
+    }
+    prefetch->mem = &mem;
+    prefetch->settings = get_decode_settings();
+    prefetch->disk_cache = disk_cache;
+    prefetch->hash_nostride = import_textures || export_textures;
+    prefetch->decode = decode;
+
+    {
+        const std::lock_guard<std::mutex> lock(prefetch_state->mutex);
+        if (prefetch_state->unused.count(prefetch->repr))
+            return;
+
+        auto it = prefetch_state->pending.find(prefetch->repr);
+        if (it != prefetch_state->pending.end() && it->second->state.load(std::memory_order_relaxed) == TexturePrefetch::Queued)
+            // the pending prefetch has not read the texture yet, so it will get its latest content
+            return;
+
+        if (prefetch_state->pending.size() >= MAX_PENDING_PREFETCHES) {
+            // the finished prefetches which are still here will most likely never be used
+            for (auto pending_it = prefetch_state->pending.begin(); pending_it != prefetch_state->pending.end();) {
+                if (pending_it->second->state.load(std::memory_order_relaxed) == TexturePrefetch::Done) {
+                    prefetch_state->unused.insert(pending_it->first);
+                    pending_it = prefetch_state->pending.erase(pending_it);
+                } else {
+                    ++pending_it;
+                }
+            }
+        }
+
+        prefetch_state->pending[prefetch->repr] = prefetch;
+    }
+
+    WorkerPool::get().submit([prefetch, prefetch_state = prefetch_state]() {
+        int expected = TexturePrefetch::Queued;
+        if (!prefetch->state.compare_exchange_strong(expected, TexturePrefetch::Running, std::memory_order_acquire))
+            // the render thread needed it first and ran it itself
+            return;
+
+        run_prefetch(*prefetch, *prefetch_state);
+
+        { const std::lock_guard<std::mutex> lock(prefetch_state->mutex); }
+        prefetch_state->done_cond.notify_all();
+    });
+}
+
+void TextureCache::invalidate_prefetches(Address start, Address end) {
+    if (!async_upload || start >= end)
+        return;
+
+    const std::lock_guard<std::mutex> lock(prefetch_state->mutex);
+    for (auto it = prefetch_state->pending.begin(); it != prefetch_state->pending.end();) {
+        const TexturePrefetch &prefetch = *it->second;
+        const bool overlaps = (start < prefetch.data_end && prefetch.data_start < end)
+            || (start < prefetch.palette_end && prefetch.palette_start < end);
+        // even a prefetch still queued is dropped, a worker may be reading the texture right now
+        if (overlaps)
+            it = prefetch_state->pending.erase(it);
+        else
+            ++it;
+    }
+}
+
+std::shared_ptr<TexturePrefetch> TextureCache::take_prefetch(const TextureGxmDataRepr &texture_repr) {
+    std::shared_ptr<TexturePrefetch> prefetch;
+    {
+        const std::lock_guard<std::mutex> lock(prefetch_state->mutex);
+        // the texture is used, it can be prefetched again
+        prefetch_state->unused.erase(texture_repr);
+
+        auto it = prefetch_state->pending.find(texture_repr);
+        if (it == prefetch_state->pending.end())
+            return nullptr;
+
+        prefetch = std::move(it->second);
+        prefetch_state->pending.erase(it);
+    }
+
+    int expected = TexturePrefetch::Queued;
+    if (prefetch->state.compare_exchange_strong(expected, TexturePrefetch::Running, std::memory_order_acquire)) {
+        // no worker started it yet, running it now is faster than waiting for one
+        run_prefetch(*prefetch, *prefetch_state);
+        return prefetch;
+    }
+
+    if (prefetch->state.load(std::memory_order_acquire) != TexturePrefetch::Done) {
+        R_PROFILE("wait_texture_prefetch");
+        std::unique_lock<std::mutex> lock(prefetch_state->mutex);
+        prefetch_state->done_cond.wait(lock, [&]() { return prefetch->state.load(std::memory_order_acquire) == TexturePrefetch::Done; });
+    }
+
+    return prefetch;
+}
+
+void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
+    R_PROFILE(__func__);
+
+    size_t index = 0;
+    bool configure = false;
+    bool upload = false;
+
+    // Try to find GXM texture in cache.
+    int cached_gxm_texture_index = -1;
+    const TextureGxmDataRepr texture_repr = get_texture_repr(gxm_texture);
+
+    // use the hash computed ahead if it is of the kind we need
+    const bool hash_nostride = import_textures || export_textures;
+    std::shared_ptr<TexturePrefetch> prefetch = async_upload ? take_prefetch(texture_repr) : nullptr;
+    const auto get_hash = [&](uint32_t texture_size) {
+        if (prefetch && prefetch->hash_nostride == hash_nostride)
+            return prefetch->hash;
+        if (hash_nostride)
+            return hash_texture_nostride(gxm_texture, mem);
+        // the xor 1 is to make sure it won't be the same as hash_texture_nostride
+        return hash_texture_data(gxm_texture, texture_size, mem) ^ 1;
+    };
+
     auto gxm_it = texture_lookup.find(texture_repr);
     if (gxm_it != texture_lookup.end())
         // we found the texture in the cache
@@ -659,7 +1113,8 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
         if (info->texture_size > 0) {
             // Cache is full.
             LOG_WARN_ONCE("Texture cache is full. Starting to replace textures");
-            texture_lookup.erase(std::bit_cast<TextureGxmDataRepr>(info->texture));
+            // the host texture is replaced when configured
+            evict_texture(*info, false);
         }
         texture_lookup[texture_repr] = info;
 
@@ -671,27 +1126,12 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
         // from texture_lookup later
         info->texture = std::bit_cast<SceGxmTexture>(texture_repr);
 
-        // To prevent protecting too commonly accessed data that belongs to the page where the texture also resides
-        // (for example, uniform buffer value and texture data got mixed, so page faults are triggered too many, it's not always good).
-        // This works under the assumption that once this big enough texture decided to modify. It will have to modify either all of its data,
-        // or replace with an entire new texture.
-        bool should_use_hash = true;
-        if (use_protect && info->texture_size >= mem.host_page_size * 4) {
+        info->use_hash = !(use_protect && can_protect_texture(gxm_texture.data_addr << 2, info->texture_size, mem));
+        if (info->use_hash) {
+            info->hash = get_hash(info->texture_size);
+        } else {
             range_protect_begin = align(gxm_texture.data_addr << 2, mem.host_page_size);
             range_protect_end = align_down((gxm_texture.data_addr << 2) + info->texture_size, mem.host_page_size);
-
-            if (range_protect_end - range_protect_begin >= mem.host_page_size * 4) {
-                should_use_hash = false;
-            }
-        }
-
-        info->use_hash = should_use_hash;
-        if (info->use_hash) {
-            if (import_textures || export_textures)
-                info->hash = hash_texture_nostride(gxm_texture, mem);
-            else
-                // the xor 1 is to make sure it won't be the same as hash_texture_nostride
-                info->hash = hash_texture_data(gxm_texture, info->texture_size, mem) ^ 1;
         }
     } else {
         // Texture is cached.
@@ -700,10 +1140,7 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
         configure = false;
         if (info->use_hash) {
             const uint64_t previous_hash = info->hash;
-            if (import_textures || export_textures)
-                info->hash = hash_texture_nostride(gxm_texture, mem);
-            else
-                info->hash = hash_texture_data(gxm_texture, info->texture_size, mem) ^ 1;
+            info->hash = get_hash(info->texture_size);
 
             upload = previous_hash != info->hash;
         } else {
@@ -714,13 +1151,18 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
     }
     current_info = info;
 
+    if (!info->use_hash)
+        // the texture may have been written between the prefetch and its protection being triggered,
+        // only the dirty flag tells, so neither the hash nor the levels of the prefetch can be used
+        prefetch.reset();
+
     if (gxm_texture.data_addr == 0) {
         upload = false;
     }
 
     if (upload && !info->use_hash && (import_textures || export_textures)) {
         // we still need to get a hash of the texture
-        info->hash = hash_texture_nostride(gxm_texture, mem);
+        info->hash = get_hash(info->texture_size);
     }
 
     importing_texture = false;
@@ -752,6 +1194,11 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
             importing_texture = false;
             info->is_imported = false;
         }
+
+        const uint32_t memory_size = get_memory_size(gxm_texture);
+        stats.memory_used.fetch_sub(info->memory_size, std::memory_order_relaxed);
+        stats.memory_used.fetch_add(memory_size, std::memory_order_relaxed);
+        info->memory_size = memory_size;
     }
     if (upload) {
         if (export_textures && !importing_texture)
@@ -759,9 +1206,20 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
 
         if (importing_texture)
             import_upload_texture();
+        else if (prefetch && !prefetch->levels.empty())
+            upload_levels(prefetch->levels);
         else
             upload_texture(gxm_texture, mem);
 
+        if (async_upload) {
+            // the workers won't convert the texture again as long as its content stays the same
+            const std::lock_guard<std::mutex> lock(prefetch_state->mutex);
+            if (info->use_hash)
+                prefetch_state->uploaded_hashes[texture_repr] = info->hash;
+            else
+                prefetch_state->uploaded_hashes.erase(texture_repr);
+        }
+
         if (!info->use_hash) {
             info->dirty = false;
             add_protect(mem, range_protect_begin, range_protect_end - range_protect_begin, MemPerm::ReadOnly, [info, texture_repr](Address, bool) {
@@ -781,9 +1239,19 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
     }
     importing_texture = false;
 
+    if (upload)
+        stats.misses.fetch_add(1, std::memory_order_relaxed);
+    else
+        stats.hits.fetch_add(1, std::memory_order_relaxed);
+
     // set the texture as the mru
+    info->last_use = ++use_counter;
     texture_queue.set_as_mru(info);
 
+    // only a newly configured texture can make the cache go above its budget
+    if (configure)
+        enforce_memory_budget();
+
     // retrieve the appropriate sampler if needed
     if (use_sampler_cache)
         cache_and_bind_sampler(gxm_texture);
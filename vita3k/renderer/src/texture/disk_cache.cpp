@@ -0,0 +1,307 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/texture_disk_cache.h>
+
+#include <gxm/functions.h>
+#include <mem/util.h>
+#include <util/log.h>
+
+#include <miniz.h>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <thread>
+
+namespace renderer {
+
+static constexpr uint32_t TEXTURE_FILE_MAGIC = 0x43585456; // VTXC
+// must be increased each time the content of a converted texture changes
+static constexpr uint32_t TEXTURE_FILE_VERSION = 1;
+static constexpr const char *TEXTURE_FILE_EXTENSION = ".tex";
+
+struct TextureFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t level_count;
+    // size of all the levels once uncompressed
+    uint32_t data_size;
+};
+
+struct TextureFileLevel {
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mip_index;
+    int32_t face;
+    uint32_t pixels_per_stride;
+    uint32_t data_size;
+};
+
+// largest size a converted level with these dimensions and format can have, 0 if the level can't be valid
+static uint64_t get_max_level_size(const TextureFileLevel &level) {
+    // the textures are at most 4096x4096, a linear stride can be larger than the width
+    if (level.width == 0 || level.height == 0 || level.width > 4096 || level.height > 4096 || level.pixels_per_stride < level.width || level.pixels_per_stride > 65536)
+        return 0;
+
+    const uint64_t bytes_per_pixel = (gxm::bits_per_pixel(static_cast<SceGxmTextureBaseFormat>(level.format)) + 7) / 8;
+    // the height is aligned on the tiles or on a power of two for swizzled textures
+    const uint64_t memory_height = std::max<uint64_t>(std::bit_ceil(level.height), (level.height + 31) / 32 * 32);
+    return level.pixels_per_stride * memory_height * bytes_per_pixel;
+}
+
+void TextureDiskCache::init(const fs::path &folder, uint64_t max_size) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    this->folder = folder;
+    this->max_size = max_size;
+    total_size = 0;
+    entries.clear();
+    lru.clear();
+
+    if (max_size == 0)
+        return;
+
+    boost::system::error_code error;
+    fs::create_directories(folder, error);
+    if (error) {
+        LOG_ERROR("Failed to create the texture cache folder {}: {}", folder, error.message());
+        this->max_size = 0;
+        return;
+    }
+
+    // the last write time of a file is the last time it was used
+    std::vector<std::pair<std::time_t, uint64_t>> files;
+    for (const auto &file : fs::directory_iterator(folder, error)) {
+        const fs::path &path = file.path();
+        if (path.extension() != TEXTURE_FILE_EXTENSION)
+            continue;
+
+        const std::string name = path.stem().string();
+        uint64_t key = 0;
+        const auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(), key, 16);
+        if (ec != std::errc() || ptr != name.data() + name.size())
+            continue;
+
+        const uint64_t size = fs::file_size(path, error);
+        if (error)
+            continue;
+
+        files.emplace_back(fs::last_write_time(path, error), key);
+        entries[key] = Entry{ size, {} };
+        total_size += size;
+    }
+
+    std::sort(files.begin(), files.end(), std::greater());
+    for (const auto &[time, key] : files)
+        entries[key].lru_it = lru.insert(lru.end(), key);
+
+    evict();
+    LOG_INFO("Texture disk cache: {} textures, {} MiB", entries.size(), total_size / MiB(1));
+}
+
+fs::path TextureDiskCache::get_entry_path(uint64_t key) const {
+    return folder / fmt::format("{:016X}{}", key, TEXTURE_FILE_EXTENSION);
+}
+
+void TextureDiskCache::evict() {
+    while (total_size > max_size && !lru.empty()) {
+        const uint64_t key = lru.back();
+        lru.pop_back();
+
+        auto it = entries.find(key);
+        total_size -= it->second.size;
+        entries.erase(it);
+
+        boost::system::error_code error;
+        fs::remove(get_entry_path(key), error);
+    }
+}
+
+bool TextureDiskCache::load(uint64_t key, std::vector<TextureUploadLevel> &levels) {
+    if (!is_enabled())
+        return false;
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end())
+            return false;
+
+        lru.splice(lru.begin(), lru, it->second.lru_it);
+    }
+
+    const fs::path path = get_entry_path(key);
+    const auto remove_entry = [&]() {
+        LOG_WARN("Removing invalid texture cache file {}", path);
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            total_size -= it->second.size;
+            lru.erase(it->second.lru_it);
+            entries.erase(it);
+        }
+
+        boost::system::error_code error;
+        fs::remove(path, error);
+        return false;
+    };
+
+    std::vector<uint8_t> file;
+    if (!fs_utils::read_data(path, file))
+        return remove_entry();
+
+    TextureFileHeader header;
+    if (file.size() < sizeof(header))
+        return remove_entry();
+    memcpy(&header, file.data(), sizeof(header));
+
+    const size_t levels_offset = sizeof(header);
+    const size_t data_offset = levels_offset + header.level_count * sizeof(TextureFileLevel);
+    if (header.magic != TEXTURE_FILE_MAGIC || header.version != TEXTURE_FILE_VERSION || header.key != key || file.size() < data_offset)
+        return remove_entry();
+
+    // the sizes come from the disk, check them against the dimensions of the levels before allocating anything
+    std::vector<TextureFileLevel> file_levels(header.level_count);
+    memcpy(file_levels.data(), &file[levels_offset], header.level_count * sizeof(TextureFileLevel));
+    uint64_t levels_size = 0;
+    for (const TextureFileLevel &file_level : file_levels) {
+        if (file_level.data_size > get_max_level_size(file_level))
+            return remove_entry();
+        levels_size += file_level.data_size;
+    }
+    if (levels_size != header.data_size)
+        return remove_entry();
+
+    std::vector<uint8_t> data(header.data_size);
+    mz_ulong data_size = header.data_size;
+    if (mz_uncompress(data.data(), &data_size, &file[data_offset], static_cast<mz_ulong>(file.size() - data_offset)) != MZ_OK || data_size != header.data_size)
+        return remove_entry();
+
+    std::vector<TextureUploadLevel> loaded_levels(header.level_count);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < header.level_count; i++) {
+        const TextureFileLevel &file_level = file_levels[i];
+        TextureUploadLevel &level = loaded_levels[i];
+        level.format = static_cast<SceGxmTextureBaseFormat>(file_level.format);
+        level.width = file_level.width;
+        level.height = file_level.height;
+        level.mip_index = file_level.mip_index;
+        level.face = file_level.face;
+        level.pixels_per_stride = file_level.pixels_per_stride;
+        level.data.assign(data.begin() + offset, data.begin() + offset + file_level.data_size);
+        level.pixels = level.data.data();
+        offset += file_level.data_size;
+    }
+
+    // keep the order of use between sessions
+    boost::system::error_code error;
+    fs::last_write_time(path, std::time(nullptr), error);
+
+    levels = std::move(loaded_levels);
+    return true;
+}
+
+void TextureDiskCache::store(uint64_t key, const std::vector<TextureUploadLevel> &levels) {
+    if (!is_enabled() || levels.empty())
+        return;
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        if (entries.count(key))
+            return;
+    }
+
+    size_t data_size = 0;
+    for (const TextureUploadLevel &level : levels) {
+        if (level.data.empty())
+            return;
+        data_size += level.data.size();
+    }
+
+    std::vector<uint8_t> data;
+    data.reserve(data_size);
+    for (const TextureUploadLevel &level : levels)
+        data.insert(data.end(), level.data.begin(), level.data.end());
+
+    const TextureFileHeader header{
+        .magic = TEXTURE_FILE_MAGIC,
+        .version = TEXTURE_FILE_VERSION,
+        .key = key,
+        .level_count = static_cast<uint32_t>(levels.size()),
+        .data_size = static_cast<uint32_t>(data_size)
+    };
+
+    const size_t data_offset = sizeof(header) + levels.size() * sizeof(TextureFileLevel);
+    mz_ulong compressed_size = mz_compressBound(static_cast<mz_ulong>(data_size));
+    std::vector<uint8_t> file(data_offset + compressed_size);
+    memcpy(file.data(), &header, sizeof(header));
+    for (size_t i = 0; i < levels.size(); i++) {
+        const TextureUploadLevel &level = levels[i];
+        const TextureFileLevel file_level{
+            .format = static_cast<uint32_t>(level.format),
+            .width = level.width,
+            .height = level.height,
+            .mip_index = level.mip_index,
+            .face = level.face,
+            .pixels_per_stride = level.pixels_per_stride,
+            .data_size = static_cast<uint32_t>(level.data.size())
+        };
+        memcpy(&file[sizeof(header) + i * sizeof(TextureFileLevel)], &file_level, sizeof(file_level));
+    }
+
+    // the fastest level, decoding is what takes time when loading
+    if (mz_compress2(&file[data_offset], &compressed_size, data.data(), static_cast<mz_ulong>(data_size), MZ_BEST_SPEED) != MZ_OK)
+        return;
+    file.resize(data_offset + compressed_size);
+
+    // write to a temporary file first so a partially written file is never loaded
+    const fs::path path = get_entry_path(key);
+    const fs::path temp_path = fs_utils::path_concat(path, fmt::format(".{}", std::hash<std::thread::id>()(std::this_thread::get_id())));
+    bool written;
+    {
+        fs::ofstream out(temp_path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(file.data()), file.size());
+        written = out.good();
+    }
+
+    boost::system::error_code error;
+    if (written)
+        fs::rename(temp_path, path, error);
+    if (!written || error) {
+        fs::remove(temp_path, error);
+        return;
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (entries.count(key))
+        return;
+    entries[key] = Entry{ file.size(), lru.insert(lru.begin(), key) };
+    total_size += file.size();
+    evict();
+}
+
+uint64_t TextureDiskCache::get_total_size() {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return total_size;
+}
+
+} // namespace renderer
@@ -16,13 +16,17 @@
 // with this program; if not, write to the Free Software Foundation, Inc.,
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include <gxm/types.h>
 #include <renderer/functions.h>
 #include <renderer/pvrt-dec.h>
+#include <threads/worker_pool.h>
 #include <util/log.h>
 
 namespace renderer::texture {
@@ -343,17 +347,80 @@ uint32_t encode_morton(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
     return result;
 }
 
-void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
-    if (bits_per_pixel % 8 != 0) {
-        // Don't support yet
+// conversions smaller than this (in bytes of output) are not worth being split between threads
+constexpr size_t MIN_PARALLEL_CONVERSION_SIZE = KiB(256);
+
+// Splits the rows of a conversion between the worker threads when the image is large enough
+template <typename F>
+static void for_each_row_range(uint32_t row_count, size_t row_size, F func) {
+    const size_t min_rows = std::max<size_t>(MIN_PARALLEL_CONVERSION_SIZE / std::max<size_t>(row_size, 1), 1);
+    if (row_count <= min_rows) {
+        func(0, row_count);
         return;
     }
 
-    uint8_t bytes_per_pixel = (bits_per_pixel + 7) >> 3;
-    uint32_t min = std::min(width, height);
-    uint32_t k = std::bit_width(min) - 1;
+    WorkerPool::get().parallel_for(row_count, min_rows, [&](size_t begin, size_t end) {
+        func(static_cast<uint32_t>(begin), static_cast<uint32_t>(end));
+    });
+}
 
-    for (uint32_t i = 0; i < width * static_cast<uint32_t>(height); i++) {
+template <uint32_t element_size>
+static void copy_element(uint8_t *dest, const uint8_t *src) {
+    memcpy(dest, src, element_size);
+}
+
+/**
+ * \brief Converts an image whose elements are stored in Z-order to a linear image.
+ *
+ * Instead of decoding the morton code of each source element, the code of each destination element is
+ * built from the contributions of its column and of its row, so the destination is written row by row.
+ */
+template <uint32_t element_size>
+static void unswizzle_elements(uint8_t *dest, const uint8_t *src, uint32_t width, uint32_t height) {
+    const uint32_t min = std::min(width, height);
+    const uint32_t k = std::bit_width(min) - 1;
+
+    // the bits of the larger dimension above the square part are stored above the interleaved bits
+    std::vector<uint32_t> column_codes(width);
+    for (uint32_t x = 0; x < width; x++) {
+        column_codes[x] = Part1By1(x & (min - 1)) << 1;
+        if (width > height)
+            column_codes[x] |= (x >> k) << (2 * k);
+    }
+    std::vector<uint32_t> row_codes(height);
+    for (uint32_t y = 0; y < height; y++) {
+        row_codes[y] = Part1By1(y & (min - 1));
+        if (height > width)
+            row_codes[y] |= (y >> k) << (2 * k);
+    }
+
+    for_each_row_range(height, width * element_size, [&](uint32_t row_begin, uint32_t row_end) {
+        for (uint32_t y = row_begin; y < row_end; y++) {
+            uint8_t *dest_row = dest + static_cast<size_t>(y) * width * element_size;
+            const uint32_t row_code = row_codes[y];
+            for (uint32_t x = 0; x < width; x++)
+                copy_element<element_size>(dest_row + x * element_size, src + static_cast<size_t>(column_codes[x] | row_code) * element_size);
+        }
+    });
+}
+
+static void unswizzle_elements(uint8_t *dest, const uint8_t *src, uint32_t width, uint32_t height, uint32_t element_size) {
+    // the row and column contributions only cover the whole source when both dimensions are powers of two
+    if (std::has_single_bit(width) && std::has_single_bit(height)) {
+        switch (element_size) {
+        case 1: return unswizzle_elements<1>(dest, src, width, height);
+        case 2: return unswizzle_elements<2>(dest, src, width, height);
+        case 3: return unswizzle_elements<3>(dest, src, width, height);
+        case 4: return unswizzle_elements<4>(dest, src, width, height);
+        case 8: return unswizzle_elements<8>(dest, src, width, height);
+        case 12: return unswizzle_elements<12>(dest, src, width, height);
+        case 16: return unswizzle_elements<16>(dest, src, width, height);
+        }
+    }
+
+    const uint32_t min = std::min(width, height);
+    const uint32_t k = std::bit_width(min) - 1;
+    for (uint32_t i = 0; i < width * height; i++) {
         uint32_t x = decode_morton2_x(i) & (min - 1);
         uint32_t y = decode_morton2_y(i) & (min - 1);
         uint32_t upper_bits = (i >> (2 * k)) << k;
@@ -363,8 +430,17 @@ void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint1
             y |= upper_bits;
         }
 
-        memcpy(dest + (y * width + x) * bytes_per_pixel, src + i * bytes_per_pixel, bytes_per_pixel);
+        memcpy(dest + (y * width + x) * element_size, src + i * element_size, element_size);
+    }
+}
+
+void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
+    if (bits_per_pixel % 8 != 0) {
+        // Don't support yet
+        return;
     }
+
+    unswizzle_elements(dest, src, width, height, bits_per_pixel >> 3);
 }
 
 void tiled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
@@ -377,18 +453,19 @@ void tiled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t
     const uint32_t bpp = bits_per_pixel >> 3;
     const uint32_t width_in_tiles = (width + 31) >> 5;
 
-    for (uint16_t y = 0; y < height; y++) {
-        for (uint16_t x = 0; x < width; x++) {
-            // Calculate texel address in tile
-            const uint32_t texel_offset_in_tile = (x & 0b11111) | ((y & 0b11111) << 5);
-            const uint32_t tile_address = (x >> 5) + width_in_tiles * (y >> 5);
-
-            const uint32_t offset = ((tile_address << 10) | (texel_offset_in_tile)) * bpp;
+    // the 32 texels of a tile row are contiguous, so a scanline is copied a tile row at a time
+    for_each_row_range(height, width * bpp, [&](uint32_t row_begin, uint32_t row_end) {
+        for (uint32_t y = row_begin; y < row_end; y++) {
+            uint8_t *dest_row = dest + static_cast<size_t>(y) * width * bpp;
+            for (uint32_t tile_x = 0; tile_x < width_in_tiles; tile_x++) {
+                const uint32_t tile_address = tile_x + width_in_tiles * (y >> 5);
+                const uint32_t offset = ((tile_address << 10) | ((y & 0b11111) << 5)) * bpp;
+                const uint32_t x = tile_x << 5;
 
-            // Make scanline
-            memcpy(dest + ((y * width) + x) * bpp, src + offset, bpp);
+                memcpy(dest_row + x * bpp, src + offset, std::min(32U, width - x) * bpp);
+            }
         }
-    }
+    });
 }
 
 uint32_t get_compressed_size(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height) {
@@ -468,22 +545,10 @@ static void decompress_block_bc1(const uint8_t *block_storage, uint32_t *image)
         std::uint32_t c2 = 0xFF000000 | (b2 << 16) | (g2 << 8) | r2;
         std::uint32_t c3 = 0xFF000000 | (b3 << 16) | (g3 << 8) | r3;
 
+        const std::uint32_t colors[4] = { c0, c1, c2, c3 };
         for (int i = 0; i < 16; ++i) {
             int index = (block_storage[i / 4] >> (i % 4 * 2)) & 0x03;
-            switch (index) {
-            case 0:
-                image[i] = c0;
-                break;
-            case 1:
-                image[i] = c1;
-                break;
-            case 2:
-                image[i] = c2;
-                break;
-            case 3:
-                image[i] = c3;
-                break;
-            }
+            image[i] = colors[index];
         }
     } else {
         // Transparent decode
@@ -493,22 +558,10 @@ static void decompress_block_bc1(const uint8_t *block_storage, uint32_t *image)
 
         std::uint32_t c2 = 0xFF000000 | (b2 << 16) | (g2 << 8) | r2;
 
+        const std::uint32_t colors[4] = { c0, c1, c2, 0x00000000 };
         for (int i = 0; i < 16; ++i) {
             int index = (block_storage[i / 4] >> (i % 4 * 2)) & 0x03;
-            switch (index) {
-            case 0:
-                image[i] = c0;
-                break;
-            case 1:
-                image[i] = c1;
-                break;
-            case 2:
-                image[i] = c2;
-                break;
-            case 3:
-                image[i] = 0x00000000;
-                break;
-            }
+            image[i] = colors[index];
         }
     }
 }
@@ -703,22 +756,27 @@ void decompress_bc_image(uint32_t width, uint32_t height, const uint8_t *block_s
     const uint32_t block_size = (format_id != 1 && format_id != 4 && format_id != 5) ? 16 : 8;
     const uint32_t line_size = block_count_x * 4;
 
-    auto decompress_bcn = [=, &block_storage]<typename T, typename F>(T _, F decompress_func) {
-        T temp_block_result[16] = {};
+    auto decompress_bcn = [=]<typename T, typename F>(T _, F decompress_func) {
         T *img = reinterpret_cast<T *>(image);
 
-        for (uint32_t j = 0; j < block_count_y; j++) {
-            for (uint32_t i = 0; i < block_count_x; i++) {
-                decompress_func(block_storage, temp_block_result);
+        // each row of blocks is independent
+        for_each_row_range(block_count_y, line_size * 4 * sizeof(T), [&](uint32_t row_begin, uint32_t row_end) {
+            T temp_block_result[16] = {};
+            const uint8_t *block = block_storage + static_cast<size_t>(row_begin) * block_count_x * block_size;
 
-                const uint32_t offset = j * 4 * line_size + i * 4;
-                for (uint32_t delta = 0; delta < 16; delta++) {
-                    img[offset + (delta % 4) + ((delta / 4) * line_size)] = temp_block_result[delta];
-                }
+            for (uint32_t j = row_begin; j < row_end; j++) {
+                for (uint32_t i = 0; i < block_count_x; i++) {
+                    decompress_func(block, temp_block_result);
+
+                    const uint32_t offset = j * 4 * line_size + i * 4;
+                    for (uint32_t delta = 0; delta < 16; delta++) {
+                        img[offset + (delta % 4) + ((delta / 4) * line_size)] = temp_block_result[delta];
+                    }
 
-                block_storage += block_size;
+                    block += block_size;
+                }
             }
-        }
+        });
     };
 
     switch (format_id) {
@@ -763,25 +821,10 @@ void decompress_bc_image(uint32_t width, uint32_t height, const uint8_t *block_s
  * \param dest      Pointer to the image where the decompressed pixels will be stored.
  */
 void resolve_z_order_compressed_image(uint32_t width, uint32_t height, const uint8_t *src, uint8_t *dest, const uint32_t block_size) {
-    uint32_t block_count_x = (width + 3) / 4;
-    uint32_t block_count_y = (height + 3) / 4;
-
-    uint32_t min = std::min(block_count_x, block_count_y);
-    uint32_t k = std::bit_width(min) - 1;
-
-    uint32_t block_count = block_count_x * block_count_y;
-    for (uint32_t i = 0; i < block_count; i++) {
-        uint32_t x = decode_morton2_x(i) & (min - 1);
-        uint32_t y = decode_morton2_y(i) & (min - 1);
-        uint32_t upper_bits = (i >> (2 * k)) << k;
-        if (block_count_x >= block_count_y) {
-            x |= upper_bits;
-        } else {
-            y |= upper_bits;
-        }
+    const uint32_t block_count_x = (width + 3) / 4;
+    const uint32_t block_count_y = (height + 3) / 4;
 
-        std::memcpy(dest + (y * block_count_x + x) * block_size, src + i * block_size, block_size);
-    }
+    unswizzle_elements(dest, src, block_count_x, block_count_y, block_size);
 }
 
 } // namespace renderer::texture
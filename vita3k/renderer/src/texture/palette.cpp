@@ -17,9 +17,53 @@
 
 #include <gxm/types.h>
 #include <mem/ptr.h>
+#include <threads/worker_pool.h>
+#include <util/instrset_detect.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((__target__("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define TARGET_AVX2
+#include <intrin.h>
+#endif
+#define PALETTE_HAS_AVX2
+#endif
 
 namespace renderer::texture {
 
+// palette textures smaller than this (in pixels) are converted on the calling thread
+constexpr uint32_t MIN_PARALLEL_PALETTE_PIXELS = 1 << 16;
+
+static void palette_8_to_rgba_basic(uint32_t *dst, const uint8_t *src, size_t count, const uint32_t *palette) {
+    for (size_t i = 0; i < count; i++)
+        dst[i] = palette[src[i]];
+}
+
+#ifdef PALETTE_HAS_AVX2
+// gathers 8 palette entries at a time
+static void TARGET_AVX2 palette_8_to_rgba_avx2(uint32_t *dst, const uint8_t *src, size_t count, const uint32_t *palette) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i)));
+        const __m256i colors = _mm256_i32gather_epi32(reinterpret_cast<const int *>(palette), indices, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), colors);
+    }
+    palette_8_to_rgba_basic(dst + i, src + i, count - i, palette);
+}
+#endif
+
+typedef void (*Palette8ToRgbaFunc)(uint32_t *dst, const uint8_t *src, size_t count, const uint32_t *palette);
+
+static Palette8ToRgbaFunc get_palette_8_to_rgba() {
+#ifdef PALETTE_HAS_AVX2
+    if (util::instrset::instrset_detect() >= util::instrset::instrset_AVX2)
+        return palette_8_to_rgba_avx2;
+#endif
+    return palette_8_to_rgba_basic;
+}
+
 void palette_texture_to_rgba_4(uint32_t *dst, const uint8_t *src, uint32_t width, uint32_t height, const uint32_t *palette) {
     for (uint32_t y = 0; y < height; ++y) {
         for (uint32_t x = 0; x < width; x += 2) {
@@ -33,11 +77,18 @@ void palette_texture_to_rgba_4(uint32_t *dst, const uint8_t *src, uint32_t width
 }
 
 void palette_texture_to_rgba_8(uint32_t *dst, const uint8_t *src, uint32_t width, uint32_t height, const uint32_t *palette) {
-    for (uint32_t y = 0; y < height; ++y) {
-        for (uint32_t x = 0; x < width; ++x) {
-            dst[y * width + x] = palette[src[y * width + x]];
-        }
+    static const Palette8ToRgbaFunc convert = get_palette_8_to_rgba();
+
+    // the rows are contiguous, so the whole texture is converted as a single line
+    const size_t pixel_count = static_cast<size_t>(width) * height;
+    if (pixel_count < MIN_PARALLEL_PALETTE_PIXELS) {
+        convert(dst, src, pixel_count, palette);
+        return;
     }
+
+    WorkerPool::get().parallel_for(pixel_count, MIN_PARALLEL_PALETTE_PIXELS, [&](size_t begin, size_t end) {
+        convert(dst + begin, src + begin, end - begin, palette);
+    });
 }
 
 const uint32_t *get_texture_palette(const SceGxmTexture &texture, const MemState &mem) {
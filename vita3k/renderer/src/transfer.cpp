@@ -21,7 +21,10 @@
 #include <renderer/driver_functions.h>
 #include <renderer/functions.h>
 #include <renderer/state.h>
+#include <renderer/texture_cache.h>
 #include <renderer/types.h>
+#include <mem/util.h>
+#include <threads/worker_pool.h>
 #include <util/log.h>
 #include <util/tracy.h>
 
@@ -30,51 +33,192 @@
 // keywords.h must be after tracy.h for msvc compiler
 #include <util/keywords.h>
 
+#include <bit>
+
 extern "C" {
 #include <libswscale/swscale.h>
 }
 
 namespace renderer {
 
-template <typename T, SceGxmTransferColorKeyMode mode, SceGxmTransferType src_type, SceGxmTransferType dst_type>
-static void perform_transfer_copy_impl(MemState &mem, const SceGxmTransferImage &src, const SceGxmTransferImage &dst, uint32_t key_value, uint32_t key_mask) {
-    T *__restrict__ src_ptr = src.address.cast<T>().get(mem);
-    T *__restrict__ dst_ptr = dst.address.cast<T>().get(mem);
-
-    auto compute_offset = [&](uint32_t dx, uint32_t dy, const SceGxmTransferImage &img, SceGxmTransferType type) -> int32_t {
-        const int32_t stride_pixel = img.stride / sizeof(T);
-        if (type == SCE_GXM_TRANSFER_LINEAR) {
-            return dy * stride_pixel + dx;
-        } else if (type == SCE_GXM_TRANSFER_TILED) {
+// transfers smaller than this (in bytes copied) are not worth being split between threads
+constexpr size_t MIN_PARALLEL_TRANSFER_SIZE = KiB(256);
+
+// offset of each row and each column of the transferred area, the offset of a texel is the sum of both
+// for swizzled images, the morton code of a texel is made of the bits of its column and the bits of its row
+template <typename T>
+static void compute_transfer_offsets(const SceGxmTransferImage &img, SceGxmTransferType type, uint32_t width, uint32_t height, std::vector<int32_t> &column_offsets, std::vector<int32_t> &row_offsets) {
+    const int32_t stride_pixel = img.stride / static_cast<int32_t>(sizeof(T));
+    column_offsets.resize(width);
+    row_offsets.resize(height);
+    for (uint32_t dx = 0; dx < width; dx++) {
+        const uint32_t x = img.x + dx;
+        if (type == SCE_GXM_TRANSFER_LINEAR)
+            column_offsets[dx] = x;
+        else if (type == SCE_GXM_TRANSFER_TILED)
             // tiles are 32x32, you have the offset within the tile then the offset of the tile
-            const uint32_t texel_offset_in_tile = ((dy % 32) * 32) + (dx % 32);
-            const int32_t tile_address = (stride_pixel / 32) * (dy / 32) + (dx / 32);
+            column_offsets[dx] = (x / 32) * 1024 + (x % 32);
+        else
+            column_offsets[dx] = texture::encode_morton(x, 0, img.width, img.height);
+    }
+    for (uint32_t dy = 0; dy < height; dy++) {
+        const uint32_t y = img.y + dy;
+        if (type == SCE_GXM_TRANSFER_LINEAR)
+            row_offsets[dy] = y * stride_pixel;
+        else if (type == SCE_GXM_TRANSFER_TILED)
+            row_offsets[dy] = (stride_pixel / 32) * (y / 32) * 1024 + (y % 32) * 32;
+        else
+            row_offsets[dy] = texture::encode_morton(0, y, img.width, img.height);
+    }
+}
 
-            return tile_address * 1024 + texel_offset_in_tile;
-        } else {
-            return texture::encode_morton(dx, dy, img.width, img.height);
+// number of texels starting at column x which are contiguous in memory
+template <SceGxmTransferType type>
+static uint32_t get_contiguous_texels(uint32_t x, uint32_t remaining) {
+    if constexpr (type == SCE_GXM_TRANSFER_LINEAR)
+        return remaining;
+    else if constexpr (type == SCE_GXM_TRANSFER_TILED)
+        return std::min(remaining, 32 - (x % 32));
+    else
+        return 1;
+}
+
+template <typename T, SceGxmTransferColorKeyMode mode>
+static void copy_texels(const T *src, T *dst, uint32_t count, uint32_t key_value, uint32_t key_mask) {
+    if constexpr (mode == SCE_GXM_TRANSFER_COLORKEY_NONE) {
+        // overlapping images never get here, they are copied a texel at a time
+        memcpy(dst, src, count * sizeof(T));
+    } else {
+        // branchless so the compiler can vectorize it with a blend
+        for (uint32_t i = 0; i < count; i++) {
+            const T value = src[i];
+            const bool key_match = (value & key_mask) == key_value;
+            const bool keep = (mode == SCE_GXM_TRANSFER_COLORKEY_PASS) ? key_match : !key_match;
+            dst[i] = keep ? value : dst[i];
         }
-    };
+    }
+}
+
+// rough upper bound of the memory used by an image, as [start, end)
+static std::pair<uint64_t, uint64_t> get_transfer_image_range(const SceGxmTransferImage &img, SceGxmTransferType type) {
+    const uint64_t address = img.address.address();
+    if (type == SCE_GXM_TRANSFER_SWIZZLED) {
+        // the morton code of any texel is below the size of the image rounded to powers of two
+        const uint64_t texel_size = gxm::get_bits_per_pixel(img.format) / 8;
+        return { address, address + static_cast<uint64_t>(std::bit_ceil(img.width)) * std::bit_ceil(img.height) * texel_size };
+    }
+
+    // a tiled image is padded to 32 rows
+    const uint64_t strided_size = static_cast<uint64_t>(std::abs(img.stride)) * (img.y + img.height + 32);
+    if (img.stride < 0)
+        // the rows go towards the lower addresses
+        return { address - std::min(address, strided_size), address + strided_size };
 
-    for (uint32_t dx = 0; dx < src.width; dx++) {
-        for (uint32_t dy = 0; dy < src.height; dy++) {
-            // compute offset depending on the texture type used
-            // the function compute_offset gets inlined
-            uint32_t src_offset = compute_offset(src.x + dx, src.y + dy, src, src_type);
-            uint32_t dst_offset = compute_offset(dst.x + dx, dst.y + dy, dst, dst_type);
-
-            T value = src_ptr[src_offset];
-            if constexpr (mode == SCE_GXM_TRANSFER_COLORKEY_PASS) {
-                if ((value & key_mask) != key_value)
-                    continue;
-            } else if constexpr (mode == SCE_GXM_TRANSFER_COLORKEY_REJECT) {
-                if ((value & key_mask) == key_value)
-                    continue;
+    return { address, address + strided_size };
+}
+
+static bool transfer_images_overlap(const SceGxmTransferImage &src, const SceGxmTransferImage &dst, SceGxmTransferType src_type, SceGxmTransferType dst_type) {
+    const auto [src_start, src_end] = get_transfer_image_range(src, src_type);
+    const auto [dst_start, dst_end] = get_transfer_image_range(dst, dst_type);
+    return src_start < dst_end && dst_start < src_end;
+}
+
+// the textures prefetched by the guest threads may have been read before this transfer wrote to them
+static void invalidate_transfer_prefetches(TextureCache *texture_cache, const SceGxmTransferImage &dst, SceGxmTransferType dst_type) {
+    const auto [start, end] = get_transfer_image_range(dst, dst_type);
+    texture_cache->invalidate_prefetches(static_cast<Address>(start), static_cast<Address>(std::min<uint64_t>(end, std::numeric_limits<Address>::max())));
+}
+
+template <typename F>
+static void for_each_transfer_row_range(uint32_t row_count, size_t row_size, F func) {
+    const size_t min_rows = std::max<size_t>(MIN_PARALLEL_TRANSFER_SIZE / std::max<size_t>(row_size, 1), 1);
+    if (row_count <= min_rows) {
+        func(0, row_count);
+        return;
+    }
+
+    WorkerPool::get().parallel_for(row_count, min_rows, [&](size_t begin, size_t end) {
+        func(static_cast<uint32_t>(begin), static_cast<uint32_t>(end));
+    });
+}
+
+// tiled to tiled copy where the tiles of both images are aligned, each tile fully covered is a single copy
+template <typename T>
+static void perform_transfer_copy_tiles(T *src_ptr, T *dst_ptr, const SceGxmTransferImage &src, const SceGxmTransferImage &dst) {
+    const int32_t src_tiles_per_row = (src.stride / static_cast<int32_t>(sizeof(T))) / 32;
+    const int32_t dst_tiles_per_row = (dst.stride / static_cast<int32_t>(sizeof(T))) / 32;
+    const uint32_t tile_rows = (src.height + 31) / 32;
+    const uint32_t tile_columns = (src.width + 31) / 32;
+
+    for_each_transfer_row_range(tile_rows, static_cast<size_t>(src.width) * 32 * sizeof(T), [&](uint32_t begin, uint32_t end) {
+        for (uint32_t tile_y = begin; tile_y < end; tile_y++) {
+            const uint32_t rows = std::min<uint32_t>(32, src.height - tile_y * 32);
+            for (uint32_t tile_x = 0; tile_x < tile_columns; tile_x++) {
+                const uint32_t columns = std::min<uint32_t>(32, src.width - tile_x * 32);
+                const T *src_tile = src_ptr + ((src.y / 32 + tile_y) * src_tiles_per_row + src.x / 32 + tile_x) * 1024;
+                T *dst_tile = dst_ptr + ((dst.y / 32 + tile_y) * dst_tiles_per_row + dst.x / 32 + tile_x) * 1024;
+                if (rows == 32 && columns == 32) {
+                    memcpy(dst_tile, src_tile, 1024 * sizeof(T));
+                } else {
+                    for (uint32_t row = 0; row < rows; row++)
+                        memcpy(dst_tile + row * 32, src_tile + row * 32, columns * sizeof(T));
+                }
             }
+        }
+    });
+}
+
+template <typename T, SceGxmTransferColorKeyMode mode, SceGxmTransferType src_type, SceGxmTransferType dst_type>
+static void perform_transfer_copy_impl(MemState &mem, const SceGxmTransferImage &src, const SceGxmTransferImage &dst, uint32_t key_value, uint32_t key_mask) {
+    T *src_ptr = src.address.cast<T>().get(mem);
+    T *dst_ptr = dst.address.cast<T>().get(mem);
+    const uint32_t width = src.width;
+    const uint32_t height = src.height;
 
-            dst_ptr[dst_offset] = value;
+    // when the images may overlap, a texel can be read after being written by the same transfer
+    const bool overlap = transfer_images_overlap(src, dst, src_type, dst_type);
+
+    if constexpr (mode == SCE_GXM_TRANSFER_COLORKEY_NONE && src_type == SCE_GXM_TRANSFER_TILED && dst_type == SCE_GXM_TRANSFER_TILED) {
+        if (!overlap && src.x % 32 == 0 && src.y % 32 == 0 && dst.x % 32 == 0 && dst.y % 32 == 0) {
+            perform_transfer_copy_tiles<T>(src_ptr, dst_ptr, src, dst);
+            return;
         }
     }
+
+    std::vector<int32_t> src_columns, src_rows, dst_columns, dst_rows;
+    compute_transfer_offsets<T>(src, src_type, width, height, src_columns, src_rows);
+    compute_transfer_offsets<T>(dst, dst_type, width, height, dst_columns, dst_rows);
+
+    if (overlap) {
+        // keep the order of the per-texel copy (column by column) so such a transfer gives the same result as before
+        for (uint32_t dx = 0; dx < width; dx++) {
+            for (uint32_t dy = 0; dy < height; dy++)
+                copy_texels<T, mode>(src_ptr + src_rows[dy] + src_columns[dx], dst_ptr + dst_rows[dy] + dst_columns[dx], 1, key_value, key_mask);
+        }
+        return;
+    }
+
+    for_each_transfer_row_range(height, static_cast<size_t>(width) * sizeof(T), [&](uint32_t begin, uint32_t end) {
+        for (uint32_t dy = begin; dy < end; dy++) {
+            const T *src_row = src_ptr + src_rows[dy];
+            T *dst_row = dst_ptr + dst_rows[dy];
+
+            if constexpr (src_type == SCE_GXM_TRANSFER_SWIZZLED || dst_type == SCE_GXM_TRANSFER_SWIZZLED) {
+                // texels are never contiguous in a swizzled row
+                for (uint32_t dx = 0; dx < width; dx++)
+                    copy_texels<T, mode>(src_row + src_columns[dx], dst_row + dst_columns[dx], 1, key_value, key_mask);
+            } else {
+                // copy the longest runs of texels contiguous in both images
+                uint32_t dx = 0;
+                while (dx < width) {
+                    uint32_t count = get_contiguous_texels<src_type>(src.x + dx, width - dx);
+                    count = get_contiguous_texels<dst_type>(dst.x + dx, count);
+                    copy_texels<T, mode>(src_row + src_columns[dx], dst_row + dst_columns[dx], count, key_value, key_mask);
+                    dx += count;
+                }
+            }
+        }
+    });
 }
 
 template <typename T, SceGxmTransferColorKeyMode mode, SceGxmTransferType src_type>
@@ -131,6 +275,33 @@ static void perform_transfer_copy_mode(MemState &mem, const SceGxmTransferImage
     }
 }
 
+void perform_transfer_copy(MemState &mem, const SceGxmTransferImage &src, const SceGxmTransferImage &dst, SceGxmTransferType src_type, SceGxmTransferType dst_type, SceGxmTransferColorKeyMode key_mode, uint32_t key_value, uint32_t key_mask) {
+    // Get bits per pixel of the image
+    const uint32_t bpp = gxm::get_bits_per_pixel(src.format);
+
+    // use a specialized function for each type (more optimized)
+    switch (bpp) {
+    case 8:
+        perform_transfer_copy_src_type<uint8_t, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, key_value, key_mask);
+        break;
+    case 16:
+        perform_transfer_copy_src_type<uint16_t, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, key_value, key_mask);
+        break;
+    case 24:
+        perform_transfer_copy_src_type<std::array<uint8_t, 3>, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, key_value, key_mask);
+        break;
+    case 32:
+        perform_transfer_copy_mode<uint32_t>(mem, src, dst, src_type, dst_type, key_value, key_mask, key_mode);
+        break;
+    case 64:
+        perform_transfer_copy_src_type<uint64_t, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, key_value, key_mask);
+        break;
+    case 128:
+        perform_transfer_copy_src_type<std::array<uint64_t, 2>, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, key_value, key_mask);
+        break;
+    }
+}
+
 COMMAND(handle_transfer_copy) {
     TRACY_FUNC_COMMANDS(handle_transfer_copy);
     const uint32_t colorKeyValue = helper.pop<uint32_t>();
@@ -152,35 +323,9 @@ COMMAND(handle_transfer_copy) {
         LOG_ERROR_ONCE("Transfer copy with non-zero key mask not handled for format 0x{:0X}", fmt::underlying(src_fmt));
     }
 
-    vulkan::CallbackRequestFunction copy_operation = [=, &mem]() {
-        const SceGxmTransferImage &src = images[0];
-        const SceGxmTransferImage &dst = images[1];
-
-        // Get bits per pixel of the image
-        const uint32_t bpp = gxm::get_bits_per_pixel(src.format);
-
-        // use a specialized function for each type (more optimized)
-        switch (bpp) {
-        case 8:
-            perform_transfer_copy_src_type<uint8_t, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, colorKeyValue, colorKeyMask);
-            break;
-        case 16:
-            perform_transfer_copy_src_type<uint16_t, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, colorKeyValue, colorKeyMask);
-            break;
-        case 24:
-            perform_transfer_copy_src_type<std::array<uint8_t, 3>, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, colorKeyValue, colorKeyMask);
-            break;
-        case 32:
-            perform_transfer_copy_mode<uint32_t>(mem, src, dst, src_type, dst_type, colorKeyValue, colorKeyMask, colorKeyMode);
-            break;
-        case 64:
-            perform_transfer_copy_src_type<uint64_t, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, colorKeyValue, colorKeyMask);
-            break;
-        case 128:
-            perform_transfer_copy_src_type<std::array<uint64_t, 2>, SCE_GXM_TRANSFER_COLORKEY_NONE>(mem, src, dst, src_type, dst_type, colorKeyValue, colorKeyMask);
-            break;
-        }
-
+    vulkan::CallbackRequestFunction copy_operation = [=, &mem, texture_cache = renderer.get_texture_cache()]() {
+        perform_transfer_copy(mem, images[0], images[1], src_type, dst_type, colorKeyMode, colorKeyValue, colorKeyMask);
+        invalidate_transfer_prefetches(texture_cache, images[1], dst_type);
         delete[] images;
     };
 
@@ -209,7 +354,7 @@ COMMAND(handle_transfer_downscale) {
     dst->address = (dst->address.cast<uint8_t>() + dst->y * dst->stride + dst->x * pixel_bytes).cast<void>();
 
     // only rgb formats are supported by the PS Vita for downscaling
-    vulkan::CallbackRequestFunction downscale_operation = [&mem, src, dst]() {
+    vulkan::CallbackRequestFunction downscale_operation = [&mem, src, dst, texture_cache = renderer.get_texture_cache()]() {
         AVPixelFormat pixel_fmt = AV_PIX_FMT_NONE;
         switch (src->format) {
         case SCE_GXM_TRANSFER_FORMAT_U5U6U5_BGR:
@@ -272,6 +417,7 @@ COMMAND(handle_transfer_downscale) {
             }
         }
 
+        invalidate_transfer_prefetches(texture_cache, *dst, SCE_GXM_TRANSFER_LINEAR);
         delete src;
         delete dst;
     };
@@ -293,21 +439,20 @@ COMMAND(handle_transfer_fill) {
     const auto bpp = gxm::get_bits_per_pixel(dest->format);
 
     const uint32_t bytes_per_pixel = (bpp + 7) >> 3;
-    for (uint32_t y = 0; y < dest->height; y++) {
-        for (uint32_t x = 0; x < dest->width; x++) {
-            // Set offset of destination
-            const auto dest_offset = ((x + dest->x) * bytes_per_pixel) + ((y + dest->y) * dest->stride);
+    uint8_t *dest_ptr = dest->address.cast<uint8_t>().get(mem) + dest->x * bytes_per_pixel + static_cast<int64_t>(dest->y) * dest->stride;
 
-            // Set pointer of destination
-            auto dest_ptr = (uint8_t *)dest->address.get(mem) + dest_offset;
+    // build a single row filled with the color, then copy it to each row
+    // the fill color is at most 32 bits, the remaining bytes of larger formats are zero
+    std::vector<uint8_t> row(static_cast<size_t>(dest->width) * bytes_per_pixel);
+    for (uint32_t x = 0; x < dest->width; x++)
+        memcpy(&row[x * bytes_per_pixel], &fill_color, std::min<uint32_t>(bytes_per_pixel, sizeof(fill_color)));
 
-            // Fill color in destination
-            memcpy(dest_ptr, &fill_color, bytes_per_pixel);
-        }
-    }
+    for (uint32_t y = 0; y < dest->height; y++)
+        memcpy(dest_ptr + static_cast<int64_t>(y) * dest->stride, row.data(), row.size());
 
     // TODO: handle case where dest is a cached surface
 
+    invalidate_transfer_prefetches(renderer.get_texture_cache(), *dest, SCE_GXM_TRANSFER_LINEAR);
     delete dest;
 }
 
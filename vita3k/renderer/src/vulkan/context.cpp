@@ -69,6 +69,7 @@ void VKContext::wait_thread_function(const MemState &mem) {
                        [&](NotificationRequest &request) {
                            if (request.notifications[0].address || request.notifications[1].address) {
                                wait_for_fences();
+                               state.surface_cache.wait_for_readbacks();
 
                                // same as in handle_sync_surface_data
                                std::unique_lock<std::mutex> lock(state.notification_mutex);
@@ -95,6 +96,7 @@ void VKContext::wait_thread_function(const MemState &mem) {
                        },
                        [&](BufferSyncRequest &request) {
                            wait_for_fences();
+                           state.surface_cache.wait_for_readbacks();
                            auto mem_it = state.mapped_memories.lower_bound(request.location);
                            if (mem_it == state.mapped_memories.end() || mem_it->first + mem_it->second.size < request.location + request.size) {
                                LOG_ERROR("Buffer Sync request for {}-{} is not fully mapped", log_hex(request.location), log_hex(request.location + request.size));
@@ -103,19 +105,28 @@ void VKContext::wait_thread_function(const MemState &mem) {
                            uint8_t *src = reinterpret_cast<uint8_t *>(std::get<vkutil::Buffer>(mem_it->second.buffer_impl).mapped_data);
                            src += request.location - mem_it->first;
                            memcpy(Ptr<void>(request.location).get(mem), src, request.size);
+                           state.texture_cache.invalidate_prefetches(request.location, request.location + request.size);
                        },
                        [&](PostSurfaceSyncRequest &request) {
                            wait_for_fences();
 
-                           state.surface_cache.perform_post_surface_sync(mem, request.cache_info);
+                           if (request.readback)
+                               // the conversion is done on a worker, meanwhile this thread can wait for the next fences
+                               state.surface_cache.perform_post_surface_sync(mem, request.readback);
+                           else
+                               // the GPU wrote the surface to the guest memory
+                               state.texture_cache.invalidate_prefetches(request.location, request.location + request.size);
                        },
                        [&](SyncSignalRequest &request) {
                            wait_for_fences();
+                           state.surface_cache.wait_for_readbacks();
 
                            renderer::subject_done(request.sync, request.timestamp);
                        },
                        [&](CallbackRequest &request) {
                            if (request.callback) {
+                               // callbacks may read surfaces synced just before
+                               state.surface_cache.wait_for_readbacks();
                                (*request.callback)();
                                delete request.callback;
                            }
@@ -497,8 +508,8 @@ void VKContext::stop_recording(const SceGxmNotification &notif1, const SceGxmNot
                 state.request_queue.push(BufferSyncRequest{ surface_info->data.address(), static_cast<uint32_t>(surface_info->total_bytes) });
         }
 
-        if (surface_info && surface_info->need_post_surface_sync) {
-            state.request_queue.push(PostSurfaceSyncRequest{ surface_info });
+        if (surface_info) {
+            state.request_queue.push(PostSurfaceSyncRequest{ surface_info->readback, surface_info->data.address(), static_cast<uint32_t>(surface_info->total_bytes) });
         }
 
         if (notif1.address || notif2.address) {
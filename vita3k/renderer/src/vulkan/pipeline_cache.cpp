@@ -25,6 +25,7 @@
 #include <gxm/types.h>
 #include <renderer/shaders.h>
 #include <shader/spirv_recompiler.h>
+#include <threads/worker_pool.h>
 
 #include <util/fs.h>
 #include <util/log.h>
@@ -45,6 +46,7 @@ constexpr size_t record_pipeline_len = offsetof(GxmRecordState, vertex_streams);
 struct CompileRequest {
     // iterator to the pipeline location
     vk::Pipeline *pipeline;
+    uint64_t key;
 
     // this is everything we need to compile the shader on another thread (as the original data will change)
     SceGxmPrimitiveType type;
@@ -277,6 +279,164 @@ void PipelineCache::set_async_compilation(bool enable) {
 
 // magic number put at the beginning of the pipeline cache file
 constexpr uint32_t pipeline_cache_magic = 0xBEEF4321;
+// magic number put at the beginning of the pipeline descriptions file
+constexpr uint32_t pipeline_descriptions_magic = 0xBEEF4323;
+
+static fs::path get_pipeline_descriptions_path(const fs::path &shaders_path) {
+    return shaders_path / fmt::format("pipeline-descriptions-vk{}.dat", shader::CURRENT_VERSION);
+}
+
+// calls field on every member of the parameters, in the order they are stored on the disk
+// the structure has padding and bools, so it is never written as is: two equal descriptions must give the same file
+template <typename Params, typename F>
+static void visit_description_params(Params &params, F &&field) {
+    field(params.vertex_hash);
+    field(params.fragment_hash);
+
+    field(params.blending.blendEnable);
+    field(params.blending.srcColorBlendFactor);
+    field(params.blending.dstColorBlendFactor);
+    field(params.blending.colorBlendOp);
+    field(params.blending.srcAlphaBlendFactor);
+    field(params.blending.dstAlphaBlendFactor);
+    field(params.blending.alphaBlendOp);
+    field(params.blending.colorWriteMask);
+
+    for (auto *stencil : { &params.front_stencil, &params.back_stencil }) {
+        field(stencil->failOp);
+        field(stencil->passOp);
+        field(stencil->depthFailOp);
+        field(stencil->compareOp);
+        field(stencil->compareMask);
+        field(stencil->writeMask);
+        field(stencil->reference);
+    }
+
+    field(params.topology);
+    field(params.polygon_mode);
+    field(params.cull_mode);
+    field(params.depth_func);
+    field(params.color_blend_flags);
+    field(params.vertex_texture_count);
+    field(params.fragment_texture_count);
+    field(params.depth_write);
+    field(params.fragment_disabled);
+    field(params.use_srgb_specialization);
+    field(params.is_srgb);
+
+    field(params.render_pass.format);
+    field(params.render_pass.force_load);
+    field(params.render_pass.force_store);
+    field(params.render_pass.is_color_transient);
+    field(params.render_pass.no_color);
+}
+
+// enums and vulkan flags are stored as 32-bit integers, bools as a single byte
+template <typename T>
+using StoredDescriptionField = std::conditional_t<std::is_same_v<T, bool>, uint8_t,
+    std::conditional_t<std::is_enum_v<T> || requires { typename T::MaskType; }, uint32_t, T>>;
+
+static uint32_t get_stored_params_size() {
+    uint32_t size = 0;
+    PipelineDescription::Parameters params{};
+    visit_description_params(params, [&]<typename T>(T &) {
+        size += sizeof(StoredDescriptionField<T>);
+    });
+    return size;
+}
+
+void read_pipeline_descriptions(const fs::path &path, unordered_map_fast<uint64_t, PipelineDescription> &descriptions) {
+    fs::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return;
+
+    auto read_integer = [&]<typename T>(T &val) {
+        file.read(reinterpret_cast<char *>(&val), sizeof(T));
+    };
+    auto read_vector = [&]<typename T>(std::vector<T> &vec) {
+        uint32_t size = 0;
+        read_integer(size);
+        // no pipeline has more than a few dozens of inputs, anything else means the file is corrupted
+        if (size > 256) {
+            file.setstate(std::ios::failbit);
+            return;
+        }
+        vec.resize(size);
+        file.read(reinterpret_cast<char *>(vec.data()), size * sizeof(T));
+    };
+    auto read_field = [&]<typename T>(T &val) {
+        if constexpr (std::is_same_v<StoredDescriptionField<T>, T>) {
+            read_integer(val);
+        } else {
+            StoredDescriptionField<T> stored{};
+            read_integer(stored);
+            if constexpr (requires { typename T::MaskType; })
+                val = T(static_cast<typename T::MaskType>(stored));
+            else
+                val = static_cast<T>(stored);
+        }
+    };
+
+    uint32_t magic_number = 0;
+    read_integer(magic_number);
+    // the size of the parameters changes with the structure content
+    uint32_t params_size = 0;
+    read_integer(params_size);
+    size_t nb_descriptions = 0;
+    read_integer(nb_descriptions);
+    if (!file || magic_number != pipeline_descriptions_magic || params_size != get_stored_params_size()) {
+        LOG_WARN("Pipeline descriptions are corrupted or outdated, ignoring them.");
+        return;
+    }
+
+    for (size_t i = 0; i < nb_descriptions; i++) {
+        uint64_t key;
+        read_integer(key);
+        PipelineDescription description{};
+        visit_description_params(description.params, read_field);
+        read_vector(description.bindings);
+        read_vector(description.attributes);
+        if (!file) {
+            LOG_WARN("Pipeline descriptions are corrupted, ignoring the last ones.");
+            return;
+        }
+
+        descriptions[key] = std::move(description);
+    }
+}
+
+void save_pipeline_descriptions(const fs::path &path, const std::vector<std::pair<uint64_t, PipelineDescription>> &descriptions) {
+    fs::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return;
+
+    auto write_integer = [&]<typename T>(const T &val) {
+        file.write(reinterpret_cast<const char *>(&val), sizeof(T));
+    };
+    auto write_vector = [&]<typename T>(const std::vector<T> &vec) {
+        write_integer(static_cast<uint32_t>(vec.size()));
+        file.write(reinterpret_cast<const char *>(vec.data()), vec.size() * sizeof(T));
+    };
+    auto write_field = [&]<typename T>(const T &val) {
+        if constexpr (std::is_same_v<StoredDescriptionField<T>, T>) {
+            write_integer(val);
+        } else if constexpr (requires { typename T::MaskType; }) {
+            write_integer(static_cast<uint32_t>(static_cast<typename T::MaskType>(val)));
+        } else {
+            write_integer(static_cast<StoredDescriptionField<T>>(val));
+        }
+    };
+
+    write_integer(pipeline_descriptions_magic);
+    write_integer(get_stored_params_size());
+    write_integer(descriptions.size());
+    for (const auto &[key, description] : descriptions) {
+        write_integer(key);
+        visit_description_params(description.params, write_field);
+        write_vector(description.bindings);
+        write_vector(description.attributes);
+    }
+}
 
 void PipelineCache::read_pipeline_cache() {
     const std::string pipeline_cache_name = fmt::format("pipeline-cache-vk{}.dat", shader::CURRENT_VERSION);
@@ -330,6 +490,15 @@ void PipelineCache::read_pipeline_cache() {
 
     state.device.destroyPipelineCache(pipeline_cache);
     pipeline_cache = state.device.createPipelineCache(cache_info);
+
+    {
+        std::lock_guard<std::mutex> guard(descriptions_mutex);
+        read_pipeline_descriptions(get_pipeline_descriptions_path(state.shaders_path), pipeline_descriptions);
+        // the key of a pipeline with a description must be known, or it won't be considered to be in the cache
+        for (const auto &[key, description] : pipeline_descriptions)
+            pipelines.insert({ key, nullptr });
+    }
+
     LOG_INFO("Pipeline cache read and loaded");
 }
 
@@ -370,6 +539,14 @@ void PipelineCache::save_pipeline_cache() {
     // then save the cache
     pipeline_cache_file.write(reinterpret_cast<const char *>(pipeline_data.data()), pipeline_data.size());
     pipeline_cache_file.close();
+
+    // and finally the pipeline descriptions, do a copy for thread safety
+    std::vector<std::pair<uint64_t, PipelineDescription>> descriptions_copy;
+    {
+        std::lock_guard<std::mutex> guard(descriptions_mutex);
+        descriptions_copy.assign(pipeline_descriptions.begin(), pipeline_descriptions.end());
+    }
+    save_pipeline_descriptions(get_pipeline_descriptions_path(state.shaders_path), descriptions_copy);
     LOG_INFO("Pipeline cache saved");
 }
 
@@ -382,6 +559,15 @@ void PipelineCache::cleanup() {
         state.device.destroy(pipeline);
     pipelines.clear();
 
+    for (auto &[hash, precompiled] : precompiled_pipelines)
+        state.device.destroy(precompiled.pipeline);
+    precompiled_pipelines.clear();
+
+    {
+        std::lock_guard<std::mutex> guard(descriptions_mutex);
+        pipeline_descriptions.clear();
+    }
+
     {
         std::lock_guard<std::mutex> guard(shaders_mutex);
         for (auto &[hash, shader] : shaders)
@@ -401,6 +587,11 @@ void PipelineCache::cleanup() {
         state.device.destroy(pass);
     shader_interlock_pass.clear();
 
+    {
+        std::lock_guard<std::mutex> guard(render_pass_mutex);
+        render_pass_params.clear();
+    }
+
     for (int i = 0; i < 17; i++)
         for (int j = 0; j < 17; j++) {
             state.device.destroy(pipeline_layouts[i][j]);
@@ -659,9 +850,20 @@ vk::RenderPass PipelineCache::retrieve_render_pass(vk::Format format, bool force
         pass_info.setDependencyCount(2);
     }
 
-    render_passes_map[format] = state.device.createRenderPass(pass_info);
+    const vk::RenderPass render_pass = state.device.createRenderPass(pass_info);
+    render_passes_map[format] = render_pass;
+    {
+        std::lock_guard<std::mutex> guard(render_pass_mutex);
+        render_pass_params[static_cast<VkRenderPass>(render_pass)] = RenderPassParams{
+            .format = format,
+            .force_load = force_load,
+            .force_store = force_store,
+            .is_color_transient = is_color_transient,
+            .no_color = no_color
+        };
+    }
 
-    return render_passes_map[format];
+    return render_pass;
 }
 
 vk::PipelineVertexInputStateCreateInfo PipelineCache::get_vertex_input_state(const SceGxmVertexProgram &vertex_program, MemState &mem) {
@@ -791,7 +993,7 @@ void PipelineCache::compiler_thread(MemState &mem) {
             // use this as an instruction to stop the thread
             break;
 
-        vk::Pipeline pipeline = compile_pipeline(request->type, request->render_pass, *request->vertex_program_gxm, *request->fragment_program_gxm, *request->get_record(), request->hints, mem);
+        vk::Pipeline pipeline = compile_pipeline(request->key, request->type, request->render_pass, *request->vertex_program_gxm, *request->fragment_program_gxm, *request->get_record(), request->hints, mem);
         *request->pipeline = pipeline;
 
         request->vertex_program_gxm->compile_threads_on.fetch_sub(1, std::memory_order_release);
@@ -815,33 +1017,34 @@ static vk::StencilOpState convert_op_state(const GxmStencilStateOp &state) {
     };
 }
 
-vk::Pipeline PipelineCache::compile_pipeline(SceGxmPrimitiveType type, vk::RenderPass render_pass, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem) {
-    const VertexProgram &vertex_program = *vertex_program_gxm.renderer_data;
-    const SceGxmProgram *gxm_fragment_shader = fragment_program_gxm.program.get(mem);
-    const VKFragmentProgram &fragment_program = *reinterpret_cast<VKFragmentProgram *>(
-        fragment_program_gxm.renderer_data.get());
-
-    // the vertex input state must be computed before shader are retrieved in case symbols are stripped
-    const vk::PipelineVertexInputStateCreateInfo vertex_input = get_vertex_input_state(vertex_program_gxm, mem);
-
-    const vk::PipelineShaderStageCreateInfo vertex_shader = retrieve_shader(vertex_program_gxm.program.get(mem), vertex_program.hash, true, fragment_program_gxm.is_maskupdate, mem, hints);
-    const vk::PipelineShaderStageCreateInfo fragment_shader = retrieve_shader(gxm_fragment_shader, fragment_program.hash, false, fragment_program_gxm.is_maskupdate, mem, hints, record.is_gamma_corrected);
-    const vk::PipelineShaderStageCreateInfo shader_stages[] = { vertex_shader, fragment_shader };
+vk::Pipeline PipelineCache::create_pipeline(const PipelineDescription &description, vk::RenderPass render_pass, vk::ShaderModule vertex_shader, vk::ShaderModule fragment_shader) {
+    const PipelineDescription::Parameters &params = description.params;
+
+    const vk::PipelineShaderStageCreateInfo shader_stages[] = {
+        vk::PipelineShaderStageCreateInfo{
+            .stage = vk::ShaderStageFlagBits::eVertex,
+            .module = vertex_shader,
+            .pName = "main_vs" },
+        vk::PipelineShaderStageCreateInfo{
+            .stage = vk::ShaderStageFlagBits::eFragment,
+            .module = fragment_shader,
+            .pName = "main_fs",
+            .pSpecializationInfo = params.use_srgb_specialization ? (params.is_srgb ? &srgb_info_true : &srgb_info_false) : nullptr },
+    };
     // disable the fragment shader if gxm asks us to
-    const bool is_fragment_disabled = record.front_side_fragment_program_mode == SCE_GXM_FRAGMENT_PROGRAM_DISABLED || gxm_fragment_shader->has_no_effect();
-    const uint32_t shader_stage_count = is_fragment_disabled ? 1U : 2U;
+    const uint32_t shader_stage_count = params.fragment_disabled ? 1U : 2U;
+
+    vk::PipelineVertexInputStateCreateInfo vertex_input{};
+    vertex_input.setVertexBindingDescriptions(description.bindings);
+    vertex_input.setVertexAttributeDescriptions(description.attributes);
 
     const vk::PipelineInputAssemblyStateCreateInfo input_assembly{
-        .topology = translate_primitive(type)
+        .topology = params.topology
     };
 
-    const bool two_sided = (record.two_sided == SCE_GXM_TWO_SIDED_ENABLED);
-
-    const bool use_shader_interlock = state.features.support_shader_interlock && gxm_fragment_shader->is_frag_color_used();
-
     const vk::PipelineRasterizationStateCreateInfo rasterizer{
-        .polygonMode = translate_polygon_mode(record.front_polygon_mode),
-        .cullMode = translate_cull_mode(record.cull_mode),
+        .polygonMode = params.polygon_mode,
+        .cullMode = params.cull_mode,
         // front face is always counter clockwise
         .frontFace = vk::FrontFace::eCounterClockwise,
         .depthBiasEnable = VK_TRUE,
@@ -854,32 +1057,20 @@ vk::Pipeline PipelineCache::compile_pipeline(SceGxmPrimitiveType type, vk::Rende
     // on a tiled renderer
     const vk::PipelineDepthStencilStateCreateInfo ds_info{
         .depthTestEnable = VK_TRUE,
-        .depthWriteEnable = (record.front_depth_write_mode == SCE_GXM_DEPTH_WRITE_ENABLED),
-        .depthCompareOp = translate_depth_func(record.front_depth_func),
+        .depthWriteEnable = params.depth_write,
+        .depthCompareOp = params.depth_func,
         .depthBoundsTestEnable = VK_FALSE,
         .stencilTestEnable = VK_TRUE,
-        .front = convert_op_state(record.front_stencil_state_op),
-        .back = convert_op_state(two_sided ? record.back_stencil_state_op : record.front_stencil_state_op)
+        .front = params.front_stencil,
+        .back = params.back_stencil
     };
 
-    vk::PipelineColorBlendStateCreateInfo color_blending{};
-    if (support_coherent_framebuffer_fetch && gxm_fragment_shader->is_frag_color_used())
-        color_blending.flags = vk::PipelineColorBlendStateCreateFlagBits::eRasterizationOrderAttachmentAccessEXT;
-
-    const bool frag_has_no_output = static_cast<bool>(gxm_fragment_shader->program_flags & SCE_GXM_PROGRAM_FLAG_OUTPUT_UNDEFINED);
-    if (is_fragment_disabled || frag_has_no_output || use_shader_interlock) {
-        // The write mask must be empty as the lack of a fragment shader results in undefined values
-        static const vk::PipelineColorBlendAttachmentState blending = {
-            .blendEnable = VK_FALSE,
-            .colorWriteMask = vk::ColorComponentFlags()
-        };
-        color_blending.setAttachments(blending);
-    } else {
-        const vk::PipelineColorBlendAttachmentState &blending = fragment_program.blending;
-        color_blending.setAttachments(blending);
-    }
+    vk::PipelineColorBlendStateCreateInfo color_blending{
+        .flags = params.color_blend_flags
+    };
+    color_blending.setAttachments(params.blending);
 
-    vk::PipelineLayout pipeline_layout = pipeline_layouts[vertex_program.texture_count][fragment_program.texture_count];
+    vk::PipelineLayout pipeline_layout = pipeline_layouts[params.vertex_texture_count][params.fragment_texture_count];
 
     // all of these can be changed at any time using the vita graphics api (like opengl)
     // Because each one can take a lot of different values, it's better to set them as dynamic
@@ -928,6 +1119,75 @@ vk::Pipeline PipelineCache::compile_pipeline(SceGxmPrimitiveType type, vk::Rende
     return result.value;
 }
 
+vk::Pipeline PipelineCache::compile_pipeline(uint64_t key, SceGxmPrimitiveType type, vk::RenderPass render_pass, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem) {
+    const VertexProgram &vertex_program = *vertex_program_gxm.renderer_data;
+    const SceGxmProgram *gxm_fragment_shader = fragment_program_gxm.program.get(mem);
+    const VKFragmentProgram &fragment_program = *reinterpret_cast<VKFragmentProgram *>(
+        fragment_program_gxm.renderer_data.get());
+
+    // the vertex input state must be computed before shader are retrieved in case symbols are stripped
+    const vk::PipelineVertexInputStateCreateInfo vertex_input = get_vertex_input_state(vertex_program_gxm, mem);
+
+    const vk::PipelineShaderStageCreateInfo vertex_shader = retrieve_shader(vertex_program_gxm.program.get(mem), vertex_program.hash, true, fragment_program_gxm.is_maskupdate, mem, hints);
+    const vk::PipelineShaderStageCreateInfo fragment_shader = retrieve_shader(gxm_fragment_shader, fragment_program.hash, false, fragment_program_gxm.is_maskupdate, mem, hints, record.is_gamma_corrected);
+
+    const bool two_sided = (record.two_sided == SCE_GXM_TWO_SIDED_ENABLED);
+    const bool use_shader_interlock = state.features.support_shader_interlock && gxm_fragment_shader->is_frag_color_used();
+
+    PipelineDescription description{};
+    PipelineDescription::Parameters &params = description.params;
+    params.vertex_hash = vertex_program.hash;
+    params.fragment_hash = fragment_program.hash;
+    params.fragment_disabled = record.front_side_fragment_program_mode == SCE_GXM_FRAGMENT_PROGRAM_DISABLED || gxm_fragment_shader->has_no_effect();
+    params.use_srgb_specialization = fragment_shader.pSpecializationInfo != nullptr;
+    params.is_srgb = fragment_shader.pSpecializationInfo == &srgb_info_true;
+    params.topology = translate_primitive(type);
+    params.polygon_mode = translate_polygon_mode(record.front_polygon_mode);
+    params.cull_mode = translate_cull_mode(record.cull_mode);
+    params.depth_write = (record.front_depth_write_mode == SCE_GXM_DEPTH_WRITE_ENABLED);
+    params.depth_func = translate_depth_func(record.front_depth_func);
+    params.front_stencil = convert_op_state(record.front_stencil_state_op);
+    params.back_stencil = convert_op_state(two_sided ? record.back_stencil_state_op : record.front_stencil_state_op);
+    params.vertex_texture_count = vertex_program.texture_count;
+    params.fragment_texture_count = fragment_program.texture_count;
+
+    if (support_coherent_framebuffer_fetch && gxm_fragment_shader->is_frag_color_used())
+        params.color_blend_flags = vk::PipelineColorBlendStateCreateFlagBits::eRasterizationOrderAttachmentAccessEXT;
+
+    const bool frag_has_no_output = static_cast<bool>(gxm_fragment_shader->program_flags & SCE_GXM_PROGRAM_FLAG_OUTPUT_UNDEFINED);
+    if (params.fragment_disabled || frag_has_no_output || use_shader_interlock) {
+        // The write mask must be empty as the lack of a fragment shader results in undefined values
+        params.blending = vk::PipelineColorBlendAttachmentState{
+            .blendEnable = VK_FALSE,
+            .colorWriteMask = vk::ColorComponentFlags()
+        };
+    } else {
+        params.blending = fragment_program.blending;
+    }
+
+    description.bindings.assign(vertex_input.pVertexBindingDescriptions, vertex_input.pVertexBindingDescriptions + vertex_input.vertexBindingDescriptionCount);
+    description.attributes.assign(vertex_input.pVertexAttributeDescriptions, vertex_input.pVertexAttributeDescriptions + vertex_input.vertexAttributeDescriptionCount);
+
+    bool has_render_pass_params = false;
+    {
+        std::lock_guard<std::mutex> guard(render_pass_mutex);
+        auto render_pass_it = render_pass_params.find(static_cast<VkRenderPass>(render_pass));
+        if (render_pass_it != render_pass_params.end()) {
+            params.render_pass = render_pass_it->second;
+            has_render_pass_params = true;
+        }
+    }
+
+    const vk::Pipeline pipeline = create_pipeline(description, render_pass, vertex_shader.module, fragment_shader.module);
+
+    if (pipeline && has_render_pass_params) {
+        std::lock_guard<std::mutex> guard(descriptions_mutex);
+        pipeline_descriptions[key] = std::move(description);
+    }
+
+    return pipeline;
+}
+
 vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiveType &type, bool consider_for_async, MemState &mem) {
     const GxmRecordState &record = context.record;
     // get the hash of the current context
@@ -961,6 +1221,20 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
                 return it->second;
         }
         already_in_cache = true;
+
+        auto precompiled_it = precompiled_pipelines.find(key);
+        if (precompiled_it != precompiled_pipelines.end()) {
+            const PrecompiledPipeline precompiled = precompiled_it->second;
+            precompiled_pipelines.erase(precompiled_it);
+
+            if (precompiled.vertex_hash == vertex_program_gxm.renderer_data->hash && precompiled.fragment_hash == fragment_program.hash) {
+                it->second = precompiled.pipeline;
+                return precompiled.pipeline;
+            }
+
+            // the programs are now at a different location, this pipeline can't be used
+            state.device.destroy(precompiled.pipeline);
+        }
     } else {
         // the pipeline hash was not in the cache;
         it = pipelines.insert({ key, pipeline_compiling }).first;
@@ -982,6 +1256,7 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
         CompileRequest *request = new CompileRequest;
         *request = {
             .pipeline = &it->second,
+            .key = key,
             .type = type,
             .render_pass = render_pass,
             .vertex_program_gxm = &vertex_program_gxm,
@@ -1000,7 +1275,7 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
         return nullptr;
     } else {
         // can't wait, compile it right now
-        vk::Pipeline result = compile_pipeline(type, render_pass, vertex_program_gxm, fragment_program_gxm, record, context.shader_hints, mem);
+        vk::Pipeline result = compile_pipeline(key, type, render_pass, vertex_program_gxm, fragment_program_gxm, record, context.shader_hints, mem);
 
         const auto time_s = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
         next_pipeline_cache_save = time_s + pipeline_cache_save_delay;
@@ -1016,7 +1291,8 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
 
 vk::ShaderModule PipelineCache::precompile_shader(const Sha256Hash &hash, bool search_first) {
     if (search_first) {
-        // happens while loading the thread, no parallel access so no need for a mutex
+        // shaders are precompiled on multiple threads
+        std::lock_guard<std::mutex> guard(shaders_mutex);
         auto it = shaders.find(hash);
         if (it != shaders.end())
             return it->second;
@@ -1046,4 +1322,60 @@ vk::ShaderModule PipelineCache::precompile_shader(const Sha256Hash &hash, bool s
 
     return shader;
 }
+
+void PipelineCache::precompile_pipelines() {
+    struct PrecompileJob {
+        uint64_t key;
+        PipelineDescription description;
+        vk::RenderPass render_pass;
+        vk::ShaderModule vertex_shader;
+        vk::ShaderModule fragment_shader;
+        vk::Pipeline pipeline = nullptr;
+    };
+
+    std::vector<PrecompileJob> jobs;
+    {
+        std::lock_guard<std::mutex> guard(descriptions_mutex);
+        for (const auto &[key, description] : pipeline_descriptions) {
+            auto it = pipelines.find(key);
+            if ((it != pipelines.end() && it->second != nullptr) || precompiled_pipelines.count(key))
+                continue;
+
+            jobs.push_back(PrecompileJob{ .key = key, .description = description });
+        }
+    }
+
+    if (jobs.empty())
+        return;
+
+    // render passes and shader modules are shared between pipelines, get them first
+    // the shaders should have already been loaded, in which case precompile_shader only looks them up
+    std::erase_if(jobs, [&](PrecompileJob &job) {
+        const PipelineDescription::Parameters &params = job.description.params;
+        const RenderPassParams &pass = params.render_pass;
+        job.render_pass = retrieve_render_pass(pass.format, pass.force_load, pass.force_store, pass.is_color_transient, pass.no_color);
+        job.vertex_shader = precompile_shader(params.vertex_hash);
+        job.fragment_shader = precompile_shader(params.fragment_hash);
+        return !job.vertex_shader || !job.fragment_shader;
+    });
+
+    LOG_INFO("Compiling {} pipelines from the previous sessions", jobs.size());
+    WorkerPool::get().parallel_for(jobs.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            PrecompileJob &job = jobs[i];
+            job.pipeline = create_pipeline(job.description, job.render_pass, job.vertex_shader, job.fragment_shader);
+        }
+    });
+
+    for (const PrecompileJob &job : jobs) {
+        if (!job.pipeline)
+            continue;
+
+        precompiled_pipelines[job.key] = PrecompiledPipeline{
+            .pipeline = job.pipeline,
+            .vertex_hash = job.description.params.vertex_hash,
+            .fragment_hash = job.description.params.fragment_hash
+        };
+    }
+}
 } // namespace renderer::vulkan
@@ -28,7 +28,9 @@
 #include <config/state.h>
 #include <config/version.h>
 #include <display/state.h>
+#include <mem/util.h>
 #include <shader/spirv_recompiler.h>
+#include <threads/worker_pool.h>
 #include <util/align.h>
 #include <util/android_driver.h>
 #include <util/log.h>
@@ -981,6 +983,9 @@ void VKState::late_init(const Config &cfg, const std::string_view game_id, MemSt
     pipeline_cache.init(support_rasterized_order_access);
 
     texture_cache.init(true, texture_folder(), game_id);
+    texture_cache.async_upload = cfg.async_texture_upload;
+    if (cfg.texture_disk_cache)
+        texture_cache.init_disk_cache(cache_path / "textures" / std::string(game_id), MiB(cfg.texture_disk_cache_size));
 }
 
 void VKState::cleanup() {
@@ -1756,6 +1761,34 @@ void VKState::precompile_shader(const ShadersHash &hash) {
     LOG_INFO("Program Compiled {}/{}", programs_count_pre_compiled, shaders_cache_hashs.size());
 }
 
+void VKState::precompile_shaders(std::span<const ShadersHash> hashes) {
+    // the same shader can be used by multiple programs, it must not be loaded twice at the same time
+    const Sha256Hash empty_hash{};
+    std::vector<Sha256Hash> shader_hashes;
+    shader_hashes.reserve(hashes.size() * 2);
+    for (const ShadersHash &hash : hashes) {
+        if (hash.vert != empty_hash)
+            shader_hashes.push_back(hash.vert);
+        if (hash.frag != empty_hash)
+            shader_hashes.push_back(hash.frag);
+    }
+    std::sort(shader_hashes.begin(), shader_hashes.end());
+    shader_hashes.erase(std::unique(shader_hashes.begin(), shader_hashes.end()), shader_hashes.end());
+
+    // reading a shader and creating its module can be done from any thread
+    WorkerPool::get().parallel_for(shader_hashes.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            pipeline_cache.precompile_shader(shader_hashes[i]);
+    });
+
+    programs_count_pre_compiled += hashes.size();
+    LOG_INFO("Program Compiled {}/{}", programs_count_pre_compiled, shaders_cache_hashs.size());
+}
+
+void VKState::precompile_pipelines() {
+    pipeline_cache.precompile_pipelines();
+}
+
 void VKState::preclose_action() {
     // Stop the GPU request wait thread before destruction begins.
     // VKState (owns the queue) is destroyed before VKContext (owns the thread).
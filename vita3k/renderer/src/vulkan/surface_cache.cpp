@@ -25,6 +25,7 @@
 
 #include <vulkan/vulkan_format_traits.hpp>
 
+#include <threads/worker_pool.h>
 #include <util/align.h>
 #include <util/log.h>
 #include <util/vector_utils.h>
@@ -59,6 +60,16 @@ static bool format_need_additional_memory(SceGxmColorBaseFormat format) {
 
 namespace renderer::vulkan {
 
+// is the swizzle of the surface undone by the CPU when the surface is synced
+static bool surface_swizzle_is_converted(const ColorSurfaceCacheInfo &surface) {
+    return surface.swizzle.r != vk::ComponentSwizzle::eR && format_support_swizzle(surface.format);
+}
+
+// does the sync of the surface go through a readback converted by the CPU
+static bool surface_sync_needs_readback(const ColorSurfaceCacheInfo &surface) {
+    return format_need_additional_memory(surface.format) || surface_swizzle_is_converted(surface);
+}
+
 static void protect_surface(MemState &mem, ColorSurfaceCacheInfo &info) {
     const bool trap_reads = (info.tiling == SurfaceTiling::Linear
         && format_support_surface_sync(info.format));
@@ -89,7 +100,7 @@ static void protect_surface(MemState &mem, ColorSurfaceCacheInfo &info) {
         });
 }
 
-ColorSurfaceCacheInfo::~ColorSurfaceCacheInfo() {
+SurfaceReadback::~SurfaceReadback() {
     sws_freeContext(sws_context);
 }
 
@@ -97,7 +108,7 @@ void VKSurfaceCache::destroy_framebuffers(vk::ImageView view) {
     vkutil::DestroyQueue &destroy_queue = state.frame().destroy_queue;
     for (auto it = framebuffer_array.begin(); it != framebuffer_array.end();) {
         // if the color of depth-stencil match the one of the render_target, this won't be used anymore
-        if (it->first.first == view || it->first.second == view) {
+        if (it->first.first == static_cast<VkImageView>(view) || it->first.second == static_cast<VkImageView>(view)) {
             destroy_queue.add(it->second.standard);
             destroy_queue.add(it->second.shader_interlock);
             it = framebuffer_array.erase(it);
@@ -146,6 +157,10 @@ VKSurfaceCache::VKSurfaceCache(VKState &state)
 }
 
 void VKSurfaceCache::cleanup() {
+    wait_for_readbacks();
+    for (auto &readback : readback_ring)
+        readback.buffer.destroy();
+
     for (auto &[key, fb] : framebuffer_array) {
         state.device.destroy(fb.standard);
         state.device.destroy(fb.shader_interlock);
@@ -167,8 +182,6 @@ void VKSurfaceCache::cleanup() {
 
         if (info.blit_image)
             info.blit_image->destroy();
-        if (info.copy_buffer)
-            info.copy_buffer->destroy();
 
         info.texture.destroy();
     }
@@ -211,18 +224,9 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_color_surface_for_framebuffer(Mem
     uint32_t width = static_cast<uint32_t>(original_width * state.res_multiplier);
     uint32_t height = static_cast<uint32_t>(original_height * state.res_multiplier);
 
-    bool overlap = true;
-
-    // Of course, this works under the assumption that range must be unique :D
-    auto ite = color_address_lookup.upper_bound(address);
-    if (ite == color_address_lookup.begin())
-        // no match
-        overlap = false;
-    else
-        --ite;
-    // ite is now the first item with an address lower or equal to key
-
-    overlap = (overlap && (ite->first + ite->second->total_bytes) > address);
+    // the surface containing this address with the highest start address
+    const auto *lookup_entry = color_address_lookup.find_containing(address);
+    const bool overlap = lookup_entry != nullptr;
 
     const SceGxmColorBaseFormat base_format = gxm::get_base_format(color->colorFormat);
     vk::Format vk_format = color::translate_format(base_format);
@@ -250,7 +254,8 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_color_surface_for_framebuffer(Mem
     VKContext *context = reinterpret_cast<VKContext *>(state.context);
 
     if (overlap) {
-        ColorSurfaceCacheInfo &info = *ite->second;
+        ColorSurfaceCacheInfo &info = *lookup_entry->value;
+        const Address surface_address = lookup_entry->begin;
 
         // There are four situations I think of:
         // 1. Different base address, lookup for write, in this case, if the cached surface range contains the given address, then
@@ -258,19 +263,19 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_color_surface_for_framebuffer(Mem
         // 2. Same base address, but width and height change to be larger, or format change if write. Remake a new one for both read and write situation.
         // 3. Out of cache range. In write case, create a new one, in read case, lul
         // 4. Read situation with smaller width and height, probably need to extract the needed region out.
-        // 5. the surface is a gbuffer and we are currently trying to read the 2nd component, in this case key == ite->first + 4
-        const bool addr_in_range_of_cache = ((address + total_surface_size) <= (ite->first + info.total_bytes + 4));
-        const bool cache_probably_freed = (ite->first != address) && addr_in_range_of_cache;
+        // 5. the surface is a gbuffer and we are currently trying to read the 2nd component, in this case address == surface_address + 4
+        const bool addr_in_range_of_cache = ((address + total_surface_size) <= (surface_address + info.total_bytes + 4));
+        const bool cache_probably_freed = (surface_address != address) && addr_in_range_of_cache;
         const bool surface_extent_changed = info.height < height || bytes_per_stride != info.stride_bytes || tiling != info.tiling;
         bool surface_stat_changed = false;
 
-        if (ite->first == address)
+        if (surface_address == address)
             surface_stat_changed = surface_extent_changed || info.width < width || base_format != info.format;
 
         const bool invalidated = cache_probably_freed || surface_stat_changed || !addr_in_range_of_cache;
         if (invalidated) {
             destroy_surface(info);
-            color_address_lookup.erase(ite);
+            color_address_lookup.erase(surface_address);
             color_surface_queue.set_as_lru(&info);
         } else {
             color_surface_queue.set_as_mru(&info);
@@ -317,7 +322,7 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_color_surface_for_framebuffer(Mem
     color_surface_queue.set_as_mru(&info_added);
     info_added.last_frame_rendered = context->frame_timestamp;
 
-    color_address_lookup[address] = &info_added;
+    color_address_lookup.insert(address, address + total_surface_size, &info_added);
 
     info_added.width = width;
     info_added.height = height;
@@ -394,22 +399,14 @@ std::optional<TextureLookupResult> VKSurfaceCache::retrieve_color_surface_as_tex
     const uint32_t width = static_cast<uint32_t>(original_width * state.res_multiplier);
     const uint32_t height = static_cast<uint32_t>(original_height * state.res_multiplier);
 
-    bool overlap = true;
-    // Of course, this works under the assumption that range must be unique :D
-    auto ite = color_address_lookup.upper_bound(address);
-    if (ite == color_address_lookup.begin())
-        // no match
-        overlap = false;
-    else
-        --ite;
-    // ite is now the first item with an address lower or equal to key
-
-    overlap = (overlap && (ite->first + ite->second->total_bytes) > address);
-
-    if (!overlap)
+    // the surface containing this address with the highest start address
+    const auto *lookup_entry = color_address_lookup.find_containing(address);
+    if (!lookup_entry)
         return std::nullopt;
 
-    if (*ite->second->dirty)
+    const Address surface_address = lookup_entry->begin;
+    ColorSurfaceCacheInfo &info = *lookup_entry->value;
+    if (*info.dirty)
         // Guest wrote to the surface backing memory since it was rendered, so GPU data is stale.
         return std::nullopt;
 
@@ -453,8 +450,6 @@ std::optional<TextureLookupResult> VKSurfaceCache::retrieve_color_surface_as_tex
     }
     uint32_t total_surface_size = stride_bytes * original_height;
 
-    ColorSurfaceCacheInfo &info = *ite->second;
-
     if ((base_format == SCE_GXM_COLOR_BASE_FORMAT_U8U8U8 || info.format == SCE_GXM_COLOR_BASE_FORMAT_U8U8U8)
         && base_format != info.format)
         // don't even try to match u8u8u8 with something else
@@ -466,9 +461,9 @@ std::optional<TextureLookupResult> VKSurfaceCache::retrieve_color_surface_as_tex
         return std::nullopt;
 
     // Check if we can use this surface
-    bool addr_in_range_of_cache = ((address + total_surface_size) <= (ite->first + info.total_bytes + 4));
+    bool addr_in_range_of_cache = ((address + total_surface_size) <= (surface_address + info.total_bytes + 4));
 
-    if (ite->first != address && !addr_in_range_of_cache)
+    if (surface_address != address && !addr_in_range_of_cache)
         // persona 4 sample from the top of a texture while the bottom wasn't rendered to, the fact that both the surface and
         // the texture start at the same location should be enough
         return std::nullopt;
@@ -481,7 +476,7 @@ std::optional<TextureLookupResult> VKSurfaceCache::retrieve_color_surface_as_tex
 
     // TODO: this is true only for linear textures (and also kind of for tiled textures) (and in this case start_x = 0),
     // for swizzled textures this is different
-    const uint32_t data_delta = address - ite->first;
+    const uint32_t data_delta = address - surface_address;
     uint32_t start_sourced_line = static_cast<uint32_t>((data_delta / stride_bytes) * state.res_multiplier);
     uint32_t start_x = static_cast<uint32_t>((data_delta % stride_bytes) / bytes_per_pixel_requested * state.res_multiplier);
 
@@ -701,13 +696,11 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_depth_stencil_for_framebuffer(Sce
     DepthStencilSurfaceCacheInfo *cached_info = nullptr;
 
     if (!is_stencil_only) {
-        auto it = depth_address_lookup.find(depth_stencil->depth_data.address());
-        if (it != depth_address_lookup.end())
-            cached_info = it->second;
+        if (const auto *entry = depth_address_lookup.find(depth_stencil->depth_data.address()))
+            cached_info = entry->value;
     } else {
-        auto it = stencil_address_lookup.find(depth_stencil->stencil_data.address());
-        if (it != stencil_address_lookup.end())
-            cached_info = it->second;
+        if (const auto *entry = stencil_address_lookup.find(depth_stencil->stencil_data.address()))
+            cached_info = entry->value;
     }
 
     if (cached_info != nullptr) {
@@ -737,12 +730,7 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_depth_stencil_for_framebuffer(Sce
     if (cached_info->texture.image)
         destroy_surface(*cached_info);
 
-    // update the lookup info
     ds_surface_queue.set_as_mru(cached_info);
-    if (depth_stencil->depth_data)
-        depth_address_lookup[depth_stencil->depth_data.address()] = cached_info;
-    if (depth_stencil->stencil_data)
-        stencil_address_lookup[depth_stencil->stencil_data.address()] = cached_info;
 
     cached_info->surface = *depth_stencil;
     cached_info->memory_width = memory_width;
@@ -765,6 +753,17 @@ SurfaceRetrieveResult VKSurfaceCache::retrieve_depth_stencil_for_framebuffer(Sce
     }
     cached_info->total_bytes = bytes_per_sample * depth_stencil->get_stride() * memory_height;
 
+    // update the lookup info
+    if (depth_stencil->depth_data) {
+        const Address depth_address = depth_stencil->depth_data.address();
+        depth_address_lookup.insert(depth_address, depth_address + cached_info->total_bytes, cached_info);
+    }
+    if (depth_stencil->stencil_data) {
+        // the stencil is always one byte per sample
+        const Address stencil_address = depth_stencil->stencil_data.address();
+        stencil_address_lookup.insert(stencil_address, stencil_address + depth_stencil->get_stride() * memory_height, cached_info);
+    }
+
     vkutil::Image &image = cached_info->texture;
 
     // use prerender cmd in case we read from the depth buffer (although I really doubt this could happen)
@@ -853,33 +852,25 @@ std::optional<TextureLookupResult> VKSurfaceCache::retrieve_depth_stencil_as_tex
     DepthStencilSurfaceCacheInfo *found_info = nullptr;
 
     if (can_be_depth) {
-        // get the first depth surface with an address lower or equal to address
-        auto it = depth_address_lookup.upper_bound(address);
-        if (it != depth_address_lookup.begin()) {
-            --it;
-
-            // the texture must be contained entirely in the depth surface
-            if (address + total_bytes <= it->first + it->second->total_bytes) {
-                surface_address = it->first;
-                found_info = it->second;
-            }
+        // get the depth surface containing address
+        const auto *entry = depth_address_lookup.find_containing(address);
+
+        // the texture must be contained entirely in the depth surface
+        if (entry && address + total_bytes <= entry->end) {
+            surface_address = entry->begin;
+            found_info = entry->value;
         }
     }
     if (!found_info && can_be_stencil) {
-        // get the first stencil surface with an address lower or equal to address
-        auto it = stencil_address_lookup.upper_bound(address);
-        if (it != stencil_address_lookup.begin()) {
-            --it;
-
-            // note: we don't support sampling the stencil from a D24S8 depth-stencil
-            // so we can assume any stencil uses only 1 byte per sample
-            uint32_t surface_bytes = it->second->stride_samples * it->second->memory_height * 1;
-
-            // the texture must be contained entirely in the stencil surface
-            if (address + total_bytes <= it->first + surface_bytes) {
-                surface_address = it->first;
-                found_info = it->second;
-            }
+        // get the stencil surface containing address
+        // note: we don't support sampling the stencil from a D24S8 depth-stencil
+        // so the range of a stencil surface assumes it uses only 1 byte per sample
+        const auto *entry = stencil_address_lookup.find_containing(address);
+
+        // the texture must be contained entirely in the stencil surface
+        if (entry && address + total_bytes <= entry->end) {
+            surface_address = entry->begin;
+            found_info = entry->value;
         }
     }
 
@@ -1077,7 +1068,7 @@ Framebuffer &VKSurfaceCache::retrieve_framebuffer_handle(MemState &mem, SceGxmCo
     color_view = color_result.view;
     ds_view = ds_result.view;
 
-    std::pair<vk::ImageView, vk::ImageView> key = { color_view, ds_view };
+    const std::pair<VkImageView, VkImageView> key = { static_cast<VkImageView>(color_view), static_cast<VkImageView>(ds_view) };
     auto it = framebuffer_array.find(key);
 
     if (it != framebuffer_array.end()) {
@@ -1125,11 +1116,11 @@ bool VKSurfaceCache::check_for_surface(MemState &mem, Address source_address, Ca
     }
 
     // for now, only look if the address matches exactly a color surface
-    auto it = color_address_lookup.find(source_address);
-    if (it == color_address_lookup.end())
+    const auto *entry = color_address_lookup.find(source_address);
+    if (!entry)
         return false;
 
-    auto &surface = *it->second;
+    auto &surface = *entry->value;
     VKContext &context = *static_cast<VKContext *>(state.context);
     // if the frame is already rendered skip
     // Note: that's not the best behavior but it should be fine
@@ -1150,13 +1141,16 @@ bool VKSurfaceCache::check_for_surface(MemState &mem, Address source_address, Ca
         vk::CommandBuffer surface_cmd = nullptr;
         vk::Fence fence = state.device.createFence({});
         ColorSurfaceCacheInfo *returned_info = nullptr;
+        // the readback may only be released by the wait thread once it went past a previous vk_callback,
+        // which needs the pool mutex, so it must be taken before locking it
+        SurfaceReadback *readback = surface_sync_needs_readback(surface) ? &acquire_readback() : nullptr;
         {
             std::lock_guard<std::mutex> lock(state.multithread_pool_mutex);
             surface_cmd = vkutil::create_single_time_command(state.device, state.multithread_command_pool);
 
             context.render_cmd = surface_cmd;
             last_written_surface = &surface;
-            returned_info = perform_surface_sync();
+            returned_info = perform_surface_sync(readback);
             context.render_cmd = prev_cmd;
 
             surface_cmd.end();
@@ -1182,7 +1176,7 @@ bool VKSurfaceCache::check_for_surface(MemState &mem, Address source_address, Ca
         state.request_queue.push(CallbackRequest{ new CallbackRequestFunction(std::move(vk_callback)) });
 
         if (returned_info)
-            state.request_queue.push(PostSurfaceSyncRequest{ returned_info });
+            state.request_queue.push(PostSurfaceSyncRequest{ returned_info->readback, returned_info->data.address(), static_cast<uint32_t>(returned_info->total_bytes) });
     }
 
     // now push the callback
@@ -1194,13 +1188,13 @@ bool VKSurfaceCache::check_for_surface(MemState &mem, Address source_address, Ca
     return true;
 }
 
-ColorSurfaceCacheInfo *VKSurfaceCache::perform_surface_sync() {
+ColorSurfaceCacheInfo *VKSurfaceCache::perform_surface_sync(SurfaceReadback *acquired_readback) {
     // surface sync is supported only if memory mapping is enabled
-    if (!state.features.enable_memory_mapping)
-        return nullptr;
-
-    if (last_written_surface == nullptr || !*last_written_surface->need_surface_sync)
+    if (!state.features.enable_memory_mapping || last_written_surface == nullptr || !*last_written_surface->need_surface_sync) {
+        if (acquired_readback)
+            release_readback(*acquired_readback);
         return nullptr;
+    }
 
     VKContext *context = reinterpret_cast<VKContext *>(state.context);
     vk::CommandBuffer cmd_buffer = context->render_cmd;
@@ -1209,13 +1203,10 @@ ColorSurfaceCacheInfo *VKSurfaceCache::perform_surface_sync() {
     vk::ImageLayout image_layout = vk::ImageLayout::eGeneral;
 
     // this works for surface swizzles
-    bool is_swizzle_identity = last_written_surface->swizzle.r == vk::ComponentSwizzle::eR;
-    if (!is_swizzle_identity && !format_support_swizzle(last_written_surface->format)) {
+    const bool is_swizzle_identity = !surface_swizzle_is_converted(*last_written_surface);
+    if (last_written_surface->swizzle.r != vk::ComponentSwizzle::eR && is_swizzle_identity)
         LOG_WARN_ONCE("Surface sync with swizzle not support on {}", vk::to_string(last_written_surface->texture.format));
 
-        is_swizzle_identity = true;
-    }
-
     if (state.res_multiplier != 1.0f) {
         // scale back the image using a blit command first
 
@@ -1249,30 +1240,43 @@ ColorSurfaceCacheInfo *VKSurfaceCache::perform_surface_sync() {
         image_layout = vk::ImageLayout::eTransferSrcOptimal;
     }
 
+    const uint32_t pixel_stride = (last_written_surface->stride_bytes * 8) / gxm::bits_per_pixel(last_written_surface->format);
     vk::Buffer buffer;
     uint32_t offset;
-    if (format_need_additional_memory(last_written_surface->format)) {
-        if (!last_written_surface->copy_buffer)
-            last_written_surface->copy_buffer = std::make_unique<vkutil::Buffer>();
-
-        vkutil::Buffer &copy_buffer = *last_written_surface->copy_buffer;
-
-        if (!copy_buffer.buffer) {
-            copy_buffer.size = last_written_surface->stride_bytes * last_written_surface->original_height;
-            copy_buffer.init_buffer(vk::BufferUsageFlagBits::eTransferDst, vkutil::vma_mapped_alloc);
+    if (surface_sync_needs_readback(*last_written_surface)) {
+        // copy to a readback buffer, the CPU part then writes the converted surface to the guest memory
+        SurfaceReadback &readback = acquired_readback ? *acquired_readback : acquire_readback();
+
+        const vk::DeviceSize buffer_size = static_cast<vk::DeviceSize>(pixel_stride) * last_written_surface->original_height * vk::blockSize(last_written_surface->texture.format);
+        if (readback.buffer.size < buffer_size) {
+            // the buffer is not used by the GPU anymore once the readback is available
+            readback.buffer.destroy();
+            readback.buffer.size = buffer_size;
+            readback.buffer.init_buffer(vk::BufferUsageFlagBits::eTransferDst, vkutil::vma_mapped_alloc);
         }
 
-        buffer = copy_buffer.buffer;
+        readback.data = last_written_surface->data;
+        readback.width = last_written_surface->original_width;
+        readback.height = last_written_surface->original_height;
+        readback.pixel_stride = pixel_stride;
+        readback.format = last_written_surface->format;
+        readback.texture_format = last_written_surface->texture.format;
+        readback.swizzle = is_swizzle_identity ? vk::ComponentSwizzle::eR : last_written_surface->swizzle.r;
+
+        buffer = readback.buffer.buffer;
         offset = 0;
 
         last_written_surface->need_buffer_sync = false;
-        last_written_surface->need_post_surface_sync = true;
+        last_written_surface->readback = &readback;
     } else {
+        if (acquired_readback)
+            release_readback(*acquired_readback);
+
         last_written_surface->need_buffer_sync = true;
-        last_written_surface->need_post_surface_sync = !is_swizzle_identity;
+        last_written_surface->readback = nullptr;
         std::tie(buffer, offset) = state.get_matching_mapping(last_written_surface->data);
     }
-    const uint32_t pixel_stride = (last_written_surface->stride_bytes * 8) / gxm::bits_per_pixel(last_written_surface->format);
+
     vk::BufferImageCopy copy{
         .bufferOffset = offset,
         .bufferRowLength = pixel_stride,
@@ -1289,96 +1293,174 @@ ColorSurfaceCacheInfo *VKSurfaceCache::perform_surface_sync() {
     return return_value;
 }
 
+SurfaceReadback &VKSurfaceCache::acquire_readback() {
+    SurfaceReadback &readback = readback_ring[readback_ring_index];
+    readback_ring_index = (readback_ring_index + 1) % readback_ring_size;
+
+    // this only waits if surfaces are synced faster than the GPU and the workers can handle them
+    std::unique_lock<std::mutex> lock(readback_mutex);
+    while (readback.in_use && !state.request_queue.is_aborted())
+        readback_cond.wait_for(lock, std::chrono::milliseconds(100));
+    readback.in_use = true;
+
+    return readback;
+}
+
+void VKSurfaceCache::release_readback(SurfaceReadback &readback) {
+    {
+        const std::lock_guard<std::mutex> lock(readback_mutex);
+        readback.in_use = false;
+    }
+    readback_cond.notify_all();
+}
+
 template <typename T>
-static void swizzle_text_T_2(T *pixels, uint32_t nb_pixel) {
+static void swizzle_text_T_2(const T *src, T *dst, uint32_t nb_pixel) {
     for (uint32_t i = 0; i < nb_pixel; i++) {
-        std::swap(pixels[2 * i], pixels[2 * i + 1]);
+        dst[2 * i] = src[2 * i + 1];
+        dst[2 * i + 1] = src[2 * i];
     }
 }
 
 template <typename T, size_t type>
-static void swizzle_text_T_4(T *pixels, uint32_t nb_pixel) {
+static void swizzle_text_T_4(const T *src, T *dst, uint32_t nb_pixel) {
     for (uint32_t i = 0; i < nb_pixel; i++) {
         if constexpr (type == 0) {
             // BGRA
-            std::swap(pixels[4 * i], pixels[4 * i + 2]);
+            dst[4 * i] = src[4 * i + 2];
+            dst[4 * i + 1] = src[4 * i + 1];
+            dst[4 * i + 2] = src[4 * i];
+            dst[4 * i + 3] = src[4 * i + 3];
         } else if constexpr (type == 1) {
             // ABGR
-            std::swap(pixels[4 * i], pixels[4 * i + 3]);
-            std::swap(pixels[4 * i + 1], pixels[4 * i + 2]);
+            dst[4 * i] = src[4 * i + 3];
+            dst[4 * i + 1] = src[4 * i + 2];
+            dst[4 * i + 2] = src[4 * i + 1];
+            dst[4 * i + 3] = src[4 * i];
         } else {
             // ARGB
-            T copy[] = { pixels[4 * i],
-                pixels[4 * i + 1],
-                pixels[4 * i + 2],
-                pixels[4 * i + 3] };
-            pixels[4 * i] = copy[3];
-            pixels[4 * i + 1] = copy[0];
-            pixels[4 * i + 2] = copy[1];
-            pixels[4 * i + 3] = copy[2];
+            dst[4 * i] = src[4 * i + 3];
+            dst[4 * i + 1] = src[4 * i];
+            dst[4 * i + 2] = src[4 * i + 1];
+            dst[4 * i + 3] = src[4 * i + 2];
         }
     }
 }
 
 template <typename T>
-static void swizzle_text_T(T *pixels, uint32_t nb_pixel, ColorSurfaceCacheInfo *surface) {
+static void swizzle_text_T(const T *src, T *dst, uint32_t nb_pixel, const SurfaceReadback &readback) {
     // there can only be 2 or 4 component textures here
-    if (vk::componentCount(surface->texture.format) == 2) {
-        swizzle_text_T_2<T>(pixels, nb_pixel);
+    if (vk::componentCount(readback.texture_format) == 2) {
+        swizzle_text_T_2<T>(src, dst, nb_pixel);
     } else {
         // find the swizzle
         // swizzles are inversed
-        switch (surface->swizzle.r) {
+        switch (readback.swizzle) {
         case vk::ComponentSwizzle::eB:
             // BGRA
-            swizzle_text_T_4<T, 0>(pixels, nb_pixel);
+            swizzle_text_T_4<T, 0>(src, dst, nb_pixel);
             break;
         case vk::ComponentSwizzle::eA:
             // ABGR
-            swizzle_text_T_4<T, 1>(pixels, nb_pixel);
+            swizzle_text_T_4<T, 1>(src, dst, nb_pixel);
             break;
         case vk::ComponentSwizzle::eG:
             // ARGB
-            swizzle_text_T_4<T, 2>(pixels, nb_pixel);
+            swizzle_text_T_4<T, 2>(src, dst, nb_pixel);
+            break;
+        default:
+            memcpy(dst, src, nb_pixel * 4 * sizeof(T));
             break;
         }
     }
 }
 
-void VKSurfaceCache::perform_post_surface_sync(const MemState &mem, ColorSurfaceCacheInfo *surface) {
-    if (surface == nullptr)
-        return;
+// range of the guest memory written by the conversion of the readback
+static std::pair<Address, Address> get_readback_range(const SurfaceReadback &readback) {
+    const uint32_t pixel_size = format_need_additional_memory(readback.format) ? 3 : vk::blockSize(readback.texture_format);
+    const Address start = readback.data.address();
+    return { start, start + readback.pixel_stride * pixel_size * readback.height };
+}
 
-    const uint32_t pixel_stride = (surface->stride_bytes * 8) / gxm::bits_per_pixel(surface->format);
-    const uint32_t nb_pixels = pixel_stride * surface->original_height;
-    uint8_t *pixels = surface->data.cast<uint8_t>().get(mem);
+// convert the content of the readback buffer and write it to the guest memory
+static void write_back_readback(const MemState &mem, SurfaceReadback &readback) {
+    uint8_t *pixels = readback.data.cast<uint8_t>().get(mem);
+    const uint8_t *src = static_cast<const uint8_t *>(readback.buffer.mapped_data);
 
-    if (format_need_additional_memory(surface->format)) {
+    if (format_need_additional_memory(readback.format)) {
         // special case, use a custom function
-        const bool is_swizzle_identity = surface->swizzle.r == vk::ComponentSwizzle::eR;
-        if (!surface->sws_context) {
-            const AVPixelFormat dst_fmt = is_swizzle_identity ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_BGR24;
-            surface->sws_context = sws_getContext(surface->original_width, surface->original_height, AV_PIX_FMT_RGB0, surface->original_width, surface->original_height, dst_fmt, 0, nullptr, nullptr, nullptr);
-            assert(surface->sws_context != NULL);
-        }
+        const AVPixelFormat dst_fmt = readback.swizzle == vk::ComponentSwizzle::eR ? AV_PIX_FMT_RGB24 : AV_PIX_FMT_BGR24;
+        readback.sws_context = sws_getCachedContext(readback.sws_context, readback.width, readback.height, AV_PIX_FMT_RGB0, readback.width, readback.height, dst_fmt, 0, nullptr, nullptr, nullptr);
+        assert(readback.sws_context != NULL);
 
-        int src_stride = pixel_stride * 4;
-        int dst_stride = pixel_stride * 3;
-        sws_scale(surface->sws_context, reinterpret_cast<const uint8_t *const *>(&surface->copy_buffer->mapped_data), &src_stride, 0, surface->original_height, &pixels, &dst_stride);
+        int src_stride = readback.pixel_stride * 4;
+        int dst_stride = readback.pixel_stride * 3;
+        sws_scale(readback.sws_context, &src, &src_stride, 0, readback.height, &pixels, &dst_stride);
         return;
     }
 
-    switch (vk::componentBits(surface->texture.format, 0)) {
-    case 8:
-        swizzle_text_T<uint8_t>(pixels, nb_pixels, surface);
-        break;
-    case 16:
-        swizzle_text_T<uint16_t>(reinterpret_cast<uint16_t *>(pixels), nb_pixels, surface);
-        break;
-    case 32:
-        swizzle_text_T<uint32_t>(reinterpret_cast<uint32_t *>(pixels), nb_pixels, surface);
-        break;
+    // split the surface by rows, swizzling a big surface on a single thread takes a few ms
+    const size_t row_size = static_cast<size_t>(readback.pixel_stride) * vk::blockSize(readback.texture_format);
+    WorkerPool::get().parallel_for(readback.height, 64, [&](size_t begin, size_t end) {
+        const size_t offset = begin * row_size;
+        const uint32_t nb_pixels = static_cast<uint32_t>((end - begin) * readback.pixel_stride);
+        switch (vk::componentBits(readback.texture_format, 0)) {
+        case 8:
+            swizzle_text_T<uint8_t>(src + offset, pixels + offset, nb_pixels, readback);
+            break;
+        case 16:
+            swizzle_text_T<uint16_t>(reinterpret_cast<const uint16_t *>(src + offset), reinterpret_cast<uint16_t *>(pixels + offset), nb_pixels, readback);
+            break;
+        case 32:
+            swizzle_text_T<uint32_t>(reinterpret_cast<const uint32_t *>(src + offset), reinterpret_cast<uint32_t *>(pixels + offset), nb_pixels, readback);
+            break;
+        }
+    });
+}
+
+void VKSurfaceCache::perform_post_surface_sync(const MemState &mem, SurfaceReadback *readback) {
+    if (readback == nullptr)
+        return;
+
+    {
+        // the same memory may have been synced twice, the conversions writing to it must be done in order
+        const std::pair<Address, Address> range = get_readback_range(*readback);
+        auto overlaps_conversion = [&]() {
+            for (const SurfaceReadback &other : readback_ring) {
+                if (!other.converting)
+                    continue;
+
+                const std::pair<Address, Address> other_range = get_readback_range(other);
+                if (range.first < other_range.second && other_range.first < range.second)
+                    return true;
+            }
+            return false;
+        };
+
+        std::unique_lock<std::mutex> lock(readback_mutex);
+        readback_cond.wait(lock, [&]() { return !overlaps_conversion(); });
+        readback->converting = true;
+        readbacks_pending++;
     }
+
+    WorkerPool::get().submit([this, &mem, readback]() {
+        write_back_readback(mem, *readback);
+        const std::pair<Address, Address> range = get_readback_range(*readback);
+        state.texture_cache.invalidate_prefetches(range.first, range.second);
+
+        {
+            const std::lock_guard<std::mutex> lock(readback_mutex);
+            readback->in_use = false;
+            readback->converting = false;
+            readbacks_pending--;
+        }
+        readback_cond.notify_all();
+    });
+}
+
+void VKSurfaceCache::wait_for_readbacks() {
+    std::unique_lock<std::mutex> lock(readback_mutex);
+    readback_cond.wait(lock, [&]() { return readbacks_pending == 0; });
 }
 
 void VKSurfaceCache::destroy_associated_framebuffers(const VKRenderTarget *render_target) {
@@ -1390,21 +1472,15 @@ void VKSurfaceCache::destroy_associated_framebuffers(const VKRenderTarget *rende
 }
 
 vk::ImageView VKSurfaceCache::sourcing_color_surface_for_presentation(Ptr<const void> address, uint32_t pitch, Viewport &viewport) {
-    // get closest surface with an address below address
-    auto ite = color_address_lookup.upper_bound(address.address());
-    if (ite == color_address_lookup.begin()) {
-        return nullptr;
-    }
-    --ite;
-
-    ColorSurfaceCacheInfo &info = *ite->second;
-    if (info.data.address() + info.total_bytes <= address.address())
-        // they do not overlap
+    // get the surface containing this address
+    const auto *lookup_entry = color_address_lookup.find_containing(address.address());
+    if (!lookup_entry)
         return nullptr;
 
+    ColorSurfaceCacheInfo &info = *lookup_entry->value;
     if (info.stride_bytes == pitch * 4) {
         // In assumption the format is RGBA8
-        const size_t data_delta = address.address() - ite->first;
+        const size_t data_delta = address.address() - lookup_entry->begin;
         uint32_t limited_height = viewport.height;
         if ((data_delta % (pitch * 4)) == 0) {
             uint32_t start_sourced_line = static_cast<uint32_t>((data_delta / (pitch * 4)) * state.res_multiplier);
@@ -1450,16 +1526,14 @@ vk::ImageView VKSurfaceCache::sourcing_color_surface_for_presentation(Ptr<const
 }
 
 std::vector<uint32_t> VKSurfaceCache::dump_frame(Ptr<const void> address, uint32_t width, uint32_t height, uint32_t pitch) {
-    // get closest surface with an address below address
-    auto ite = color_address_lookup.upper_bound(address.address());
-    if (ite == color_address_lookup.begin()) {
+    // get the surface containing this address
+    const auto *lookup_entry = color_address_lookup.find_containing(address.address());
+    if (!lookup_entry)
         return {};
-    }
-    --ite;
 
-    const ColorSurfaceCacheInfo &info = *ite->second;
+    const ColorSurfaceCacheInfo &info = *lookup_entry->value;
 
-    const uint32_t data_delta = address.address() - ite->first;
+    const uint32_t data_delta = address.address() - lookup_entry->begin;
     const uint32_t pitch_byte = pitch * 4;
     if (info.stride_bytes != pitch_byte || data_delta % pitch_byte != 0)
         return {};
@@ -554,6 +554,17 @@ void VKTextureCache::upload_done() {
     is_texture_transfer_ready = false;
 }
 
+uint32_t VKTextureCache::get_memory_size(const SceGxmTexture &texture) const {
+    return current_texture->memory_needed;
+}
+
+void VKTextureCache::release_texture(size_t index) {
+    // the image may still be used by a frame being rendered
+    TextureCacheEntry &entry = textures[index];
+    if (entry.texture.image)
+        state.frame().destroy_queue.add_image(entry.texture);
+}
+
 void VKTextureCache::configure_sampler(size_t index, const SceGxmTexture &texture, bool no_linear) {
     vk::Sampler &sampler = samplers[index];
     if (sampler) {
@@ -0,0 +1,150 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/address_range_index.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using renderer::AddressRangeIndex;
+
+// ranges by start address, searched one by one
+struct BruteForceIndex {
+    std::map<Address, std::pair<Address, int>> ranges;
+
+    const std::pair<Address, int> *find_containing(Address address) const {
+        const std::pair<Address, int> *found = nullptr;
+        for (const auto &[begin, range] : ranges) {
+            if (begin <= address && address < range.first)
+                found = &range;
+        }
+        return found;
+    }
+};
+
+TEST(address_range_index, matches_brute_force) {
+    std::mt19937 rng(42);
+    for (int sequence = 0; sequence < 2000; sequence++) {
+        // a small address space so the ranges overlap a lot
+        const Address space = 64 + rng() % 4096;
+        auto random_address = [&]() { return static_cast<Address>(rng() % space); };
+
+        AddressRangeIndex<int> index;
+        BruteForceIndex expected;
+        for (int op = 0; op < 200; op++) {
+            const uint32_t kind = rng() % 8;
+            if (kind < 3) {
+                const Address begin = random_address();
+                const Address end = begin + 1 + rng() % (space / 4);
+                index.insert(begin, end, op);
+                expected.ranges[begin] = { end, op };
+            } else if (kind < 5) {
+                // remove an existing range most of the time
+                Address begin = random_address();
+                if (!expected.ranges.empty() && rng() % 4 != 0)
+                    begin = std::next(expected.ranges.begin(), rng() % expected.ranges.size())->first;
+                ASSERT_EQ(index.erase(begin), expected.ranges.erase(begin) == 1) << "sequence " << sequence << ", op " << op;
+            } else if (kind == 5 && rng() % 20 == 0) {
+                index.clear();
+                expected.ranges.clear();
+            }
+
+            ASSERT_EQ(index.size(), expected.ranges.size()) << "sequence " << sequence << ", op " << op;
+            for (int lookup = 0; lookup < 4; lookup++) {
+                const Address address = random_address();
+                const auto *entry = index.find_containing(address);
+                const auto *expected_range = expected.find_containing(address);
+                ASSERT_EQ(entry != nullptr, expected_range != nullptr) << "sequence " << sequence << ", op " << op << ", address " << address;
+                if (entry) {
+                    EXPECT_EQ(entry->end, expected_range->first);
+                    ASSERT_EQ(entry->value, expected_range->second) << "sequence " << sequence << ", op " << op << ", address " << address;
+                }
+
+                const auto *exact = index.find(address);
+                const auto it = expected.ranges.find(address);
+                ASSERT_EQ(exact != nullptr, it != expected.ranges.end()) << "sequence " << sequence << ", op " << op << ", address " << address;
+                if (exact)
+                    ASSERT_EQ(exact->value, it->second.second);
+            }
+        }
+    }
+}
+
+// Replays the lookups of a frame of a post-processing heavy game: a few dozen render targets,
+// most lookups hit one of them, compared with the std::map the surface cache used before
+TEST(address_range_index, DISABLED_replay_benchmark) {
+    constexpr int FRAME_COUNT = 200;
+    constexpr int LOOKUPS_PER_FRAME = 20000;
+
+    std::mt19937 rng(7);
+    std::vector<std::pair<Address, Address>> surfaces;
+    Address address = 0x81000000;
+    for (int i = 0; i < 48; i++) {
+        // full screen targets, then half and quarter sized ones for the blur and bloom passes
+        const uint32_t divisor = 1 << (i % 3);
+        const uint32_t size = (960 / divisor) * (544 / divisor) * 4;
+        surfaces.emplace_back(address, address + size);
+        address += size + 0x1000 * (rng() % 4);
+    }
+
+    std::vector<Address> lookups(LOOKUPS_PER_FRAME);
+    for (Address &lookup : lookups) {
+        const auto &[begin, end] = surfaces[rng() % surfaces.size()];
+        // a few lookups are for textures which are not render targets
+        lookup = (rng() % 10 == 0) ? address + rng() % 0x100000 : begin + (rng() % 8 == 0 ? rng() % (end - begin) : 0);
+    }
+
+    AddressRangeIndex<int> index;
+    std::map<Address, std::pair<Address, int>> map;
+    for (size_t i = 0; i < surfaces.size(); i++) {
+        index.insert(surfaces[i].first, surfaces[i].second, static_cast<int>(i));
+        map[surfaces[i].first] = { surfaces[i].second, static_cast<int>(i) };
+    }
+
+    int64_t index_found = 0;
+    auto start_time = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        for (const Address lookup : lookups) {
+            if (const auto *entry = index.find_containing(lookup))
+                index_found += entry->value;
+        }
+    }
+    const auto index_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+
+    int64_t map_found = 0;
+    start_time = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        for (const Address lookup : lookups) {
+            // the surfaces don't overlap here, the closest range starting before is enough
+            auto it = map.upper_bound(lookup);
+            if (it != map.begin() && (--it)->second.first > lookup)
+                map_found += it->second.second;
+        }
+    }
+    const auto map_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time);
+
+    EXPECT_EQ(index_found, map_found);
+    const int64_t lookup_count = static_cast<int64_t>(FRAME_COUNT) * LOOKUPS_PER_FRAME;
+    std::cout << "AddressRangeIndex: " << index_duration.count() / lookup_count << " ns per lookup, std::map: "
+              << map_duration.count() / lookup_count << " ns per lookup" << std::endl;
+}
@@ -0,0 +1,156 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/vulkan/pipeline_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+using namespace renderer::vulkan;
+
+static PipelineDescription make_description(uint32_t seed, uint8_t padding = 0) {
+    PipelineDescription description{};
+    // only the fields are saved, whatever is left in the padding must not reach the file
+    // so every field is assigned on its own instead of copying a whole structure
+    memset(static_cast<void *>(&description.params), padding, sizeof(description.params));
+    description.params.blending = vk::PipelineColorBlendAttachmentState{};
+    description.params.front_stencil = vk::StencilOpState{};
+    description.params.back_stencil = vk::StencilOpState{};
+    description.params.color_blend_flags = {};
+    description.params.fragment_disabled = false;
+    description.params.use_srgb_specialization = seed & 16;
+    description.params.render_pass.force_load = false;
+    description.params.render_pass.is_color_transient = false;
+    description.params.render_pass.no_color = seed & 32;
+    description.params.vertex_hash.fill(static_cast<uint8_t>(seed));
+    description.params.fragment_hash.fill(static_cast<uint8_t>(seed * 7 + 1));
+    description.params.blending.blendEnable = seed & 1;
+    description.params.blending.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
+    description.params.blending.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+    description.params.front_stencil.compareMask = seed;
+    description.params.back_stencil.reference = seed * 3;
+    description.params.topology = (seed & 2) ? vk::PrimitiveTopology::eTriangleStrip : vk::PrimitiveTopology::eTriangleList;
+    description.params.polygon_mode = vk::PolygonMode::eFill;
+    description.params.cull_mode = vk::CullModeFlagBits::eBack;
+    description.params.depth_func = vk::CompareOp::eLessOrEqual;
+    description.params.vertex_texture_count = seed % 17;
+    description.params.fragment_texture_count = (seed * 5) % 17;
+    description.params.depth_write = seed & 4;
+    description.params.is_srgb = seed & 8;
+    description.params.render_pass.format = vk::Format::eR8G8B8A8Unorm;
+    description.params.render_pass.force_store = true;
+
+    for (uint32_t i = 0; i < seed % 5; i++)
+        description.bindings.push_back(vk::VertexInputBindingDescription{ i, 16 + i * 4, vk::VertexInputRate::eVertex });
+    for (uint32_t i = 0; i < seed % 9; i++)
+        description.attributes.push_back(vk::VertexInputAttributeDescription{ i, i % 4, vk::Format::eR32G32B32A32Sfloat, i * 4 });
+
+    return description;
+}
+
+static void expect_same_description(const PipelineDescription &a, const PipelineDescription &b) {
+    EXPECT_TRUE(a.params == b.params);
+    EXPECT_EQ(a.bindings, b.bindings);
+    EXPECT_EQ(a.attributes, b.attributes);
+}
+
+static fs::path get_test_path(const char *name) {
+    return fs::path(testing::TempDir()) / name;
+}
+
+TEST(pipeline_descriptions, round_trip) {
+    std::vector<std::pair<uint64_t, PipelineDescription>> descriptions;
+    for (uint32_t i = 0; i < 40; i++)
+        descriptions.emplace_back(0x1234567800000000ULL + i * 0x9E3779B9ULL, make_description(i));
+
+    const fs::path path = get_test_path("pipeline-descriptions-round-trip.dat");
+    save_pipeline_descriptions(path, descriptions);
+
+    unordered_map_fast<uint64_t, PipelineDescription> read;
+    read_pipeline_descriptions(path, read);
+    ASSERT_EQ(read.size(), descriptions.size());
+    for (const auto &[key, description] : descriptions) {
+        ASSERT_TRUE(read.find(key) != read.end()) << "key " << key;
+        expect_same_description(read[key], description);
+    }
+
+    fs::remove(path);
+}
+
+TEST(pipeline_descriptions, missing_file) {
+    unordered_map_fast<uint64_t, PipelineDescription> read;
+    read_pipeline_descriptions(get_test_path("pipeline-descriptions-missing.dat"), read);
+    EXPECT_TRUE(read.empty());
+}
+
+TEST(pipeline_descriptions, truncated_file_keeps_complete_descriptions) {
+    std::vector<std::pair<uint64_t, PipelineDescription>> descriptions;
+    for (uint32_t i = 0; i < 10; i++)
+        descriptions.emplace_back(i, make_description(i + 1));
+
+    const fs::path path = get_test_path("pipeline-descriptions-truncated.dat");
+    save_pipeline_descriptions(path, descriptions);
+    // cut the last description in the middle
+    fs::resize_file(path, fs::file_size(path) - 10);
+
+    unordered_map_fast<uint64_t, PipelineDescription> read;
+    read_pipeline_descriptions(path, read);
+    ASSERT_EQ(read.size(), descriptions.size() - 1);
+    for (size_t i = 0; i + 1 < descriptions.size(); i++)
+        expect_same_description(read[descriptions[i].first], descriptions[i].second);
+
+    fs::remove(path);
+}
+
+TEST(pipeline_descriptions, wrong_magic_is_ignored) {
+    const std::vector<std::pair<uint64_t, PipelineDescription>> descriptions = { { 1, make_description(3) } };
+
+    const fs::path path = get_test_path("pipeline-descriptions-magic.dat");
+    save_pipeline_descriptions(path, descriptions);
+    {
+        fs::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.put(0);
+    }
+
+    unordered_map_fast<uint64_t, PipelineDescription> read;
+    read_pipeline_descriptions(path, read);
+    EXPECT_TRUE(read.empty());
+
+    fs::remove(path);
+}
+
+TEST(pipeline_descriptions, padding_does_not_change_file) {
+    const fs::path zeroed_path = get_test_path("pipeline-descriptions-zeroed.dat");
+    const fs::path dirty_path = get_test_path("pipeline-descriptions-dirty.dat");
+    save_pipeline_descriptions(zeroed_path, { { 5, make_description(13, 0x00) } });
+    save_pipeline_descriptions(dirty_path, { { 5, make_description(13, 0xCD) } });
+
+    auto read_all = [](const fs::path &path) {
+        fs::ifstream file(path, std::ios::in | std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    const std::vector<char> zeroed = read_all(zeroed_path);
+    EXPECT_FALSE(zeroed.empty());
+    EXPECT_EQ(zeroed, read_all(dirty_path));
+
+    fs::remove(zeroed_path);
+    fs::remove(dirty_path);
+}
@@ -0,0 +1,112 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/texture_disk_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace renderer;
+
+// offsets in the file of the total size of the levels and of the size of the first level
+static constexpr std::streamoff HEADER_DATA_SIZE_OFFSET = 20;
+static constexpr std::streamoff FIRST_LEVEL_DATA_SIZE_OFFSET = 24 + 6 * sizeof(uint32_t);
+
+class texture_disk_cache : public testing::Test {
+protected:
+    void SetUp() override {
+        folder = fs::path(testing::TempDir()) / "texture-disk-cache";
+        fs::remove_all(folder);
+        cache.init(folder, MiB(16));
+    }
+
+    void TearDown() override {
+        fs::remove_all(folder);
+    }
+
+    // a 64x64 RGBA texture with its 32x32 mip
+    static std::vector<TextureUploadLevel> make_levels() {
+        std::vector<TextureUploadLevel> levels;
+        for (uint32_t mip = 0; mip < 2; mip++) {
+            TextureUploadLevel &level = levels.emplace_back();
+            level.format = SCE_GXM_TEXTURE_BASE_FORMAT_U8U8U8U8;
+            level.width = 64 >> mip;
+            level.height = 64 >> mip;
+            level.mip_index = mip;
+            level.pixels_per_stride = level.width;
+            level.data.resize(level.width * level.height * 4);
+            for (size_t i = 0; i < level.data.size(); i++)
+                level.data[i] = static_cast<uint8_t>(i * 7 + mip);
+            level.pixels = level.data.data();
+        }
+        return levels;
+    }
+
+    fs::path get_path(uint64_t key) const {
+        return folder / fmt::format("{:016X}.tex", key);
+    }
+
+    void overwrite(uint64_t key, std::streamoff offset, uint32_t value) {
+        fs::fstream file(get_path(key), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    fs::path folder;
+    TextureDiskCache cache;
+};
+
+TEST_F(texture_disk_cache, round_trip) {
+    const std::vector<TextureUploadLevel> levels = make_levels();
+    cache.store(1, levels);
+
+    std::vector<TextureUploadLevel> loaded;
+    ASSERT_TRUE(cache.load(1, loaded));
+    ASSERT_EQ(loaded.size(), levels.size());
+    for (size_t i = 0; i < levels.size(); i++) {
+        EXPECT_EQ(loaded[i].width, levels[i].width);
+        EXPECT_EQ(loaded[i].height, levels[i].height);
+        EXPECT_EQ(loaded[i].mip_index, levels[i].mip_index);
+        EXPECT_EQ(loaded[i].data, levels[i].data);
+        EXPECT_EQ(loaded[i].pixels, loaded[i].data.data());
+    }
+}
+
+TEST_F(texture_disk_cache, huge_data_size_is_rejected) {
+    cache.store(2, make_levels());
+    overwrite(2, HEADER_DATA_SIZE_OFFSET, 0xFFFFFFF0);
+
+    std::vector<TextureUploadLevel> loaded;
+    EXPECT_FALSE(cache.load(2, loaded));
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_FALSE(fs::exists(get_path(2)));
+}
+
+TEST_F(texture_disk_cache, level_larger_than_its_dimensions_is_rejected) {
+    cache.store(3, make_levels());
+    // the total size still matches the levels
+    overwrite(3, FIRST_LEVEL_DATA_SIZE_OFFSET, 64 * 64 * 4 * 100);
+    overwrite(3, HEADER_DATA_SIZE_OFFSET, 64 * 64 * 4 * 100 + 32 * 32 * 4);
+
+    std::vector<TextureUploadLevel> loaded;
+    EXPECT_FALSE(cache.load(3, loaded));
+    EXPECT_FALSE(fs::exists(get_path(3)));
+}
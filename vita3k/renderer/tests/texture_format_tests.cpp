@@ -0,0 +1,315 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/functions.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace renderer::texture;
+
+// The reference_* functions are the scalar conversions as they were before being made table driven and split
+// between threads, the current ones must give exactly the same output.
+
+static void reference_unswizzle(uint8_t *dest, const uint8_t *src, uint32_t width, uint32_t height, uint32_t element_size) {
+    const uint32_t min = std::min(width, height);
+    const uint32_t k = std::bit_width(min) - 1;
+
+    for (uint32_t i = 0; i < width * height; i++) {
+        uint32_t x = decode_morton2_x(i) & (min - 1);
+        uint32_t y = decode_morton2_y(i) & (min - 1);
+        const uint32_t upper_bits = (i >> (2 * k)) << k;
+        if (width >= height)
+            x |= upper_bits;
+        else
+            y |= upper_bits;
+
+        memcpy(dest + (y * width + x) * element_size, src + i * element_size, element_size);
+    }
+}
+
+static void reference_detile(uint8_t *dest, const uint8_t *src, uint32_t width, uint32_t height, uint32_t bpp) {
+    const uint32_t width_in_tiles = (width + 31) >> 5;
+
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint32_t texel_offset_in_tile = (x & 0b11111) | ((y & 0b11111) << 5);
+            const uint32_t tile_address = (x >> 5) + width_in_tiles * (y >> 5);
+            const uint32_t offset = ((tile_address << 10) | texel_offset_in_tile) * bpp;
+
+            memcpy(dest + ((y * width) + x) * bpp, src + offset, bpp);
+        }
+    }
+}
+
+static void reference_decompress_block_bc1(const uint8_t *block_storage, uint32_t *image) {
+    const uint16_t n0 = static_cast<uint16_t>((block_storage[1] << 8) | block_storage[0]);
+    const uint16_t n1 = static_cast<uint16_t>((block_storage[3] << 8) | block_storage[2]);
+    block_storage += 4;
+
+    uint8_t r0 = (n0 & 0xF800) >> 8;
+    uint8_t g0 = (n0 & 0x07E0) >> 3;
+    uint8_t b0 = (n0 & 0x001F) << 3;
+    uint8_t r1 = (n1 & 0xF800) >> 8;
+    uint8_t g1 = (n1 & 0x07E0) >> 3;
+    uint8_t b1 = (n1 & 0x001F) << 3;
+
+    r0 |= r0 >> 5;
+    r1 |= r1 >> 5;
+    g0 |= g0 >> 6;
+    g1 |= g1 >> 6;
+    b0 |= b0 >> 5;
+    b1 |= b1 >> 5;
+
+    const uint32_t c0 = 0xFF000000 | (b0 << 16) | (g0 << 8) | r0;
+    const uint32_t c1 = 0xFF000000 | (b1 << 16) | (g1 << 8) | r1;
+
+    uint32_t c2, c3;
+    if (n0 > n1) {
+        const uint8_t r2 = static_cast<uint8_t>((2 * r0 + r1 + 1) / 3);
+        const uint8_t r3 = static_cast<uint8_t>((2 * r1 + r0 + 1) / 3);
+        const uint8_t g2 = static_cast<uint8_t>((2 * g0 + g1 + 1) / 3);
+        const uint8_t g3 = static_cast<uint8_t>((2 * g1 + g0 + 1) / 3);
+        const uint8_t b2 = static_cast<uint8_t>((2 * b0 + b1 + 1) / 3);
+        const uint8_t b3 = static_cast<uint8_t>((2 * b1 + b0 + 1) / 3);
+        c2 = 0xFF000000 | (b2 << 16) | (g2 << 8) | r2;
+        c3 = 0xFF000000 | (b3 << 16) | (g3 << 8) | r3;
+    } else {
+        const uint8_t r2 = static_cast<uint8_t>((r0 + r1) / 2);
+        const uint8_t g2 = static_cast<uint8_t>((g0 + g1) / 2);
+        const uint8_t b2 = static_cast<uint8_t>((b0 + b1) / 2);
+        c2 = 0xFF000000 | (b2 << 16) | (g2 << 8) | r2;
+        c3 = 0x00000000;
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        const int index = (block_storage[i / 4] >> (i % 4 * 2)) & 0x03;
+        switch (index) {
+        case 0:
+            image[i] = c0;
+            break;
+        case 1:
+            image[i] = c1;
+            break;
+        case 2:
+            image[i] = c2;
+            break;
+        case 3:
+            image[i] = c3;
+            break;
+        }
+    }
+}
+
+static void reference_decompress_bc1_image(uint32_t width, uint32_t height, const uint8_t *block_storage, uint32_t *image) {
+    const uint32_t block_count_x = (width + 3) / 4;
+    const uint32_t block_count_y = (height + 3) / 4;
+    const uint32_t line_size = block_count_x * 4;
+
+    uint32_t block_result[16] = {};
+    for (uint32_t j = 0; j < block_count_y; j++) {
+        for (uint32_t i = 0; i < block_count_x; i++) {
+            reference_decompress_block_bc1(block_storage, block_result);
+
+            const uint32_t offset = j * 4 * line_size + i * 4;
+            for (uint32_t delta = 0; delta < 16; delta++)
+                image[offset + (delta % 4) + ((delta / 4) * line_size)] = block_result[delta];
+
+            block_storage += 8;
+        }
+    }
+}
+
+static void reference_palette_8(uint32_t *dst, const uint8_t *src, uint32_t width, uint32_t height, const uint32_t *palette) {
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x)
+            dst[y * width + x] = palette[src[y * width + x]];
+    }
+}
+
+static std::vector<uint8_t> make_random_data(size_t size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data(size);
+    for (uint8_t &byte : data)
+        byte = static_cast<uint8_t>(rng());
+    return data;
+}
+
+struct ImageSize {
+    uint32_t width;
+    uint32_t height;
+};
+
+// the last ones are large enough to be split between the worker threads
+static const ImageSize power_of_two_sizes[] = {
+    { 1, 1 }, { 1, 16 }, { 32, 2 }, { 8, 8 }, { 64, 16 }, { 16, 128 }, { 256, 256 }, { 1024, 256 }, { 128, 1024 }
+};
+static const ImageSize odd_sizes[] = {
+    { 3, 5 }, { 31, 33 }, { 37, 19 }, { 100, 7 }, { 6, 90 }, { 333, 517 }, { 1000, 601 }
+};
+
+template <typename F>
+static void for_each_image_size(F func) {
+    for (const auto [width, height] : power_of_two_sizes)
+        func(width, height);
+    for (const auto [width, height] : odd_sizes)
+        func(width, height);
+}
+
+TEST(texture_format, unswizzle_matches_reference) {
+    for (const uint32_t bits_per_pixel : { 8, 16, 24, 32, 64, 96, 128 }) {
+        const uint32_t element_size = bits_per_pixel / 8;
+        for (const auto [width, height] : power_of_two_sizes) {
+            const size_t size = static_cast<size_t>(width) * height * element_size;
+            const std::vector<uint8_t> src = make_random_data(size, width * 31 + height + bits_per_pixel);
+            std::vector<uint8_t> expected(size, 0xCD);
+            std::vector<uint8_t> result(size, 0xCD);
+
+            reference_unswizzle(expected.data(), src.data(), width, height, element_size);
+            swizzled_texture_to_linear_texture(result.data(), src.data(), width, height, bits_per_pixel);
+            EXPECT_EQ(result, expected) << width << "x" << height << " " << bits_per_pixel << "bpp";
+        }
+    }
+}
+
+TEST(texture_format, detile_matches_reference) {
+    for (const uint32_t bits_per_pixel : { 8, 16, 32, 64, 128 }) {
+        const uint32_t bpp = bits_per_pixel / 8;
+        for_each_image_size([&](uint32_t width, uint32_t height) {
+            // the source is made of whole 32x32 tiles
+            const size_t src_size = static_cast<size_t>((width + 31) & ~31) * ((height + 31) & ~31) * bpp;
+            const size_t dest_size = static_cast<size_t>(width) * height * bpp;
+            const std::vector<uint8_t> src = make_random_data(src_size, width * 17 + height * 3 + bits_per_pixel);
+            std::vector<uint8_t> expected(dest_size, 0xCD);
+            std::vector<uint8_t> result(dest_size, 0xCD);
+
+            reference_detile(expected.data(), src.data(), width, height, bpp);
+            tiled_texture_to_linear_texture(result.data(), src.data(), width, height, bits_per_pixel);
+            EXPECT_EQ(result, expected) << width << "x" << height << " " << bits_per_pixel << "bpp";
+        });
+    }
+}
+
+TEST(texture_format, bc1_matches_reference) {
+    for_each_image_size([](uint32_t width, uint32_t height) {
+        const uint32_t block_count = ((width + 3) / 4) * ((height + 3) / 4);
+        std::vector<uint8_t> blocks = make_random_data(block_count * 8, width * 7 + height);
+        // every other block uses the transparent decode, where the first color is not above the second one
+        for (uint32_t i = 0; i < block_count; i++) {
+            uint8_t *block = &blocks[i * 8];
+            const bool is_opaque = (block[1] << 8 | block[0]) > (block[3] << 8 | block[2]);
+            if (is_opaque != (i % 2 == 0)) {
+                std::swap(block[0], block[2]);
+                std::swap(block[1], block[3]);
+            }
+        }
+
+        const size_t pixel_count = static_cast<size_t>(block_count) * 16;
+        std::vector<uint32_t> expected(pixel_count, 0xCDCDCDCD);
+        std::vector<uint32_t> result(pixel_count, 0xCDCDCDCD);
+        reference_decompress_bc1_image(width, height, blocks.data(), expected.data());
+        decompress_bc_image(width, height, blocks.data(), result.data(), 1);
+        EXPECT_EQ(result, expected) << width << "x" << height;
+    });
+}
+
+TEST(texture_format, z_order_blocks_match_reference) {
+    for (const uint32_t block_size : { 8, 16 }) {
+        for_each_image_size([&](uint32_t width, uint32_t height) {
+            const uint32_t block_count_x = (width + 3) / 4;
+            const uint32_t block_count_y = (height + 3) / 4;
+            // when the block counts are not powers of two, the blocks can be placed past the image
+            const size_t size = static_cast<size_t>(std::bit_ceil(block_count_x)) * std::bit_ceil(block_count_y) * block_size * 4;
+            const std::vector<uint8_t> src = make_random_data(size, width + height * 5 + block_size);
+            std::vector<uint8_t> expected(size, 0xCD);
+            std::vector<uint8_t> result(size, 0xCD);
+    
+            reference_unswizzle(expected.data(), src.data(), block_count_x, block_count_y, block_size);
+            resolve_z_order_compressed_image(width, height, src.data(), result.data(), block_size);
+            EXPECT_EQ(result, expected) << width << "x" << height << " block size " << block_size;
+        });
+    }
+}
+
+TEST(texture_format, palette_8_matches_reference) {
+    std::vector<uint32_t> palette(256);
+    std::mt19937 rng(3);
+    for (uint32_t &color : palette)
+        color = rng();
+
+    for_each_image_size([&](uint32_t width, uint32_t height) {
+        const size_t pixel_count = static_cast<size_t>(width) * height;
+        const std::vector<uint8_t> src = make_random_data(pixel_count, width * 13 + height);
+        std::vector<uint32_t> expected(pixel_count, 0xCDCDCDCD);
+        std::vector<uint32_t> result(pixel_count, 0xCDCDCDCD);
+
+        reference_palette_8(expected.data(), src.data(), width, height, palette.data());
+        palette_texture_to_rgba_8(result.data(), src.data(), width, height, palette.data());
+        EXPECT_EQ(result, expected) << width << "x" << height;
+    });
+}
+
+// Run with --gtest_also_run_disabled_tests, prints the throughput of each conversion in MB/s of output
+TEST(texture_format, DISABLED_conversion_benchmark) {
+    constexpr uint32_t SIZE = 1024;
+    constexpr int ITERATIONS = 20;
+
+    const std::vector<uint8_t> src = make_random_data(static_cast<size_t>(SIZE) * SIZE * 16, 11);
+    std::vector<uint8_t> dest(static_cast<size_t>(SIZE) * SIZE * 16);
+    std::vector<uint32_t> palette(256);
+    std::iota(palette.begin(), palette.end(), 0);
+
+    auto measure = [&](const char *name, size_t output_size, auto &&convert) {
+        convert();
+        const auto start_time = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; i++)
+            convert();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << name << ": " << static_cast<uint64_t>(output_size * ITERATIONS / seconds / 1e6) << " MB/s" << std::endl;
+    };
+
+    for (const uint8_t bits_per_pixel : { 8, 16, 32, 64, 128 }) {
+        const size_t size = static_cast<size_t>(SIZE) * SIZE * (bits_per_pixel / 8);
+        const std::string unswizzle_name = "unswizzle " + std::to_string(bits_per_pixel) + "bpp";
+        measure(unswizzle_name.c_str(), size, [&] { swizzled_texture_to_linear_texture(dest.data(), src.data(), SIZE, SIZE, bits_per_pixel); });
+        const std::string detile_name = "detile " + std::to_string(bits_per_pixel) + "bpp";
+        measure(detile_name.c_str(), size, [&] { tiled_texture_to_linear_texture(dest.data(), src.data(), SIZE, SIZE, bits_per_pixel); });
+    }
+
+    // the output size of each BCn format, in bytes per pixel
+    static const char *bc_names[] = { "BC1", "BC2", "BC3", "BC4U", "BC4S", "BC5U", "BC5S" };
+    static const uint32_t bc_output_sizes[] = { 4, 4, 4, 1, 1, 2, 2 };
+    for (uint8_t format_id = 1; format_id <= 7; format_id++) {
+        measure(bc_names[format_id - 1], static_cast<size_t>(SIZE) * SIZE * bc_output_sizes[format_id - 1], [&] {
+            decompress_bc_image(SIZE, SIZE, src.data(), reinterpret_cast<uint32_t *>(dest.data()), format_id);
+        });
+    }
+
+    measure("z-order BC3 blocks", static_cast<size_t>(SIZE) * SIZE, [&] { resolve_z_order_compressed_image(SIZE, SIZE, src.data(), dest.data(), 16); });
+    measure("palette 8-bit", static_cast<size_t>(SIZE) * SIZE * 4, [&] {
+        palette_texture_to_rgba_8(reinterpret_cast<uint32_t *>(dest.data()), src.data(), SIZE, SIZE, palette.data());
+    });
+}
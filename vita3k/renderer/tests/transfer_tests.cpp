@@ -0,0 +1,277 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/functions.h>
+
+#include <gxm/functions.h>
+#include <mem/functions.h>
+#include <mem/state.h>
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// size of each of the guest buffers used by the tests, large enough for a 1024x1024 image of 32 bits
+static constexpr uint32_t BUFFER_SIZE = MiB(4);
+
+// texel offset computed for each texel, as the transfer copy did before working row by row
+static int32_t get_texel_offset(uint32_t x, uint32_t y, const SceGxmTransferImage &img, SceGxmTransferType type, uint32_t texel_size) {
+    const int32_t stride_pixel = img.stride / static_cast<int32_t>(texel_size);
+    if (type == SCE_GXM_TRANSFER_LINEAR)
+        return y * stride_pixel + x;
+    if (type == SCE_GXM_TRANSFER_TILED)
+        return ((stride_pixel / 32) * (y / 32) + (x / 32)) * 1024 + (y % 32) * 32 + (x % 32);
+
+    return renderer::texture::encode_morton(x, y, img.width, img.height);
+}
+
+static void reference_transfer_copy(const uint8_t *src_ptr, uint8_t *dst_ptr, const SceGxmTransferImage &src, const SceGxmTransferImage &dst, SceGxmTransferType src_type, SceGxmTransferType dst_type, SceGxmTransferColorKeyMode key_mode, uint32_t key_value, uint32_t key_mask) {
+    const uint32_t texel_size = gxm::get_bits_per_pixel(src.format) / 8;
+    for (uint32_t dx = 0; dx < src.width; dx++) {
+        for (uint32_t dy = 0; dy < src.height; dy++) {
+            const uint8_t *src_texel = src_ptr + get_texel_offset(src.x + dx, src.y + dy, src, src_type, texel_size) * texel_size;
+            uint8_t *dst_texel = dst_ptr + get_texel_offset(dst.x + dx, dst.y + dy, dst, dst_type, texel_size) * texel_size;
+
+            if (texel_size == 4 && key_mode != SCE_GXM_TRANSFER_COLORKEY_NONE) {
+                uint32_t value;
+                memcpy(&value, src_texel, sizeof(value));
+                const bool key_match = (value & key_mask) == key_value;
+                if (key_match != (key_mode == SCE_GXM_TRANSFER_COLORKEY_PASS))
+                    continue;
+            }
+
+            memcpy(dst_texel, src_texel, texel_size);
+        }
+    }
+}
+
+struct TransferCase {
+    SceGxmTransferFormat format;
+    SceGxmTransferType src_type;
+    SceGxmTransferType dst_type;
+    // position in both images and size of the copied area
+    uint32_t src_x, src_y, dst_x, dst_y;
+    uint32_t width, height;
+    SceGxmTransferColorKeyMode key_mode = SCE_GXM_TRANSFER_COLORKEY_NONE;
+};
+
+class transfer_copy : public testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(init(mem, false));
+        src_address = alloc(mem, BUFFER_SIZE, "transfer src");
+        dst_address = alloc(mem, BUFFER_SIZE, "transfer dst");
+        ASSERT_NE(src_address, 0);
+        ASSERT_NE(dst_address, 0);
+    }
+
+    // image large enough to hold the copied area at the given position, swizzled images have power of two sizes
+    static SceGxmTransferImage make_image(const TransferCase &test, Address address, SceGxmTransferType type, uint32_t x, uint32_t y) {
+        const uint32_t texel_size = gxm::get_bits_per_pixel(test.format) / 8;
+        SceGxmTransferImage img{};
+        img.format = test.format;
+        img.address = Ptr<void>(address);
+        img.x = x;
+        img.y = y;
+        img.width = test.width;
+        img.height = test.height;
+        if (type == SCE_GXM_TRANSFER_SWIZZLED) {
+            // the size of a swizzled image is a power of two, a swizzled source must be copied whole
+            img.width = std::bit_ceil(x + test.width);
+            img.height = std::bit_ceil(y + test.height);
+        }
+        img.stride = static_cast<int32_t>(((x + test.width + 31) / 32 * 32 + 32) * texel_size);
+        return img;
+    }
+
+    void check(const TransferCase &test) {
+        uint8_t *src_ptr = Ptr<uint8_t>(src_address).get(mem);
+        uint8_t *dst_ptr = Ptr<uint8_t>(dst_address).get(mem);
+
+        std::mt19937 rng(test.width * 31 + test.height);
+        std::vector<uint8_t> src_data(BUFFER_SIZE);
+        std::vector<uint8_t> expected(BUFFER_SIZE);
+        for (size_t i = 0; i < BUFFER_SIZE; i += 4) {
+            // bytes from 0 to 3 so some texels match the color key
+            const uint32_t src_word = rng() & 0x03030303;
+            const uint32_t dst_word = rng();
+            memcpy(&src_data[i], &src_word, 4);
+            memcpy(&expected[i], &dst_word, 4);
+        }
+
+        memcpy(src_ptr, src_data.data(), BUFFER_SIZE);
+        memcpy(dst_ptr, expected.data(), BUFFER_SIZE);
+
+        const SceGxmTransferImage src = make_image(test, src_address, test.src_type, test.src_x, test.src_y);
+        const SceGxmTransferImage dst = make_image(test, dst_address, test.dst_type, test.dst_x, test.dst_y);
+        // the copied area is the size of the source image
+        ASSERT_EQ(src.width, test.width);
+        ASSERT_EQ(src.height, test.height);
+
+        const uint32_t key_value = 0x01020300;
+        const uint32_t key_mask = 0x03030300;
+        renderer::perform_transfer_copy(mem, src, dst, test.src_type, test.dst_type, test.key_mode, key_value, key_mask);
+        reference_transfer_copy(src_data.data(), expected.data(), src, dst, test.src_type, test.dst_type, test.key_mode, key_value, key_mask);
+
+        ASSERT_EQ(memcmp(src_ptr, src_data.data(), BUFFER_SIZE), 0) << "the source was modified";
+        if (memcmp(dst_ptr, expected.data(), BUFFER_SIZE) != 0) {
+            for (uint32_t i = 0; i < BUFFER_SIZE; i++)
+                ASSERT_EQ(dst_ptr[i], expected[i]) << "byte " << i;
+        }
+    }
+
+    // both images are in the source buffer, the destination dst_offset bytes after the source
+    void check_overlapping(const TransferCase &test, uint32_t dst_offset) {
+        uint8_t *ptr = Ptr<uint8_t>(src_address).get(mem);
+
+        std::mt19937 rng(test.width * 7 + test.height + dst_offset);
+        std::vector<uint8_t> expected(BUFFER_SIZE);
+        for (uint8_t &byte : expected)
+            byte = static_cast<uint8_t>(rng());
+        memcpy(ptr, expected.data(), BUFFER_SIZE);
+
+        const SceGxmTransferImage src = make_image(test, src_address, test.src_type, test.src_x, test.src_y);
+        const SceGxmTransferImage dst = make_image(test, src_address + dst_offset, test.dst_type, test.dst_x, test.dst_y);
+        renderer::perform_transfer_copy(mem, src, dst, test.src_type, test.dst_type, test.key_mode, 0, 0);
+        // the texels written first are read again by the later ones, as with the original copy
+        reference_transfer_copy(expected.data(), expected.data() + dst_offset, src, dst, test.src_type, test.dst_type, test.key_mode, 0, 0);
+
+        if (memcmp(ptr, expected.data(), BUFFER_SIZE) != 0) {
+            for (uint32_t i = 0; i < BUFFER_SIZE; i++)
+                ASSERT_EQ(ptr[i], expected[i]) << "byte " << i;
+        }
+    }
+
+    MemState mem;
+    Address src_address = 0;
+    Address dst_address = 0;
+};
+
+static constexpr SceGxmTransferType TRANSFER_TYPES[] = { SCE_GXM_TRANSFER_LINEAR, SCE_GXM_TRANSFER_TILED, SCE_GXM_TRANSFER_SWIZZLED };
+static constexpr SceGxmTransferFormat TRANSFER_FORMATS[] = {
+    SCE_GXM_TRANSFER_FORMAT_U8_R,
+    SCE_GXM_TRANSFER_FORMAT_U5U6U5_BGR,
+    SCE_GXM_TRANSFER_FORMAT_U8U8U8_BGR,
+    SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR,
+    SCE_GXM_TRANSFER_FORMAT_RAW64,
+    SCE_GXM_TRANSFER_FORMAT_RAW128,
+};
+
+TEST_F(transfer_copy, matches_per_texel_copy) {
+    for (const SceGxmTransferFormat format : TRANSFER_FORMATS) {
+        for (const SceGxmTransferType src_type : TRANSFER_TYPES) {
+            for (const SceGxmTransferType dst_type : TRANSFER_TYPES) {
+                if (src_type == SCE_GXM_TRANSFER_SWIZZLED) {
+                    check({ format, src_type, dst_type, 0, 0, 37, 9, 64, 32 });
+                    check({ format, src_type, dst_type, 0, 0, 32, 32, 32, 64 });
+                } else {
+                    // unaligned positions, then positions aligned on the tiles
+                    check({ format, src_type, dst_type, 5, 3, 37, 9, 70, 45 });
+                    check({ format, src_type, dst_type, 32, 64, 0, 32, 96, 40 });
+                }
+                if (HasFatalFailure()) {
+                    ADD_FAILURE() << "format 0x" << std::hex << format << ", src type " << src_type << ", dst type " << dst_type;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(transfer_copy, matches_per_texel_copy_with_color_key) {
+    for (const SceGxmTransferColorKeyMode key_mode : { SCE_GXM_TRANSFER_COLORKEY_PASS, SCE_GXM_TRANSFER_COLORKEY_REJECT }) {
+        for (const SceGxmTransferType src_type : TRANSFER_TYPES) {
+            for (const SceGxmTransferType dst_type : TRANSFER_TYPES) {
+                if (src_type == SCE_GXM_TRANSFER_SWIZZLED)
+                    check({ SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, src_type, dst_type, 0, 0, 2, 33, 64, 64, key_mode });
+                else
+                    check({ SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, src_type, dst_type, 7, 1, 2, 33, 61, 50, key_mode });
+                if (HasFatalFailure()) {
+                    ADD_FAILURE() << "key mode " << key_mode << ", src type " << src_type << ", dst type " << dst_type;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+// large enough to be split between the worker threads
+TEST_F(transfer_copy, large_copies_match_per_texel_copy) {
+    for (const SceGxmTransferType src_type : { SCE_GXM_TRANSFER_LINEAR, SCE_GXM_TRANSFER_TILED }) {
+        for (const SceGxmTransferType dst_type : { SCE_GXM_TRANSFER_LINEAR, SCE_GXM_TRANSFER_TILED }) {
+            check({ SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, src_type, dst_type, 0, 0, 0, 0, 960, 544 });
+            check({ SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, src_type, dst_type, 3, 1, 30, 2, 900, 500, SCE_GXM_TRANSFER_COLORKEY_REJECT });
+        }
+    }
+    check({ SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, SCE_GXM_TRANSFER_SWIZZLED, SCE_GXM_TRANSFER_LINEAR, 0, 0, 0, 0, 1024, 512 });
+    check({ SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, SCE_GXM_TRANSFER_LINEAR, SCE_GXM_TRANSFER_SWIZZLED, 0, 0, 0, 0, 512, 1024 });
+}
+
+TEST_F(transfer_copy, overlapping_images_match_per_texel_copy) {
+    for (const SceGxmTransferType src_type : TRANSFER_TYPES) {
+        for (const SceGxmTransferType dst_type : TRANSFER_TYPES) {
+            const SceGxmTransferFormat format = SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR;
+            if (src_type == SCE_GXM_TRANSFER_SWIZZLED) {
+                check_overlapping({ format, src_type, dst_type, 0, 0, 1, 1, 32, 16 }, 0);
+                check_overlapping({ format, src_type, dst_type, 0, 0, 0, 0, 32, 16 }, 5 * 4);
+            } else {
+                // one texel to the right and one row down, then back to the top left
+                check_overlapping({ format, src_type, dst_type, 2, 3, 3, 3, 40, 20 }, 0);
+                check_overlapping({ format, src_type, dst_type, 2, 3, 2, 4, 40, 20 }, 0);
+                check_overlapping({ format, src_type, dst_type, 5, 4, 1, 2, 40, 20 }, 0);
+                // aligned on the tiles
+                check_overlapping({ format, src_type, dst_type, 32, 32, 64, 32, 64, 64 }, 0);
+            }
+            if (HasFatalFailure()) {
+                ADD_FAILURE() << "src type " << src_type << ", dst type " << dst_type;
+                return;
+            }
+        }
+    }
+}
+
+// Run with --gtest_also_run_disabled_tests, prints the MB/s copied for each pair of image types
+TEST_F(transfer_copy, DISABLED_throughput_benchmark) {
+    constexpr int ITERATIONS = 50;
+    auto get_type_name = [](SceGxmTransferType type) {
+        return (type == SCE_GXM_TRANSFER_LINEAR) ? "linear" : (type == SCE_GXM_TRANSFER_TILED) ? "tiled" : "swizzled";
+    };
+
+    for (const SceGxmTransferType src_type : TRANSFER_TYPES) {
+        for (const SceGxmTransferType dst_type : TRANSFER_TYPES) {
+            // a power of two size so the swizzled images can be copied whole
+            const TransferCase test = { SCE_GXM_TRANSFER_FORMAT_U8U8U8U8_ABGR, src_type, dst_type, 0, 0, 0, 0, 1024, 512 };
+            const SceGxmTransferImage src = make_image(test, src_address, src_type, 0, 0);
+            const SceGxmTransferImage dst = make_image(test, dst_address, dst_type, 0, 0);
+
+            renderer::perform_transfer_copy(mem, src, dst, src_type, dst_type, SCE_GXM_TRANSFER_COLORKEY_NONE, 0, 0);
+            const auto start_time = std::chrono::steady_clock::now();
+            for (int i = 0; i < ITERATIONS; i++)
+                renderer::perform_transfer_copy(mem, src, dst, src_type, dst_type, SCE_GXM_TRANSFER_COLORKEY_NONE, 0, 0);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+            const double bytes = static_cast<double>(test.width) * test.height * 4 * ITERATIONS;
+            std::cout << get_type_name(src_type) << " to " << get_type_name(dst_type) << ": "
+                      << static_cast<uint64_t>(bytes / seconds / 1e6) << " MB/s" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <sas/state.h>
+
+/**
+ * Software mixer of the SAS library: up to MAX_VOICES voices playing VAG (PS-ADPCM), 16-bit PCM or noise
+ * at their own pitch, shaped by an ADSR envelope and sent to a dry and a wet (effect) bus.
+ * The callers check the parameters and hold the mutex of the state.
+ */
+namespace sas {
+
+struct Config {
+    uint32_t voice_count = 32;
+    uint32_t grain = DEFAULT_GRAIN;
+    uint32_t reverb_count = 1;
+};
+
+// parses the "name=value" settings separated by spaces (numVoices, numGrains and numReverbs),
+// the unknown ones are ignored, returns false if a value is not a number
+bool parse_config(const char *text, Config &config);
+uint32_t get_needed_memory_size(const Config &config);
+
+void init(State &state, const Config &config, Ptr<void> buffer, uint32_t buffer_size);
+void exit(State &state);
+void set_grain(State &state, uint32_t grain);
+
+void set_vag(Voice &voice, const uint8_t *data, uint32_t size, bool loop);
+void set_pcm(Voice &voice, const int16_t *data, uint32_t sample_count, int32_t loop_position);
+void set_noise(Voice &voice, uint32_t clock);
+void key_on(Voice &voice);
+void key_off(Voice &voice);
+
+// envelope given in the format of the SPU registers
+void set_simple_adsr(Envelope &envelope, uint32_t adsr1, uint32_t adsr2);
+
+void set_effect_type(Effect &effect, EffectType type);
+void set_effect_param(Effect &effect, uint32_t delay, uint32_t feedback);
+
+// renders one grain of all the voices to out, 2 or 4 channels depending on the output mode
+void render(State &state, int16_t *out);
+// same as render, with the samples already in buffer scaled by the volumes (left, right) added to the result
+void render_with_mix(State &state, int16_t *buffer, const float volume[2]);
+
+} // namespace sas
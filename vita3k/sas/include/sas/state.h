@@ -0,0 +1,211 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <mem/ptr.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace sas {
+
+constexpr uint32_t MAX_VOICES = 128;
+constexpr uint32_t MIN_GRAIN = 64;
+constexpr uint32_t MAX_GRAIN = 2048;
+constexpr uint32_t DEFAULT_GRAIN = 256;
+
+// 0x1000 plays the samples at the output rate
+constexpr int32_t PITCH_BASE = 0x1000;
+constexpr int32_t PITCH_MIN = 1;
+constexpr int32_t PITCH_MAX = 0x4000;
+// volumes go from -MAX_VOLUME (inverted phase) to MAX_VOLUME
+constexpr int32_t MAX_VOLUME = 0x1000;
+
+constexpr int32_t ENVELOPE_HEIGHT_MAX = 0x40000000;
+constexpr uint32_t NOISE_CLOCK_MAX = 0x3F;
+
+// number of samples in a VAG (PS-ADPCM) block of 16 bytes
+constexpr uint32_t VAG_BLOCK_SAMPLES = 28;
+constexpr uint32_t VAG_BLOCK_SIZE = 16;
+
+enum class OutputMode {
+    // interleaved L, R
+    Stereo = 0,
+    // interleaved dry L, dry R, wet L, wet R
+    Multichannel = 1,
+};
+
+enum class SourceType {
+    None,
+    VAG,
+    PCM,
+    Noise,
+};
+
+enum class EnvelopeCurve {
+    LinearIncrease = 0,
+    LinearDecrease = 1,
+    // increases 4 times slower once above 3/4 of the maximum
+    LinearBent = 2,
+    ExponentDecrease = 3,
+    ExponentIncrease = 4,
+    // the height is set to the rate
+    Direct = 5,
+};
+
+constexpr uint32_t ENVELOPE_CURVE_COUNT = 6;
+
+enum class EnvelopePhase {
+    Attack,
+    Decay,
+    Sustain,
+    Release,
+    Off,
+};
+
+enum class EffectType {
+    Off = -1,
+    Room = 0,
+    StudioSmall = 1,
+    StudioMedium = 2,
+    StudioLarge = 3,
+    Hall = 4,
+    Space = 5,
+    Echo = 6,
+    Delay = 7,
+    Pipe = 8,
+};
+
+constexpr int32_t EFFECT_TYPE_MAX = 8;
+constexpr uint32_t EFFECT_PARAM_MAX = 0x7F;
+
+struct Envelope {
+    // rates are added to (or scaled with, for the exponent curves) the height at each sample
+    int32_t attack_rate = 0x7FFFFFFF;
+    int32_t decay_rate = 0;
+    int32_t sustain_rate = 0;
+    int32_t release_rate = 0x7FFFFFFF;
+    EnvelopeCurve attack_curve = EnvelopeCurve::LinearIncrease;
+    EnvelopeCurve decay_curve = EnvelopeCurve::LinearDecrease;
+    EnvelopeCurve sustain_curve = EnvelopeCurve::LinearDecrease;
+    EnvelopeCurve release_curve = EnvelopeCurve::LinearDecrease;
+    int32_t sustain_level = ENVELOPE_HEIGHT_MAX;
+
+    EnvelopePhase phase = EnvelopePhase::Off;
+    int32_t height = 0;
+};
+
+struct VagSource {
+    const uint8_t *data = nullptr;
+    uint32_t size = 0;
+    // use the loop markers of the blocks
+    bool loop = false;
+
+    uint32_t next_block = 0;
+    // block to go back to at a loop end marker, -1 until a loop start marker is met
+    int32_t loop_block = -1;
+    int32_t history[2] = {};
+    std::array<float, VAG_BLOCK_SAMPLES> samples{};
+    // next sample of the decoded block to read
+    uint32_t sample_index = VAG_BLOCK_SAMPLES;
+};
+
+struct PcmSource {
+    const int16_t *data = nullptr;
+    uint32_t sample_count = 0;
+    // sample played after the last one, negative to play the samples once
+    int32_t loop_position = -1;
+
+    uint32_t position = 0;
+};
+
+struct NoiseSource {
+    uint32_t clock = 0;
+
+    uint32_t timer = 0;
+    uint32_t lfsr = 1;
+};
+
+struct Voice {
+    SourceType type = SourceType::None;
+    VagSource vag;
+    PcmSource pcm;
+    NoiseSource noise;
+    Envelope envelope;
+
+    int32_t pitch = PITCH_BASE;
+    // left, right
+    float dry_volume[2] = { 1.0f, 1.0f };
+    float wet_volume[2] = {};
+
+    bool paused = false;
+    // the source or the release of the envelope reached its end
+    bool ended = true;
+    // the source has no more samples, the ones read afterwards are silent
+    bool source_ended = true;
+
+    // fraction of the distance between history[0] and history[1] at which the next sample is
+    uint32_t position = 0;
+    float history[2] = {};
+    bool primed = false;
+};
+
+struct Effect {
+    EffectType type = EffectType::Off;
+    uint32_t delay = 0;
+    uint32_t feedback = 0;
+    // left, right
+    float volume[2] = {};
+    bool dry_enabled = true;
+    bool wet_enabled = false;
+
+    // interleaved stereo delay line
+    std::vector<float> line;
+    uint32_t line_position = 0;
+};
+
+struct State {
+    std::mutex mutex;
+    bool initialized = false;
+
+    // the memory given at init, only kept to be returned at exit
+    Ptr<void> buffer;
+    uint32_t buffer_size = 0;
+
+    uint32_t grain = DEFAULT_GRAIN;
+    OutputMode output_mode = OutputMode::Stereo;
+    std::vector<Voice> voices;
+    Effect effect;
+
+    // peaks of the last update, left and right, on the int16 scale
+    int32_t dry_peak[2] = {};
+    int32_t wet_peak[2] = {};
+    int32_t pre_master_peak[2] = {};
+
+    // interleaved stereo buffers of one grain, reused at each update
+    std::vector<float> dry;
+    std::vector<float> wet;
+    std::vector<float> output;
+    // samples of the voice being rendered, with a few more at the end for the interpolation
+    std::vector<float> voice_input;
+    std::vector<float> voice_output;
+};
+
+} // namespace sas
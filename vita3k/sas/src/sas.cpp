@@ -0,0 +1,591 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <sas/functions.h>
+
+#include <dsp/dsp.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace sas {
+
+// frames of the effect delay line, the output rate is 48 kHz
+static constexpr uint32_t MAX_DELAY_FRAMES = (EFFECT_PARAM_MAX + 1) * 128;
+
+bool parse_config(const char *text, Config &config) {
+    if (!text)
+        return true;
+
+    std::string_view remaining(text);
+    while (!remaining.empty()) {
+        const size_t start = remaining.find_first_not_of(" \t\n");
+        if (start == std::string_view::npos)
+            break;
+        remaining.remove_prefix(start);
+
+        const size_t end = std::min(remaining.find_first_of(" \t\n"), remaining.size());
+        std::string_view setting = remaining.substr(0, end);
+        remaining.remove_prefix(end);
+
+        if (setting.starts_with('-'))
+            setting.remove_prefix(1);
+        const size_t separator = setting.find('=');
+        if (separator == std::string_view::npos) {
+            LOG_WARN("Ignoring the SAS setting {}", setting);
+            continue;
+        }
+
+        const std::string_view name = setting.substr(0, separator);
+        const std::string_view value_text = setting.substr(separator + 1);
+        uint32_t value = 0;
+        const auto [ptr, ec] = std::from_chars(value_text.data(), value_text.data() + value_text.size(), value);
+        if (ec != std::errc() || ptr != value_text.data() + value_text.size())
+            return false;
+
+        if (name == "numVoices")
+            config.voice_count = value;
+        else if (name == "numGrains")
+            config.grain = value;
+        else if (name == "numReverbs")
+            config.reverb_count = value;
+        else
+            LOG_WARN("Ignoring the SAS setting {}", setting);
+    }
+
+    return true;
+}
+
+uint32_t get_needed_memory_size(const Config &config) {
+    // the state is kept on the host, the memory is only asked for so the games can give it
+    // and is sized like the buffers of the library would be
+    const uint32_t voices_size = config.voice_count * 0x100;
+    const uint32_t grain_size = config.grain * 2 * 2 * sizeof(int32_t);
+    const uint32_t effect_size = config.reverb_count * MAX_DELAY_FRAMES * 2 * sizeof(int16_t);
+    return 0x400 + voices_size + grain_size + effect_size;
+}
+
+void init(State &state, const Config &config, Ptr<void> buffer, uint32_t buffer_size) {
+    state.initialized = true;
+    state.buffer = buffer;
+    state.buffer_size = buffer_size;
+    state.output_mode = OutputMode::Stereo;
+    state.voices.assign(config.voice_count, Voice{});
+    state.effect = Effect{};
+    state.effect.line.resize(MAX_DELAY_FRAMES * 2);
+    std::fill_n(state.dry_peak, 2, 0);
+    std::fill_n(state.wet_peak, 2, 0);
+    std::fill_n(state.pre_master_peak, 2, 0);
+    set_grain(state, config.grain);
+}
+
+void exit(State &state) {
+    state.initialized = false;
+    state.buffer = Ptr<void>();
+    state.buffer_size = 0;
+    state.voices.clear();
+    state.effect = Effect{};
+}
+
+void set_grain(State &state, uint32_t grain) {
+    state.grain = grain;
+    state.dry.resize(grain * 2);
+    state.wet.resize(grain * 2);
+    state.output.resize(grain * 4);
+    // the highest pitch reads 4 samples per output sample, plus the 2 kept for the interpolation
+    state.voice_input.resize(grain * (PITCH_MAX / PITCH_BASE) + 2);
+    state.voice_output.resize(grain);
+}
+
+void set_vag(Voice &voice, const uint8_t *data, uint32_t size, bool loop) {
+    voice.type = SourceType::VAG;
+    voice.vag.data = data;
+    voice.vag.size = size;
+    voice.vag.loop = loop;
+}
+
+void set_pcm(Voice &voice, const int16_t *data, uint32_t sample_count, int32_t loop_position) {
+    voice.type = SourceType::PCM;
+    voice.pcm.data = data;
+    voice.pcm.sample_count = sample_count;
+    voice.pcm.loop_position = loop_position;
+}
+
+void set_noise(Voice &voice, uint32_t clock) {
+    voice.type = SourceType::Noise;
+    voice.noise.clock = clock;
+}
+
+void key_on(Voice &voice) {
+    voice.vag.next_block = 0;
+    voice.vag.loop_block = -1;
+    voice.vag.history[0] = 0;
+    voice.vag.history[1] = 0;
+    voice.vag.sample_index = VAG_BLOCK_SAMPLES;
+    voice.pcm.position = 0;
+    voice.noise.timer = 0;
+    voice.noise.lfsr = 1;
+
+    voice.envelope.phase = EnvelopePhase::Attack;
+    voice.envelope.height = 0;
+    voice.ended = voice.type == SourceType::None;
+    voice.source_ended = voice.ended;
+    voice.position = 0;
+    voice.primed = false;
+}
+
+void key_off(Voice &voice) {
+    if (voice.envelope.phase != EnvelopePhase::Off)
+        voice.envelope.phase = EnvelopePhase::Release;
+}
+
+// rates of the SPU registers, 0x7F stops the envelope
+static int32_t get_simple_rate(uint32_t value, uint32_t scale_bits) {
+    value &= 0x7F;
+    if (value == 0x7F)
+        return 0;
+
+    const int32_t rate = ((7 - (value & 3)) << scale_bits) >> (value >> 2);
+    return std::max(rate, 1);
+}
+
+void set_simple_adsr(Envelope &envelope, uint32_t adsr1, uint32_t adsr2) {
+    envelope.attack_curve = (adsr1 & 0x8000) ? EnvelopeCurve::LinearBent : EnvelopeCurve::LinearIncrease;
+    envelope.attack_rate = get_simple_rate(adsr1 >> 8, 26);
+
+    envelope.decay_curve = EnvelopeCurve::ExponentDecrease;
+    const uint32_t decay = (adsr1 >> 4) & 0xF;
+    envelope.decay_rate = decay == 0 ? 0x7FFFFFFF : static_cast<int32_t>(0x80000000U >> decay);
+    envelope.sustain_level = static_cast<int32_t>(((adsr1 & 0xF) + 1) << 26);
+
+    switch ((adsr2 >> 13) & 7) {
+    case 2:
+        envelope.sustain_curve = EnvelopeCurve::LinearDecrease;
+        break;
+    case 4:
+        envelope.sustain_curve = EnvelopeCurve::LinearBent;
+        break;
+    case 6:
+        envelope.sustain_curve = EnvelopeCurve::ExponentDecrease;
+        break;
+    default:
+        envelope.sustain_curve = EnvelopeCurve::LinearIncrease;
+        break;
+    }
+    envelope.sustain_rate = get_simple_rate(adsr2 >> 6, envelope.sustain_curve == EnvelopeCurve::ExponentDecrease ? 24 : 26);
+
+    const uint32_t release = adsr2 & 0x1F;
+    if (adsr2 & 0x20) {
+        envelope.release_curve = EnvelopeCurve::ExponentDecrease;
+        envelope.release_rate = release == 0 ? 0x7FFFFFFF : static_cast<int32_t>(0x80000000U >> release);
+    } else {
+        envelope.release_curve = EnvelopeCurve::LinearDecrease;
+        if (release == 30)
+            envelope.release_rate = ENVELOPE_HEIGHT_MAX;
+        else if (release == 29)
+            envelope.release_rate = 1;
+        else
+            envelope.release_rate = 0x10000000 >> release;
+    }
+    if (release == 31)
+        envelope.release_rate = 0;
+}
+
+// a coarse stand-in for the reverb presets, the same feedback delay as the echo with fixed parameters
+struct EffectPreset {
+    uint32_t delay;
+    uint32_t feedback;
+};
+
+static constexpr EffectPreset effect_presets[] = {
+    { 8, 48 }, // room
+    { 4, 40 }, // small studio
+    { 10, 52 }, // medium studio
+    { 16, 60 }, // large studio
+    { 28, 72 }, // hall
+    { 64, 88 }, // space
+};
+
+void set_effect_type(Effect &effect, EffectType type) {
+    effect.type = type;
+    std::fill(effect.line.begin(), effect.line.end(), 0.0f);
+    effect.line_position = 0;
+
+    const int32_t preset = static_cast<int32_t>(type);
+    if (preset >= 0 && preset < static_cast<int32_t>(std::size(effect_presets))) {
+        effect.delay = effect_presets[preset].delay;
+        effect.feedback = effect_presets[preset].feedback;
+    } else if (type == EffectType::Pipe) {
+        effect.delay = 1;
+        effect.feedback = 96;
+    }
+}
+
+void set_effect_param(Effect &effect, uint32_t delay, uint32_t feedback) {
+    // only the echo and the delay take their parameters from the game
+    if (effect.type != EffectType::Echo && effect.type != EffectType::Delay)
+        return;
+
+    effect.delay = delay;
+    effect.feedback = feedback;
+}
+
+static void decode_vag_block(VagSource &vag, const uint8_t *block) {
+    static constexpr int32_t coefficients[5][2] = { { 0, 0 }, { 60, 0 }, { 115, -52 }, { 98, -55 }, { 122, -60 } };
+
+    const uint32_t shift = std::min<uint32_t>(block[0] & 0xF, 12);
+    const uint32_t filter = std::min<uint32_t>(block[0] >> 4, 4);
+
+    // the nibbles don't depend on the previous samples, only the prediction does
+    int32_t samples[VAG_BLOCK_SAMPLES];
+    for (uint32_t i = 0; i < VAG_BLOCK_SAMPLES; i += 2) {
+        const uint8_t byte = block[2 + i / 2];
+        samples[i] = static_cast<int16_t>(byte << 12) >> shift;
+        samples[i + 1] = static_cast<int16_t>((byte & 0xF0) << 8) >> shift;
+    }
+
+    if (filter != 0) {
+        const int32_t coefficient0 = coefficients[filter][0];
+        const int32_t coefficient1 = coefficients[filter][1];
+        int32_t history0 = vag.history[0];
+        int32_t history1 = vag.history[1];
+        for (int32_t &sample : samples) {
+            sample += (history0 * coefficient0 + history1 * coefficient1) >> 6;
+            // a branch rarely taken instead of a clamp, which would lengthen the dependency chain between samples
+            if (static_cast<uint32_t>(sample + 32768) > 0xFFFF) [[unlikely]]
+                sample = std::clamp(sample, -32768, 32767);
+            history1 = history0;
+            history0 = sample;
+        }
+    }
+
+    vag.history[0] = samples[VAG_BLOCK_SAMPLES - 1];
+    vag.history[1] = samples[VAG_BLOCK_SAMPLES - 2];
+    for (uint32_t i = 0; i < VAG_BLOCK_SAMPLES; i++)
+        vag.samples[i] = static_cast<float>(samples[i]) * (1.0f / 32768.0f);
+}
+
+// decodes the next block, returns false at the end of the data
+static bool next_vag_block(VagSource &vag) {
+    static constexpr uint8_t FLAG_LOOP_END = 1;
+    static constexpr uint8_t FLAG_LOOP_START = 4;
+    // the flags of a block only marking the end
+    static constexpr uint8_t FLAGS_END = 7;
+
+    if (vag.next_block == UINT32_MAX || (vag.next_block + 1) * VAG_BLOCK_SIZE > vag.size)
+        return false;
+
+    const uint8_t *block = vag.data + vag.next_block * VAG_BLOCK_SIZE;
+    const uint8_t flags = block[1];
+    if (flags == FLAGS_END)
+        return false;
+
+    if (flags & FLAG_LOOP_START)
+        vag.loop_block = static_cast<int32_t>(vag.next_block);
+
+    decode_vag_block(vag, block);
+    vag.sample_index = 0;
+
+    if (flags & FLAG_LOOP_END) {
+        if (vag.loop && vag.loop_block >= 0)
+            vag.next_block = static_cast<uint32_t>(vag.loop_block);
+        else
+            vag.next_block = UINT32_MAX;
+    } else {
+        vag.next_block++;
+    }
+
+    return true;
+}
+
+// returns the number of samples read, less than count at the end of the data
+static uint32_t read_vag(VagSource &vag, float *dest, uint32_t count) {
+    uint32_t read = 0;
+    while (read < count) {
+        if (vag.sample_index == VAG_BLOCK_SAMPLES && !next_vag_block(vag))
+            break;
+
+        const uint32_t copied = std::min(count - read, VAG_BLOCK_SAMPLES - vag.sample_index);
+        std::copy_n(vag.samples.data() + vag.sample_index, copied, dest + read);
+        vag.sample_index += copied;
+        read += copied;
+    }
+
+    return read;
+}
+
+static uint32_t read_pcm(PcmSource &pcm, float *dest, uint32_t count) {
+    uint32_t read = 0;
+    while (read < count) {
+        if (pcm.position >= pcm.sample_count) {
+            if (pcm.loop_position < 0 || static_cast<uint32_t>(pcm.loop_position) >= pcm.sample_count)
+                break;
+            pcm.position = pcm.loop_position;
+        }
+
+        const uint32_t copied = std::min(count - read, pcm.sample_count - pcm.position);
+        for (uint32_t i = 0; i < copied; i++)
+            dest[read + i] = static_cast<float>(pcm.data[pcm.position + i]) * (1.0f / 32768.0f);
+        pcm.position += copied;
+        read += copied;
+    }
+
+    return read;
+}
+
+static void read_source(Voice &voice, float *dest, uint32_t count) {
+    uint32_t read = 0;
+    if (!voice.source_ended) {
+        if (voice.type == SourceType::VAG)
+            read = read_vag(voice.vag, dest, count);
+        else if (voice.type == SourceType::PCM)
+            read = read_pcm(voice.pcm, dest, count);
+    }
+
+    if (read < count) {
+        std::fill(dest + read, dest + count, 0.0f);
+        voice.source_ended = true;
+    }
+}
+
+// square wave switching between random levels, at a rate given by the clock like the SPU noise
+static void render_noise(NoiseSource &noise, float *dest, uint32_t count) {
+    const uint32_t increment = (4 + (noise.clock & 3)) << (noise.clock >> 2);
+    for (uint32_t i = 0; i < count; i++) {
+        noise.timer += increment;
+        while (noise.timer >= 0x20000) {
+            noise.timer -= 0x20000;
+            noise.lfsr = (noise.lfsr >> 1) ^ ((0U - (noise.lfsr & 1)) & 0xD0000001U);
+        }
+        dest[i] = static_cast<float>(static_cast<int16_t>(noise.lfsr)) * (1.0f / 32768.0f);
+    }
+}
+
+// plays the samples at the pitch of the voice, interpolating linearly between them
+static void render_pitched(Voice &voice, std::vector<float> &input, float *dest, uint32_t count) {
+    if (!voice.primed) {
+        read_source(voice, voice.history, 2);
+        voice.primed = true;
+    }
+
+    const uint64_t step = static_cast<uint64_t>(voice.pitch) << 20;
+    const uint64_t end = voice.position + step * count;
+    const uint32_t consumed = static_cast<uint32_t>(end >> 32);
+
+    input[0] = voice.history[0];
+    input[1] = voice.history[1];
+    read_source(voice, input.data() + 2, consumed);
+
+    dsp::interpolate(dest, input.data(), voice.position, step, count);
+
+    voice.history[0] = input[consumed];
+    voice.history[1] = input[consumed + 1];
+    voice.position = static_cast<uint32_t>(end);
+}
+
+static int64_t next_height(EnvelopeCurve curve, int64_t height, int64_t rate) {
+    switch (curve) {
+    case EnvelopeCurve::LinearIncrease:
+        return height + rate;
+    case EnvelopeCurve::LinearDecrease:
+        return height - rate;
+    case EnvelopeCurve::LinearBent:
+        return height + ((height < ENVELOPE_HEIGHT_MAX / 4 * 3) ? rate : rate / 4);
+    case EnvelopeCurve::ExponentDecrease:
+        // at least 1 so the height reaches 0
+        return height - (rate ? std::max<int64_t>((height * rate) >> 31, 1) : 0);
+    case EnvelopeCurve::ExponentIncrease:
+        return height + (rate ? std::max<int64_t>(((ENVELOPE_HEIGHT_MAX - height) * rate) >> 31, 1) : 0);
+    case EnvelopeCurve::Direct:
+        return rate;
+    }
+    return height;
+}
+
+static void step_envelope(Envelope &envelope) {
+    switch (envelope.phase) {
+    case EnvelopePhase::Attack: {
+        const int64_t height = next_height(envelope.attack_curve, envelope.height, envelope.attack_rate);
+        if (height >= ENVELOPE_HEIGHT_MAX) {
+            envelope.height = ENVELOPE_HEIGHT_MAX;
+            envelope.phase = EnvelopePhase::Decay;
+        } else {
+            envelope.height = static_cast<int32_t>(std::max<int64_t>(height, 0));
+        }
+        break;
+    }
+    case EnvelopePhase::Decay: {
+        const int64_t height = next_height(envelope.decay_curve, envelope.height, envelope.decay_rate);
+        if (height <= envelope.sustain_level) {
+            envelope.height = envelope.sustain_level;
+            envelope.phase = EnvelopePhase::Sustain;
+        } else {
+            envelope.height = static_cast<int32_t>(std::min<int64_t>(height, ENVELOPE_HEIGHT_MAX));
+        }
+        break;
+    }
+    case EnvelopePhase::Sustain:
+        envelope.height = static_cast<int32_t>(std::clamp<int64_t>(next_height(envelope.sustain_curve, envelope.height, envelope.sustain_rate), 0, ENVELOPE_HEIGHT_MAX));
+        break;
+    case EnvelopePhase::Release: {
+        const int64_t height = next_height(envelope.release_curve, envelope.height, envelope.release_rate);
+        if (height <= 0) {
+            envelope.height = 0;
+            envelope.phase = EnvelopePhase::Off;
+        } else {
+            envelope.height = static_cast<int32_t>(std::min<int64_t>(height, ENVELOPE_HEIGHT_MAX));
+        }
+        break;
+    }
+    case EnvelopePhase::Off:
+        break;
+    }
+}
+
+// true if the height doesn't change anymore
+static bool is_envelope_steady(const Envelope &envelope) {
+    return envelope.phase == EnvelopePhase::Off
+        || (envelope.phase == EnvelopePhase::Sustain && envelope.sustain_rate == 0 && envelope.sustain_curve != EnvelopeCurve::Direct);
+}
+
+static void apply_envelope(Envelope &envelope, float *samples, uint32_t count) {
+    static constexpr float scale = 1.0f / ENVELOPE_HEIGHT_MAX;
+
+    uint32_t i = 0;
+    for (; i < count && !is_envelope_steady(envelope); i++) {
+        samples[i] *= static_cast<float>(envelope.height) * scale;
+        step_envelope(envelope);
+    }
+
+    const float gain = static_cast<float>(envelope.height) * scale;
+    for (; i < count; i++)
+        samples[i] *= gain;
+}
+
+static void render_voice(State &state, Voice &voice) {
+    float *samples = state.voice_output.data();
+    if (voice.type == SourceType::Noise)
+        render_noise(voice.noise, samples, state.grain);
+    else
+        render_pitched(voice, state.voice_input, samples, state.grain);
+
+    apply_envelope(voice.envelope, samples, state.grain);
+
+    if (voice.envelope.phase == EnvelopePhase::Off || voice.source_ended)
+        voice.ended = true;
+
+    if (voice.dry_volume[0] != 0.0f || voice.dry_volume[1] != 0.0f)
+        dsp::mix_mono(state.dry.data(), samples, voice.dry_volume, state.grain);
+    if (voice.wet_volume[0] != 0.0f || voice.wet_volume[1] != 0.0f)
+        dsp::mix_mono(state.wet.data(), samples, voice.wet_volume, state.grain);
+}
+
+static void apply_effect(Effect &effect, float *wet, uint32_t frame_count) {
+    if (effect.type == EffectType::Off)
+        return;
+
+    const uint32_t line_frames = std::min(effect.delay + 1, EFFECT_PARAM_MAX + 1) * 128;
+    const float feedback = static_cast<float>(effect.feedback) * (1.0f / (EFFECT_PARAM_MAX + 1));
+    float *line = effect.line.data();
+    uint32_t position = effect.line_position % line_frames;
+
+    for (uint32_t i = 0; i < frame_count * 2; i += 2) {
+        const float delayed_left = line[position * 2];
+        const float delayed_right = line[position * 2 + 1];
+        line[position * 2] = wet[i] + delayed_left * feedback;
+        line[position * 2 + 1] = wet[i + 1] + delayed_right * feedback;
+        wet[i] = delayed_left;
+        wet[i + 1] = delayed_right;
+        if (++position == line_frames)
+            position = 0;
+    }
+
+    effect.line_position = position;
+}
+
+static void update_peaks(int32_t peaks[2], const float *samples, uint32_t frame_count) {
+    float max[2] = {};
+    for (uint32_t i = 0; i < frame_count; i++) {
+        max[0] = std::max(max[0], std::abs(samples[i * 2]));
+        max[1] = std::max(max[1], std::abs(samples[i * 2 + 1]));
+    }
+
+    for (int channel = 0; channel < 2; channel++)
+        peaks[channel] = static_cast<int32_t>(std::min(max[channel] * 32768.0f, 32767.0f));
+}
+
+// mixes the voices and the effect, the result is in state.output, interleaved with 2 or 4 channels
+static uint32_t mix(State &state) {
+    const uint32_t frame_count = state.grain;
+    std::fill(state.dry.begin(), state.dry.end(), 0.0f);
+    std::fill(state.wet.begin(), state.wet.end(), 0.0f);
+
+    for (Voice &voice : state.voices) {
+        if (!voice.ended && !voice.paused)
+            render_voice(state, voice);
+    }
+
+    Effect &effect = state.effect;
+    update_peaks(state.wet_peak, state.wet.data(), frame_count);
+    apply_effect(effect, state.wet.data(), frame_count);
+
+    float *dry = state.dry.data();
+    float *wet = state.wet.data();
+    float *output = state.output.data();
+    const float dry_gain = effect.dry_enabled ? 1.0f : 0.0f;
+    const float wet_gain[2] = { effect.wet_enabled ? effect.volume[0] : 0.0f, effect.wet_enabled ? effect.volume[1] : 0.0f };
+
+    if (state.output_mode == OutputMode::Multichannel) {
+        for (uint32_t i = 0; i < frame_count; i++) {
+            output[i * 4] = dry[i * 2] * dry_gain;
+            output[i * 4 + 1] = dry[i * 2 + 1] * dry_gain;
+            output[i * 4 + 2] = wet[i * 2] * wet_gain[0];
+            output[i * 4 + 3] = wet[i * 2 + 1] * wet_gain[1];
+        }
+        update_peaks(state.dry_peak, dry, frame_count);
+        update_peaks(state.pre_master_peak, dry, frame_count);
+        return 4;
+    }
+
+    for (uint32_t i = 0; i < frame_count; i++) {
+        output[i * 2] = dry[i * 2] * dry_gain + wet[i * 2] * wet_gain[0];
+        output[i * 2 + 1] = dry[i * 2 + 1] * dry_gain + wet[i * 2 + 1] * wet_gain[1];
+    }
+    update_peaks(state.dry_peak, dry, frame_count);
+    update_peaks(state.pre_master_peak, output, frame_count);
+    return 2;
+}
+
+void render(State &state, int16_t *out) {
+    const uint32_t channel_count = mix(state);
+    dsp::float_to_s16(out, state.output.data(), state.grain * channel_count);
+}
+
+void render_with_mix(State &state, int16_t *buffer, const float volume[2]) {
+    const uint32_t channel_count = mix(state);
+    float *output = state.output.data();
+    const uint32_t sample_count = state.grain * channel_count;
+    for (uint32_t i = 0; i < sample_count; i++)
+        output[i] += static_cast<float>(buffer[i]) * volume[i & 1] * (1.0f / 32768.0f);
+
+    dsp::float_to_s16(buffer, output, sample_count);
+}
+
+} // namespace sas
@@ -0,0 +1,345 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <sas/functions.h>
+
+#include <dsp/dsp.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+static constexpr uint32_t GRAIN = 256;
+static constexpr uint32_t OUTPUT_RATE = 48000;
+
+// 16-byte VAG block without prediction, each nibble is a sample (shifted left by 12 - shift)
+static std::vector<uint8_t> make_vag_block(const std::vector<int8_t> &nibbles, uint8_t shift, uint8_t flags) {
+    std::vector<uint8_t> block(sas::VAG_BLOCK_SIZE);
+    block[0] = shift;
+    block[1] = flags;
+    for (size_t i = 0; i < nibbles.size() && i < sas::VAG_BLOCK_SAMPLES; i++)
+        block[2 + i / 2] |= (nibbles[i] & 0xF) << ((i & 1) * 4);
+
+    return block;
+}
+
+// square wave with a period of 4 samples
+static std::vector<uint8_t> make_vag_square(uint32_t block_count, uint8_t last_flags) {
+    std::vector<int8_t> nibbles;
+    for (uint32_t i = 0; i < sas::VAG_BLOCK_SAMPLES; i++)
+        nibbles.push_back((i & 2) ? -4 : 4);
+
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < block_count; i++) {
+        const std::vector<uint8_t> block = make_vag_block(nibbles, 2, i + 1 == block_count ? last_flags : 0);
+        data.insert(data.end(), block.begin(), block.end());
+    }
+
+    return data;
+}
+
+static std::vector<int16_t> make_sine(uint32_t sample_count, float frequency, float amplitude) {
+    std::vector<int16_t> samples(sample_count);
+    for (uint32_t i = 0; i < sample_count; i++)
+        samples[i] = static_cast<int16_t>(std::sin(2.0f * std::numbers::pi_v<float> * frequency * i / OUTPUT_RATE) * amplitude * 32767.0f);
+
+    return samples;
+}
+
+static void init_state(sas::State &state, uint32_t voice_count) {
+    sas::Config config;
+    config.voice_count = voice_count;
+    config.grain = GRAIN;
+    sas::init(state, config, Ptr<void>(), 0);
+}
+
+static std::vector<int16_t> render_grain(sas::State &state) {
+    std::vector<int16_t> out(state.grain * 2);
+    sas::render(state, out.data());
+    return out;
+}
+
+// number of grains rendered before the voice ends, 0 if it doesn't in max_grains
+static uint32_t grains_until_end(sas::State &state, uint32_t voice, uint32_t max_grains) {
+    for (uint32_t grain = 1; grain <= max_grains; grain++) {
+        render_grain(state);
+        if (state.voices[voice].ended)
+            return grain;
+    }
+
+    return 0;
+}
+
+TEST(sas, parse_config) {
+    sas::Config config;
+    EXPECT_TRUE(sas::parse_config("numGrains=512 numVoices=8  -numReverbs=0 unknown=1", config));
+    EXPECT_EQ(config.grain, 512);
+    EXPECT_EQ(config.voice_count, 8);
+    EXPECT_EQ(config.reverb_count, 0);
+
+    EXPECT_FALSE(sas::parse_config("numVoices=many", config));
+    EXPECT_GE(sas::get_needed_memory_size(config), config.grain * 4);
+}
+
+TEST(sas, silent_without_key_on) {
+    sas::State state;
+    init_state(state, 4);
+
+    const std::vector<uint8_t> vag = make_vag_square(4, 1);
+    sas::set_vag(state.voices[0], vag.data(), vag.size(), false);
+
+    for (const int16_t sample : render_grain(state))
+        ASSERT_EQ(sample, 0);
+}
+
+TEST(sas, vag_decodes_blocks) {
+    sas::State state;
+    init_state(state, 1);
+
+    const std::vector<uint8_t> vag = make_vag_square(20, 1);
+    sas::Voice &voice = state.voices[0];
+    sas::set_vag(voice, vag.data(), vag.size(), false);
+    sas::key_on(voice);
+
+    const std::vector<int16_t> out = render_grain(state);
+    // the default envelope reaches its maximum after the first sample
+    EXPECT_EQ(out[0], 0);
+    for (uint32_t i = 1; i < GRAIN; i++) {
+        const int16_t expected = (i & 2) ? -0x1000 : 0x1000;
+        ASSERT_EQ(out[i * 2], expected) << "sample " << i;
+        ASSERT_EQ(out[i * 2 + 1], expected) << "sample " << i;
+    }
+}
+
+TEST(sas, vag_loops_at_markers) {
+    static constexpr uint8_t FLAG_LOOP_END = 1;
+    static constexpr uint8_t FLAG_LOOP_REPEAT = 2;
+    static constexpr uint8_t FLAG_LOOP_START = 4;
+
+    std::vector<uint8_t> vag = make_vag_square(3, FLAG_LOOP_END | FLAG_LOOP_REPEAT);
+    vag[sas::VAG_BLOCK_SIZE + 1] = FLAG_LOOP_START;
+
+    sas::State state;
+    init_state(state, 2);
+    sas::set_vag(state.voices[0], vag.data(), vag.size(), true);
+    sas::set_vag(state.voices[1], vag.data(), vag.size(), false);
+    sas::key_on(state.voices[0]);
+    sas::key_on(state.voices[1]);
+
+    // 3 blocks are 84 samples, less than a grain
+    EXPECT_EQ(grains_until_end(state, 1, 10), 1);
+    EXPECT_FALSE(state.voices[0].ended);
+
+    const std::vector<int16_t> out = render_grain(state);
+    // the loop is 2 blocks long, the period of the square wave stays the same
+    EXPECT_EQ(out[GRAIN * 2 - 2], ((2 * GRAIN - 1) & 2) ? -0x1000 : 0x1000);
+}
+
+TEST(sas, pitch_changes_playback_speed) {
+    const std::vector<int16_t> pcm = make_sine(GRAIN * 20, 440.0f, 0.5f);
+
+    sas::State state;
+    init_state(state, 3);
+    const int32_t pitches[] = { sas::PITCH_BASE, sas::PITCH_BASE * 2, sas::PITCH_BASE / 2 };
+    for (uint32_t i = 0; i < 3; i++) {
+        sas::set_pcm(state.voices[i], pcm.data(), pcm.size(), -1);
+        state.voices[i].pitch = pitches[i];
+        sas::key_on(state.voices[i]);
+    }
+
+    std::vector<uint32_t> ends(3);
+    for (uint32_t grain = 1; grain <= 50; grain++) {
+        render_grain(state);
+        for (uint32_t i = 0; i < 3; i++) {
+            if (!ends[i] && state.voices[i].ended)
+                ends[i] = grain;
+        }
+    }
+
+    EXPECT_EQ(ends[0], 20);
+    EXPECT_EQ(ends[1], 10);
+    EXPECT_EQ(ends[2], 40);
+}
+
+TEST(sas, envelope_phases) {
+    const std::vector<int16_t> pcm = make_sine(GRAIN, 1000.0f, 1.0f);
+
+    sas::State state;
+    init_state(state, 1);
+    sas::Voice &voice = state.voices[0];
+    sas::set_pcm(voice, pcm.data(), pcm.size(), 0);
+
+    sas::Envelope &envelope = voice.envelope;
+    envelope.attack_rate = sas::ENVELOPE_HEIGHT_MAX / 100;
+    envelope.decay_curve = sas::EnvelopeCurve::ExponentDecrease;
+    envelope.decay_rate = 0x100000;
+    envelope.sustain_level = sas::ENVELOPE_HEIGHT_MAX / 2;
+    envelope.sustain_rate = 0;
+    envelope.release_curve = sas::EnvelopeCurve::LinearDecrease;
+    envelope.release_rate = sas::ENVELOPE_HEIGHT_MAX / (GRAIN * 3);
+
+    sas::key_on(voice);
+    render_grain(state);
+    EXPECT_EQ(envelope.phase, sas::EnvelopePhase::Decay);
+
+    for (uint32_t i = 0; i < 20; i++)
+        render_grain(state);
+    EXPECT_EQ(envelope.phase, sas::EnvelopePhase::Sustain);
+    EXPECT_EQ(envelope.height, sas::ENVELOPE_HEIGHT_MAX / 2);
+    EXPECT_FALSE(voice.ended);
+
+    // the release goes from the sustain level to 0 in 1.5 grain
+    sas::key_off(voice);
+    EXPECT_EQ(grains_until_end(state, 0, 10), 2);
+    EXPECT_EQ(envelope.height, 0);
+}
+
+TEST(sas, simple_adsr) {
+    sas::Envelope envelope;
+    // fastest linear attack, decay to the sustain level 15, exponential release
+    sas::set_simple_adsr(envelope, 0x00FF, 0x1FE0 | 0x20 | 4);
+    EXPECT_EQ(envelope.attack_curve, sas::EnvelopeCurve::LinearIncrease);
+    EXPECT_EQ(envelope.attack_rate, 7 << 26);
+    EXPECT_EQ(envelope.decay_curve, sas::EnvelopeCurve::ExponentDecrease);
+    EXPECT_EQ(envelope.decay_rate, static_cast<int32_t>(0x80000000U >> 0xF));
+    EXPECT_EQ(envelope.sustain_level, sas::ENVELOPE_HEIGHT_MAX);
+    EXPECT_EQ(envelope.release_curve, sas::EnvelopeCurve::ExponentDecrease);
+    EXPECT_EQ(envelope.release_rate, static_cast<int32_t>(0x80000000U >> 4));
+}
+
+TEST(sas, render_with_mix_adds_the_input) {
+    sas::State state;
+    init_state(state, 1);
+
+    std::vector<int16_t> buffer(GRAIN * 2, 0x2000);
+    const float volume[2] = { 0.5f, 1.0f };
+    sas::render_with_mix(state, buffer.data(), volume);
+    EXPECT_EQ(buffer[0], 0x1000);
+    EXPECT_EQ(buffer[1], 0x2000);
+}
+
+// Plays a few voices of every kind with pitch changes, key offs and the echo, and writes the result to a WAV file
+// which can be listened to or compared with the output of the library on the console.
+static std::vector<int16_t> render_session(sas::State &state, uint32_t grain_count) {
+    static const std::vector<int16_t> low_tone = make_sine(OUTPUT_RATE, 220.0f, 0.3f);
+    static const std::vector<int16_t> high_tone = make_sine(OUTPUT_RATE / 4, 880.0f, 0.2f);
+    static const std::vector<uint8_t> square = make_vag_square(400, 1 | 2);
+
+    init_state(state, 16);
+    sas::set_effect_type(state.effect, sas::EffectType::Echo);
+    sas::set_effect_param(state.effect, 60, 64);
+    state.effect.wet_enabled = true;
+    state.effect.volume[0] = 0.5f;
+    state.effect.volume[1] = 0.5f;
+
+    // voice, grain at which it's keyed on, grain at which it's keyed off
+    struct Note {
+        uint32_t voice;
+        uint32_t on;
+        uint32_t off;
+    };
+    const Note notes[] = { { 0, 0, 300 }, { 1, 20, 120 }, { 2, 60, 200 }, { 3, 100, 110 }, { 4, 150, 350 } };
+
+    sas::set_pcm(state.voices[0], low_tone.data(), low_tone.size(), 0);
+    sas::set_pcm(state.voices[1], high_tone.data(), high_tone.size(), -1);
+    sas::set_vag(state.voices[2], square.data(), square.size(), true);
+    sas::set_noise(state.voices[3], 0x30);
+    sas::set_pcm(state.voices[4], low_tone.data(), low_tone.size(), 0);
+    for (uint32_t i = 0; i < 5; i++) {
+        sas::set_simple_adsr(state.voices[i].envelope, 0x0A0F, 0x1FC0 | 0x08);
+        state.voices[i].dry_volume[0] = 0.2f + 0.15f * i;
+        state.voices[i].dry_volume[1] = 0.8f - 0.15f * i;
+        state.voices[i].wet_volume[0] = 0.3f;
+        state.voices[i].wet_volume[1] = 0.3f;
+    }
+    state.voices[2].pitch = sas::PITCH_BASE / 4;
+
+    std::vector<int16_t> output;
+    for (uint32_t grain = 0; grain < grain_count; grain++) {
+        for (const Note &note : notes) {
+            if (grain == note.on)
+                sas::key_on(state.voices[note.voice]);
+            else if (grain == note.off)
+                sas::key_off(state.voices[note.voice]);
+        }
+        // slide the last voice an octave up
+        if (grain >= 150 && grain < 250)
+            state.voices[4].pitch = sas::PITCH_BASE + (grain - 150) * sas::PITCH_BASE / 100;
+
+        const std::vector<int16_t> out = render_grain(state);
+        output.insert(output.end(), out.begin(), out.end());
+    }
+
+    return output;
+}
+
+static void write_wav(const std::string &path, const std::vector<int16_t> &samples) {
+    const auto write_u32 = [](std::ofstream &file, uint32_t value) { file.write(reinterpret_cast<const char *>(&value), 4); };
+    const auto write_u16 = [](std::ofstream &file, uint16_t value) { file.write(reinterpret_cast<const char *>(&value), 2); };
+    const uint32_t data_size = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+
+    std::ofstream file(path, std::ios::binary);
+    file.write("RIFF", 4);
+    write_u32(file, 36 + data_size);
+    file.write("WAVEfmt ", 8);
+    write_u32(file, 16);
+    write_u16(file, 1); // PCM
+    write_u16(file, 2);
+    write_u32(file, OUTPUT_RATE);
+    write_u32(file, OUTPUT_RATE * 2 * sizeof(int16_t));
+    write_u16(file, 2 * sizeof(int16_t));
+    write_u16(file, 16);
+    file.write("data", 4);
+    write_u32(file, data_size);
+    file.write(reinterpret_cast<const char *>(samples.data()), data_size);
+}
+
+TEST(sas, render_session_to_wav) {
+    constexpr uint32_t grain_count = 400;
+
+    const dsp::Implementation default_implementation = dsp::get_implementation();
+    sas::State state;
+    const std::vector<int16_t> output = render_session(state, grain_count);
+    ASSERT_EQ(output.size(), grain_count * GRAIN * 2);
+
+    // the vector mixing gives the same result as the scalar one
+    dsp::set_implementation(dsp::Implementation::Scalar);
+    sas::State scalar_state;
+    EXPECT_EQ(render_session(scalar_state, grain_count), output);
+    dsp::set_implementation(default_implementation);
+
+    int32_t peak = 0;
+    for (const int16_t sample : output)
+        peak = std::max(peak, std::abs(static_cast<int32_t>(sample)));
+    EXPECT_GT(peak, 0x1000);
+
+    // every voice ended, only the echo is left
+    for (uint32_t i = 0; i < 5; i++)
+        EXPECT_TRUE(state.voices[i].ended) << "voice " << i;
+
+    const std::string path = ::testing::TempDir() + "sas_session.wav";
+    write_wav(path, output);
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    EXPECT_EQ(static_cast<size_t>(file.tellg()), 44 + output.size() * sizeof(int16_t));
+    std::cout << "SAS session written to " << path << std::endl;
+}
@@ -40,6 +40,7 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -2033,7 +2034,13 @@ static std::string convert_spirv_to_glsl(const std::string &shader_name, SpirvCo
 
 void spirv_disasm_print(const usse::SpirvCode &spirv_binary, std::string *spirv_dump) {
     std::stringstream spirv_disasm;
-    spv::Disassemble(spirv_disasm, spirv_binary);
+    {
+        // the disassembler fills its opcode tables on first use without any lock,
+        // and shaders can be translated on multiple threads
+        static std::mutex disasm_mutex;
+        std::lock_guard<std::mutex> guard(disasm_mutex);
+        spv::Disassemble(spirv_disasm, spirv_binary);
+    }
 
     if (spirv_dump) {
         *spirv_dump = spirv_disasm.str();
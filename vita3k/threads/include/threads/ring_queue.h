@@ -0,0 +1,222 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+
+/**
+ * @brief Bounded queue with any number of producers and a single consumer
+ *
+ * Pushing and popping are lock-free. A side which has to block (the consumer on an empty queue, the producers
+ * on a full one) sleeps with std::atomic::wait on an epoch counter, which the other side only bumps and notifies
+ * when someone is waiting. Timed waits poll instead as atomics can't be waited on with a timeout, they are only
+ * used with a few microseconds. Unlike Queue, the items are returned by value.
+ * top, pop and wait_for_item must only be called from the consumer thread.
+ */
+template <typename T>
+class RingQueue {
+public:
+    RingQueue() {
+        set_capacity(1);
+    }
+    RingQueue(const RingQueue &) = delete; // disable copying
+    RingQueue &operator=(const RingQueue &) = delete; // disable assignment
+
+    // Must not be called while the queue is used, it also empties the queue
+    void set_capacity(size_t capacity) {
+        capacity_ = std::max<size_t>(capacity, 1);
+        slots_ = std::make_unique<Slot[]>(capacity_);
+        reset();
+    }
+
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // Returns the first item without removing it, ms is the maximum time to wait in microseconds, 0 to wait forever
+    std::optional<T> top(const int ms = 0) {
+        if (!wait_for_item(ms))
+            return {};
+
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return slots_[pos % capacity_].item;
+    }
+
+    std::optional<T> pop(const int ms = 0) {
+        if (!wait_for_item(ms))
+            return {};
+
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[pos % capacity_];
+        std::optional<T> item(std::move(slot.item));
+        slot.sequence.store((pos + capacity_) * 2, std::memory_order_seq_cst);
+        dequeue_pos_.store(pos + 1, std::memory_order_seq_cst);
+
+        if (space_waiters_.load(std::memory_order_seq_cst) > 0)
+            signal(space_epoch_);
+
+        return item;
+    }
+
+    // Blocks while the queue is full
+    void push(T item) {
+        while (!aborted_.load(std::memory_order_relaxed) && !try_push(item))
+            wait_for_space([&]() { return !is_full(); });
+
+        if (consumer_waiting_.load(std::memory_order_seq_cst)) {
+            // there is a single consumer
+            item_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            item_epoch_.notify_one();
+        }
+    }
+
+    bool try_push(T &item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot &slot = slots_[pos % capacity_];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos * 2);
+            if (diff == 0) {
+                // the slot is free, claim it
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.item = std::move(item);
+                    slot.sequence.store(pos * 2 + 1, std::memory_order_seq_cst);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // the consumer has not released this slot yet
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t size() const {
+        return enqueue_pos_.load(std::memory_order_relaxed) - dequeue_pos_.load(std::memory_order_relaxed);
+    }
+
+    // Makes the consumer return from its current wait
+    void wake() {
+        signal(item_epoch_);
+    }
+
+    void abort() {
+        aborted_.store(true, std::memory_order_seq_cst);
+        signal(item_epoch_);
+        signal(space_epoch_);
+    }
+
+    bool is_aborted() const {
+        return aborted_.load(std::memory_order_relaxed);
+    }
+
+    // Must not be called while the queue is used
+    void reset() {
+        for (size_t i = 0; i < capacity_; i++) {
+            slots_[i].item = T();
+            slots_[i].sequence.store(i * 2, std::memory_order_relaxed);
+        }
+        enqueue_pos_ = 0;
+        dequeue_pos_ = 0;
+        aborted_ = false;
+    }
+
+    void wait_empty() {
+        while (!aborted_.load(std::memory_order_relaxed) && !is_empty())
+            wait_for_space([&]() { return is_empty(); });
+    }
+
+    // Returns false if the queue was aborted or is still empty after ms microseconds, ms = 0 waits forever
+    bool wait_for_item(const int ms) {
+        const auto ready = [&]() { return aborted_.load(std::memory_order_seq_cst) || has_item(); };
+        if (ms != 0) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(ms);
+            while (!ready() && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        } else {
+            while (!ready()) {
+                const uint32_t epoch = item_epoch_.load(std::memory_order_seq_cst);
+                // a producer publishing after this point sees the flag and bumps the epoch, so the wait returns
+                consumer_waiting_.store(true, std::memory_order_seq_cst);
+                if (!ready())
+                    item_epoch_.wait(epoch, std::memory_order_seq_cst);
+                consumer_waiting_.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        return !aborted_.load(std::memory_order_relaxed) && has_item();
+    }
+
+private:
+    struct Slot {
+        // pos * 2 while the slot is free for the item at pos, pos * 2 + 1 once it is pushed,
+        // (pos + capacity) * 2 once it is popped. Doubling keeps the states apart with a capacity of 1
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    static void signal(std::atomic<uint32_t> &epoch) {
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        epoch.notify_all();
+    }
+
+    // sleeps until the consumer pops an item or the queue is aborted, done may already be true once registered
+    template <typename F>
+    void wait_for_space(F done) {
+        const uint32_t epoch = space_epoch_.load(std::memory_order_seq_cst);
+        space_waiters_.fetch_add(1, std::memory_order_seq_cst);
+        if (!aborted_.load(std::memory_order_seq_cst) && !done())
+            space_epoch_.wait(epoch, std::memory_order_seq_cst);
+        space_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool has_item() const {
+        const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return slots_[pos % capacity_].sequence.load(std::memory_order_seq_cst) == pos * 2 + 1;
+    }
+
+    bool is_full() const {
+        const size_t pos = enqueue_pos_.load(std::memory_order_seq_cst);
+        return slots_[pos % capacity_].sequence.load(std::memory_order_seq_cst) != pos * 2;
+    }
+
+    bool is_empty() const {
+        return enqueue_pos_.load(std::memory_order_seq_cst) == dequeue_pos_.load(std::memory_order_seq_cst);
+    }
+
+    size_t capacity_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+
+    // the producers and the consumer are kept on separate cache lines
+    alignas(64) std::atomic<size_t> enqueue_pos_{ 0 };
+    alignas(64) std::atomic<size_t> dequeue_pos_{ 0 };
+
+    // bumped to wake up the consumer waiting for an item and the producers waiting for space
+    std::atomic<uint32_t> item_epoch_{ 0 };
+    std::atomic<uint32_t> space_epoch_{ 0 };
+    std::atomic<bool> consumer_waiting_{ false };
+    std::atomic<int> space_waiters_{ 0 };
+    std::atomic<bool> aborted_{ false };
+};
@@ -0,0 +1,147 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of host threads used to split CPU heavy work (texture conversions, ...)
+ *
+ * A thread waiting for a parallel_for only runs the ranges of its own call in the meantime,
+ * so the work can be split again from inside a task without any deadlock.
+ */
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t thread_count) {
+        for (size_t i = 0; i < thread_count; i++)
+            threads.emplace_back([this]() { worker_loop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cond.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Shared pool with one thread per host core, minus the one calling it
+    static WorkerPool &get() {
+        static WorkerPool pool(std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1);
+        return pool;
+    }
+
+    size_t thread_count() const {
+        return threads.size();
+    }
+
+    // Runs the task on one of the workers, without waiting for it
+    void submit(std::function<void()> task) {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        cond.notify_one();
+    }
+
+    // Calls func(begin, end) on ranges covering [0, count) and returns once all of them are done.
+    // Each range is at least min_range long. The calling thread handles the ranges no worker has
+    // taken yet instead of sleeping, so the work can be split again from inside a task.
+    void parallel_for(size_t count, size_t min_range, const std::function<void(size_t, size_t)> &func) {
+        const size_t max_ranges = std::max<size_t>(count / std::max<size_t>(min_range, 1), 1);
+        const size_t range_count = std::min(max_ranges, thread_count() + 1);
+        if (range_count <= 1) {
+            func(0, count);
+            return;
+        }
+
+        const auto job = std::make_shared<RangeJob>(func, count, range_count);
+        // the workers only pick a job up once they are free, the ranges are taken as they go
+        for (size_t i = 1; i < range_count; i++)
+            submit([job, this]() { run_ranges(*job); });
+
+        run_ranges(*job);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cond.wait(lock, [&]() { return job->done.load(std::memory_order_acquire) == job->range_count; });
+    }
+
+private:
+    struct RangeJob {
+        RangeJob(const std::function<void(size_t, size_t)> &func, size_t count, size_t range_count)
+            : func(func)
+            , count(count)
+            , range_count(range_count) {}
+
+        // only used while a range is left, a late task may outlive the call
+        const std::function<void(size_t, size_t)> &func;
+        const size_t count;
+        const size_t range_count;
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> done{ 0 };
+    };
+
+    void run_ranges(RangeJob &job) {
+        while (true) {
+            const size_t range = job.next.fetch_add(1, std::memory_order_relaxed);
+            if (range >= job.range_count)
+                return;
+
+            // the sizes of the ranges differ by 1 at most, none is shorter than min_range
+            job.func(range * job.count / job.range_count, (range + 1) * job.count / job.range_count);
+            if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.range_count) {
+                { const std::lock_guard<std::mutex> lock(mutex); }
+                done_cond.notify_all();
+            }
+        }
+    }
+
+    void worker_loop() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::condition_variable done_cond;
+    bool stopping = false;
+};
@@ -0,0 +1,172 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <threads/ring_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// producer index in the high bits, sequence number in the low bits
+static uint64_t make_item(uint32_t producer, uint32_t sequence) {
+    return (static_cast<uint64_t>(producer) << 32) | sequence;
+}
+
+TEST(ring_queue, producers_keep_their_order) {
+    constexpr uint32_t PRODUCER_COUNT = 4;
+    constexpr uint32_t ITEM_COUNT = 20000;
+
+    for (const size_t capacity : { 1, 2, 7, 64 }) {
+        RingQueue<uint64_t> queue;
+        queue.set_capacity(capacity);
+
+        std::vector<std::thread> producers;
+        for (uint32_t producer = 0; producer < PRODUCER_COUNT; producer++) {
+            producers.emplace_back([&queue, producer]() {
+                for (uint32_t i = 0; i < ITEM_COUNT; i++)
+                    queue.push(make_item(producer, i));
+            });
+        }
+
+        std::vector<uint32_t> next(PRODUCER_COUNT, 0);
+        for (uint32_t i = 0; i < PRODUCER_COUNT * ITEM_COUNT; i++) {
+            // alternate between untimed and timed waits, a timed wait may run out before the item arrives
+            std::optional<uint64_t> item;
+            if (i % 2)
+                item = queue.pop();
+            else
+                while (!(item = queue.pop(5))) { }
+
+            ASSERT_TRUE(item);
+            const uint32_t producer = *item >> 32;
+            ASSERT_LT(producer, PRODUCER_COUNT);
+            ASSERT_EQ(static_cast<uint32_t>(*item), next[producer]) << "capacity " << capacity << ", producer " << producer;
+            next[producer]++;
+        }
+
+        for (std::thread &producer : producers)
+            producer.join();
+        EXPECT_EQ(queue.size(), 0);
+    }
+}
+
+TEST(ring_queue, top_does_not_remove_the_item) {
+    RingQueue<int> queue;
+    queue.set_capacity(2);
+    queue.push(1);
+    queue.push(2);
+    EXPECT_EQ(queue.top(), 1);
+    EXPECT_EQ(queue.top(), 1);
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.top(), 2);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_FALSE(queue.top(10));
+}
+
+TEST(ring_queue, abort_wakes_every_waiter) {
+    RingQueue<int> queue;
+    queue.set_capacity(1);
+    queue.push(0);
+
+    std::atomic<int> returned = 0;
+    std::vector<std::thread> threads;
+    // the queue is full, the producers and wait_empty block
+    for (int i = 0; i < 3; i++) {
+        threads.emplace_back([&]() {
+            queue.push(1);
+            returned++;
+        });
+    }
+    threads.emplace_back([&]() {
+        queue.wait_empty();
+        returned++;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(returned, 0);
+    queue.abort();
+    for (std::thread &thread : threads)
+        thread.join();
+    EXPECT_EQ(returned, 4);
+
+    // the consumer does not block either
+    EXPECT_FALSE(queue.pop());
+    EXPECT_FALSE(queue.top());
+}
+
+TEST(ring_queue, abort_wakes_the_consumer) {
+    RingQueue<int> queue;
+    std::thread consumer([&]() { EXPECT_FALSE(queue.pop()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.abort();
+    consumer.join();
+
+    queue.reset();
+    EXPECT_FALSE(queue.is_aborted());
+    queue.push(3);
+    EXPECT_EQ(queue.pop(), 3);
+}
+
+TEST(ring_queue, wait_empty_returns_once_everything_is_popped) {
+    RingQueue<int> queue;
+    queue.set_capacity(8);
+    for (int i = 0; i < 8; i++)
+        queue.push(i);
+
+    std::atomic<bool> empty = false;
+    std::thread waiter([&]() {
+        queue.wait_empty();
+        empty = true;
+    });
+
+    for (int i = 0; i < 8; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_FALSE(empty);
+        EXPECT_EQ(queue.pop(), i);
+    }
+    waiter.join();
+    EXPECT_TRUE(empty);
+}
+
+// Items per second going through the queue from one producer to the consumer
+TEST(ring_queue, DISABLED_throughput_benchmark) {
+    constexpr uint32_t ITEM_COUNT = 200000;
+
+    for (const size_t capacity : { 1, 16, 1024 }) {
+        RingQueue<uint32_t> queue;
+        queue.set_capacity(capacity);
+
+        const auto start_time = std::chrono::steady_clock::now();
+        std::thread producer([&]() {
+            for (uint32_t i = 0; i < ITEM_COUNT; i++)
+                queue.push(i);
+        });
+
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < ITEM_COUNT; i++)
+            sum += *queue.pop();
+        producer.join();
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+
+        EXPECT_EQ(sum, static_cast<uint64_t>(ITEM_COUNT) * (ITEM_COUNT - 1) / 2);
+        std::cout << "capacity " << capacity << ": " << ITEM_COUNT * 1000000ULL / std::max<int64_t>(duration.count(), 1) << " items per second" << std::endl;
+    }
+}
@@ -0,0 +1,95 @@
+// Vita3K emulator project
+// Copyright (C) 2026 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <threads/worker_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+TEST(worker_pool, parallel_for_covers_every_index_once) {
+    for (size_t thread_count = 1; thread_count <= 16; thread_count++) {
+        WorkerPool pool(thread_count);
+        for (size_t count = 0; count <= 70; count++) {
+            for (size_t min_range = 0; min_range <= 5; min_range++) {
+                std::vector<std::atomic<int>> hits(count);
+                std::atomic<bool> short_range = false;
+                pool.parallel_for(count, min_range, [&](size_t begin, size_t end) {
+                    if (end - begin < min_range && end - begin != count)
+                        short_range = true;
+                    for (size_t i = begin; i < end; i++)
+                        hits[i]++;
+                });
+
+                ASSERT_FALSE(short_range) << thread_count << " threads, count " << count << ", min_range " << min_range;
+                for (size_t i = 0; i < count; i++)
+                    ASSERT_EQ(hits[i], 1) << thread_count << " threads, count " << count << ", min_range " << min_range << ", index " << i;
+            }
+        }
+    }
+}
+
+// shader precompilation splits batches of up to 32 programs (so 64 shaders) by single items, twice that is tested
+TEST(worker_pool, parallel_for_single_items_on_large_pools) {
+    for (size_t thread_count = 16; thread_count <= 64; thread_count += 3) {
+        WorkerPool pool(thread_count);
+        for (size_t count = 0; count <= 128; count++) {
+            std::vector<std::atomic<int>> hits(count);
+            pool.parallel_for(count, 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    hits[i]++;
+            });
+
+            for (size_t i = 0; i < count; i++)
+                ASSERT_EQ(hits[i], 1) << thread_count << " threads, count " << count << ", index " << i;
+        }
+    }
+}
+
+TEST(worker_pool, nested_parallel_for) {
+    WorkerPool pool(3);
+    std::atomic<size_t> total = 0;
+    pool.parallel_for(17, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            pool.parallel_for(40, 2, [&](size_t inner_begin, size_t inner_end) {
+                total += inner_end - inner_begin;
+            });
+        }
+    });
+
+    EXPECT_EQ(total, 17 * 40);
+}
+
+TEST(worker_pool, caller_does_not_run_other_tasks) {
+    WorkerPool pool(1);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> other_ran = false;
+
+    // keeps the only worker busy, the other task stays queued
+    pool.submit([released]() { released.wait(); });
+    pool.submit([&]() { other_ran = true; });
+
+    std::atomic<size_t> total = 0;
+    pool.parallel_for(100, 1, [&](size_t begin, size_t end) { total += end - begin; });
+    EXPECT_EQ(total, 100);
+    EXPECT_FALSE(other_ran);
+
+    release.set_value();
+}
@@ -79,11 +79,19 @@ struct Queue {
         return &head->prev->content;
     }
 
+    // get the most recently used element
+    T *get_mru() const {
+        return &head->content;
+    }
+
+    // get the element used right after this one (going from the least to the most recently used)
+    T *get_more_recent(T *ptr) const {
+        return &get_item(ptr)->prev->content;
+    }
+
     // set an element as the most recently used
     void set_as_mru(T *ptr) {
-        // get the item from a pointer to its content
-        // removed the offsetof to avoid compilation warnings
-        Item<T> *item = reinterpret_cast<Item<T> *>(reinterpret_cast<char *>(ptr) - 2 * sizeof(void *) /* offsetof(Item<T>, content)*/);
+        Item<T> *item = get_item(ptr);
         if (item == head)
             return;
 
@@ -107,5 +115,12 @@ struct Queue {
         set_as_mru(ptr);
         head = head->next;
     }
+
+private:
+    static Item<T> *get_item(T *ptr) {
+        // get the item from a pointer to its content
+        // removed the offsetof to avoid compilation warnings
+        return reinterpret_cast<Item<T> *>(reinterpret_cast<char *>(ptr) - 2 * sizeof(void *) /* offsetof(Item<T>, content)*/);
+    }
 };
 } // namespace lru
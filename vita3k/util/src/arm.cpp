@@ -32,9 +32,10 @@ uint32_t encode_arm_inst(uint8_t type, uint32_t immed, uint16_t reg) {
         // Upper bits == 0xE34
         return (0xE34u << 20) | ((immed & 0xF000) << 4) | (immed & 0xFFF) | (reg << 12);
     case INSTRUCTION_SYSCALL:
-        // Syscall does not have any immediate value, the number should
-        // already be in R12
-        return 0xEF000000u;
+        // 1110 1111 XXXXXXXXXXXXXXXXXXXXXXXX
+        // where X is the immediate, it is ignored by the processor and
+        // only read by the supervisor call handler
+        return 0xEF000000u | (immed & 0xFFFFFF);
     case INSTRUCTION_BRANCH:
         // 1110 0001 0010 111111111111 0001 YYYY
         // BX Rn has 0xE12FFF1 as top bytes